@@ -0,0 +1,100 @@
+// Benchmark de host: costo del log por ciclo de control_task.
+//
+// Compara, para la línea de cada ciclo (7 argumentos con un float):
+//   - formatear con snprintf, que es lo que ESP_LOGI hacía dentro del lazo
+//     (sin contar la UART, que además bloquea mientras el FIFO está lleno),
+//   - blog_put: copiar ID + argumentos crudos al ring (core/blog.c),
+//   - blog_format: lo que después paga BlogDrain con prioridad 1.
+// Imprime también el tiempo de UART de la línea a 115200 baud, y el efecto
+// del límite de repetición con un mensaje de advertencia en ráfaga.
+//
+// Uso: bench_blog [--iterations N]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "blog.h"
+
+#define UART_BAUD   115200
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static volatile size_t sink;
+
+int main(int argc, char **argv) {
+    long iterations = 1000000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atol(argv[++i]);
+    }
+    if (iterations < 1) {
+        fprintf(stderr, "uso: %s [--iterations N>0]\n", argv[0]);
+        return 2;
+    }
+
+    static blog_t blog;
+    blog_init(&blog);
+    char line[160];
+
+    // Lo que hacía ESP_LOGI: "[HH:MM:SS] Zona ..." formateado en el lazo
+    uint64_t t0 = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        float temp = 24.0f + (float)(i & 63) * 0.01f;
+        sink += (size_t)snprintf(line, sizeof(line),
+                                 "I (%lu) TASK_CONTROL: [%s] Zona %u | Mode: %d | Temp: %.1f | PIR: %d -> PWM: %lu%% (motivo %d, %lld us)\n",
+                                 (unsigned long)i, "12:34:56", (unsigned)(i & 7), 2, temp, 1, (unsigned long)(i % 101), 0,
+                                 (long long)(i & 1023));
+    }
+    double fmt_ns = (double)(now_ns() - t0) / iterations;
+    size_t line_len = strlen(line);
+
+    // Productor binario: el ring se vacía de a tandas como haría BlogDrain
+    blog_record_t r;
+    uint64_t put_total = 0;
+    long done = 0;
+    while (done < iterations) {
+        long batch = (iterations - done < BLOG_RING_LEN) ? iterations - done : BLOG_RING_LEN;
+        t0 = now_ns();
+        for (long i = 0; i < batch; i++) {
+            long k = done + i;
+            float temp = 24.0f + (float)(k & 63) * 0.01f;
+            const uint32_t args[] = { (uint32_t)(k & 7), 2, blog_f(temp), 1, (uint32_t)(k % 101), 0, (uint32_t)(k & 1023) };
+            blog_put(&blog, k, BLOG_CONTROL_CYCLE, args, 7);
+        }
+        put_total += now_ns() - t0;
+        while (blog_get(&blog, &r)) {}
+        done += batch;
+    }
+    double put_ns = (double)put_total / iterations;
+
+    // Drenaje: formatear los registros fuera del lazo
+    const uint32_t args[] = { 3, 2, blog_f(24.3f), 1, 57, 0, 812 };
+    blog_put(&blog, 0, BLOG_CONTROL_CYCLE, args, 7);
+    blog_get(&blog, &r);
+    t0 = now_ns();
+    for (long i = 0; i < iterations; i++) sink += blog_format(line, sizeof(line), &r);
+    double drain_ns = (double)(now_ns() - t0) / iterations;
+
+    // Ráfaga de advertencias: 1000 lecturas inválidas a 4 Hz por zona
+    blog_init(&blog);
+    unsigned queued = 0;
+    for (int i = 0; i < 1000; i++) {
+        const uint32_t a[] = { 0, 4095 };
+        if (blog_put(&blog, (int64_t)i * 250000, BLOG_NTC_INVALID, a, 2)) queued++;
+        while (blog_get(&blog, &r)) {}
+    }
+
+    printf("control cycle line: %zu bytes, record %zu bytes, ring %d records (%zu bytes)\n",
+           line_len, sizeof(blog_record_t), BLOG_RING_LEN, sizeof(blog_t));
+    printf("snprintf (old ESP_LOGI path) %8.1f ns/line + UART %.0f us at %d baud\n",
+           fmt_ns, line_len * 10 * 1e6 / UART_BAUD, UART_BAUD);
+    printf("blog_put (control path)      %8.1f ns/record (%.1fx faster, no UART)\n", put_ns, fmt_ns / put_ns);
+    printf("blog_format (BlogDrain)      %8.1f ns/record\n", drain_ns);
+    printf("rate limit: 1000 invalid reads at 4 Hz -> %u records, %u suppressed, last: %s\n",
+           queued, blog.suppressed, (blog_format(line, sizeof(line), &r), line));
+    return 0;
+}
@@ -0,0 +1,215 @@
+// Benchmark de host: blob versionado de configuración (core/config_codec.c)
+// contra el volcado crudo de system_config_t que se guardaba antes.
+//
+// Para la config de fábrica (1 zona, 1 regla) y una completa (8 zonas, 24
+// reglas) mide:
+//   - bytes del blob y entradas de NVS que ocupa (32 bytes cada una: índice
+//     de blob + cabecera de datos + los datos), y cuántas escrituras entran
+//     en una página de NVS (126 entradas) antes de que haya que rotarla,
+//   - tiempo de codificar y de decodificar (con CRC), contra memcpy del
+//     blob crudo, que es todo lo que hacía la carga anterior después de
+//     nvs_get_blob. En el ESP32 la carga completa (lectura de NVS incluida)
+//     queda en /api/storage como load_us.
+// Verifica además que decode(encode(c)) == c, que un blob con un tag
+// desconocido (firmware más nuevo) se sigue leyendo, que el volcado crudo
+// del firmware original ("sys_cfg", 56 bytes) migra a la zona 0 y que una
+// regla fuera de rango se borra sin tocar el resto (config_repair).
+//
+// Uso: bench_config [--iterations N]    (ctest: config_migration)
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "config_codec.h"
+#include "config_check.h"
+#include "sensor_log_codec.h"
+
+#define NVS_ENTRY_SIZE      32
+#define NVS_PAGE_ENTRIES    126
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned nvs_entries(size_t len) {
+    return 2 + (unsigned)((len + NVS_ENTRY_SIZE - 1) / NVS_ENTRY_SIZE);
+}
+
+static system_config_t full_config(void) {
+    system_config_t c = default_system_config;
+    c.version = 1234;
+    c.zone_count = MAX_ZONES;
+    for (int z = 0; z < MAX_ZONES; z++) {
+        c.zones[z] = default_system_config.zones[0];
+        c.zones[z].operation_mode = (operation_mode_t)(z % MODE_COUNT);
+        c.zones[z].pid.setpoint_c = 22.0f + z * 0.5f;
+    }
+    c.schedule_count = MAX_SCHEDULES;
+    memset(c.schedules, 0, sizeof(c.schedules));   // Padding en cero: el roundtrip compara con memcmp
+    for (int i = 0; i < MAX_SCHEDULES; i++) {
+        schedule_reg_t *r = &c.schedules[i];
+        r->start_hour = r->end_hour = (uint8_t)i;
+        r->end_min = 59;
+        r->days = DAYS_ALL;
+        r->temp_min_0_percent = 22.0f + i * 0.1f;
+        r->temp_max_100_percent = 27.0f;
+        r->active = (i % 2) == 0;
+    }
+    return c;
+}
+
+static volatile uint32_t sink;
+
+static int run(const char *name, const system_config_t *cfg, int iterations) {
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t len = config_encode(cfg, blob, sizeof(blob));
+    system_config_t out;
+    config_decode_info_t info;
+    if (len == 0 || config_decode(blob, len, &out, &info) != CONFIG_DECODE_OK ||
+        memcmp(&out, cfg, sizeof(out)) != 0) {
+        printf("%s: roundtrip FALLA\n", name);
+        return 1;
+    }
+
+    double t0 = now_s();
+    for (int i = 0; i < iterations; i++) sink += (uint32_t)config_encode(cfg, blob, sizeof(blob));
+    double enc_ns = (now_s() - t0) / iterations * 1e9;
+
+    t0 = now_s();
+    for (int i = 0; i < iterations; i++) {
+        config_decode(blob, len, &out, NULL);
+        sink += out.version;
+    }
+    double dec_ns = (now_s() - t0) / iterations * 1e9;
+
+    system_config_t raw;
+    t0 = now_s();
+    for (int i = 0; i < iterations; i++) {
+        memcpy(&raw, cfg, sizeof(raw));
+        __asm__ volatile("" : : "r"(&raw) : "memory");
+        sink += raw.version;
+    }
+    double raw_ns = (now_s() - t0) / iterations * 1e9;
+
+    unsigned e_blob = nvs_entries(len), e_raw = nvs_entries(sizeof(system_config_t));
+    printf("%-8s blob %4zu B, %2u entradas NVS (%2u escrituras/página) | crudo %4zu B, %2u entradas (%u/página)\n",
+           name, len, e_blob, NVS_PAGE_ENTRIES / e_blob, sizeof(system_config_t), e_raw, NVS_PAGE_ENTRIES / e_raw);
+    printf("         encode %6.0f ns, decode %6.0f ns | memcpy crudo %4.0f ns\n", enc_ns, dec_ns, raw_ns);
+    return 0;
+}
+
+// Un firmware más nuevo agrega un campo global (tag 0x30) y uno por zona:
+// este firmware los saltea y lee el resto igual
+static int check_forward(void) {
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t len = config_encode(&default_system_config, blob, sizeof(blob));
+    const uint8_t extra[] = { 0x30, 2, 0x34, 0x12 };
+    memcpy(blob + len, extra, sizeof(extra));
+    len += sizeof(extra);
+    size_t body = len - CONFIG_HEADER_SIZE;
+    blob[6] = (uint8_t)body;
+    blob[7] = (uint8_t)(body >> 8);
+    uint32_t crc = slog_crc32(blob + CONFIG_HEADER_SIZE, body);
+    for (int i = 0; i < 4; i++) blob[8 + i] = (uint8_t)(crc >> (8 * i));
+
+    system_config_t out;
+    config_decode_info_t info;
+    config_decode_err_t err = config_decode(blob, len, &out, &info);
+    bool ok = err == CONFIG_DECODE_OK && info.unknown == 1 &&
+              memcmp(&out, &default_system_config, sizeof(out)) == 0;
+    blob[CONFIG_HEADER_SIZE] ^= 0x01;
+    bool crc_ok = config_decode(blob, len, &out, NULL) == CONFIG_DECODE_CRC;
+    printf("tag desconocido: %s, CRC corrupto: %s\n", ok ? "salteado" : "FALLA", crc_ok ? "rechazado" : "FALLA");
+    return (ok && crc_ok) ? 0 : 1;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_float(uint8_t *p, float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    put32(p, bits);
+}
+
+// Volcado del firmware original armado byte a byte (layout del ESP32, no el
+// de este host): modo AUTO, 35 % y dos reglas, la segunda inactiva
+static int check_legacy(void) {
+    uint8_t raw[CONFIG_LEGACY_SIZE] = {0};
+    put32(raw, MODE_AUTO);
+    put32(raw + 4, 35);
+    const uint8_t r0[] = { 22, 30, 6, 15 };
+    memcpy(raw + 8, r0, sizeof(r0));
+    put_float(raw + 12, 23.5f);
+    put_float(raw + 16, 26.0f);
+    raw[20] = 1;
+    const uint8_t r1[] = { 13, 0, 17, 45 };
+    memcpy(raw + 24, r1, sizeof(r1));
+    put_float(raw + 28, 24.0f);
+    put_float(raw + 32, 28.0f);
+
+    system_config_t out;
+    int index;
+    bool ok = config_decode_legacy(raw, sizeof(raw), &out) && config_check(&out, &index) == NULL;
+    const zone_config_t *z = &out.zones[0];
+    const schedule_reg_t *s0 = &out.schedules[0], *s1 = &out.schedules[1];
+    ok = ok && z->operation_mode == MODE_AUTO && z->manual_duty == 35 &&
+         out.zone_count == default_system_config.zone_count && out.schedule_count == 3 &&
+         s0->start_hour == 22 && s0->start_min == 30 && s0->end_hour == 6 && s0->end_min == 15 &&
+         s0->temp_min_0_percent == 23.5f && s0->temp_max_100_percent == 26.0f && s0->active &&
+         s1->start_hour == 13 && s1->end_min == 45 && s1->temp_max_100_percent == 28.0f && !s1->active &&
+         s0->days == DAYS_ALL && s1->days == DAYS_ALL && out.schedules[2].days == DAYS_ALL &&
+         memcmp(&z->pid, &default_system_config.zones[0].pid, sizeof(z->pid)) == 0;
+    // Otro largo (un volcado de este host o truncado) no se adivina
+    bool len_ok = !config_decode_legacy(raw, sizeof(raw) - 4, &out);
+    printf("volcado original: %s, largo ajeno: %s\n", ok ? "migrado" : "FALLA", len_ok ? "rechazado" : "FALLA");
+    return (ok && len_ok) ? 0 : 1;
+}
+
+// Un minuto fuera de rango en la regla 1 y un Kp imposible en la zona 2: se
+// borra esa regla, se repone ese Kp y todo lo demás queda igual
+static int check_repair(void) {
+    system_config_t cfg = full_config();
+    system_config_t want = cfg;
+    cfg.schedules[1].end_min = 75;
+    cfg.zones[2].pid.kp = -1.0f;
+
+    want.zones[2].pid.kp = default_system_config.zones[2].pid.kp;
+    memmove(&want.schedules[1], &want.schedules[2], (MAX_SCHEDULES - 2) * sizeof(schedule_reg_t));
+    memset(&want.schedules[MAX_SCHEDULES - 1], 0, sizeof(schedule_reg_t));
+    want.schedule_count--;
+
+    int fixed = config_repair(&cfg);
+    bool ok = fixed == 2 && memcmp(&cfg, &want, sizeof(cfg)) == 0;
+    printf("config fuera de rango: %s (%d arreglos)\n", ok ? "reparada" : "FALLA", fixed);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int iterations = 200000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "uso: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations < 1) iterations = 1;
+
+    system_config_t full = full_config();
+    int index;
+    if (config_check(&full, &index) != NULL) {
+        printf("config completa fuera de rango\n");
+        return 1;
+    }
+    int fails = run("fábrica", &default_system_config, iterations);
+    fails += run("completa", &full, iterations);
+    fails += check_forward();
+    fails += check_legacy();
+    fails += check_repair();
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+// Benchmark de host: replay de trazas sensor_data_t a través de control_decide().
+//
+// Formato de traza (una muestra por línea, '#' = comentario):
+//     epoch_s,temp_c,presence[,expected_pwm]
+// También acepta directamente la salida del monitor serie del ESP32: se busca
+// el prefijo "TRACE," que emite control_task con nivel DEBUG.
+//
+// Uso:
+//     bench_control <traza.csv> [--mode N] [--iterations N] [--check] [--emit]
+//
+//   --mode N        Fuerza operation_mode (0=MANUAL, 1=AUTO, 2=PROGRAMADO, 3=PID, 4=HISTÉRESIS)
+//   --iterations N  Veces que se reproduce la traza completa (default 200)
+//   --check         Compara contra expected_pwm y sale con código 1 si difiere
+//   --emit          Imprime la traza con el PWM calculado (regenera el golden)
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "control_logic.h"
+
+#define MAX_SAMPLES     (1 << 20)
+#define LAT_BUCKETS     4096    // Histograma de latencia con resolución de 1 ns
+
+typedef struct {
+    sensor_data_t data;
+    struct tm timeinfo;
+    bool time_synced;
+    int expected_pwm;           // -1 si la traza no lo trae
+} trace_sample_t;
+
+static trace_sample_t samples[MAX_SAMPLES];
+static schedule_index_t sched;
+static control_state_t state;
+static uint64_t lat_hist[LAT_BUCKETS];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t load_trace(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        exit(2);
+    }
+
+    char line[256];
+    size_t n = 0;
+    while (fgets(line, sizeof(line), f) != NULL && n < MAX_SAMPLES) {
+        const char *p = strstr(line, "TRACE,");
+        p = (p != NULL) ? p + 6 : line;
+        if (*p == '#' || *p == '\n') continue;
+
+        long long epoch = 0;
+        float temp = 0;
+        int presence = 0, pwm = -1;
+        int fields = sscanf(p, "%lld,%f,%d,%d", &epoch, &temp, &presence, &pwm);
+        if (fields < 3) continue;
+
+        trace_sample_t *s = &samples[n++];
+        s->data.temperature = temp;
+        s->data.presence_detected = presence != 0;
+        s->data.timestamp = epoch * 1000000;    // Como esp_timer: µs (dt del PID)
+        s->expected_pwm = (fields == 4) ? pwm : -1;
+
+        // Igual que control_task: hora local y criterio de sincronización NTP
+        time_t t = (time_t)epoch;
+        localtime_r(&t, &s->timeinfo);
+        s->time_synced = (s->timeinfo.tm_year > (2020 - 1900));
+    }
+    fclose(f);
+    return n;
+}
+
+static uint64_t percentile(uint64_t total, double q) {
+    uint64_t target = (uint64_t)(total * q);
+    uint64_t acc = 0;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        acc += lat_hist[i];
+        if (acc > target) return (uint64_t)i;
+    }
+    return LAT_BUCKETS - 1;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    int mode = -1;
+    int iterations = 200;
+    bool check = false, emit = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) mode = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--check") == 0) check = true;
+        else if (strcmp(argv[i], "--emit") == 0) emit = true;
+        else path = argv[i];
+    }
+    if (path == NULL || iterations <= 0) {
+        fprintf(stderr, "uso: %s <traza.csv> [--mode N] [--iterations N] [--check] [--emit]\n", argv[0]);
+        return 2;
+    }
+
+    // Misma zona horaria que app_main (main.c)
+    setenv("TZ", "EST5", 1);
+    tzset();
+
+    size_t n = load_trace(path);
+    if (n == 0) {
+        fprintf(stderr, "Traza vacía: %s\n", path);
+        return 2;
+    }
+
+    system_config_t cfg = default_system_config;
+    if (mode >= 0) cfg.zones[0].operation_mode = mode;
+    schedule_index_compile(&sched, &cfg);
+
+    // 1. Pasada de verificación (regresión contra el PWM grabado)
+    size_t mismatches = 0, checked = 0;
+    for (size_t i = 0; i < n; i++) {
+        control_decision_t d = control_decide(&cfg.zones[0], &sched, &state, &samples[i].data, &samples[i].timeinfo, samples[i].time_synced);
+        if (emit) {
+            printf("%lld,%.2f,%d,%lu\n", (long long)(samples[i].data.timestamp / 1000000),
+                   samples[i].data.temperature, samples[i].data.presence_detected,
+                   (unsigned long)d.pwm);
+        }
+        if (samples[i].expected_pwm >= 0) {
+            checked++;
+            if ((int)d.pwm != samples[i].expected_pwm) {
+                if (mismatches < 10) {
+                    fprintf(stderr, "DIFF muestra %zu: esperado %d, obtenido %lu\n",
+                            i, samples[i].expected_pwm, (unsigned long)d.pwm);
+                }
+                mismatches++;
+            }
+        }
+    }
+    if (emit) return 0;
+
+    // 2. Throughput: replay completo sin instrumentar cada llamada
+    volatile uint32_t sink = 0;
+    uint64_t t0 = now_ns();
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < n; i++) {
+            sink += control_decide(&cfg.zones[0], &sched, &state, &samples[i].data, &samples[i].timeinfo, samples[i].time_synced).pwm;
+        }
+    }
+    uint64_t elapsed = now_ns() - t0;
+    uint64_t decisions = (uint64_t)iterations * n;
+
+    // 3. Latencia por decisión (incluye el overhead del reloj, medido aparte)
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t a = now_ns();
+        uint64_t b = now_ns();
+        if (b - a < overhead) overhead = b - a;
+    }
+    uint64_t lat_max = 0;
+    for (int it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < n; i++) {
+            uint64_t a = now_ns();
+            sink += control_decide(&cfg.zones[0], &sched, &state, &samples[i].data, &samples[i].timeinfo, samples[i].time_synced).pwm;
+            uint64_t lat = now_ns() - a;
+            lat = (lat > overhead) ? lat - overhead : 0;
+            if (lat > lat_max) lat_max = lat;
+            lat_hist[lat < LAT_BUCKETS ? lat : LAT_BUCKETS - 1]++;
+        }
+    }
+    (void)sink;
+
+    printf("trace=%s samples=%zu mode=%d iterations=%d\n", path, n, cfg.zones[0].operation_mode, iterations);
+    printf("throughput: %.0f decisions/s (%.2f ns/decision)\n",
+           decisions * 1e9 / (double)elapsed, (double)elapsed / (double)decisions);
+    printf("latency_ns: p50=%llu p99=%llu max=%llu (timer overhead %llu ns)\n",
+           (unsigned long long)percentile(decisions, 0.50),
+           (unsigned long long)percentile(decisions, 0.99),
+           (unsigned long long)lat_max,
+           (unsigned long long)overhead);
+    printf("regression: %zu/%zu samples differ\n", mismatches, checked);
+
+    return (check && mismatches > 0) ? 1 : 0;
+}
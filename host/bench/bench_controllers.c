@@ -0,0 +1,201 @@
+// Benchmark de host: modos de control sobre la planta térmica del mock de HAL.
+//
+// Corre control_decide() a 1 Hz contra core/thermal_plant.c (con ruido de
+// sensor y retardo del ventilador) durante 8 h con presencia continua y dos
+// cambios de carga térmica (29 °C a las 3 h, 26 °C a las 5.5 h), y compara
+// por modo:
+//   - tiempo de asentamiento tras cada cambio (entrar y quedarse en
+//     +-SETTLE_BAND del valor final del tramo) y sobrepaso,
+//   - error RMS contra la consigna en régimen; la rampa lineal no tiene
+//     consigna y se mide contra la del PID por defecto (24 °C), el mismo
+//     objetivo que las demás filas,
+//   - actividad del actuador: cambios de PWM, suma de |dPWM| y PWM medio.
+// El PID usa las ganancias de un autotune por relé hecho al inicio sobre la
+// misma planta (PI y PID completo) además de las de config_defaults.c;
+// --deadband fuerza la banda muerta de las tres variantes PID. Los miles de
+// cambios de "pid-tuned" son del controlador, no de la métrica: con Td ~40 s
+// la derivada (filtrada a Td/8) lleva el ruido del sensor a saltos de ~20 %
+// de PWM por muestra, muy por encima de la banda muerta (--trace pid-tuned).
+//
+// Uso: bench_controllers [--hours N] [--deadband PCT] [--trace MODE]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "control_logic.h"
+#include "thermal_plant.h"
+#include "pid_autotune.h"
+
+#define SETTLE_BAND     0.2f    // °C
+#define FINAL_WINDOW_S  600     // Promedio final de cada tramo
+#define MAX_STEPS       (24 * 3600)
+
+typedef struct {
+    const char *name;
+    system_config_t cfg;
+} variant_t;
+
+typedef struct {
+    float settle_s[3];          // Por tramo (-1 = no asentó)
+    float overshoot[3];
+    float final_c[3];
+    double rms_sp;              // Error RMS contra la consigna en régimen (últimos FINAL_WINDOW_S de cada tramo)
+    uint32_t changes;
+    uint64_t total_variation;
+    double mean_pwm;
+} metrics_t;
+
+static float temps[MAX_STEPS];
+
+// Carga térmica por tramo: equilibrio sin ventilador
+static float ambient_at(int t, int hours) {
+    int seg1 = hours * 3600 * 3 / 8, seg2 = hours * 3600 * 11 / 16;
+    return (t < seg1) ? 27.0f : (t < seg2) ? 29.0f : 26.0f;
+}
+
+static void run(const variant_t *v, int hours, bool trace, metrics_t *m) {
+    thermal_plant_t plant;
+    thermal_plant_init(&plant, &thermal_plant_default_params, 7);
+    control_state_t st;
+    control_state_reset(&st);
+    schedule_index_t *sched = malloc(sizeof(schedule_index_t));
+    schedule_index_compile(sched, &v->cfg);
+
+    int total = hours * 3600;
+    int bounds[4] = { 0, total * 3 / 8, total * 11 / 16, total };
+    uint32_t pwm = 0, prev = 0;
+    uint64_t pwm_sum = 0;
+    memset(m, 0, sizeof(*m));
+    struct tm tm_now = { .tm_year = 126, .tm_mday = 1, .tm_hour = 12 };
+
+    for (int t = 0; t < total; t++) {
+        plant.p.ambient_c = ambient_at(t, hours);
+        sensor_data_t s = {
+            .temperature = thermal_plant_measure(&plant),
+            .presence_detected = true,
+            .timestamp = (int64_t)t * 1000000,
+            .temp_quality = TEMP_QUALITY_GOOD,
+        };
+        control_decision_t d = control_decide(&v->cfg.zones[0], sched, &st, &s, &tm_now, true);
+        if (d.status == CONTROL_OK) pwm = d.pwm;
+        if (t > 0 && pwm != prev) {
+            m->changes++;
+            m->total_variation += (pwm > prev) ? pwm - prev : prev - pwm;
+        }
+        prev = pwm;
+        pwm_sum += pwm;
+        temps[t] = plant.temp_c;
+        if (trace) printf("%d,%.3f,%.3f,%u\n", t, plant.temp_c, s.temperature, pwm);
+        thermal_plant_step(&plant, pwm);
+    }
+    free(sched);
+    m->mean_pwm = (double)pwm_sum / total;
+
+    const zone_config_t *zc = &v->cfg.zones[0];
+    float sp = (zc->operation_mode == MODE_HYSTERESIS) ? zc->hysteresis.setpoint_c : zc->pid.setpoint_c;
+    double sq = 0;
+    for (int k = 0; k < 3; k++) {
+        int a = bounds[k], b = bounds[k + 1];
+        double fin = 0;
+        for (int t = b - FINAL_WINDOW_S; t < b; t++) {
+            fin += temps[t];
+            sq += (temps[t] - sp) * (temps[t] - sp);
+        }
+        fin /= FINAL_WINDOW_S;
+        m->final_c[k] = (float)fin;
+
+        // Último instante fuera de la banda: desde ahí quedó asentado
+        int last_out = -1;
+        float peak = 0;
+        for (int t = a; t < b; t++) {
+            float e = temps[t] - (float)fin;
+            if (fabsf(e) > SETTLE_BAND) last_out = t;
+            // Sobrepaso: del lado opuesto al arranque del tramo
+            float start_side = temps[a] - (float)fin;
+            if ((start_side > 0 && -e > peak) || (start_side < 0 && e > peak)) peak = fabsf(e);
+        }
+        m->settle_s[k] = (last_out < b - FINAL_WINDOW_S) ? (float)(last_out + 1 - a) : -1.0f;
+        m->overshoot[k] = peak;
+    }
+    m->rms_sp = sqrt(sq / (3 * FINAL_WINDOW_S));
+}
+
+int main(int argc, char **argv) {
+    int hours = 8;
+    const char *trace_name = NULL;
+    int deadband = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) hours = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_name = argv[++i];
+        else if (strcmp(argv[i], "--deadband") == 0 && i + 1 < argc) deadband = atoi(argv[++i]);
+    }
+    if (hours < 2 || hours > 24) {
+        fprintf(stderr, "uso: %s [--hours 2..24] [--deadband PCT] [--trace NOMBRE]\n", argv[0]);
+        return 2;
+    }
+
+    // Autotune por relé sobre la misma planta (ver host/tools/pid_autotune.c)
+    thermal_plant_t plant;
+    thermal_plant_init(&plant, &thermal_plant_default_params, 1);
+    pid_autotune_t at;
+    pid_autotune_init(&at, default_system_config.zones[0].pid.setpoint_c, 0.1f, 0, 100);
+    float t_at = 0;
+    while (at.status == PID_AUTOTUNE_RUNNING) {
+        uint32_t u = pid_autotune_step(&at, thermal_plant_measure(&plant), t_at);
+        thermal_plant_step(&plant, u);
+        t_at += 1.0f;
+    }
+    if (at.status != PID_AUTOTUNE_DONE) {
+        fprintf(stderr, "autotune falló\n");
+        return 1;
+    }
+
+    variant_t v[5];
+    for (int i = 0; i < 5; i++) v[i].cfg = default_system_config;
+    v[0].name = "linear";      v[0].cfg.zones[0].operation_mode = MODE_AUTO;
+    v[1].name = "hysteresis";  v[1].cfg.zones[0].operation_mode = MODE_HYSTERESIS;
+    v[2].name = "pid-default"; v[2].cfg.zones[0].operation_mode = MODE_PID;
+    v[3].name = "pi-tuned";    v[3].cfg.zones[0].operation_mode = MODE_PID;
+    pid_autotune_result(&at, false, &v[3].cfg.zones[0].pid);
+    v[4].name = "pid-tuned";   v[4].cfg.zones[0].operation_mode = MODE_PID;
+    pid_autotune_result(&at, true, &v[4].cfg.zones[0].pid);
+    if (deadband >= 0) {
+        for (int i = 2; i < 5; i++) v[i].cfg.zones[0].pid.deadband_pct = (uint32_t)deadband;
+    }
+
+    if (trace_name != NULL) {
+        for (int i = 0; i < 5; i++) {
+            if (strcmp(v[i].name, trace_name) == 0) {
+                metrics_t m;
+                printf("# t_s,temp_c,measured_c,pwm\n");
+                run(&v[i], hours, true, &m);
+                return 0;
+            }
+        }
+        fprintf(stderr, "modo desconocido: %s\n", trace_name);
+        return 2;
+    }
+
+    printf("plant: ambient 27->29->26 °C, gain %.1f, tau %.0f s, dead %.0f s, noise %.2f; %d h at 1 Hz\n",
+           thermal_plant_default_params.fan_gain_c, thermal_plant_default_params.tau_s,
+           thermal_plant_default_params.dead_time_s, thermal_plant_default_params.noise_c, hours);
+    printf("autotune: Ku=%.1f %%/°C Tu=%.0f s\n", at.ku, at.tu);
+    printf("%-12s %-26s %-20s %-17s %8s %8s %7s\n", "mode", "settle s (3 steps)", "overshoot °C",
+           "final °C", "rms_sp", "changes", "sum|dU|");
+    for (int i = 0; i < 5; i++) {
+        metrics_t m;
+        run(&v[i], hours, false, &m);
+        char settle[64], over[64], fin[64];
+        snprintf(settle, sizeof(settle), "%6.0f %6.0f %6.0f", m.settle_s[0], m.settle_s[1], m.settle_s[2]);
+        snprintf(over, sizeof(over), "%.2f %.2f %.2f", m.overshoot[0], m.overshoot[1], m.overshoot[2]);
+        snprintf(fin, sizeof(fin), "%.2f %.2f %.2f", m.final_c[0], m.final_c[1], m.final_c[2]);
+        printf("%-12s %-26s %-20s %-17s %8.3f %8u %7llu  mean pwm %.1f%%\n", v[i].name, settle, over, fin,
+               m.rms_sp, m.changes, (unsigned long long)m.total_variation, m.mean_pwm);
+        if (v[i].cfg.zones[0].operation_mode == MODE_PID) {
+            printf("%-12s kp=%.2f ki=%.4f kd=%.1f db=%u\n", "", v[i].cfg.zones[0].pid.kp, v[i].cfg.zones[0].pid.ki,
+                   v[i].cfg.zones[0].pid.kd, v[i].cfg.zones[0].pid.deadband_pct);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+// Benchmark de host: historial de telemetría en RAM (core/history.c).
+//
+// Alimenta N días de muestras sintéticas (con huecos diarios y lecturas
+// INVALID), verifica cada nivel contra un recálculo directo desde el
+// generador y mide el costo por muestra, por lectura de nivel completo y el
+// tamaño en memoria y en el cable de /api/history. Dos casos:
+//   - 1hz:    una muestra por segundo,
+//   - uneven: como el muestreo adaptativo, tramos de 15 s a 4 muestras por
+//             segundo (250 ms) cada 5 min y en el resto una cada 10 s.
+// El recálculo recorre el tiempo segundo a segundo con la muestra vigente
+// (ver HISTORY_MAX_HOLD_S): si los agregados contaran muestras en vez de
+// tiempo, el caso uneven no coincidiría.
+//
+// Uso: bench_history [--days N]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "history.h"
+
+#define T0_EPOCH    1767225600LL    // 2026-01-01 00:00:00 UTC
+#define GAP_START   3600            // Hueco diario 01:00-01:10 (sensor apagado)
+#define GAP_LEN     600
+
+static history_t hist;
+static history_agg_t agg_buf[HISTORY_MINUTES_LEN];
+static history_sample_t sample_buf[HISTORY_SECONDS_LEN];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+static bool uneven;
+
+// Muestras en el segundo 'ts' (0 = ninguna)
+static int samples_at(int64_t ts) {
+    if (ts < T0_EPOCH) return 0;
+    if ((ts - T0_EPOCH) % 86400 >= GAP_START && (ts - T0_EPOCH) % 86400 < GAP_START + GAP_LEN) return 0;
+    if (!uneven) return 1;
+    if (ts % 300 < 15) return 4;
+    return (ts % 10 == 0) ? 1 : 0;
+}
+
+// Muestra sintética determinista k del segundo 'ts'
+static void synth(int64_t ts, int k, float *temp, temp_quality_t *q, bool *pres, uint32_t *pwm) {
+    uint32_t h = hash32((uint32_t)(ts * 4 + k));
+    *temp = 22.0f + 3.0f * sinf((float)(ts % 86400) * 6.2831853f / 86400.0f) + (float)(h % 100) / 200.0f;
+    *q = (h % 97 == 0) ? TEMP_QUALITY_INVALID : TEMP_QUALITY_GOOD;
+    *pres = (h >> 8) & 1;
+    *pwm = (h >> 9) % 101;
+}
+
+// Muestra vigente en el segundo 'ts': la primera del segundo para los
+// agregados, la última para el nivel de 1 s; sin muestras, la última de
+// los HISTORY_MAX_HOLD_S anteriores. false = hueco
+static bool state_at(int64_t ts, bool first, float *temp, temp_quality_t *q, bool *pres, uint32_t *pwm) {
+    int n = samples_at(ts);
+    if (n > 0) {
+        synth(ts, first ? 0 : n - 1, temp, q, pres, pwm);
+        return true;
+    }
+    for (int j = 1; j < HISTORY_MAX_HOLD_S; j++) {
+        n = samples_at(ts - j);
+        if (n > 0) {
+            synth(ts - j, n - 1, temp, q, pres, pwm);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Agregado de referencia: recorre el tiempo segundo a segundo
+static history_agg_t reference_agg(int64_t start, uint32_t period, int64_t end_excl) {
+    int64_t sum = 0;
+    int tn = 0, n = 0, pn = 0;
+    int16_t mn = INT16_MAX, mx = INT16_MIN;
+    uint32_t pwm_sum = 0;
+    for (int64_t ts = start; ts < start + period && ts < end_excl; ts++) {
+        float t; temp_quality_t q; bool p; uint32_t pwm;
+        if (!state_at(ts, true, &t, &q, &p, &pwm)) continue;
+        if (q != TEMP_QUALITY_INVALID) {
+            int16_t c = (int16_t)roundf(t * 100.0f);
+            sum += c; tn++;
+            if (c < mn) mn = c;
+            if (c > mx) mx = c;
+        }
+        pn += p; pwm_sum += pwm; n++;
+    }
+    history_agg_t a = { HISTORY_NO_TEMP, HISTORY_NO_TEMP, HISTORY_NO_TEMP, 0, HISTORY_PRESENCE_EMPTY };
+    if (n == 0) return a;
+    if (tn > 0) {
+        a.temp_avg = (int16_t)((sum + tn / 2) / tn);
+        a.temp_min = mn;
+        a.temp_max = mx;
+    }
+    a.pwm_avg = (uint8_t)((pwm_sum + n / 2) / n);
+    a.presence_pct = (uint8_t)((pn * 100 + n / 2) / n);
+    return a;
+}
+
+static size_t verify_agg_tier(int tier, int64_t end_excl) {
+    uint32_t period = history_period_s(tier);
+    size_t cap = history_capacity(tier);
+    int64_t first = history_latest(&hist, tier) - (int64_t)(cap - 1) * period;
+    history_read(&hist, tier, first, cap, agg_buf);
+
+    size_t diffs = 0;
+    for (size_t i = 0; i < cap; i++) {
+        int64_t start = first + (int64_t)i * period;
+        history_agg_t want = (start < T0_EPOCH) ? reference_agg(0, 0, 0) : reference_agg(start, period, end_excl);
+        if (memcmp(&want, &agg_buf[i], sizeof(want)) != 0) {
+            if (diffs < 5) {
+                fprintf(stderr, "DIFF tier %d bucket %lld: avg %d/%d min %d/%d max %d/%d pwm %u/%u pres %u/%u\n",
+                        tier, (long long)start, agg_buf[i].temp_avg, want.temp_avg,
+                        agg_buf[i].temp_min, want.temp_min, agg_buf[i].temp_max, want.temp_max,
+                        agg_buf[i].pwm_avg, want.pwm_avg, agg_buf[i].presence_pct, want.presence_pct);
+            }
+            diffs++;
+        }
+    }
+    return diffs;
+}
+
+static size_t verify_seconds(void) {
+    int64_t first = history_latest(&hist, HISTORY_TIER_SECOND) - (HISTORY_SECONDS_LEN - 1);
+    history_read(&hist, HISTORY_TIER_SECOND, first, HISTORY_SECONDS_LEN, sample_buf);
+
+    size_t diffs = 0;
+    for (size_t i = 0; i < HISTORY_SECONDS_LEN; i++) {
+        float t; temp_quality_t q; bool p; uint32_t pwm;
+        bool present = state_at(first + (int64_t)i, false, &t, &q, &p, &pwm);
+        const history_sample_t *s = &sample_buf[i];
+        bool ok;
+        if (!present) {
+            ok = !(s->flags & HISTORY_F_VALID);
+        } else {
+            int16_t c = (q == TEMP_QUALITY_INVALID) ? HISTORY_NO_TEMP : (int16_t)roundf(t * 100.0f);
+            ok = (s->flags & HISTORY_F_VALID) && s->temp_c100 == c && s->pwm == pwm &&
+                 ((s->flags & HISTORY_F_PRESENCE) != 0) == p;
+        }
+        if (!ok) diffs++;
+    }
+    return diffs;
+}
+
+// Un caso completo; devuelve los buckets que difieren
+static size_t run_case(const char *name, int days) {
+    history_init(&hist);
+    int64_t end = T0_EPOCH + (int64_t)days * 86400 - 1234;  // Termina a mitad de hora
+    int64_t last = T0_EPOCH;
+    uint64_t pushes = 0;
+
+    uint64_t t0 = now_ns();
+    for (int64_t ts = T0_EPOCH; ts < end; ts++) {
+        int n = samples_at(ts);
+        for (int k = 0; k < n; k++) {
+            float t; temp_quality_t q; bool p; uint32_t pwm;
+            synth(ts, k, &t, &q, &p, &pwm);
+            history_push(&hist, ts, t, q, p, pwm);
+            pushes++;
+            last = ts;
+        }
+    }
+    uint64_t t_push = now_ns() - t0;
+
+    // Lectura de un nivel completo, como /api/history sin rango
+    const int reads = 200;
+    t0 = now_ns();
+    for (int r = 0; r < reads; r++) {
+        int64_t first = history_latest(&hist, HISTORY_TIER_MINUTE) - (HISTORY_MINUTES_LEN - 1) * 60;
+        history_read(&hist, HISTORY_TIER_MINUTE, first, HISTORY_MINUTES_LEN, agg_buf);
+    }
+    uint64_t t_read = now_ns() - t0;
+
+    // Lo vigente después de la última muestra se acredita recién con la próxima
+    size_t d_sec = verify_seconds();
+    size_t d_min = verify_agg_tier(HISTORY_TIER_MINUTE, last + 1);
+    size_t d_hour = verify_agg_tier(HISTORY_TIER_HOUR, last + 1);
+
+    printf("[%s] days=%d samples=%llu\n", name, days, (unsigned long long)pushes);
+    printf("push: %.1f ns/sample\n", (double)t_push / (double)pushes);
+    printf("read: %.1f us per full minute tier (%d records)\n", t_read / 1000.0 / reads, HISTORY_MINUTES_LEN);
+    printf("verify: seconds %zu, minutes %zu, hours %zu buckets differ\n", d_sec, d_min, d_hour);
+    return d_sec + d_min + d_hour;
+}
+
+int main(int argc, char **argv) {
+    int days = 31;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) days = atoi(argv[++i]);
+    }
+    if (days < 1) {
+        fprintf(stderr, "uso: %s [--days N>=1]\n", argv[0]);
+        return 2;
+    }
+
+    printf("history_bytes=%zu\n", sizeof(history_t));
+    for (int tier = 0; tier < HISTORY_TIER_COUNT; tier++) {
+        printf("wire tier %d: %zu bytes (%zu x %zu B + %zu B header)\n", tier,
+               sizeof(history_wire_header_t) + history_capacity(tier) * history_record_size(tier),
+               history_capacity(tier), history_record_size(tier), sizeof(history_wire_header_t));
+    }
+    size_t diffs = run_case("1hz", days);
+    uneven = true;
+    diffs += run_case("uneven", days);
+    return diffs ? 1 : 0;
+}
@@ -0,0 +1,574 @@
+// Generador de carga HTTP para la API web: varios dashboards y scripts a la vez.
+//
+// Contra el ESP32 (--host <ip>) o contra host/tools/web_standin, que corre el
+// mismo web_server.c sobre el httpd de host/shim. Hilos cliente de tres tipos,
+// cada uno en lazo cerrado (pide, espera la respuesta completa, --think ms,
+// repite) durante --duration segundos:
+//   - lectores: GET /api/status (el polling de un dashboard o un script),
+//   - escritores: POST /api/settings alternando el "hold" vigente y el
+//     siguiente (cada request toma config_mutex y publica una versión nueva;
+//     sin cambios el servidor no publicaría); al terminar se repone el valor,
+//   - dashboards WS: abren /ws y solo reciben el push de estado.
+// Con --keepalive 1 cada cliente reusa su conexión; con 0 abre una por
+// request (la latencia incluye el connect). Una conexión cerrada por el
+// servidor (reset o EOF antes de la respuesta) cuenta como error y el cliente
+// reconecta tras 10 ms: es lo que ve un cliente de más cuando el httpd ya
+// tiene max_open_sockets sesiones y no purga por LRU.
+//
+// Informa por tipo requests/s y latencia p50/p99/max exacta (todas las
+// muestras), errores por causa, frames WS recibidos y el mayor hueco entre
+// dos pushes, y de /api/metrics?format=json antes y después la espera y el
+// tiempo tomado de config_mutex (tomas en la ventana; p99/max son desde el
+// arranque del servidor: para una ventana limpia usar un web_standin nuevo).
+//
+// Uso: bench_http [--host H] [--port N] [--readers N] [--writers N] [--ws N]
+//                 [--keepalive 0|1] [--duration S] [--think MS]
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define IO_TIMEOUT_S    5
+#define RETRY_US        10000
+#define MAX_CLIENTS     64
+
+typedef enum { CLIENT_READER = 0, CLIENT_WRITER, CLIENT_WS, CLIENT_KIND_COUNT } client_kind_t;
+
+static const char *const kind_names[CLIENT_KIND_COUNT] = { "GET /api/status", "POST /api/settings", "WS /ws" };
+
+// Errores por causa
+typedef enum {
+    ERR_CONNECT = 0,            // connect() rechazado o vencido
+    ERR_RESET,                  // Conexión cerrada por el servidor antes de la respuesta
+    ERR_TIMEOUT,                // Sin respuesta en IO_TIMEOUT_S
+    ERR_HTTP,                   // Status >= 400 o respuesta mal formada
+    ERR_COUNT
+} err_kind_t;
+
+static const char *const err_names[ERR_COUNT] = { "connect", "reset", "timeout", "http" };
+
+typedef struct {
+    client_kind_t kind;
+    pthread_t thread;
+    int fd;
+    // Resultados (solo el hilo del cliente)
+    uint32_t *lat_us;           // Una muestra por respuesta completa
+    size_t lat_count, lat_cap;
+    uint32_t errors[ERR_COUNT];
+    uint32_t connects;
+    uint64_t bytes;
+    uint32_t ws_frames;
+    int64_t ws_max_gap_us;
+} client_t;
+
+static struct sockaddr_storage server_addr;
+static socklen_t server_addr_len;
+static char host_name[128] = "127.0.0.1";
+static int port = 8080;
+static bool keepalive = true;
+static int think_ms = 0;
+static int hold_value = 30;
+static atomic_bool running;
+
+static int64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void record(client_t *c, uint32_t us) {
+    if (c->lat_count == c->lat_cap) {
+        c->lat_cap = c->lat_cap ? c->lat_cap * 2 : 4096;
+        c->lat_us = realloc(c->lat_us, c->lat_cap * sizeof(uint32_t));
+        if (c->lat_us == NULL) exit(1);
+    }
+    c->lat_us[c->lat_count++] = us;
+}
+
+static int connect_server(void) {
+    int fd = socket(server_addr.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    struct timeval tv = { .tv_sec = IO_TIMEOUT_S };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (struct sockaddr *)&server_addr, server_addr_len) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// --- Lectura de respuestas (Content-Length o chunked) ---
+
+typedef struct {
+    int fd;
+    char buf[8192];
+    size_t len, pos;
+    err_kind_t err;
+    uint64_t bytes;
+} reader_t;
+
+static bool fill(reader_t *r) {
+    if (r->pos > 0) {
+        memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+        r->len -= r->pos;
+        r->pos = 0;
+    }
+    if (r->len == sizeof(r->buf)) {
+        r->err = ERR_HTTP;
+        return false;
+    }
+    ssize_t n;
+    do {
+        n = recv(r->fd, r->buf + r->len, sizeof(r->buf) - r->len, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        r->err = (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? ERR_TIMEOUT : ERR_RESET;
+        return false;
+    }
+    r->len += (size_t)n;
+    r->bytes += (uint64_t)n;
+    return true;
+}
+
+// Línea terminada en \r\n (sin ella), NULL si se cortó la conexión
+static char *read_line(reader_t *r) {
+    while (1) {
+        char *eol = memmem(r->buf + r->pos, r->len - r->pos, "\r\n", 2);
+        if (eol != NULL) {
+            *eol = '\0';
+            char *line = r->buf + r->pos;
+            r->pos = (size_t)(eol + 2 - r->buf);
+            return line;
+        }
+        if (!fill(r)) return NULL;
+    }
+}
+
+static bool skip_bytes(reader_t *r, size_t n) {
+    while (n > 0) {
+        if (r->pos == r->len && !fill(r)) return false;
+        size_t take = r->len - r->pos < n ? r->len - r->pos : n;
+        r->pos += take;
+        n -= take;
+    }
+    return true;
+}
+
+// Respuesta completa: devuelve el status HTTP o -1 (r->err dice por qué)
+static int read_response(reader_t *r) {
+    char *line = read_line(r);
+    int status;
+    if (line == NULL) return -1;
+    if (sscanf(line, "HTTP/1.%*d %d", &status) != 1) {
+        r->err = ERR_HTTP;
+        return -1;
+    }
+    long content_len = -1;
+    bool chunked = false;
+    while ((line = read_line(r)) != NULL && *line != '\0') {
+        if (strncasecmp(line, "Content-Length:", 15) == 0) content_len = strtol(line + 15, NULL, 10);
+        else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line, "chunked") != NULL) chunked = true;
+    }
+    if (line == NULL) return -1;
+    if (status == 101 || status == 304) return status;
+    if (chunked) {
+        while (1) {
+            if ((line = read_line(r)) == NULL) return -1;
+            size_t n = strtoul(line, NULL, 16);
+            if (!skip_bytes(r, n)) return -1;
+            if (read_line(r) == NULL) return -1;
+            if (n == 0) break;
+        }
+    } else if (content_len > 0 && !skip_bytes(r, (size_t)content_len)) {
+        return -1;
+    }
+    return status;
+}
+
+// --- Clientes ---
+
+static void backoff(void) {
+    struct timespec ts = { 0, RETRY_US * 1000L };
+    nanosleep(&ts, NULL);
+}
+
+static void think(void) {
+    if (think_ms <= 0) return;
+    struct timespec ts = { think_ms / 1000, (long)(think_ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void http_client(client_t *c) {
+    char req[2][512];
+    int req_len[2];
+    const char *conn = keepalive ? "" : "Connection: close\r\n";
+    for (int i = 0; i < 2; i++) {
+        char body[64];
+        int body_len = snprintf(body, sizeof(body), "{\"hold\":%d}", hold_value + (hold_value < 3600 ? i : -i));
+        req_len[i] = (c->kind == CLIENT_READER)
+            ? snprintf(req[i], sizeof(req[i]), "GET /api/status HTTP/1.1\r\nHost: %s\r\n%s\r\n", host_name, conn)
+            : snprintf(req[i], sizeof(req[i]), "POST /api/settings HTTP/1.1\r\nHost: %s\r\n%sContent-Type: application/json\r\n"
+                       "Content-Length: %d\r\n\r\n%s", host_name, conn, body_len, body);
+    }
+    unsigned seq = 0;
+
+    reader_t *r = calloc(1, sizeof(*r));
+    if (r == NULL) return;
+    int fd = -1;
+    while (atomic_load(&running)) {
+        int64_t t0 = now_us();
+        if (fd < 0) {
+            fd = connect_server();
+            if (fd < 0) {
+                c->errors[ERR_CONNECT]++;
+                backoff();
+                continue;
+            }
+            c->connects++;
+            r->fd = fd;
+            r->len = r->pos = 0;
+        }
+        int status = -1;
+        int k = seq++ & 1;
+        if (send_all(fd, req[k], (size_t)req_len[k])) status = read_response(r);
+        else r->err = ERR_RESET;
+        int64_t t1 = now_us();
+
+        if (status >= 200 && status < 400) {
+            record(c, (uint32_t)(t1 - t0));
+        } else {
+            c->errors[status < 0 ? r->err : ERR_HTTP]++;
+            close(fd);
+            fd = -1;
+            if (status < 0) backoff();
+        }
+        if (!keepalive && fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        think();
+    }
+    if (fd >= 0) close(fd);
+    c->bytes = r->bytes;
+    free(r);
+}
+
+// Dashboard: handshake y después solo frames del servidor (sin máscara)
+static void ws_client(client_t *c) {
+    reader_t *r = calloc(1, sizeof(*r));
+    if (r == NULL) return;
+    char req[256];
+    int req_len = snprintf(req, sizeof(req),
+                           "GET /ws HTTP/1.1\r\nHost: %s\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n",
+                           host_name);
+    while (atomic_load(&running)) {
+        int fd = connect_server();
+        if (fd < 0) {
+            c->errors[ERR_CONNECT]++;
+            backoff();
+            continue;
+        }
+        c->connects++;
+        r->fd = fd;
+        r->len = r->pos = 0;
+        int64_t t0 = now_us();
+        int status = send_all(fd, req, (size_t)req_len) ? read_response(r) : -1;
+        if (status != 101) {
+            c->errors[status < 0 ? r->err : ERR_HTTP]++;
+            close(fd);
+            backoff();
+            continue;
+        }
+        record(c, (uint32_t)(now_us() - t0));    // Latencia del handshake
+
+        int64_t last = 0;
+        while (atomic_load(&running)) {
+            while (r->len - r->pos < 2) {
+                if (!fill(r)) goto lost;
+            }
+            uint8_t *h = (uint8_t *)r->buf + r->pos;
+            uint64_t len = h[1] & 0x7F;
+            size_t head = 2;
+            if (len == 126) head = 4;
+            else if (len == 127) head = 10;
+            while (r->len - r->pos < head) {
+                if (!fill(r)) goto lost;
+            }
+            h = (uint8_t *)r->buf + r->pos;
+            if (len == 126) len = (uint64_t)h[2] << 8 | h[3];
+            else if (len == 127) {
+                len = 0;
+                for (int i = 0; i < 8; i++) len = len << 8 | h[2 + i];
+            }
+            r->pos += head;
+            if (!skip_bytes(r, (size_t)len)) goto lost;
+            int64_t t = now_us();
+            if ((h[0] & 0x0F) == 0x8) goto lost;     // Close del servidor
+            c->ws_frames++;
+            if (last != 0 && t - last > c->ws_max_gap_us) c->ws_max_gap_us = t - last;
+            last = t;
+        }
+        close(fd);
+        break;
+lost:
+        // Un timeout de recepción no es error: sin cambios el push puede callar
+        if (r->err == ERR_TIMEOUT && atomic_load(&running)) {
+            r->err = ERR_COUNT;
+            close(fd);
+            continue;
+        }
+        if (atomic_load(&running)) c->errors[ERR_RESET]++;
+        close(fd);
+        backoff();
+    }
+    c->bytes = r->bytes;
+    free(r);
+}
+
+static void *client_main(void *arg) {
+    client_t *c = arg;
+    if (c->kind == CLIENT_WS) ws_client(c);
+    else http_client(c);
+    return NULL;
+}
+
+// --- /api/metrics del servidor ---
+
+typedef struct {
+    bool ok;
+    unsigned n, p50, p99, max;
+} lock_hist_t;
+
+// Un request suelto (POST con 'post' si no es NULL): devuelve el cuerpo
+// (malloc, des-chunkeado) o NULL
+static char *fetch(const char *path, const char *post) {
+    int fd = connect_server();
+    if (fd < 0) return NULL;
+    char req[512];
+    int n = (post == NULL)
+        ? snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", path, host_name)
+        : snprintf(req, sizeof(req), "POST %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n"
+                   "Content-Type: application/json\r\nContent-Length: %zu\r\n\r\n%s", path, host_name, strlen(post), post);
+    if (!send_all(fd, req, (size_t)n)) {
+        close(fd);
+        return NULL;
+    }
+    size_t cap = 65536, len = 0;
+    char *raw = malloc(cap);
+    ssize_t got;
+    while (raw != NULL && (got = recv(fd, raw + len, cap - len - 1, 0)) > 0) {
+        len += (size_t)got;
+        if (len + 1 == cap) raw = realloc(raw, cap *= 2);
+        // El httpd no cierra tras la respuesta: terminar al ver el último chunk o el largo completo
+        raw[len] = '\0';
+        char *body = strstr(raw, "\r\n\r\n");
+        if (body == NULL) continue;
+        char *cl = strcasestr(raw, "Content-Length:");
+        if (cl != NULL && cl < body) {
+            if (len >= (size_t)(body + 4 - raw) + strtoul(cl + 15, NULL, 10)) break;
+        } else if (strstr(body, "\r\n0\r\n\r\n") != NULL) {
+            break;
+        }
+    }
+    close(fd);
+    if (raw == NULL) return NULL;
+    raw[len] = '\0';
+    char *body = strstr(raw, "\r\n\r\n");
+    if (body == NULL) {
+        free(raw);
+        return NULL;
+    }
+    body += 4;
+    char *out = malloc(strlen(body) + 1);
+    size_t o = 0;
+    if (strcasestr(raw, "Transfer-Encoding: chunked") != NULL) {
+        for (char *p = body; ; ) {
+            size_t sz = strtoul(p, &p, 16);
+            p = strstr(p, "\r\n");
+            if (sz == 0 || p == NULL) break;
+            memcpy(out + o, p + 2, sz);
+            o += sz;
+            p += 2 + sz + 2;
+        }
+    } else {
+        o = strlen(body);
+        memcpy(out, body, o);
+    }
+    out[o] = '\0';
+    free(raw);
+    return out;
+}
+
+// "<group>":{..."config":{"n":..,"avg":..,"p50":..,"p99":..,"max":..}
+static lock_hist_t find_lock(const char *json, const char *group) {
+    lock_hist_t h = {0};
+    char key[48];
+    snprintf(key, sizeof(key), "\"%s\":{", group);
+    const char *g = json ? strstr(json, key) : NULL;
+    const char *c = g ? strstr(g, "\"config\":{") : NULL;
+    unsigned avg;
+    h.ok = c != NULL && sscanf(c, "\"config\":{\"n\":%u,\"avg\":%u,\"p50\":%u,\"p99\":%u,\"max\":%u",
+                                &h.n, &avg, &h.p50, &h.p99, &h.max) == 5;
+    return h;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t pct(const uint32_t *v, size_t n, int p) {
+    if (n == 0) return 0;
+    size_t i = (n * (size_t)p + 99) / 100;
+    return v[i ? i - 1 : 0];
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "uso: %s [--host H] [--port N] [--readers N] [--writers N] [--ws N]\n"
+                    "          [--keepalive 0|1] [--duration S] [--think MS]\n", argv0);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    int counts[CLIENT_KIND_COUNT] = { 4, 1, 1 };
+    int duration_s = 10;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) usage(argv[0]);
+        const char *v = argv[++i];
+        if (strcmp(a, "--host") == 0) snprintf(host_name, sizeof(host_name), "%s", v);
+        else if (strcmp(a, "--port") == 0) port = atoi(v);
+        else if (strcmp(a, "--readers") == 0) counts[CLIENT_READER] = atoi(v);
+        else if (strcmp(a, "--writers") == 0) counts[CLIENT_WRITER] = atoi(v);
+        else if (strcmp(a, "--ws") == 0) counts[CLIENT_WS] = atoi(v);
+        else if (strcmp(a, "--keepalive") == 0) keepalive = atoi(v) != 0;
+        else if (strcmp(a, "--duration") == 0) duration_s = atoi(v);
+        else if (strcmp(a, "--think") == 0) think_ms = atoi(v);
+        else usage(argv[0]);
+    }
+    int total = counts[0] + counts[1] + counts[2];
+    if (total <= 0 || total > MAX_CLIENTS || duration_s <= 0) usage(argv[0]);
+
+    struct addrinfo hints = { .ai_socktype = SOCK_STREAM }, *ai;
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+    if (getaddrinfo(host_name, port_str, &hints, &ai) != 0) {
+        fprintf(stderr, "%s: no resuelve\n", host_name);
+        return 1;
+    }
+    memcpy(&server_addr, ai->ai_addr, ai->ai_addrlen);
+    server_addr_len = ai->ai_addrlen;
+    freeaddrinfo(ai);
+
+    // Estado inicial: el "hold" vigente (los escritores lo alternan con el siguiente)
+    char *status = fetch("/api/status", NULL);
+    if (status == NULL) {
+        fprintf(stderr, "%s:%d: sin respuesta en /api/status\n", host_name, port);
+        return 1;
+    }
+    const char *hold = strstr(status, "\"hold\":");
+    if (hold != NULL) hold_value = atoi(hold + 7);
+    free(status);
+    char *metrics = fetch("/api/metrics?format=json", NULL);
+    lock_hist_t wait0 = find_lock(metrics, "lock_wait_us");
+    lock_hist_t hold0 = find_lock(metrics, "lock_hold_us");
+    free(metrics);
+
+    printf("%s:%d  readers %d, writers %d, ws %d, keep-alive %s, think %d ms, %d s\n", host_name, port,
+           counts[CLIENT_READER], counts[CLIENT_WRITER], counts[CLIENT_WS], keepalive ? "on" : "off",
+           think_ms, duration_s);
+
+    static client_t clients[MAX_CLIENTS];
+    int n = 0;
+    atomic_store(&running, true);
+    for (int k = 0; k < CLIENT_KIND_COUNT; k++) {
+        for (int i = 0; i < counts[k]; i++, n++) {
+            clients[n].kind = (client_kind_t)k;
+            pthread_create(&clients[n].thread, NULL, client_main, &clients[n]);
+        }
+    }
+    int64_t t0 = now_us();
+    sleep((unsigned)duration_s);
+    atomic_store(&running, false);
+    for (int i = 0; i < n; i++) pthread_join(clients[i].thread, NULL);
+    double wall_s = (double)(now_us() - t0) / 1e6;
+
+    printf("%-19s %7s %8s %8s %8s %8s %9s  %s\n", "", "ok", "req/s", "p50 us", "p99 us", "max us", "connects", "errors");
+    for (int k = 0; k < CLIENT_KIND_COUNT; k++) {
+        if (counts[k] == 0) continue;
+        size_t total_lat = 0;
+        uint32_t errs[ERR_COUNT] = {0}, connects = 0, frames = 0;
+        int64_t max_gap = 0;
+        for (int i = 0; i < n; i++) {
+            if (clients[i].kind != (client_kind_t)k) continue;
+            total_lat += clients[i].lat_count;
+            connects += clients[i].connects;
+            frames += clients[i].ws_frames;
+            if (clients[i].ws_max_gap_us > max_gap) max_gap = clients[i].ws_max_gap_us;
+            for (int e = 0; e < ERR_COUNT; e++) errs[e] += clients[i].errors[e];
+        }
+        uint32_t *all = malloc((total_lat ? total_lat : 1) * sizeof(uint32_t));
+        size_t off = 0;
+        for (int i = 0; i < n; i++) {
+            if (clients[i].kind != (client_kind_t)k || clients[i].lat_count == 0) continue;
+            memcpy(all + off, clients[i].lat_us, clients[i].lat_count * sizeof(uint32_t));
+            off += clients[i].lat_count;
+        }
+        qsort(all, total_lat, sizeof(uint32_t), cmp_u32);
+        printf("%-19s %7zu %8.1f %8u %8u %8u %9u ", kind_names[k], total_lat, total_lat / wall_s,
+               pct(all, total_lat, 50), pct(all, total_lat, 99), total_lat ? all[total_lat - 1] : 0, connects);
+        for (int e = 0; e < ERR_COUNT; e++) {
+            if (errs[e]) printf(" %s %u", err_names[e], errs[e]);
+        }
+        printf("\n");
+        if (k == CLIENT_WS) {
+            printf("%-19s frames %u (%.1f/s per dashboard), max gap %lld ms\n", "",
+                   frames, frames / wall_s / counts[k], (long long)(max_gap / 1000));
+        }
+        free(all);
+    }
+
+    metrics = fetch("/api/metrics?format=json", NULL);
+    lock_hist_t wait1 = find_lock(metrics, "lock_wait_us");
+    lock_hist_t hold1 = find_lock(metrics, "lock_hold_us");
+    free(metrics);
+    if (wait1.ok && hold1.ok) {
+        printf("config_mutex: %u takes in window; wait p99 %u max %u us; held p99 %u max %u us (since boot)\n",
+               hold1.n - (hold0.ok ? hold0.n : 0), wait1.p99, wait1.max, hold1.p99, hold1.max);
+        (void)wait0;
+    } else {
+        printf("config_mutex: /api/metrics sin lock_wait_us/lock_hold_us\n");
+    }
+    char body[32];
+    snprintf(body, sizeof(body), "{\"hold\":%d}", hold_value);
+    free(fetch("/api/settings", body));
+    for (int i = 0; i < n; i++) free(clients[i].lat_us);
+    return 0;
+}
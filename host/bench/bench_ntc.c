@@ -0,0 +1,109 @@
+// Benchmark de host: conversión NTC por fórmula (log() doble precisión) vs tabla.
+//
+// Informa el costo por conversión de cada método y el error máximo de la
+// tabla contra la fórmula original, en todo el rango y en el rango útil.
+// Nota: en el ESP32 la diferencia es mucho mayor que en x86, porque allí la
+// aritmética double se emula por software; aquí se mide la proporción.
+//
+// Uso: bench_ntc [--iterations N]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ntc_convert.h"
+#include "ntc_params.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define USEFUL_MIN_C  (-10.0f)  // Rango útil para una cuna
+#define USEFUL_MAX_C  (60.0f)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Ecuación Beta en double con código ADC fraccionario (referencia para interpolación)
+static double celsius_exact(double raw) {
+    double v = raw * NTC_VREF / NTC_ADC_MAX;
+    double r = v * R_SERIES / (NTC_VREF - v);
+    double s = log(r / R_NOMINAL) / B_COEFFICIENT + 1.0 / (T_NOMINAL + 273.15);
+    return 1.0 / s - 273.15 - NTC_CAL_OFFSET;
+}
+
+typedef float (*convert_fn)(int);
+
+static void run(const char *name, convert_fn fn, int iterations, double *ns_out, double *cyc_out) {
+    volatile float sink = 0;
+    uint64_t t0 = now_ns();
+    uint64_t c0 = cycles();
+    for (int it = 0; it < iterations; it++) {
+        for (int raw = 1; raw < NTC_ADC_MAX; raw++) {
+            sink += fn(raw);
+        }
+    }
+    uint64_t c1 = cycles();
+    uint64_t t1 = now_ns();
+    (void)sink;
+
+    double n = (double)iterations * (NTC_ADC_MAX - 1);
+    *ns_out = (t1 - t0) / n;
+    *cyc_out = (c1 - c0) / n;
+    printf("%-8s %8.2f ns/conv  %8.1f cycles/conv\n", name, *ns_out, *cyc_out);
+}
+
+int main(int argc, char **argv) {
+    int iterations = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+    }
+
+    // 1. Exactitud: tabla vs fórmula original en cada código
+    float max_err = 0, max_err_useful = 0;
+    int worst = 0;
+    for (int raw = 1; raw < NTC_ADC_MAX; raw++) {
+        float ref = ntc_celsius_formula(raw);
+        float err = fabsf(ntc_celsius_lut(raw) - ref);
+        if (err > max_err) { max_err = err; worst = raw; }
+        if (ref >= USEFUL_MIN_C && ref <= USEFUL_MAX_C && err > max_err_useful) max_err_useful = err;
+    }
+
+    // 2. Interpolación: puntos a mitad de código contra la ecuación exacta
+    const unsigned frac_bits = 4;
+    double max_interp = 0;
+    for (int raw = 1; raw < NTC_ADC_MAX - 1; raw++) {
+        double ref = celsius_exact(raw + 0.5);
+        if (ref < USEFUL_MIN_C || ref > USEFUL_MAX_C) continue;
+        uint32_t q = ((uint32_t)raw << frac_bits) | (1u << (frac_bits - 1));
+        double err = fabs(ntc_celsius_lut_q(q, frac_bits) - ref);
+        if (err > max_interp) max_interp = err;
+    }
+
+    printf("accuracy: max_err=%.4f C (code %d), useful[%.0f..%.0f C] max_err=%.4f C, interp(half-code) max_err=%.4f C\n",
+           max_err, worst, USEFUL_MIN_C, USEFUL_MAX_C, max_err_useful, max_interp);
+
+    // 3. Costo por conversión
+    double ns_f, cyc_f, ns_l, cyc_l;
+    run("formula", ntc_celsius_formula, iterations, &ns_f, &cyc_f);
+    run("lut", ntc_celsius_lut, iterations, &ns_l, &cyc_l);
+#ifdef HAVE_TSC
+    printf("saved: %.1f cycles/conv (%.1fx)\n", cyc_f - cyc_l, cyc_f / cyc_l);
+#else
+    printf("saved: %.2f ns/conv (%.1fx)\n", ns_f - ns_l, ns_f / ns_l);
+#endif
+    return 0;
+}
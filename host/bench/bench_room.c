@@ -0,0 +1,202 @@
+// Benchmark de host: días de operación sobre la habitación simulada.
+//
+// Corre el mismo lazo que SensorTask/ControlTask con el simulador de
+// core/room_sim.c (el del mock de HAL) sobre un reloj virtual, sin esperas:
+// cada segundo simulado avanza la habitación, y la "SensorTask" se despierta
+// como con el driver NTC continuo (vence el período de sample_rate, cambia la
+// presencia o la lectura sale de la banda vigilada). Las muestras que envía
+// pasan por control_decide() con la hora virtual y el PWM vuelve al
+// ventilador simulado, con la pendiente de la configuración.
+//
+// Informa por modo:
+//   - energía del ventilador (Wh/día) y duty medio,
+//   - confort: % del tiempo ocupado dentro de la banda de confort y
+//     grados-hora fuera de ella por día,
+//   - arranques del motor, muestras y cambios de PWM por día,
+// y una vez la cobertura del PIR (tiempo ocupado con presencia detectada)
+// y la velocidad de la simulación.
+//
+// Uso: bench_room [--days N] [--profile nursery|always|empty] [--outdoor C]
+//                 [--swing C] [--hold S] [--seed N] [--trace MODO]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "control_logic.h"
+#include "schedule_index.h"
+#include "sample_rate.h"
+#include "room_sim.h"
+
+#define VARIANTS        6
+#define DAY_US          (86400LL * 1000000)
+
+typedef struct {
+    const char *name;
+    system_config_t cfg;
+} variant_t;
+
+typedef struct {
+    room_sim_score_t score;
+    uint32_t samples;
+    uint32_t pwm_changes;
+    double detected_s;          // Ocupada y con presencia detectada
+    double false_s;             // Presencia detectada sin nadie (cola del hold)
+} result_t;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void run(const variant_t *v, const room_sim_params_t *rp, int days, uint32_t seed, FILE *trace, result_t *out) {
+    const system_config_t *cfg = &v->cfg;
+    room_sim_t room;
+    room_sim_init(&room, rp, seed, 0);      // Domingo 00:00
+    room_sim_set_slew(&room, cfg->fan_slew_up, cfg->fan_slew_down);
+
+    schedule_index_t *sched = malloc(sizeof(schedule_index_t));
+    schedule_index_compile(sched, cfg);
+    control_state_t st;
+    control_state_reset(&st);
+    sample_rate_t rate;
+    sample_rate_init(&rate, cfg, &cfg->zones[0]);
+
+    memset(out, 0, sizeof(*out));
+    const int64_t step_us = (int64_t)(rp->plant.step_s * 1e6f);
+    const int64_t hold_us = (int64_t)cfg->presence_hold_s * 1000000;
+    const int64_t end_us = days * DAY_US;
+    int64_t next_us = 0;
+    bool last_presence = false;
+    float lo = -INFINITY, hi = INFINITY;
+    uint32_t pwm = 0;
+
+    for (int64_t t = 0; t < end_us; t += step_us) {
+        room_sim_advance(&room, t);
+        float temp = room_sim_measure(&room);
+        bool presence = room.last_motion_us >= 0 && t - room.last_motion_us < hold_us;
+        if (presence && room.occupied) out->detected_s += rp->plant.step_s;
+        if (presence && !room.occupied) out->false_s += rp->plant.step_s;
+
+        if (trace != NULL && t % 60000000 == 0) {
+            fprintf(trace, "%.4f,%.3f,%.3f,%.1f,%d,%d\n", (double)t / 3.6e9, room.plant.temp_c,
+                    room.plant.p.ambient_c, room.duty, room.occupied, presence);
+        }
+
+        // Despertar de SensorTask: período vencido, flanco o fin del hold, aviso del driver
+        if (t < next_us && presence == last_presence && temp >= lo && temp < hi) continue;
+        last_presence = presence;
+
+        sensor_data_t s = {
+            .temperature = temp,
+            .presence_detected = presence,
+            .timestamp = t,
+            .temp_quality = TEMP_QUALITY_GOOD,
+        };
+        if (sample_rate_check(&rate, &s, t, &s.reason)) {
+            out->samples++;
+            uint32_t tod = room_sim_time_of_day(&room);
+            struct tm tm_now = {
+                .tm_year = 126, .tm_mday = 1,
+                .tm_wday = (int)room_sim_weekday(&room),
+                .tm_hour = (int)(tod / 3600), .tm_min = (int)(tod / 60 % 60), .tm_sec = (int)(tod % 60),
+            };
+            control_decision_t d = control_decide(&cfg->zones[0], sched, &st, &s, &tm_now, true);
+            if (d.status == CONTROL_OK) {
+                if (d.pwm != pwm) out->pwm_changes++;
+                pwm = d.pwm;
+                room_sim_set_duty(&room, pwm);
+            }
+        }
+        sample_rate_watch_band(&rate, &lo, &hi);
+        next_us = sample_rate_deadline_us(&rate, t);
+    }
+    room_sim_advance(&room, end_us);
+    out->score = room.score;
+    free(sched);
+}
+
+int main(int argc, char **argv) {
+    int days = 7;
+    uint32_t seed = 1;
+    int hold_s = -1;
+    const char *trace_name = NULL;
+    room_sim_params_t rp = room_sim_default_params;
+    bool bad = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) days = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--outdoor") == 0 && i + 1 < argc) rp.outdoor_mean_c = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--swing") == 0 && i + 1 < argc) rp.outdoor_swing_c = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--hold") == 0 && i + 1 < argc) hold_s = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_name = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            rp.occupancy = ROOM_OCC_COUNT;
+            for (int o = 0; o < ROOM_OCC_COUNT; o++) {
+                if (strcmp(name, room_sim_occupancy_name((room_occupancy_t)o)) == 0) rp.occupancy = (room_occupancy_t)o;
+            }
+            bad |= rp.occupancy == ROOM_OCC_COUNT;
+        } else bad = true;
+    }
+    if (bad || days < 1 || days > 365) {
+        fprintf(stderr, "uso: %s [--days 1..365] [--profile nursery|always|empty] [--outdoor C] [--swing C]"
+                        " [--hold S] [--seed N] [--trace MODO]\n", argv[0]);
+        return 2;
+    }
+
+    variant_t v[VARIANTS];
+    for (int i = 0; i < VARIANTS; i++) {
+        v[i].cfg = default_system_config;
+        if (hold_s >= 0) v[i].cfg.presence_hold_s = (uint32_t)hold_s;
+    }
+    v[0].name = "off";        v[0].cfg.zones[0].operation_mode = MODE_MANUAL; v[0].cfg.zones[0].manual_duty = 0;
+    v[1].name = "manual-50";  v[1].cfg.zones[0].operation_mode = MODE_MANUAL;
+    v[2].name = "auto";       v[2].cfg.zones[0].operation_mode = MODE_AUTO;
+    v[3].name = "schedule";   v[3].cfg.zones[0].operation_mode = MODE_SCHEDULE;
+    v[4].name = "hysteresis"; v[4].cfg.zones[0].operation_mode = MODE_HYSTERESIS;
+    v[5].name = "pid";        v[5].cfg.zones[0].operation_mode = MODE_PID;
+
+    result_t r;
+    if (trace_name != NULL) {
+        for (int i = 0; i < VARIANTS; i++) {
+            if (strcmp(v[i].name, trace_name) == 0) {
+                printf("# t_h,temp_c,load_c,duty,occupied,presence\n");
+                run(&v[i], &rp, days, seed, stdout, &r);
+                return 0;
+            }
+        }
+        fprintf(stderr, "modo desconocido: %s\n", trace_name);
+        return 2;
+    }
+
+    printf("room: %s, outdoor %.1f+-%.1f °C, +%.1f internal, +%.1f sun, +%.1f occupied; fan %.1f W, start %u%%; "
+           "comfort %.1f-%.1f °C; %d days\n",
+           room_sim_occupancy_name(rp.occupancy), rp.outdoor_mean_c, rp.outdoor_swing_c, rp.internal_load_c,
+           rp.solar_load_c, rp.occupant_load_c, rp.fan_max_w, rp.fan_start_pct, rp.comfort_lo_c, rp.comfort_hi_c, days);
+    printf("%-11s %8s %9s %9s %10s %9s %11s %11s\n", "mode", "Wh/day", "comfort%", "°C·h/day",
+           "starts/day", "mean duty", "samples/day", "changes/day");
+
+    double wall = 0, simulated = 0;
+    for (int i = 0; i < VARIANTS; i++) {
+        double t0 = now_s();
+        run(&v[i], &rp, days, seed, NULL, &r);
+        wall += now_s() - t0;
+        simulated += r.score.sim_s;
+
+        const room_sim_score_t *sc = &r.score;
+        double comfort = sc->occupied_s > 0 ? 100.0 * sc->comfort_s / sc->occupied_s : NAN;
+        printf("%-11s %8.1f %9.1f %9.2f %10.1f %8.1f%% %11.0f %11.1f\n", v[i].name, sc->energy_wh / days, comfort,
+               sc->discomfort_ch / days, (double)sc->fan_starts / days, sc->duty_sum / sc->sim_s,
+               (double)r.samples / days, (double)r.pwm_changes / days);
+        if (i == VARIANTS - 1) {
+            printf("presence: occupied %.1f h/day, PIR hold %u s detects %.1f %% of it, %.2f h/day with nobody\n",
+                   sc->occupied_s / 3600.0 / days, v[i].cfg.presence_hold_s,
+                   sc->occupied_s > 0 ? 100.0 * r.detected_s / sc->occupied_s : 0.0, r.false_s / 3600.0 / days);
+        }
+    }
+    printf("simulated %.0f days in %.2f s (%.0fx real time)\n", simulated / 86400.0, wall, simulated / wall);
+    return 0;
+}
@@ -0,0 +1,291 @@
+// Benchmark de host: muestreo por eventos de SensorTask (core/sample_rate.c).
+//
+// Simula un día de la salida del filtro NTC (un valor nuevo cada 100 ms:
+// deriva diaria, una calefacción que cruza los umbrales de la regla por
+// defecto y una ventana abierta) más ráfagas de movimiento del PIR con hold,
+// y compara el muestreo fijo a 1 Hz anterior con el adaptativo:
+//   - muestras enviadas a control_task (cola, control, historial, log, push),
+//   - demora entre un cruce real de T_0%/T_100% o un flanco del PIR y la
+//     muestra que lo refleja,
+//   - error de PWM por usar la última temperatura enviada en vez de la real.
+// El bucle de SensorTask se reproduce igual que en tasks/task_sensor.c, con
+// y sin el aviso de banda del driver de temperatura. --late agrega a cada
+// despertar por tiempo un retraso fijo (tick + salida de light sleep) para
+// ver el jitter de las muestras periódicas: con la grilla fija no se acumula.
+//
+// Uso: bench_sample_rate [--min MS] [--max MS] [--late US]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sample_rate.h"
+#include "control_logic.h"
+
+#define DAY_US          86400000000LL
+#define FILTER_US       100000      // Publicación del filtro NTC
+#define HOLD_US         30000000LL  // Retención PIR por defecto
+#define MAX_EDGES       4096
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Salida del filtro en t (constante dentro de cada período de 100 ms)
+static float truth_temp(int64_t t_us) {
+    int64_t slot = t_us / FILTER_US;
+    float t = (float)(slot * FILTER_US) / 1e6f;
+    float temp = 22.0f + 0.5f * sinf(t * 6.2831853f / 86400.0f);
+
+    // Calefacción 08:00-10:00 (+5 °C lineal) y enfriamiento con tau = 1 h
+    if (t >= 8 * 3600 && t < 10 * 3600) temp += 5.0f * (t - 8 * 3600) / 7200.0f;
+    else if (t >= 10 * 3600) temp += 5.0f * expf(-(t - 10 * 3600) / 3600.0f);
+
+    // Ventana abierta a las 09:00 (~25 °C): -3 °C en 30 s, recupera con tau = 30 min
+    if (t >= 9 * 3600 && t < 9 * 3600 + 30) temp -= 3.0f * (t - 9 * 3600) / 30.0f;
+    else if (t >= 9 * 3600 + 30) temp -= 3.0f * expf(-(t - 9 * 3600 - 30) / 1800.0f);
+
+    temp += (float)((int)(hash32((uint32_t)slot) % 21) - 10) / 1000.0f;   // Ruido residual +-0.01 °C
+    return temp;
+}
+
+static int64_t edges[MAX_EDGES];
+static int edge_count;
+
+// Ráfagas de movimiento: una cada ~20 min durante el día, pulsos cada pocos segundos
+static void make_edges(void) {
+    uint32_t h = 12345;
+    for (int64_t burst = 7 * 3600 * 1000000LL; burst < 23 * 3600 * 1000000LL && edge_count < MAX_EDGES - 16;) {
+        h = hash32(h);
+        int pulses = 1 + (int)(h % 8);
+        int64_t t = burst;
+        for (int i = 0; i < pulses; i++) {
+            h = hash32(h);
+            t += 1000000LL + (int64_t)(h % 5000000);
+            edges[edge_count++] = t;
+        }
+        h = hash32(h);
+        burst = t + 600000000LL + (int64_t)(h % 1800) * 1000000LL;
+    }
+}
+
+static bool truth_presence(int64_t t_us, int *cursor) {
+    while (*cursor < edge_count && edges[*cursor] <= t_us) (*cursor)++;
+    return *cursor > 0 && t_us - edges[*cursor - 1] < HOLD_US;
+}
+
+typedef struct {
+    const char *name;
+    uint64_t samples;
+    uint64_t by_reason[SAMPLE_REASON_COUNT];
+    uint64_t wakes;
+    int crossings;
+    int64_t cross_delay_max, cross_delay_sum;
+    int pres_changes;
+    int64_t pres_delay_max, pres_delay_sum;
+    double pwm_err_sum;
+    uint32_t pwm_err_max;
+    uint64_t pwm_err_n;
+    int64_t jitter_max, jitter_sum;     // Periódicas: despertar - vencimiento atendido
+    uint32_t overruns;
+} result_t;
+
+static int64_t wake_late_us;       // --late
+
+static const float T_MIN = 23.0f, T_MAX = 26.0f;   // Regla por defecto (config_defaults.c)
+
+static int side_of(float t) {
+    return (t >= T_MAX) ? 2 : (t >= T_MIN) ? 1 : 0;
+}
+
+// Recorre el día en pasos de 100 ms comparando la verdad con lo último enviado
+static void account(result_t *r, int64_t t_us, float sent_temp, bool sent_pres,
+                    int *true_side, int64_t *cross_at, bool *true_pres, int64_t *pres_at, int *ecur) {
+    float temp = truth_temp(t_us);
+    bool pres = truth_presence(t_us, ecur);
+    int side = side_of(temp);
+
+    // Cruce real: se cuenta con la misma histéresis que el muestreador
+    if (side != *true_side && fabsf(temp - (side > *true_side ? (side == 2 ? T_MAX : T_MIN)
+                                                            : (side == 1 ? T_MAX : T_MIN))) >= SAMPLE_RATE_HYST_C) {
+        *true_side = side;
+        if (*cross_at < 0) *cross_at = t_us;
+    }
+    if (*cross_at >= 0 && side_of(sent_temp) == *true_side) {
+        int64_t d = t_us - *cross_at;
+        r->crossings++;
+        r->cross_delay_sum += d;
+        if (d > r->cross_delay_max) r->cross_delay_max = d;
+        *cross_at = -1;
+    }
+    if (pres != *true_pres) {
+        *true_pres = pres;
+        if (*pres_at < 0) *pres_at = t_us;
+    }
+    if (*pres_at >= 0 && sent_pres == *true_pres) {
+        int64_t d = t_us - *pres_at;
+        r->pres_changes++;
+        r->pres_delay_sum += d;
+        if (d > r->pres_delay_max) r->pres_delay_max = d;
+        *pres_at = -1;
+    }
+
+    uint32_t want = calculate_pwm_linear(temp, T_MIN, T_MAX);
+    uint32_t got = calculate_pwm_linear(sent_temp, T_MIN, T_MAX);
+    uint32_t err = want > got ? want - got : got - want;
+    r->pwm_err_sum += err;
+    r->pwm_err_n++;
+    if (err > r->pwm_err_max) r->pwm_err_max = err;
+}
+
+// Avanza la contabilidad de 100 ms en 100 ms hasta 'until' (exclusivo)
+typedef struct {
+    int64_t t;
+    float sent_temp;
+    bool sent_pres;
+    int true_side;
+    int64_t cross_at;
+    bool true_pres;
+    int64_t pres_at;
+    int ecur;
+} tracker_t;
+
+static void advance(result_t *r, tracker_t *k, int64_t until) {
+    while (k->t < until) {
+        account(r, k->t, k->sent_temp, k->sent_pres, &k->true_side, &k->cross_at, &k->true_pres, &k->pres_at, &k->ecur);
+        k->t += FILTER_US;
+    }
+}
+
+static void tracker_init(tracker_t *k) {
+    *k = (tracker_t){ .t = 0, .cross_at = -1, .pres_at = -1 };
+    k->sent_temp = truth_temp(0);
+    k->true_side = side_of(k->sent_temp);
+}
+
+// Política anterior: una muestra por segundo
+static void run_fixed(result_t *r) {
+    tracker_t k;
+    tracker_init(&k);
+    int ecur = 0;
+    for (int64_t t = 0; t < DAY_US; t += 1000000) {
+        advance(r, &k, t);
+        k.sent_temp = truth_temp(t);
+        k.sent_pres = truth_presence(t, &ecur);
+        r->samples++;
+        r->wakes++;
+        r->by_reason[SAMPLE_PERIODIC]++;
+    }
+    advance(r, &k, DAY_US);
+}
+
+// Política nueva: bucle de tasks/task_sensor.c con flancos del PIR como
+// notificación. 'watch' = el driver avisa al salir de la banda (ntc_continuous);
+// sin él se vigila cada sample_min_ms.
+static void run_adaptive(result_t *r, const system_config_t *cfg, bool watch) {
+    sample_rate_t rate;
+    sample_rate_init(&rate, cfg, &cfg->zones[0]);
+    tracker_t k;
+    tracker_init(&k);
+    int ecur = 0, next_edge = 0;
+    int64_t t = 0;
+
+    while (t < DAY_US) {
+        advance(r, &k, t);
+        sensor_data_t s = {
+            .temperature = truth_temp(t),
+            .temp_quality = TEMP_QUALITY_GOOD,
+            .presence_detected = truth_presence(t, &ecur),
+            .timestamp = t,
+        };
+        r->wakes++;
+        sample_reason_t why;
+        if (sample_rate_check(&rate, &s, t, &why)) {
+            r->samples++;
+            r->by_reason[why]++;
+            k.sent_temp = s.temperature;
+            k.sent_pres = s.presence_detected;
+            if (why == SAMPLE_PERIODIC) {
+                int64_t j = t - rate.last_due_us;
+                r->jitter_sum += j;
+                if (j > r->jitter_max) r->jitter_max = j;
+            }
+        }
+
+        int64_t next = watch ? sample_rate_deadline_us(&rate, t) : sample_rate_next_check_us(&rate, t);
+        if (watch) {
+            // Primera publicación del filtro fuera de la banda
+            float lo, hi;
+            sample_rate_watch_band(&rate, &lo, &hi);
+            for (int64_t p = (t / FILTER_US + 1) * FILTER_US; p < next; p += FILTER_US) {
+                float v = truth_temp(p);
+                if (v < lo || v >= hi) {
+                    next = p;
+                    break;
+                }
+            }
+        }
+        if (s.presence_detected && ecur > 0) {
+            int64_t hold_end = edges[ecur - 1] + HOLD_US + 1000;
+            if (hold_end > t && hold_end < next) next = hold_end;
+        }
+        // Resolución del tick de FreeRTOS (1 ms); los flancos llegan por ISR sin ese retraso
+        next = (next + 999) / 1000 * 1000 + wake_late_us;
+        while (next_edge < edge_count && edges[next_edge] <= t) next_edge++;
+        if (next_edge < edge_count && edges[next_edge] < next) next = edges[next_edge];
+        t = (next > t) ? next : t + 1000;
+    }
+    advance(r, &k, DAY_US);
+    r->overruns = rate.overruns;
+}
+
+static void print_result(const result_t *r) {
+    printf("%-9s samples=%6llu (periodic %llu, presence %llu, threshold %llu) wakes=%llu\n",
+           r->name, (unsigned long long)r->samples,
+           (unsigned long long)r->by_reason[SAMPLE_PERIODIC], (unsigned long long)r->by_reason[SAMPLE_PRESENCE],
+           (unsigned long long)r->by_reason[SAMPLE_THRESHOLD], (unsigned long long)r->wakes);
+    printf("          crossings=%d delay avg %.0f ms max %.0f ms | presence changes=%d delay avg %.0f ms max %.0f ms\n",
+           r->crossings, r->crossings ? r->cross_delay_sum / 1000.0 / r->crossings : 0.0, r->cross_delay_max / 1000.0,
+           r->pres_changes, r->pres_changes ? r->pres_delay_sum / 1000.0 / r->pres_changes : 0.0, r->pres_delay_max / 1000.0);
+    printf("          pwm error avg %.3f%% max %u%%\n", r->pwm_err_sum / (double)r->pwm_err_n, r->pwm_err_max);
+    uint64_t periodic = r->by_reason[SAMPLE_PERIODIC];
+    printf("          periodic jitter avg %.1f ms max %.1f ms, overruns %u\n",
+           periodic ? r->jitter_sum / 1000.0 / periodic : 0.0, r->jitter_max / 1000.0, r->overruns);
+}
+
+int main(int argc, char **argv) {
+    system_config_t cfg = default_system_config;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min") == 0 && i + 1 < argc) cfg.sample_min_ms = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) cfg.sample_max_ms = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--late") == 0 && i + 1 < argc) wake_late_us = atoll(argv[++i]);
+    }
+    if (cfg.sample_min_ms == 0 || cfg.sample_max_ms < cfg.sample_min_ms || wake_late_us < 0) {
+        fprintf(stderr, "uso: %s [--min MS>0] [--max MS>=min] [--late US>=0]\n", argv[0]);
+        return 2;
+    }
+    make_edges();
+
+    result_t fixed = { .name = "fixed1Hz" }, polled = { .name = "polled" }, adaptive = { .name = "watched" };
+    run_fixed(&fixed);
+    run_adaptive(&polled, &cfg, false);
+    run_adaptive(&adaptive, &cfg, true);
+
+    printf("bounds: %u..%u ms, %d PIR edges, thresholds %.1f/%.1f °C\n",
+           cfg.sample_min_ms, cfg.sample_max_ms, edge_count, T_MIN, T_MAX);
+    print_result(&fixed);
+    print_result(&polled);
+    print_result(&adaptive);
+    printf("samples: %.1f%% of fixed rate, wakes: %.1f%%\n",
+           100.0 * (double)adaptive.samples / (double)fixed.samples,
+           100.0 * (double)adaptive.wakes / (double)fixed.wakes);
+
+    // Con aviso del driver los eventos se ven en la misma publicación del
+    // filtro, y el PWM no puede quedar más lejos del real que con 1 Hz
+    bool worse = adaptive.cross_delay_max > FILTER_US || adaptive.pres_delay_max > FILTER_US ||
+                 adaptive.pwm_err_max > fixed.pwm_err_max;
+    return worse ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// Benchmark de host: horario semanal compilado vs recorrido lineal de reglas.
+//
+// Genera configuraciones aleatorias con N reglas (días, cruces de medianoche
+// y solapamientos), verifica minuto a minuto de la semana que el índice
+// compilado devuelve la misma regla que el recorrido lineal (gana el menor
+// índice) y mide el costo de compilar y de cada consulta.
+//
+// Uso: bench_schedule [--rules N] [--configs N]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "schedule_index.h"
+
+static schedule_index_t sched;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void random_config(system_config_t *cfg, int rules) {
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->zones[0].operation_mode = MODE_SCHEDULE;
+    cfg->schedule_count = (uint8_t)rules;
+    for (int i = 0; i < rules; i++) {
+        schedule_reg_t *r = &cfg->schedules[i];
+        r->active = (rand() % 8) != 0;
+        r->days = (rand() % 4 == 0) ? DAYS_ALL : (uint8_t)(rand() & DAYS_ALL);
+        r->start_hour = rand() % 24;
+        r->start_min = rand() % 60;
+        r->end_hour = rand() % 24;
+        r->end_min = (rand() % 10 == 0) ? r->start_min : rand() % 60;
+        r->temp_min_0_percent = 20.0f + i;
+        r->temp_max_100_percent = 25.0f + i;
+    }
+}
+
+static int linear_lookup(const system_config_t *cfg, const struct tm *now) {
+    for (int i = 0; i < cfg->schedule_count; i++) {
+        if (schedule_rule_matches(&cfg->schedules[i], now)) return i;
+    }
+    return -1;
+}
+
+static void minute_to_tm(int mow, struct tm *t) {
+    memset(t, 0, sizeof(*t));
+    t->tm_wday = mow / SCHEDULE_MINUTES_PER_DAY;
+    t->tm_hour = (mow / 60) % 24;
+    t->tm_min = mow % 60;
+}
+
+int main(int argc, char **argv) {
+    int rules = MAX_SCHEDULES;
+    int configs = 200;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rules = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--configs") == 0 && i + 1 < argc) configs = atoi(argv[++i]);
+    }
+    if (rules < 1 || rules > MAX_SCHEDULES) {
+        fprintf(stderr, "--rules debe estar entre 1 y %d\n", MAX_SCHEDULES);
+        return 2;
+    }
+    srand(1234);
+
+    uint64_t t_compile = 0, t_index = 0, t_linear = 0;
+    size_t mismatches = 0;
+    volatile int sink = 0;
+    struct tm t;
+    system_config_t cfg;
+
+    for (int c = 0; c < configs; c++) {
+        random_config(&cfg, rules);
+
+        uint64_t a = now_ns();
+        schedule_index_compile(&sched, &cfg);
+        t_compile += now_ns() - a;
+
+        // Equivalencia minuto a minuto
+        for (int mow = 0; mow < SCHEDULE_MINUTES_PER_WEEK; mow++) {
+            minute_to_tm(mow, &t);
+            const schedule_rule_t *r = schedule_index_lookup(&sched, &t);
+            int got = r ? r->source : -1;
+            int want = linear_lookup(&cfg, &t);
+            if (got != want) {
+                if (mismatches < 10) {
+                    fprintf(stderr, "DIFF config %d minuto %d: indice %d, lineal %d\n", c, mow, got, want);
+                }
+                mismatches++;
+            }
+        }
+
+        // Tiempos de consulta
+        a = now_ns();
+        for (int mow = 0; mow < SCHEDULE_MINUTES_PER_WEEK; mow++) {
+            minute_to_tm(mow, &t);
+            const schedule_rule_t *r = schedule_index_lookup(&sched, &t);
+            sink += r ? r->source : -1;
+        }
+        t_index += now_ns() - a;
+
+        a = now_ns();
+        for (int mow = 0; mow < SCHEDULE_MINUTES_PER_WEEK; mow++) {
+            minute_to_tm(mow, &t);
+            sink += linear_lookup(&cfg, &t);
+        }
+        t_linear += now_ns() - a;
+    }
+    (void)sink;
+
+    double lookups = (double)configs * SCHEDULE_MINUTES_PER_WEEK;
+    printf("rules=%d configs=%d index_bytes=%zu\n", rules, configs, sizeof(schedule_index_t));
+    printf("compile: %.1f us/config\n", t_compile / 1000.0 / configs);
+    printf("lookup:  index %.2f ns, linear %.2f ns (%.1fx)\n",
+           t_index / lookups, t_linear / lookups, (double)t_linear / (double)t_index);
+    printf("equivalence: %zu/%.0f minutes differ\n", mismatches, lookups);
+    return mismatches ? 1 : 0;
+}
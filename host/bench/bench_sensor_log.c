@@ -0,0 +1,169 @@
+// Benchmark de host: formato del log persistente (core/sensor_log_codec.c).
+//
+// Codifica N días de muestras a 1 Hz (temperatura con ruido de ADC, PIR y
+// PWM, con lecturas INVALID y saltos de tiempo) en bloques de 4 KB sobre una
+// "partición" en RAM del mismo tamaño que la del firmware, dando vueltas al
+// anillo. Verifica que lo decodificado coincide con lo escrito, que un
+// bloque truncado (corte a mitad de escritura) decodifica un prefijo válido,
+// e informa bytes por registro, retención y ciclos de borrado por año.
+//
+// Uso: bench_sensor_log [--days N] [--sectors N]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sensor_log_codec.h"
+
+#define T0_EPOCH    1767225600LL
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Muestra i de la secuencia sintética (determinista)
+static void synth(uint64_t i, slog_record_t *r) {
+    uint32_t h = hash32((uint32_t)i);
+    static int64_t ts = T0_EPOCH;
+    static int temp = 2300;
+    static int pwm = 0;
+    if (i == 0) { ts = T0_EPOCH; temp = 2300; pwm = 0; }
+
+    ts += (h % 5000 == 0) ? 120 : (h % 7001 == 0) ? -3 : 1;   // Huecos y correcciones NTP
+    temp += (int)(h % 7) - 3;                                   // Paseo aleatorio +-0.03 °C
+    if (temp < 1500) temp = 1500;
+    if (temp > 3200) temp = 3200;
+    if (h % 60 == 0) pwm = (int)((h >> 8) % 101);               // PWM cambia ~1 vez por minuto
+
+    r->ts = ts;
+    r->quality = (h % 997 == 0) ? TEMP_QUALITY_INVALID : (h % 211 == 0) ? TEMP_QUALITY_DEGRADED : TEMP_QUALITY_GOOD;
+    r->temp_c100 = (r->quality == TEMP_QUALITY_INVALID) ? SLOG_NO_TEMP : (int16_t)temp;
+    r->presence = ((h >> 20) % 10) < 3;
+    r->pwm = (uint8_t)pwm;
+}
+
+typedef struct {
+    uint64_t next;      // Índice de la próxima muestra esperada
+    size_t diffs;
+} verify_ctx_t;
+
+static void verify(void *ctx, const slog_record_t *got) {
+    verify_ctx_t *v = (verify_ctx_t *)ctx;
+    slog_record_t want;
+    synth(v->next++, &want);
+    if (want.ts != got->ts || want.temp_c100 != got->temp_c100 || want.pwm != got->pwm ||
+        want.presence != got->presence || want.quality != got->quality) {
+        if (v->diffs < 5) {
+            fprintf(stderr, "DIFF muestra %llu: ts %lld/%lld temp %d/%d pwm %u/%u\n",
+                    (unsigned long long)(v->next - 1), (long long)got->ts, (long long)want.ts,
+                    got->temp_c100, want.temp_c100, got->pwm, want.pwm);
+        }
+        v->diffs++;
+    }
+}
+
+static void count_only(void *ctx, const slog_record_t *rec) {
+    (void)rec;
+    (*(size_t *)ctx)++;
+}
+
+int main(int argc, char **argv) {
+    int days = 10;
+    int sectors = 256;      // 1 MB, como partitions.csv
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) days = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sectors") == 0 && i + 1 < argc) sectors = atoi(argv[++i]);
+    }
+    if (days < 1 || sectors < 2) {
+        fprintf(stderr, "uso: %s [--days N>=1] [--sectors N>=2]\n", argv[0]);
+        return 2;
+    }
+
+    uint8_t *flash = malloc((size_t)sectors * SLOG_BLOCK_SIZE);
+    uint64_t *first_index = calloc((size_t)sectors, sizeof(uint64_t)); // Primera muestra de cada bloque
+    memset(flash, 0xFF, (size_t)sectors * SLOG_BLOCK_SIZE);
+
+    uint64_t total = (uint64_t)days * 86400;
+    uint64_t erases = 0, blocks = 0;
+    uint32_t seq = 0;
+    int sector = -1;
+    size_t used = SLOG_BLOCK_SIZE;
+    slog_cursor_t cur;
+    slog_record_t r;
+
+    uint64_t t0 = now_ns();
+    for (uint64_t i = 0; i < total; i++) {
+        synth(i, &r);
+        size_t n = (sector >= 0) ? slog_encode(&cur, &r, &flash[(size_t)sector * SLOG_BLOCK_SIZE + used],
+                                               SLOG_BLOCK_SIZE - used) : 0;
+        if (n == 0) {
+            // Bloque lleno: siguiente sector del anillo (borrado = 0xFF)
+            sector = (sector + 1) % sectors;
+            uint8_t *blk = &flash[(size_t)sector * SLOG_BLOCK_SIZE];
+            memset(blk, 0xFF, SLOG_BLOCK_SIZE);
+            erases++;
+            blocks++;
+            used = slog_block_begin(blk, ++seq, &r, &cur);
+            first_index[sector] = i;
+            n = slog_encode(&cur, &r, &blk[used], SLOG_BLOCK_SIZE - used);
+        }
+        used += n;
+    }
+    uint64_t t_enc = now_ns() - t0;
+
+    // Decodificar el anillo completo en orden de secuencia
+    int oldest = (blocks >= (uint64_t)sectors) ? (sector + 1) % sectors : 0;
+    size_t nblk = (blocks >= (uint64_t)sectors) ? (size_t)sectors : (size_t)blocks;
+    verify_ctx_t v = { .next = first_index[oldest] };
+    for (uint64_t i = 0; i < v.next; i++) synth(i, &r);  // El generador es secuencial
+    size_t bytes = 0, records = 0;
+    t0 = now_ns();
+    for (size_t k = 0; k < nblk; k++) {
+        int s = (oldest + (int)k) % sectors;
+        size_t u = 0;
+        if (v.next != first_index[s]) v.diffs++;   // Los bloques deben ser contiguos
+        records += slog_decode_block(&flash[(size_t)s * SLOG_BLOCK_SIZE], SLOG_BLOCK_SIZE, verify, &v, &u, NULL);
+        bytes += u;
+    }
+    uint64_t t_dec = now_ns() - t0;
+    if (v.next != total) v.diffs++;
+
+    // Corte a mitad de escritura: truncar el último bloque en cada offset
+    size_t torn_bad = 0;
+    uint8_t tmp[SLOG_BLOCK_SIZE];
+    const uint8_t *last = &flash[(size_t)sector * SLOG_BLOCK_SIZE];
+    size_t full_count = 0, full_used = 0;
+    full_count = slog_decode_block(last, SLOG_BLOCK_SIZE, count_only, &(size_t){0}, &full_used, NULL);
+    for (size_t cut = sizeof(slog_block_header_t); cut < full_used; cut++) {
+        memcpy(tmp, last, cut);
+        memset(&tmp[cut], 0xFF, SLOG_BLOCK_SIZE - cut);
+        size_t c = 0, u = 0;
+        slog_decode_block(tmp, SLOG_BLOCK_SIZE, count_only, &c, &u, NULL);
+        if (c > full_count || u > cut) torn_bad++;
+    }
+
+    double bpr = (double)bytes / (double)records;
+    double rec_per_block = (double)records / (double)nblk;
+    double ring_days = rec_per_block * sectors / 86400.0;
+    printf("days=%d samples=%llu sectors=%d blocks_written=%llu\n",
+           days, (unsigned long long)total, sectors, (unsigned long long)blocks);
+    printf("encode: %.1f ns/record  decode: %.1f ns/record\n",
+           (double)t_enc / (double)total, (double)t_dec / (double)records);
+    printf("size: %.2f B/record (raw sensor_data_t + pwm: %zu B), %.0f records/block\n",
+           bpr, sizeof(sensor_data_t) + sizeof(uint32_t), rec_per_block);
+    printf("retention: %.1f days at 1 Hz, %.1f erases/sector/year\n", ring_days, 365.0 / ring_days);
+    printf("verify: %zu differences over %zu records, %zu bad torn-block decodes\n", v.diffs, records, torn_bad);
+
+    free(first_index);
+    free(flash);
+    return (v.diffs || torn_bad) ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+// Benchmark de host: serialización de /api/status.
+//
+// Mide tiempo por respuesta, bytes y actividad de heap (llamadas a malloc y
+// bytes reservados por respuesta, interceptando malloc con -Wl,--wrap) del
+// serializador en streaming (core/status_json.c). Si el build encuentra el
+// cJSON de ESP-IDF ($IDF_PATH), también mide el handler anterior basado en
+// cJSON_CreateObject + cJSON_PrintUnformatted para comparar antes/después.
+//
+// Uso: bench_status_json [--rules N] [--zones N] [--iterations N] [--buf BYTES]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "status_json.h"
+#ifdef HAVE_CJSON
+#include "cJSON.h"
+#endif
+
+// --- Contador de heap (enlazado con --wrap=malloc/calloc/realloc/free) ---
+static size_t heap_calls = 0;
+static size_t heap_bytes = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void __real_free(void *p);
+
+void *__wrap_malloc(size_t size) { heap_calls++; heap_bytes += size; return __real_malloc(size); }
+void *__wrap_calloc(size_t n, size_t size) { heap_calls++; heap_bytes += n * size; return __real_calloc(n, size); }
+void *__wrap_realloc(void *p, size_t size) { heap_calls++; heap_bytes += size; return __real_realloc(p, size); }
+void __wrap_free(void *p) { __real_free(p); }
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// "Socket" de prueba: solo cuenta bytes y chunks
+typedef struct {
+    size_t bytes;
+    size_t chunks;
+} sink_t;
+
+static int sink_flush(void *ctx, const char *data, size_t len) {
+    sink_t *s = (sink_t *)ctx;
+    (void)data;
+    s->bytes += len;
+    s->chunks++;
+    return 0;
+}
+
+static void report(const char *name, uint64_t ns, int iterations, size_t calls, size_t bytes, size_t doc_len) {
+    printf("%-10s %8.0f ns/resp  %5zu bytes/doc  %6.1f mallocs/resp  %7.0f heap bytes/resp\n",
+           name, (double)ns / iterations, doc_len,
+           (double)calls / iterations, (double)bytes / iterations);
+}
+
+#ifdef HAVE_CJSON
+// Copia del handler anterior (árbol cJSON + string en heap)
+static size_t legacy_status(const system_config_t *cfg, const system_state_t *state) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "mode", cfg->zones[0].operation_mode);
+    cJSON_AddNumberToObject(root, "manual_duty", cfg->zones[0].manual_duty);
+    cJSON_AddNumberToObject(root, "hold", cfg->presence_hold_s);
+    cJSON_AddNumberToObject(root, "temp", state->current_temp);
+    cJSON_AddNumberToObject(root, "tq", state->temp_quality);
+    cJSON_AddBoolToObject(root, "pir", state->presence);
+    cJSON_AddNumberToObject(root, "pwm", state->current_pwm);
+    cJSON_AddStringToObject(root, "time", state->current_time_str);
+    cJSON *schedules = cJSON_CreateArray();
+    for (int i = 0; i < cfg->schedule_count; i++) {
+        cJSON *item = cJSON_CreateObject();
+        const schedule_reg_t *reg = &cfg->schedules[i];
+        cJSON_AddBoolToObject(item, "act", reg->active);
+        cJSON_AddNumberToObject(item, "days", reg->days);
+        cJSON_AddNumberToObject(item, "sh", reg->start_hour);
+        cJSON_AddNumberToObject(item, "sm", reg->start_min);
+        cJSON_AddNumberToObject(item, "eh", reg->end_hour);
+        cJSON_AddNumberToObject(item, "em", reg->end_min);
+        cJSON_AddNumberToObject(item, "tmin", reg->temp_min_0_percent);
+        cJSON_AddNumberToObject(item, "tmax", reg->temp_max_100_percent);
+        cJSON_AddItemToArray(schedules, item);
+    }
+    cJSON_AddItemToObject(root, "schedules", schedules);
+    cJSON_AddNumberToObject(root, "sched_max", MAX_SCHEDULES);
+    char *out = cJSON_PrintUnformatted(root);
+    size_t len = strlen(out);
+    free(out);
+    cJSON_Delete(root);
+    return len;
+}
+#endif
+
+int main(int argc, char **argv) {
+    int rules = 3;
+    int zones = 1;
+    int iterations = 100000;
+    size_t buf_size = 1024;    // Igual que STATUS_BUF_SIZE en web_server.c
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) rules = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--zones") == 0 && i + 1 < argc) zones = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--buf") == 0 && i + 1 < argc) buf_size = (size_t)atoi(argv[++i]);
+    }
+    if (rules < 0 || rules > MAX_SCHEDULES || zones < 1 || zones > MAX_ZONES || iterations <= 0 || buf_size == 0) {
+        fprintf(stderr, "uso: %s [--rules 0..%d] [--zones 1..%d] [--iterations N] [--buf BYTES]\n",
+                argv[0], MAX_SCHEDULES, MAX_ZONES);
+        return 2;
+    }
+
+    system_config_t cfg = default_system_config;
+    cfg.schedule_count = (uint8_t)rules;
+    cfg.zone_count = (uint8_t)zones;
+    for (int i = 1; i < rules; i++) cfg.schedules[i] = cfg.schedules[0];
+    system_state_t state = { .current_temp = 24.37f, .presence = true, .current_pwm = 45 };
+    strcpy(state.current_time_str, "12:34:56");
+    system_state_t states[MAX_ZONES];
+    for (int z = 0; z < MAX_ZONES; z++) states[z] = state;
+
+    char *buf = malloc(buf_size);
+    sink_t sink = {0};
+    json_writer_t w;
+
+    heap_calls = heap_bytes = 0;
+    uint64_t t0 = now_ns();
+    for (int it = 0; it < iterations; it++) {
+        json_writer_init(&w, buf, buf_size, sink_flush, &sink);
+        status_json_write(&w, &cfg, states, cfg.zone_count);
+        json_writer_finish(&w);
+    }
+    uint64_t elapsed = now_ns() - t0;
+    printf("rules=%d zones=%d iterations=%d buf=%zu chunks/resp=%zu\n",
+           rules, zones, iterations, buf_size, sink.chunks / iterations);
+    report("streaming", elapsed, iterations, heap_calls, heap_bytes, w.total);
+
+#ifdef HAVE_CJSON
+    size_t len = 0;
+    heap_calls = heap_bytes = 0;
+    t0 = now_ns();
+    for (int it = 0; it < iterations; it++) {
+        len = legacy_status(&cfg, &state);
+    }
+    elapsed = now_ns() - t0;
+    report("cjson", elapsed, iterations, heap_calls, heap_bytes, len);
+#else
+    printf("cjson      (no medido: definir IDF_PATH para compilar el serializador anterior)\n");
+#endif
+
+    free(buf);
+    return w.error ? 1 : 0;
+}
@@ -0,0 +1,274 @@
+// Benchmark de host: escalado multi-zona con la planta del mock de HAL.
+//
+// Reproduce la estructura de tasks/zones.c con pthreads: cada zona corre su
+// lazo (planta térmica propia -> sample_rate -> control_decide con el
+// horario compartido bajo su mutex -> snapshot de estado) sobre 'hours'
+// horas de tiempo simulado a 1 Hz, lo más rápido posible. En paralelo un
+// escritor publica cambios de configuración (como POST /api/settings) y un
+// lector serializa /api/status con todas las zonas (como el httpd). Los hilos
+// de zona se fijan a la CPU (i+1) % 2 igual que en el ESP32 (si el host
+// tiene menos de 2 CPUs, todos a la 0).
+//
+// Por cada cantidad de zonas (1, 4 y 8 por defecto) informa decisiones/s,
+// latencia de cada decisión (mutex + control_decide, p50/p99), cuántas veces
+// el mutex del horario estaba tomado por otra zona, recompilaciones del
+// horario, documentos de estado por segundo y memoria de estado por zona.
+// Las latencias salen de un histograma log2: p50/p99 son cotas de bucket.
+//
+// Uso: bench_zones [--hours N] [--zones N[,N...]]   (por defecto 30 días, 1,4,8 zonas)
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "control_logic.h"
+#include "schedule_index.h"
+#include "sample_rate.h"
+#include "snapshot.h"
+#include "status_json.h"
+#include "thermal_plant.h"
+#include "latency_hist.h"
+
+#define WRITER_PERIOD_US    2000    // Un cambio de config cada 2 ms (muy por encima de una UI real)
+
+// Estado compartido (equivalente a app_context_t)
+static snapshot_t config_snap;
+static system_config_t config_slots[2];
+static pthread_mutex_t config_mutex = PTHREAD_MUTEX_INITIALIZER;
+static schedule_index_t schedule;
+static uint32_t schedule_version;
+static uint32_t schedule_compiles;
+static pthread_mutex_t schedule_mutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool running;
+static int ncpu;
+
+// Una zona (equivalente a zone_t sin las primitivas de FreeRTOS)
+typedef struct {
+    uint8_t id;
+    int cpu;
+    int hours;
+    pthread_t thread;
+    snapshot_t state_snap;
+    system_state_t state_slots[2];
+
+    // Resultados (solo el hilo de la zona)
+    latency_hist_t decide_ns;   // Registra ns (el histograma es de unidades genéricas)
+    uint32_t decisions;
+    uint32_t contended;
+    uint32_t steps;
+} bench_zone_t;
+
+static bench_zone_t zones[MAX_ZONES];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void *zone_thread(void *arg) {
+    bench_zone_t *z = (bench_zone_t *)arg;
+    pin_to_cpu(z->cpu);
+
+    thermal_plant_params_t pp = thermal_plant_default_params;
+    pp.ambient_c += 0.5f * z->id;   // Igual que mocks/mock_room.c
+    thermal_plant_t plant;
+    thermal_plant_init(&plant, &pp, 1 + z->id);
+
+    system_config_t cfg;
+    uint32_t cfg_version = snapshot_read(&config_snap, &cfg);
+    sample_rate_t rate;
+    sample_rate_init(&rate, &cfg, &cfg.zones[z->id]);
+    control_state_t cs;
+    control_state_reset(&cs);
+    system_state_t state = {0};
+    struct tm tm_now = { .tm_year = 126, .tm_mday = 1, .tm_hour = 12 };
+    uint32_t pwm = 0;
+
+    int total = z->hours * 3600;
+    for (int t = 0; t < total; t++) {
+        uint32_t version = snapshot_read(&config_snap, &cfg);
+        if (version != cfg_version) {
+            cfg_version = version;
+            sample_rate_configure(&rate, &cfg, &cfg.zones[z->id]);
+        }
+
+        int64_t now_us = (int64_t)t * 1000000;
+        sensor_data_t s = {
+            .temperature = thermal_plant_measure(&plant),
+            .presence_detected = ((t / 1800) % 4) != 3,    // 30 min sin presencia cada 2 h
+            .timestamp = now_us,
+            .temp_quality = TEMP_QUALITY_GOOD,
+        };
+        tm_now.tm_hour = (t / 3600) % 24;
+        tm_now.tm_min = (t / 60) % 60;
+
+        if (sample_rate_check(&rate, &s, now_us, &s.reason)) {
+            uint64_t t0 = now_ns();
+            if (pthread_mutex_trylock(&schedule_mutex) != 0) {
+                z->contended++;
+                pthread_mutex_lock(&schedule_mutex);
+            }
+            if ((int32_t)(cfg_version - schedule_version) > 0) {
+                schedule_index_compile(&schedule, &cfg);
+                schedule_version = cfg_version;
+                schedule_compiles++;
+            }
+            control_decision_t d = control_decide(&cfg.zones[z->id], &schedule, &cs, &s, &tm_now, true);
+            pthread_mutex_unlock(&schedule_mutex);
+            uint64_t dt = now_ns() - t0;
+            latency_hist_record(&z->decide_ns, dt > UINT32_MAX ? UINT32_MAX : (uint32_t)dt);
+            z->decisions++;
+            if (d.status == CONTROL_OK) pwm = d.pwm;
+
+            state.current_temp = s.temperature;
+            state.temp_quality = s.temp_quality;
+            state.presence = s.presence_detected;
+            state.current_pwm = pwm;
+            snapshot_publish(&z->state_snap, &state);
+        }
+        thermal_plant_step(&plant, pwm);
+        z->steps++;
+    }
+    return NULL;
+}
+
+// Cambios de configuración periódicos: alterna la consigna del PID de una zona
+static void *writer_thread(void *arg) {
+    uint32_t *writes = (uint32_t *)arg;
+    unsigned n = 0;
+    while (atomic_load(&running)) {
+        pthread_mutex_lock(&config_mutex);
+        system_config_t cfg;
+        snapshot_read(&config_snap, &cfg);
+        zone_config_t *zc = &cfg.zones[n % cfg.zone_count];
+        zc->pid.setpoint_c = (zc->pid.setpoint_c > 24.0f) ? 24.0f : 24.5f;
+        snapshot_publish(&config_snap, &cfg);
+        pthread_mutex_unlock(&config_mutex);
+        (*writes)++;
+        n++;
+        usleep(WRITER_PERIOD_US);
+    }
+    return NULL;
+}
+
+static int discard_flush(void *ctx, const char *data, size_t len) {
+    (void)ctx; (void)data; (void)len;
+    return 0;
+}
+
+// /api/status continuo: config + estado de todas las zonas
+static void *reader_thread(void *arg) {
+    uint32_t *docs = (uint32_t *)arg;
+    char buf[1024];
+    while (atomic_load(&running)) {
+        system_config_t cfg;
+        system_state_t states[MAX_ZONES];
+        snapshot_read(&config_snap, &cfg);
+        for (unsigned z = 0; z < cfg.zone_count; z++) snapshot_read(&zones[z].state_snap, &states[z]);
+        json_writer_t w;
+        json_writer_init(&w, buf, sizeof(buf), discard_flush, NULL);
+        status_json_write(&w, &cfg, states, cfg.zone_count);
+        json_writer_finish(&w);
+        (*docs)++;
+        usleep(1000);
+    }
+    return NULL;
+}
+
+static void run(int count, int hours) {
+    static const operation_mode_t modes[4] = { MODE_SCHEDULE, MODE_PID, MODE_AUTO, MODE_HYSTERESIS };
+    system_config_t cfg = default_system_config;
+    cfg.zone_count = (uint8_t)count;
+    for (int i = 0; i < count; i++) cfg.zones[i].operation_mode = modes[i % 4];
+    snapshot_init(&config_snap, &config_slots[0], &config_slots[1], sizeof(cfg), &cfg);
+    schedule_version = snapshot_read(&config_snap, &cfg);
+    schedule_index_compile(&schedule, &cfg);
+    schedule_compiles = 0;
+
+    system_state_t boot = {0};
+    for (int i = 0; i < count; i++) {
+        bench_zone_t *z = &zones[i];
+        memset(z, 0, sizeof(*z));
+        z->id = (uint8_t)i;
+        z->cpu = (ncpu >= 2) ? (i + 1) % 2 : 0;
+        z->hours = hours;
+        snapshot_init(&z->state_snap, &z->state_slots[0], &z->state_slots[1], sizeof(system_state_t), &boot);
+    }
+
+    uint32_t writes = 0, docs = 0;
+    pthread_t writer, reader;
+    atomic_store(&running, true);
+    pthread_create(&writer, NULL, writer_thread, &writes);
+    pthread_create(&reader, NULL, reader_thread, &docs);
+
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < count; i++) pthread_create(&zones[i].thread, NULL, zone_thread, &zones[i]);
+    for (int i = 0; i < count; i++) pthread_join(zones[i].thread, NULL);
+    double wall_s = (now_ns() - t0) / 1e9;
+
+    atomic_store(&running, false);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    latency_hist_t all = {0};
+    uint32_t decisions = 0, contended = 0;
+    uint64_t steps = 0;
+    for (int i = 0; i < count; i++) {
+        latency_hist_merge(&all, &zones[i].decide_ns);
+        decisions += zones[i].decisions;
+        contended += zones[i].contended;
+        steps += zones[i].steps;
+    }
+    printf("%5d %9.0f %10.0f %11.0f %7u %8u %8u %7.2f%% %8u %9.0f\n",
+           count, wall_s * 1000, steps / wall_s, decisions / wall_s, latency_hist_avg(&all),
+           latency_hist_percentile(&all, 50), latency_hist_percentile(&all, 99),
+           decisions ? 100.0 * contended / decisions : 0.0, schedule_compiles, docs / wall_s);
+}
+
+int main(int argc, char **argv) {
+    int hours = 30 * 24;
+    int counts[MAX_ZONES] = { 1, 4, 8 };
+    int ncounts = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) hours = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--zones") == 0 && i + 1 < argc) {
+            ncounts = 0;
+            for (char *tok = strtok(argv[++i], ","); tok != NULL && ncounts < MAX_ZONES; tok = strtok(NULL, ",")) {
+                counts[ncounts++] = atoi(tok);
+            }
+        }
+    }
+    for (int i = 0; i < ncounts; i++) {
+        if (counts[i] < 1 || counts[i] > MAX_ZONES) ncounts = 0;
+    }
+    if (hours < 1 || hours > 365 * 24 || ncounts == 0) {
+        fprintf(stderr, "uso: %s [--hours 1..8760] [--zones N[,N...] (1..%d)]\n", argv[0], MAX_ZONES);
+        return 2;
+    }
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    ncpu = (online >= 2) ? 2 : 1;
+    printf("%d h simulated per zone at 1 Hz, %d CPU%s (zone i -> CPU (i+1)%%2), config write every %d us\n",
+           hours, ncpu, ncpu > 1 ? "s" : "", WRITER_PERIOD_US);
+    printf("per-zone core state: %zu bytes (sample_rate %zu + control_state %zu + state snapshot %zu + plant %zu)\n",
+           sizeof(sample_rate_t) + sizeof(control_state_t) + 2 * sizeof(system_state_t) + sizeof(snapshot_t) +
+           sizeof(thermal_plant_t),
+           sizeof(sample_rate_t), sizeof(control_state_t), 2 * sizeof(system_state_t) + sizeof(snapshot_t),
+           sizeof(thermal_plant_t));
+    printf("%5s %9s %10s %11s %7s %8s %8s %8s %8s %9s\n", "zones", "wall ms", "steps/s", "decisions/s",
+           "avg ns", "p50 ns", "p99 ns", "mutex", "compiles", "status/s");
+    for (int i = 0; i < ncounts; i++) run(counts[i], hours);
+    return 0;
+}
@@ -0,0 +1,261 @@
+// Parser JSON recursivo con la API de cJSON (ver cJSON.h)
+#include "cJSON.h"
+#include <ctype.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define MAX_DEPTH   64      // CJSON_NESTING_LIMIT es 1000; alcanza para la API
+
+typedef struct {
+    const char *p;
+    const char *end;
+    int depth;
+} parser_t;
+
+static void skip_ws(parser_t *ps) {
+    while (ps->p < ps->end && isspace((unsigned char)*ps->p)) ps->p++;
+}
+
+static bool literal(parser_t *ps, const char *word) {
+    size_t n = strlen(word);
+    if ((size_t)(ps->end - ps->p) < n || strncmp(ps->p, word, n) != 0) return false;
+    ps->p += n;
+    return true;
+}
+
+static int hex4(const char *s) {
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') v |= c - '0';
+        else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+static size_t utf8_put(char *out, unsigned cp) {
+    if (cp < 0x80) { out[0] = (char)cp; return 1; }
+    if (cp < 0x800) { out[0] = (char)(0xC0 | cp >> 6); out[1] = (char)(0x80 | (cp & 0x3F)); return 2; }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | cp >> 12); out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | cp >> 18); out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F)); out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// ps->p en la comilla de apertura; devuelve el string decodificado (malloc)
+static char *parse_string_raw(parser_t *ps) {
+    const char *s = ++ps->p;
+    size_t cap = 0;
+    while (ps->p < ps->end && *ps->p != '"') {
+        if (*ps->p == '\\') ps->p++;
+        ps->p++;
+        cap++;
+    }
+    if (ps->p >= ps->end) return NULL;
+    char *out = malloc(cap * 4 + 1);     // Peor caso: \uXXXX -> 4 bytes de UTF-8 por cada uno
+    if (out == NULL) return NULL;
+    size_t n = 0;
+    for (const char *c = s; c < ps->p; c++) {
+        if (*c != '\\') {
+            out[n++] = *c;
+            continue;
+        }
+        c++;
+        switch (*c) {
+            case 'b': out[n++] = '\b'; break;
+            case 'f': out[n++] = '\f'; break;
+            case 'n': out[n++] = '\n'; break;
+            case 'r': out[n++] = '\r'; break;
+            case 't': out[n++] = '\t'; break;
+            case 'u': {
+                int cp = (ps->p - c > 4) ? hex4(c + 1) : -1;
+                if (cp < 0) { free(out); return NULL; }
+                c += 4;
+                if (cp >= 0xD800 && cp < 0xDC00 && ps->p - c > 6 && c[1] == '\\' && c[2] == 'u') {
+                    int lo = hex4(c + 3);
+                    if (lo >= 0xDC00 && lo < 0xE000) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        c += 6;
+                    }
+                }
+                n += utf8_put(out + n, (unsigned)cp);
+                break;
+            }
+            default: out[n++] = *c; break;  // \" \\ \/
+        }
+    }
+    out[n] = '\0';
+    ps->p++;    // Comilla de cierre
+    return out;
+}
+
+static cJSON *parse_value(parser_t *ps);
+
+static cJSON *new_item(int type) {
+    cJSON *item = calloc(1, sizeof(cJSON));
+    if (item != NULL) item->type = type;
+    return item;
+}
+
+static void append(cJSON *parent, cJSON **last, cJSON *child) {
+    if (*last == NULL) parent->child = child;
+    else {
+        (*last)->next = child;
+        child->prev = *last;
+    }
+    *last = child;
+    parent->child->prev = child;    // Como cJSON: el primero apunta al último
+}
+
+static cJSON *parse_container(parser_t *ps, bool object) {
+    if (++ps->depth > MAX_DEPTH) return NULL;
+    cJSON *item = new_item(object ? cJSON_Object : cJSON_Array);
+    if (item == NULL) return NULL;
+    cJSON *last = NULL;
+    char close = object ? '}' : ']';
+    ps->p++;
+    skip_ws(ps);
+    if (ps->p < ps->end && *ps->p == close) {
+        ps->p++;
+        ps->depth--;
+        return item;
+    }
+    while (ps->p < ps->end) {
+        char *key = NULL;
+        if (object) {
+            skip_ws(ps);
+            if (ps->p >= ps->end || *ps->p != '"' || (key = parse_string_raw(ps)) == NULL) break;
+            skip_ws(ps);
+            if (ps->p >= ps->end || *ps->p++ != ':') { free(key); break; }
+        }
+        cJSON *child = parse_value(ps);
+        if (child == NULL) { free(key); break; }
+        child->string = key;
+        append(item, &last, child);
+        skip_ws(ps);
+        if (ps->p < ps->end && *ps->p == ',') { ps->p++; continue; }
+        if (ps->p < ps->end && *ps->p == close) {
+            ps->p++;
+            ps->depth--;
+            return item;
+        }
+        break;
+    }
+    cJSON_Delete(item);
+    return NULL;
+}
+
+static cJSON *parse_number(parser_t *ps) {
+    char buf[64];
+    size_t n = 0;
+    while (ps->p + n < ps->end && n < sizeof(buf) - 1 && strchr("+-0123456789.eE", ps->p[n]) != NULL) n++;
+    memcpy(buf, ps->p, n);
+    buf[n] = '\0';
+    char *endp;
+    double d = strtod(buf, &endp);
+    if (endp == buf) return NULL;
+    ps->p += endp - buf;
+    cJSON *item = new_item(cJSON_Number);
+    if (item == NULL) return NULL;
+    item->valuedouble = d;
+    item->valueint = (d >= INT_MAX) ? INT_MAX : (d <= (double)INT_MIN) ? INT_MIN : (int)d;
+    return item;
+}
+
+static cJSON *parse_value(parser_t *ps) {
+    skip_ws(ps);
+    if (ps->p >= ps->end) return NULL;
+    switch (*ps->p) {
+        case '{': return parse_container(ps, true);
+        case '[': return parse_container(ps, false);
+        case '"': {
+            char *s = parse_string_raw(ps);
+            if (s == NULL) return NULL;
+            cJSON *item = new_item(cJSON_String);
+            if (item == NULL) { free(s); return NULL; }
+            item->valuestring = s;
+            return item;
+        }
+        case 't': return literal(ps, "true") ? new_item(cJSON_True) : NULL;
+        case 'f': return literal(ps, "false") ? new_item(cJSON_False) : NULL;
+        case 'n': return literal(ps, "null") ? new_item(cJSON_NULL) : NULL;
+        default: return parse_number(ps);
+    }
+}
+
+cJSON *cJSON_ParseWithLength(const char *value, size_t length) {
+    if (value == NULL) return NULL;
+    parser_t ps = { .p = value, .end = value + length };
+    cJSON *item = parse_value(&ps);
+    if (item == NULL) return NULL;
+    skip_ws(&ps);
+    if (ps.p < ps.end && *ps.p != '\0') {   // Basura después del documento
+        cJSON_Delete(item);
+        return NULL;
+    }
+    return item;
+}
+
+cJSON *cJSON_Parse(const char *value) {
+    return value ? cJSON_ParseWithLength(value, strlen(value)) : NULL;
+}
+
+void cJSON_Delete(cJSON *item) {
+    while (item != NULL) {
+        cJSON *next = item->next;
+        cJSON_Delete(item->child);
+        free(item->valuestring);
+        free(item->string);
+        free(item);
+        item = next;
+    }
+}
+
+int cJSON_GetArraySize(const cJSON *array) {
+    int n = 0;
+    const cJSON *c;
+    cJSON_ArrayForEach(c, array) n++;
+    return n;
+}
+
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index) {
+    cJSON *c;
+    cJSON_ArrayForEach(c, array) {
+        if (index-- == 0) return c;
+    }
+    return NULL;
+}
+
+static cJSON *get_item(const cJSON *object, const char *key, bool case_sensitive) {
+    if (object == NULL || key == NULL) return NULL;
+    cJSON *c;
+    cJSON_ArrayForEach(c, object) {
+        if (c->string != NULL && (case_sensitive ? strcmp(c->string, key) : strcasecmp(c->string, key)) == 0) return c;
+    }
+    return NULL;
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string) { return get_item(object, string, false); }
+cJSON *cJSON_GetObjectItemCaseSensitive(const cJSON *object, const char *string) { return get_item(object, string, true); }
+
+static cJSON_bool is_type(const cJSON *item, int type) { return item != NULL && (item->type & 0xFF) == type; }
+
+cJSON_bool cJSON_IsInvalid(const cJSON *item) { return is_type(item, cJSON_Invalid); }
+cJSON_bool cJSON_IsFalse(const cJSON *item) { return is_type(item, cJSON_False); }
+cJSON_bool cJSON_IsTrue(const cJSON *item) { return is_type(item, cJSON_True); }
+cJSON_bool cJSON_IsBool(const cJSON *item) { return item != NULL && (item->type & (cJSON_True | cJSON_False)) != 0; }
+cJSON_bool cJSON_IsNull(const cJSON *item) { return is_type(item, cJSON_NULL); }
+cJSON_bool cJSON_IsNumber(const cJSON *item) { return is_type(item, cJSON_Number); }
+cJSON_bool cJSON_IsString(const cJSON *item) { return is_type(item, cJSON_String); }
+cJSON_bool cJSON_IsArray(const cJSON *item) { return is_type(item, cJSON_Array); }
+cJSON_bool cJSON_IsObject(const cJSON *item) { return is_type(item, cJSON_Object); }
@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+
+// Subconjunto de cJSON (la API y el layout de ESP-IDF) para compilar main/web
+// en host sin un árbol de ESP-IDF: solo parseo y lectura, que es lo que usan
+// los handlers. Con IDF_PATH definido host/CMakeLists.txt usa el cJSON real.
+
+#define cJSON_Invalid   (0)
+#define cJSON_False     (1 << 0)
+#define cJSON_True      (1 << 1)
+#define cJSON_NULL      (1 << 2)
+#define cJSON_Number    (1 << 3)
+#define cJSON_String    (1 << 4)
+#define cJSON_Array     (1 << 5)
+#define cJSON_Object    (1 << 6)
+
+typedef int cJSON_bool;
+
+typedef struct cJSON {
+    struct cJSON *next;
+    struct cJSON *prev;
+    struct cJSON *child;
+    int type;
+    char *valuestring;
+    int valueint;               // Saturado a INT_MIN..INT_MAX, como cJSON
+    double valuedouble;
+    char *string;               // Clave dentro de un objeto
+} cJSON;
+
+cJSON *cJSON_Parse(const char *value);
+cJSON *cJSON_ParseWithLength(const char *value, size_t length);
+void cJSON_Delete(cJSON *item);
+
+int cJSON_GetArraySize(const cJSON *array);
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index);
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string);    // Sin distinguir mayúsculas
+cJSON *cJSON_GetObjectItemCaseSensitive(const cJSON *object, const char *string);
+
+cJSON_bool cJSON_IsInvalid(const cJSON *item);
+cJSON_bool cJSON_IsFalse(const cJSON *item);
+cJSON_bool cJSON_IsTrue(const cJSON *item);
+cJSON_bool cJSON_IsBool(const cJSON *item);
+cJSON_bool cJSON_IsNull(const cJSON *item);
+cJSON_bool cJSON_IsNumber(const cJSON *item);
+cJSON_bool cJSON_IsString(const cJSON *item);
+cJSON_bool cJSON_IsArray(const cJSON *item);
+cJSON_bool cJSON_IsObject(const cJSON *item);
+
+#define cJSON_ArrayForEach(element, array) \
+    for (element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
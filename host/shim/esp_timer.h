@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Microsegundos desde el arranque del proceso (CLOCK_MONOTONIC)
+int64_t esp_timer_get_time(void);
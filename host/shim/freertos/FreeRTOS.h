@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// FreeRTOS (variante ESP-IDF) sobre pthreads, solo lo que usa el código de
+// main/ que corre en el servidor de reemplazo de host (host/tools/web_standin.c).
+// Un tick = 1 ms. Las secciones críticas son mutex: en host no hay núcleos
+// que detener, solo hilos que excluir.
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFu)
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define portNUM_PROCESSORS      2
+
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    PTHREAD_MUTEX_INITIALIZER
+#define portMUX_INITIALIZE(mux)         pthread_mutex_init((mux), NULL)
+#define taskENTER_CRITICAL(mux)         pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL(mux)          pthread_mutex_unlock(mux)
@@ -0,0 +1,8 @@
+#pragma once
+// Valores de sdkconfig que usa el código de main/ compilado en host
+// (host/tools/web_standin.c). Los de esp_http_server son los por defecto de ESP-IDF.
+#define CONFIG_LOG_DEFAULT_LEVEL        3       // INFO
+#define CONFIG_LWIP_MAX_SOCKETS         10
+#define CONFIG_HTTPD_MAX_REQ_HDR_LEN    512
+#define CONFIG_HTTPD_MAX_URI_LEN        512
+#define CONFIG_HTTPD_WS_SUPPORT         1
@@ -0,0 +1,173 @@
+// FreeRTOS, esp_timer, esp_log y esp_system sobre POSIX (ver freertos/FreeRTOS.h)
+#define _POSIX_C_SOURCE 200809L
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// --- esp_timer ---
+
+static int64_t mono_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t boot_us;
+
+__attribute__((constructor)) static void shim_boot(void) { boot_us = mono_us(); }
+
+int64_t esp_timer_get_time(void) { return mono_us() - boot_us; }
+
+// --- esp_log ---
+
+static pthread_mutex_t log_mux = PTHREAD_MUTEX_INITIALIZER;
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...) {
+    (void)level;
+    (void)tag;
+    va_list ap;
+    va_start(ap, format);
+    pthread_mutex_lock(&log_mux);
+    vfprintf(stderr, format, ap);
+    pthread_mutex_unlock(&log_mux);
+    va_end(ap);
+}
+
+uint32_t esp_log_timestamp(void) { return (uint32_t)(esp_timer_get_time() / 1000); }
+
+// --- esp_system ---
+
+uint32_t esp_get_free_heap_size(void) { return 0; }
+uint32_t esp_get_minimum_free_heap_size(void) { return 0; }
+void esp_restart(void) { exit(0); }
+
+// --- Tareas ---
+
+void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = { .tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+// Plazo absoluto de CLOCK_REALTIME para las esperas con timeout de pthreads
+static struct timespec deadline_after(TickType_t ticks) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ticks / 1000;
+    ts.tv_nsec += (long)(ticks % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// --- Mutex ---
+
+struct shim_sem {
+    pthread_mutex_t m;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t s = calloc(1, sizeof(*s));
+    if (s != NULL) pthread_mutex_init(&s->m, NULL);
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+    if (ticks == 0) return pthread_mutex_trylock(&s->m) == 0 ? pdTRUE : pdFALSE;
+    if (ticks == portMAX_DELAY) return pthread_mutex_lock(&s->m) == 0 ? pdTRUE : pdFALSE;
+    struct timespec ts = deadline_after(ticks);
+    return pthread_mutex_timedlock(&s->m, &ts) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    return pthread_mutex_unlock(&s->m) == 0 ? pdTRUE : pdFALSE;
+}
+
+// --- Colas ---
+
+struct shim_queue {
+    pthread_mutex_t m;
+    pthread_cond_t changed;
+    UBaseType_t len, size, head, count;
+    uint8_t *items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    QueueHandle_t q = calloc(1, sizeof(*q));
+    if (q == NULL) return NULL;
+    q->items = calloc(length, item_size);
+    if (q->items == NULL) {
+        free(q);
+        return NULL;
+    }
+    pthread_mutex_init(&q->m, NULL);
+    pthread_cond_init(&q->changed, NULL);
+    q->len = length;
+    q->size = item_size;
+    return q;
+}
+
+// Espera en 'changed' hasta que 'ready' o venza el plazo
+static bool queue_wait(QueueHandle_t q, TickType_t ticks, bool (*ready)(QueueHandle_t)) {
+    struct timespec ts = deadline_after(ticks);
+    while (!ready(q)) {
+        if (ticks == 0) return false;
+        int rc = (ticks == portMAX_DELAY) ? pthread_cond_wait(&q->changed, &q->m)
+                                          : pthread_cond_timedwait(&q->changed, &q->m, &ts);
+        if (rc == ETIMEDOUT) return ready(q);
+    }
+    return true;
+}
+
+static bool has_space(QueueHandle_t q) { return q->count < q->len; }
+static bool has_item(QueueHandle_t q) { return q->count > 0; }
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+    pthread_mutex_lock(&q->m);
+    bool ok = queue_wait(q, ticks, has_space);
+    if (ok) {
+        memcpy(q->items + ((q->head + q->count) % q->len) * q->size, item, q->size);
+        q->count++;
+        pthread_cond_broadcast(&q->changed);
+    }
+    pthread_mutex_unlock(&q->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+    pthread_mutex_lock(&q->m);
+    bool ok = queue_wait(q, ticks, has_item);
+    if (ok) {
+        memcpy(item, q->items + q->head * q->size, q->size);
+        q->head = (q->head + 1) % q->len;
+        q->count--;
+        pthread_cond_broadcast(&q->changed);
+    }
+    pthread_mutex_unlock(&q->m);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    pthread_mutex_lock(&q->m);
+    UBaseType_t n = q->count;
+    pthread_mutex_unlock(&q->m);
+    return n;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+    pthread_mutex_lock(&q->m);
+    UBaseType_t n = q->len - q->count;
+    pthread_mutex_unlock(&q->m);
+    return n;
+}
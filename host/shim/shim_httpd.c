@@ -0,0 +1,933 @@
+// esp_http_server sobre sockets POSIX (ver esp_http_server.h)
+#define _GNU_SOURCE
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static const char *TAG = "httpd";
+
+#define RX_BUF_LEN      (HTTPD_MAX_URI_LEN + HTTPD_MAX_REQ_HDR_LEN + 64)
+#define WORK_QUEUE_LEN  16
+#define WS_GUID         "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+typedef struct {
+    int fd;                     // -1 = libre
+    bool ws;
+    int ws_uri;                 // Handler del WebSocket (índice en uris)
+    uint64_t lru;               // Última actividad (contador del servidor)
+    size_t len;                 // Bytes pendientes en buf (pipelining o resto del cuerpo)
+    char buf[RX_BUF_LEN];
+} sess_t;
+
+typedef struct {
+    httpd_work_fn_t fn;
+    void *arg;
+} work_t;
+
+typedef struct {
+    httpd_config_t cfg;
+    int listen_fd;
+    int ctrl[2];                // Pipe de control: despierta al select()
+    pthread_t thread;
+    volatile bool stop;
+    httpd_uri_t *uris;
+    unsigned uri_count;
+    sess_t *sess;
+    uint64_t lru_counter;
+    pthread_mutex_t mux;        // Cola de trabajos y contadores
+    work_t work[WORK_QUEUE_LEN];
+    unsigned work_head, work_count;
+    httpd_shim_stats_t stats;
+} server_t;
+
+// Estado de un request (req->aux)
+typedef struct {
+    server_t *srv;
+    sess_t *sess;
+    char hdr[HTTPD_MAX_REQ_HDR_LEN + 1];    // Líneas de cabecera (sin la del request)
+    const char *query;          // Dentro de req->uri, NULL si no hay
+    size_t body_left;
+    const char *status;
+    const char *type;
+    const char *resp_field[32];
+    const char *resp_value[32];
+    unsigned resp_hdrs;
+    bool headers_sent;
+    bool chunked;
+    bool failed;                // Error de socket: cerrar la sesión
+    // WebSocket: frame en curso
+    httpd_ws_type_t ws_type;
+    bool ws_final;
+    size_t ws_len;
+    size_t ws_read;
+    uint8_t ws_mask[4];
+    bool ws_masked;
+} req_aux_t;
+
+void (*httpd_shim_config_hook)(httpd_config_t *config);
+static httpd_handle_t last_server;
+
+static void stat_add(server_t *srv, uint32_t *field) {
+    pthread_mutex_lock(&srv->mux);
+    (*field)++;
+    pthread_mutex_unlock(&srv->mux);
+}
+
+// --- E/S de la sesión (bloqueante con recv/send_wait_timeout, como la tarea del httpd) ---
+
+static bool send_all(int fd, const void *data, size_t len) {
+    const char *p = data;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Lee hasta 'len' bytes: primero lo pendiente en el buffer, después el socket
+static ssize_t sess_read(sess_t *s, void *dst, size_t len) {
+    if (s->len > 0) {
+        size_t n = (len < s->len) ? len : s->len;
+        memcpy(dst, s->buf, n);
+        memmove(s->buf, s->buf + n, s->len - n);
+        s->len -= n;
+        return (ssize_t)n;
+    }
+    ssize_t n;
+    do {
+        n = recv(s->fd, dst, len, 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+static bool sess_read_full(sess_t *s, void *dst, size_t len) {
+    uint8_t *p = dst;
+    while (len > 0) {
+        ssize_t n = sess_read(s, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void sess_discard(sess_t *s, size_t len) {
+    char tmp[256];
+    while (len > 0) {
+        ssize_t n = sess_read(s, tmp, len < sizeof(tmp) ? len : sizeof(tmp));
+        if (n <= 0) return;
+        len -= (size_t)n;
+    }
+}
+
+static void sess_close(server_t *srv, sess_t *s) {
+    if (s->fd < 0) return;
+    if (srv->cfg.close_fn != NULL) srv->cfg.close_fn(srv, s->fd);   // El callback cierra el socket
+    else close(s->fd);
+    s->fd = -1;
+    s->ws = false;
+    s->len = 0;
+}
+
+static sess_t *sess_by_fd(server_t *srv, int fd) {
+    for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) {
+        if (srv->sess[i].fd == fd) return &srv->sess[i];
+    }
+    return NULL;
+}
+
+static unsigned sess_open_count(const server_t *srv) {
+    unsigned n = 0;
+    for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) n += srv->sess[i].fd >= 0;
+    return n;
+}
+
+// --- Respuestas ---
+
+static const char *err_status(httpd_err_code_t code) {
+    switch (code) {
+        case HTTPD_501_METHOD_NOT_IMPLEMENTED:      return "501 Method Not Implemented";
+        case HTTPD_505_VERSION_NOT_SUPPORTED:       return "505 Version Not Supported";
+        case HTTPD_400_BAD_REQUEST:                 return "400 Bad Request";
+        case HTTPD_401_UNAUTHORIZED:                return "401 Unauthorized";
+        case HTTPD_403_FORBIDDEN:                   return "403 Forbidden";
+        case HTTPD_404_NOT_FOUND:                   return "404 Not Found";
+        case HTTPD_405_METHOD_NOT_ALLOWED:          return "405 Method Not Allowed";
+        case HTTPD_408_REQ_TIMEOUT:                 return "408 Request Timeout";
+        case HTTPD_411_LENGTH_REQUIRED:             return "411 Length Required";
+        case HTTPD_414_URI_TOO_LONG:                return "414 URI Too Long";
+        case HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE:    return "431 Request Header Fields Too Large";
+        default:                                    return "500 Internal Server Error";
+    }
+}
+
+static bool send_headers(httpd_req_t *r, bool chunked, size_t content_len, const char *body, size_t body_len) {
+    req_aux_t *ra = r->aux;
+    char head[1024];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 %s\r\nContent-Type: %s\r\n", ra->status, ra->type);
+    if (chunked) n += snprintf(head + n, sizeof(head) - n, "Transfer-Encoding: chunked\r\n");
+    else n += snprintf(head + n, sizeof(head) - n, "Content-Length: %zu\r\n", content_len);
+    for (unsigned i = 0; i < ra->resp_hdrs && n < (int)sizeof(head); i++) {
+        n += snprintf(head + n, sizeof(head) - n, "%s: %s\r\n", ra->resp_field[i], ra->resp_value[i]);
+    }
+    n += snprintf(head + n, sizeof(head) - n, "\r\n");
+    if (n >= (int)sizeof(head)) return false;
+
+    // Cabecera y cuerpo en un solo envío (sin esperar al ACK retardado entre ambos)
+    struct iovec iov[2] = { { head, (size_t)n }, { (void *)body, body_len } };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = body_len ? 2 : 1 };
+    size_t total = (size_t)n + body_len;
+    ssize_t sent = sendmsg(ra->sess->fd, &msg, MSG_NOSIGNAL);
+    if (sent < 0) return false;
+    if ((size_t)sent < total) {
+        size_t done = (size_t)sent;
+        if (done < (size_t)n) {
+            if (!send_all(ra->sess->fd, head + done, (size_t)n - done)) return false;
+            done = (size_t)n;
+        }
+        return send_all(ra->sess->fd, body + (done - (size_t)n), total - done);
+    }
+    return true;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status) {
+    ((req_aux_t *)r->aux)->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) {
+    ((req_aux_t *)r->aux)->type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value) {
+    req_aux_t *ra = r->aux;
+    if (ra->resp_hdrs >= ra->srv->cfg.max_resp_headers || ra->resp_hdrs >= 32) return ESP_ERR_HTTPD_RESP_HDR;
+    ra->resp_field[ra->resp_hdrs] = field;
+    ra->resp_value[ra->resp_hdrs] = value;
+    ra->resp_hdrs++;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+    req_aux_t *ra = r->aux;
+    if (ra->headers_sent) return ESP_ERR_HTTPD_RESP_SEND;
+    size_t len = (buf == NULL) ? 0 : (buf_len == HTTPD_RESP_USE_STRLEN) ? strlen(buf) : (size_t)buf_len;
+    if (!send_headers(r, false, len, buf, len)) {
+        ra->failed = true;
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    ra->headers_sent = true;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+    req_aux_t *ra = r->aux;
+    size_t len = (buf == NULL) ? 0 : (buf_len == HTTPD_RESP_USE_STRLEN) ? strlen(buf) : (size_t)buf_len;
+    if (!ra->headers_sent) {
+        if (!send_headers(r, true, 0, NULL, 0)) goto fail;
+        ra->headers_sent = true;
+        ra->chunked = true;
+    } else if (!ra->chunked) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    char sz[16];
+    int n = snprintf(sz, sizeof(sz), "%zx\r\n", len);
+    struct iovec iov[3] = { { sz, (size_t)n }, { (void *)buf, len }, { "\r\n", 2 } };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 3 };
+    ssize_t sent = sendmsg(ra->sess->fd, &msg, MSG_NOSIGNAL);
+    if (sent == (ssize_t)(n + len + 2)) return ESP_OK;
+    if (sent >= 0) {
+        // Envío parcial (socket lleno): completar en orden
+        char *all = malloc((size_t)n + len + 2);
+        if (all != NULL) {
+            memcpy(all, sz, (size_t)n);
+            memcpy(all + n, buf, len);
+            memcpy(all + n + len, "\r\n", 2);
+            bool ok = send_all(ra->sess->fd, all + sent, (size_t)n + len + 2 - (size_t)sent);
+            free(all);
+            if (ok) return ESP_OK;
+        }
+    }
+fail:
+    ra->failed = true;
+    return ESP_ERR_HTTPD_RESP_SEND;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg) {
+    req_aux_t *ra = req->aux;
+    stat_add(ra->srv, &ra->srv->stats.errors);
+    ra->status = err_status(error);
+    ra->type = "text/plain";
+    return httpd_resp_send(req, msg ? msg : ra->status, HTTPD_RESP_USE_STRLEN);
+}
+
+// --- Lectura del request ---
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len) {
+    req_aux_t *ra = r->aux;
+    if (ra->body_left == 0) return 0;
+    size_t want = (buf_len < ra->body_left) ? buf_len : ra->body_left;
+    ssize_t n = sess_read(ra->sess, buf, want);
+    if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+    if (n == 0) return HTTPD_SOCK_ERR_FAIL;
+    ra->body_left -= (size_t)n;
+    return (int)n;
+}
+
+// Valor de la cabecera 'field' (sin distinguir mayúsculas), o NULL
+static const char *find_hdr(const req_aux_t *ra, const char *field, size_t *len) {
+    size_t flen = strlen(field);
+    for (const char *line = ra->hdr; *line != '\0'; ) {
+        const char *eol = strstr(line, "\r\n");
+        if (eol == NULL) eol = line + strlen(line);
+        if ((size_t)(eol - line) > flen && line[flen] == ':' && strncasecmp(line, field, flen) == 0) {
+            const char *v = line + flen + 1;
+            while (v < eol && (*v == ' ' || *v == '\t')) v++;
+            *len = (size_t)(eol - v);
+            return v;
+        }
+        line = (*eol == '\0') ? eol : eol + 2;
+    }
+    return NULL;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field) {
+    size_t len = 0;
+    return find_hdr(r->aux, field, &len) ? len : 0;
+}
+
+// Copia truncada con terminador: ESP_ERR_HTTPD_RESULT_TRUNC si no entró
+static esp_err_t copy_trunc(char *dst, size_t cap, const char *src, size_t len) {
+    if (cap == 0) return ESP_ERR_INVALID_ARG;
+    size_t n = (len < cap - 1) ? len : cap - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+    return (n < len) ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size) {
+    size_t len;
+    const char *v = find_hdr(r->aux, field, &len);
+    if (v == NULL) return ESP_ERR_NOT_FOUND;
+    return copy_trunc(val, val_size, v, len);
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r) {
+    const char *q = ((req_aux_t *)r->aux)->query;
+    return q ? strlen(q) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len) {
+    const char *q = ((req_aux_t *)r->aux)->query;
+    if (q == NULL) return ESP_ERR_NOT_FOUND;
+    return copy_trunc(buf, buf_len, q, strlen(q));
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size) {
+    size_t klen = strlen(key);
+    for (const char *p = qry; p != NULL && *p != '\0'; ) {
+        const char *amp = strchr(p, '&');
+        const char *end = amp ? amp : p + strlen(p);
+        const char *eq = memchr(p, '=', (size_t)(end - p));
+        const char *kend = eq ? eq : end;
+        if ((size_t)(kend - p) == klen && strncmp(p, key, klen) == 0) {
+            const char *v = eq ? eq + 1 : end;
+            return copy_trunc(val, val_size, v, (size_t)(end - v));
+        }
+        p = amp ? amp + 1 : NULL;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r) { return ((req_aux_t *)r->aux)->sess->fd; }
+
+// --- WebSocket ---
+
+// SHA-1 (RFC 3174), solo para Sec-WebSocket-Accept
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    size_t total = ((len + 8) / 64 + 1) * 64;
+    uint8_t *msg = calloc(1, total);
+    if (msg == NULL) return;
+    memcpy(msg, data, len);
+    msg[len] = 0x80;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) msg[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+
+    for (size_t off = 0; off < total; off += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t *b = msg + off + 4 * i;
+            w[i] = (uint32_t)b[0] << 24 | (uint32_t)b[1] << 16 | (uint32_t)b[2] << 8 | b[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = x << 1 | x >> 31;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = b << 30 | b >> 2;
+            b = a;
+            a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+    free(msg);
+    for (int i = 0; i < 20; i++) out[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+static void base64(const uint8_t *in, size_t len, char *out) {
+    static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16 | (i + 1 < len ? (uint32_t)in[i + 1] << 8 : 0) | (i + 2 < len ? in[i + 2] : 0);
+        out[o++] = tbl[v >> 18 & 63];
+        out[o++] = tbl[v >> 12 & 63];
+        out[o++] = (i + 1 < len) ? tbl[v >> 6 & 63] : '=';
+        out[o++] = (i + 2 < len) ? tbl[v & 63] : '=';
+    }
+    out[o] = '\0';
+}
+
+static bool ws_handshake(req_aux_t *ra) {
+    size_t klen;
+    const char *key = find_hdr(ra, "Sec-WebSocket-Key", &klen);
+    if (key == NULL || klen > 64) return false;
+    char src[64 + sizeof(WS_GUID)];
+    memcpy(src, key, klen);
+    memcpy(src + klen, WS_GUID, sizeof(WS_GUID));
+    uint8_t digest[20];
+    sha1((const uint8_t *)src, klen + sizeof(WS_GUID) - 1, digest);
+    char accept[32];
+    base64(digest, sizeof(digest), accept);
+
+    char resp[256];
+    int n = snprintf(resp, sizeof(resp),
+                     "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+    return send_all(ra->sess->fd, resp, (size_t)n);
+}
+
+static bool ws_send(server_t *srv, int fd, const httpd_ws_frame_t *f) {
+    uint8_t head[10];
+    size_t n = 0;
+    head[n++] = (uint8_t)((f->final || !f->fragmented ? 0x80 : 0) | (f->type & 0x0F));
+    if (f->len < 126) {
+        head[n++] = (uint8_t)f->len;
+    } else if (f->len < 65536) {
+        head[n++] = 126;
+        head[n++] = (uint8_t)(f->len >> 8);
+        head[n++] = (uint8_t)f->len;
+    } else {
+        head[n++] = 127;
+        for (int i = 7; i >= 0; i--) head[n++] = (uint8_t)((uint64_t)f->len >> (8 * i));
+    }
+    struct iovec iov[2] = { { head, n }, { f->payload, f->len } };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = f->len ? 2 : 1 };
+    ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    bool ok = sent == (ssize_t)(n + f->len) ||
+              (sent >= (ssize_t)n && send_all(fd, f->payload + (sent - (ssize_t)n), f->len - (size_t)(sent - (ssize_t)n)));
+    if (ok) stat_add(srv, &srv->stats.ws_frames_out);
+    return ok;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len) {
+    req_aux_t *ra = req->aux;
+    pkt->type = ra->ws_type;
+    pkt->final = ra->ws_final;
+    pkt->fragmented = !ra->ws_final;
+    if (max_len == 0) {         // Solo la longitud, como en ESP-IDF
+        pkt->len = ra->ws_len;
+        return ESP_OK;
+    }
+    size_t n = ra->ws_len - ra->ws_read;
+    if (n > max_len) n = max_len;
+    if (!sess_read_full(ra->sess, pkt->payload, n)) return ESP_FAIL;
+    if (ra->ws_masked) {
+        for (size_t i = 0; i < n; i++) pkt->payload[i] ^= ra->ws_mask[(ra->ws_read + i) & 3];
+    }
+    ra->ws_read += n;
+    pkt->len = n;
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt) {
+    req_aux_t *ra = req->aux;
+    return ws_send(ra->srv, ra->sess->fd, pkt) ? ESP_OK : ESP_FAIL;
+}
+
+// Solo desde la tarea del httpd (handlers y httpd_queue_work), como lo usa web_server.c
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t *frame) {
+    server_t *srv = hd;
+    sess_t *s = sess_by_fd(srv, fd);
+    if (s == NULL || !s->ws) return ESP_ERR_INVALID_ARG;
+    return ws_send(srv, fd, frame) ? ESP_OK : ESP_FAIL;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd) {
+    sess_t *s = sess_by_fd(hd, fd);
+    if (s == NULL) return HTTPD_WS_CLIENT_INVALID;
+    return s->ws ? HTTPD_WS_CLIENT_WEBSOCKET : HTTPD_WS_CLIENT_HTTP;
+}
+
+esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds, int *client_fds) {
+    server_t *srv = handle;
+    size_t n = 0;
+    for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) {
+        if (srv->sess[i].fd < 0) continue;
+        if (n >= *fds) return ESP_ERR_INVALID_ARG;
+        client_fds[n++] = srv->sess[i].fd;
+    }
+    *fds = n;
+    return ESP_OK;
+}
+
+// --- Trabajos en la tarea del httpd ---
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg) {
+    server_t *srv = handle;
+    pthread_mutex_lock(&srv->mux);
+    if (srv->work_count == WORK_QUEUE_LEN) {
+        pthread_mutex_unlock(&srv->mux);
+        return ESP_FAIL;
+    }
+    srv->work[(srv->work_head + srv->work_count++) % WORK_QUEUE_LEN] = (work_t){ work, arg };
+    pthread_mutex_unlock(&srv->mux);
+    char c = 'w';
+    return write(srv->ctrl[1], &c, 1) == 1 ? ESP_OK : ESP_FAIL;
+}
+
+typedef struct {
+    server_t *srv;
+    int fd;
+} close_req_t;
+
+static void trigger_close_work(void *arg) {
+    close_req_t *c = arg;
+    sess_t *s = sess_by_fd(c->srv, c->fd);
+    if (s != NULL) sess_close(c->srv, s);
+    free(c);
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+    close_req_t *c = malloc(sizeof(*c));
+    if (c == NULL) return ESP_ERR_NO_MEM;
+    c->srv = handle;
+    c->fd = sockfd;
+    esp_err_t err = httpd_queue_work(handle, trigger_close_work, c);
+    if (err != ESP_OK) free(c);
+    return err;
+}
+
+static void run_work(server_t *srv) {
+    char drain[64];
+    while (read(srv->ctrl[0], drain, sizeof(drain)) == (ssize_t)sizeof(drain)) {}
+    while (1) {
+        pthread_mutex_lock(&srv->mux);
+        if (srv->work_count == 0) {
+            pthread_mutex_unlock(&srv->mux);
+            return;
+        }
+        work_t w = srv->work[srv->work_head];
+        srv->work_head = (srv->work_head + 1) % WORK_QUEUE_LEN;
+        srv->work_count--;
+        srv->stats.work_items++;
+        pthread_mutex_unlock(&srv->mux);
+        w.fn(w.arg);
+    }
+}
+
+// --- Despacho ---
+
+static int parse_method(const char *m, size_t len) {
+    static const struct { const char *name; int method; } methods[] = {
+        { "GET", HTTP_GET }, { "POST", HTTP_POST }, { "PUT", HTTP_PUT }, { "PATCH", HTTP_PATCH },
+        { "DELETE", HTTP_DELETE }, { "HEAD", HTTP_HEAD }, { "OPTIONS", HTTP_OPTIONS },
+    };
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        if (strlen(methods[i].name) == len && strncmp(m, methods[i].name, len) == 0) return methods[i].method;
+    }
+    return -1;
+}
+
+static bool uri_matches(const server_t *srv, const httpd_uri_t *u, const char *path, size_t len) {
+    if (srv->cfg.uri_match_fn != NULL) return srv->cfg.uri_match_fn(u->uri, path, len);
+    return strlen(u->uri) == len && strncmp(u->uri, path, len) == 0;
+}
+
+// Error generado por el propio servidor: responde y cierra la sesión
+static void fail_request(httpd_req_t *r, httpd_err_code_t code) {
+    req_aux_t *ra = r->aux;
+    httpd_resp_send_err(r, code, NULL);
+    sess_close(ra->srv, ra->sess);
+}
+
+static void handle_ws_frame(server_t *srv, sess_t *s) {
+    httpd_req_t req = { .handle = srv, .method = 0 };
+    req_aux_t *ra = calloc(1, sizeof(*ra));
+    if (ra == NULL) return;
+    ra->srv = srv;
+    ra->sess = s;
+    req.aux = ra;
+
+    uint8_t h[2];
+    bool ok = sess_read_full(s, h, 2);
+    uint64_t len = h[1] & 0x7F;
+    if (ok && len == 126) {
+        uint8_t e[2];
+        ok = sess_read_full(s, e, 2);
+        len = (uint64_t)e[0] << 8 | e[1];
+    } else if (ok && len == 127) {
+        uint8_t e[8];
+        ok = sess_read_full(s, e, 8);
+        len = 0;
+        for (int i = 0; i < 8; i++) len = len << 8 | e[i];
+    }
+    ra->ws_masked = h[1] & 0x80;
+    if (ok && ra->ws_masked) ok = sess_read_full(s, ra->ws_mask, 4);
+    if (!ok || len > 65536) {
+        free(ra);
+        sess_close(srv, s);
+        return;
+    }
+    ra->ws_type = (httpd_ws_type_t)(h[0] & 0x0F);
+    ra->ws_final = h[0] & 0x80;
+    ra->ws_len = (size_t)len;
+
+    if (ra->ws_type == HTTPD_WS_TYPE_CLOSE || ra->ws_type == HTTPD_WS_TYPE_PING || ra->ws_type == HTTPD_WS_TYPE_PONG) {
+        // Control: los atiende el servidor (handle_ws_control_frames = false)
+        uint8_t payload[125];
+        httpd_ws_frame_t f = { .payload = payload };
+        bool read_ok = ra->ws_len <= sizeof(payload) && httpd_ws_recv_frame(&req, &f, sizeof(payload)) == ESP_OK;
+        if (ra->ws_type == HTTPD_WS_TYPE_CLOSE || !read_ok) {
+            httpd_ws_frame_t bye = { .final = true, .type = HTTPD_WS_TYPE_CLOSE };
+            ws_send(srv, s->fd, &bye);
+            sess_close(srv, s);
+        } else if (ra->ws_type == HTTPD_WS_TYPE_PING) {
+            f.type = HTTPD_WS_TYPE_PONG;
+            f.final = true;
+            ws_send(srv, s->fd, &f);
+        }
+        free(ra);
+        return;
+    }
+
+    const httpd_uri_t *u = &srv->uris[s->ws_uri];
+    req.user_ctx = u->user_ctx;
+    strncpy((char *)req.uri, u->uri, HTTPD_MAX_URI_LEN);
+    stat_add(srv, &srv->stats.requests);
+    esp_err_t err = u->handler(&req);
+    if (err != ESP_OK) {
+        stat_add(srv, &srv->stats.handler_fail);
+        sess_close(srv, s);
+    } else {
+        sess_discard(s, ra->ws_len - ra->ws_read);
+    }
+    free(ra);
+}
+
+static void handle_request(server_t *srv, sess_t *s) {
+    if (s->ws) {
+        handle_ws_frame(srv, s);
+        return;
+    }
+
+    // Cabecera completa, bloqueando hasta recv_wait_timeout como la tarea del httpd
+    size_t head_len = 0;
+    bool too_large = false;
+    while (1) {
+        char *end = memmem(s->buf, s->len, "\r\n\r\n", 4);
+        if (end != NULL) {
+            head_len = (size_t)(end - s->buf) + 4;
+            break;
+        }
+        if (s->len == sizeof(s->buf)) {
+            too_large = true;
+            break;
+        }
+        ssize_t n;
+        do {
+            n = recv(s->fd, s->buf + s->len, sizeof(s->buf) - s->len, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n <= 0) {
+            bool timeout = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && s->len > 0;
+            if (!timeout) {         // El cliente cerró (o error): sin respuesta
+                sess_close(srv, s);
+                return;
+            }
+            break;                  // Cabecera incompleta: 408
+        }
+        s->len += (size_t)n;
+    }
+
+    httpd_req_t req = { .handle = srv };
+    req_aux_t *ra = calloc(1, sizeof(*ra));
+    if (ra == NULL) {
+        sess_close(srv, s);
+        return;
+    }
+    ra->srv = srv;
+    ra->sess = s;
+    ra->status = "200 OK";
+    ra->type = "text/html";
+    req.aux = ra;
+
+    if (head_len == 0) {
+        fail_request(&req, too_large ? HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE : HTTPD_408_REQ_TIMEOUT);
+        free(ra);
+        return;
+    }
+
+    // Línea del request: MÉTODO URI HTTP/1.x
+    char *line_end = memmem(s->buf, head_len, "\r\n", 2);
+    char *sp1 = memchr(s->buf, ' ', (size_t)(line_end - s->buf));
+    char *sp2 = sp1 ? memchr(sp1 + 1, ' ', (size_t)(line_end - sp1 - 1)) : NULL;
+    size_t hdr_len = head_len - (size_t)(line_end + 2 - s->buf) - 2;
+    httpd_err_code_t bad = HTTPD_ERR_CODE_MAX;
+    if (sp1 == NULL || sp2 == NULL) bad = HTTPD_400_BAD_REQUEST;
+    else if ((size_t)(sp2 - sp1 - 1) > HTTPD_MAX_URI_LEN) bad = HTTPD_414_URI_TOO_LONG;
+    else if (hdr_len > HTTPD_MAX_REQ_HDR_LEN) bad = HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE;
+    else if ((req.method = parse_method(s->buf, (size_t)(sp1 - s->buf))) < 0) bad = HTTPD_501_METHOD_NOT_IMPLEMENTED;
+    if (bad != HTTPD_ERR_CODE_MAX) {
+        fail_request(&req, bad);
+        free(ra);
+        return;
+    }
+    memcpy((char *)req.uri, sp1 + 1, (size_t)(sp2 - sp1 - 1));
+    memcpy(ra->hdr, line_end + 2, hdr_len);
+    char *q = strchr(req.uri, '?');
+    ra->query = q ? q + 1 : NULL;
+    size_t path_len = q ? (size_t)(q - req.uri) : strlen(req.uri);
+
+    size_t cl_len;
+    const char *cl = find_hdr(ra, "Content-Length", &cl_len);
+    req.content_len = cl ? strtoul(cl, NULL, 10) : 0;
+    ra->body_left = req.content_len;
+
+    memmove(s->buf, s->buf + head_len, s->len - head_len);
+    s->len -= head_len;
+    s->lru = ++srv->lru_counter;
+
+    // Handler por URI y método (405 si la URI existe con otro método)
+    int found = -1;
+    bool uri_known = false;
+    for (unsigned i = 0; i < srv->uri_count; i++) {
+        if (!uri_matches(srv, &srv->uris[i], req.uri, path_len)) continue;
+        uri_known = true;
+        if ((int)srv->uris[i].method == req.method) {
+            found = (int)i;
+            break;
+        }
+    }
+    if (found < 0) {
+        httpd_resp_send_err(&req, uri_known ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND, NULL);
+        sess_discard(s, ra->body_left);
+        if (ra->failed) sess_close(srv, s);
+        free(ra);
+        return;
+    }
+
+    const httpd_uri_t *u = &srv->uris[found];
+    req.user_ctx = u->user_ctx;
+    if (u->is_websocket) {
+        size_t up_len;
+        const char *up = find_hdr(ra, "Upgrade", &up_len);
+        if (up == NULL || strncasecmp(up, "websocket", 9) != 0 || !ws_handshake(ra)) {
+            fail_request(&req, HTTPD_400_BAD_REQUEST);
+            free(ra);
+            return;
+        }
+        s->ws = true;
+        s->ws_uri = found;
+    }
+
+    stat_add(srv, &srv->stats.requests);
+    esp_err_t err = u->handler(&req);
+    if (err != ESP_OK || ra->failed) {
+        // Como ESP-IDF: un handler que falla cierra la sesión
+        stat_add(srv, &srv->stats.handler_fail);
+        sess_close(srv, s);
+    } else {
+        sess_discard(s, ra->body_left);
+    }
+    free(ra);
+}
+
+static void accept_conn(server_t *srv) {
+    if (sess_open_count(srv) == srv->cfg.max_open_sockets && srv->cfg.lru_purge_enable) {
+        sess_t *oldest = NULL;
+        for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) {
+            sess_t *s = &srv->sess[i];
+            if (s->fd >= 0 && (oldest == NULL || s->lru < oldest->lru)) oldest = s;
+        }
+        sess_close(srv, oldest);
+        stat_add(srv, &srv->stats.lru_purged);
+    }
+
+    int fd = accept(srv->listen_fd, NULL, NULL);
+    if (fd < 0) return;
+    sess_t *slot = sess_by_fd(srv, -1);
+    if (slot == NULL) {
+        // Sin lugar y sin LRU: ESP-IDF acepta y cierra (el cliente ve un reset)
+        close(fd);
+        stat_add(srv, &srv->stats.rejected);
+        return;
+    }
+
+    struct timeval rcv = { .tv_sec = srv->cfg.recv_wait_timeout };
+    struct timeval snd = { .tv_sec = srv->cfg.send_wait_timeout };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rcv, sizeof(rcv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+    // Sin Nagle: se mide el servidor, no el ACK retardado del kernel de Linux
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if (srv->cfg.open_fn != NULL && srv->cfg.open_fn(srv, fd) != ESP_OK) {
+        close(fd);
+        return;
+    }
+    slot->fd = fd;
+    slot->ws = false;
+    slot->len = 0;
+    slot->lru = ++srv->lru_counter;
+
+    pthread_mutex_lock(&srv->mux);
+    srv->stats.accepted++;
+    unsigned open = sess_open_count(srv);
+    if (open > srv->stats.open_max) srv->stats.open_max = open;
+    pthread_mutex_unlock(&srv->mux);
+}
+
+static void *server_task(void *arg) {
+    server_t *srv = arg;
+    while (!srv->stop) {
+        fd_set rd;
+        FD_ZERO(&rd);
+        FD_SET(srv->listen_fd, &rd);
+        FD_SET(srv->ctrl[0], &rd);
+        int maxfd = srv->listen_fd > srv->ctrl[0] ? srv->listen_fd : srv->ctrl[0];
+        bool pending = false;
+        for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) {
+            sess_t *s = &srv->sess[i];
+            if (s->fd < 0) continue;
+            FD_SET(s->fd, &rd);
+            if (s->fd > maxfd) maxfd = s->fd;
+            pending |= s->len > 0;      // Request ya recibido (pipelining)
+        }
+        struct timeval zero = { 0 };
+        if (select(maxfd + 1, &rd, NULL, NULL, pending ? &zero : NULL) < 0) {
+            if (errno == EINTR) continue;
+            ESP_LOGE(TAG, "select: %s", strerror(errno));
+            break;
+        }
+        if (FD_ISSET(srv->ctrl[0], &rd)) run_work(srv);
+        for (unsigned i = 0; i < srv->cfg.max_open_sockets && !srv->stop; i++) {
+            sess_t *s = &srv->sess[i];
+            if (s->fd >= 0 && (FD_ISSET(s->fd, &rd) || s->len > 0)) handle_request(srv, s);
+        }
+        if (FD_ISSET(srv->listen_fd, &rd)) accept_conn(srv);
+    }
+    return NULL;
+}
+
+// --- Ciclo de vida ---
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config) {
+    server_t *srv = calloc(1, sizeof(*srv));
+    if (srv == NULL) return ESP_ERR_HTTPD_ALLOC_MEM;
+    srv->cfg = *config;
+    if (httpd_shim_config_hook != NULL) httpd_shim_config_hook(&srv->cfg);
+    config = &srv->cfg;
+    srv->uris = calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+    srv->sess = calloc(config->max_open_sockets, sizeof(sess_t));
+    pthread_mutex_init(&srv->mux, NULL);
+    if (srv->uris == NULL || srv->sess == NULL || pipe(srv->ctrl) != 0) goto fail;
+    fcntl(srv->ctrl[0], F_SETFL, O_NONBLOCK);
+    for (unsigned i = 0; i < config->max_open_sockets; i++) srv->sess[i].fd = -1;
+
+    srv->listen_fd = socket(AF_INET6, SOCK_STREAM, 0);
+    int one = 1, zero = 0;
+    setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(srv->listen_fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+    struct sockaddr_in6 addr = { .sin6_family = AF_INET6, .sin6_port = htons(config->server_port), .sin6_addr = in6addr_any };
+    if (srv->listen_fd < 0 || bind(srv->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(srv->listen_fd, config->backlog_conn) != 0) {
+        ESP_LOGE(TAG, "puerto %u: %s", config->server_port, strerror(errno));
+        goto fail;
+    }
+    if (pthread_create(&srv->thread, NULL, server_task, srv) != 0) goto fail;
+    *handle = srv;
+    last_server = srv;
+    return ESP_OK;
+
+fail:
+    if (srv->listen_fd > 0) close(srv->listen_fd);
+    free(srv->uris);
+    free(srv->sess);
+    free(srv);
+    return ESP_ERR_HTTPD_TASK;
+}
+
+static void stop_work(void *arg) { ((server_t *)arg)->stop = true; }
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+    server_t *srv = handle;
+    if (httpd_queue_work(srv, stop_work, srv) != ESP_OK) return ESP_FAIL;
+    pthread_join(srv->thread, NULL);
+    for (unsigned i = 0; i < srv->cfg.max_open_sockets; i++) sess_close(srv, &srv->sess[i]);
+    close(srv->listen_fd);
+    close(srv->ctrl[0]);
+    close(srv->ctrl[1]);
+    free(srv->uris);
+    free(srv->sess);
+    free(srv);
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler) {
+    server_t *srv = handle;
+    for (unsigned i = 0; i < srv->uri_count; i++) {
+        if (srv->uris[i].method == uri_handler->method && strcmp(srv->uris[i].uri, uri_handler->uri) == 0) {
+            return ESP_ERR_HTTPD_HANDLER_EXISTS;
+        }
+    }
+    if (srv->uri_count == srv->cfg.max_uri_handlers) {
+        ESP_LOGW(TAG, "sin lugar para %s (max_uri_handlers = %u)", uri_handler->uri, srv->cfg.max_uri_handlers);
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    srv->uris[srv->uri_count++] = *uri_handler;
+    return ESP_OK;
+}
+
+void httpd_shim_get_stats(httpd_handle_t handle, httpd_shim_stats_t *out) {
+    server_t *srv = handle;
+    pthread_mutex_lock(&srv->mux);
+    *out = srv->stats;
+    pthread_mutex_unlock(&srv->mux);
+}
+
+httpd_handle_t httpd_shim_last_server(void) { return last_server; }
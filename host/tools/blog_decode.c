@@ -0,0 +1,106 @@
+// Decodificador de Linux del log binario (core/blog.c).
+//
+// Lee una captura de la consola del firmware compilado con
+// BLOG_DRAIN_BINARY=1 (idf.py monitor | tee consola.txt, o el puerto serie
+// directo) y reemplaza cada línea "BLOG,<hex>" por el mensaje formateado con
+// el catálogo BLOG_MESSAGES, con el mismo aspecto que ESP_LOGx:
+//     I (12345) TASK_CONTROL: Zona 0 | Mode: 2 | Temp: 24.3 | ...
+// Las demás líneas pasan sin cambios (salvo --only). Las líneas "BLOG,V,<hash>"
+// se verifican contra el catálogo compilado acá: si no coincide, el firmware
+// es de otra versión y los IDs pueden no corresponder.
+//
+// Uso: blog_decode [archivo | -] [--only] [--stats]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blog.h"
+
+static int hexval(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parse_record(const char *hex, blog_record_t *r) {
+    uint8_t *p = (uint8_t *)r;
+    for (size_t i = 0; i < sizeof(*r); i++) {
+        int hi = hexval(hex[2 * i]), lo = (hi < 0) ? -1 : hexval(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        p[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *path = "-";
+    bool only = false, stats = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--only") == 0) only = true;
+        else if (strcmp(argv[i], "--stats") == 0) stats = true;
+        else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) path = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [archivo | -] [--only] [--stats]\n", argv[0]);
+            return 2;
+        }
+    }
+    FILE *f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+
+    static const char letters[] = "NEWIDV";
+    uint32_t catalog = blog_catalog_hash();
+    uint64_t count[BLOG_MSG_COUNT] = {0}, repeats[BLOG_MSG_COUNT] = {0};
+    uint64_t records = 0, bad = 0;
+    bool mismatch_reported = false;
+    char line[512], text[256];
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        const char *p = strstr(line, "BLOG,");
+        if (p == NULL) {
+            if (!only && !stats) fputs(line, stdout);
+            continue;
+        }
+        p += 5;
+        if (strncmp(p, "V,", 2) == 0) {
+            uint32_t fw = (uint32_t)strtoul(p + 2, NULL, 16);
+            if (fw != catalog && !mismatch_reported) {
+                fprintf(stderr, "aviso: catálogo del firmware %08x, el de esta herramienta es %08x\n", fw, catalog);
+                mismatch_reported = true;
+            }
+            continue;
+        }
+
+        blog_record_t r;
+        if (strlen(p) < 2 * sizeof(r) || !parse_record(p, &r)) {
+            bad++;
+            continue;
+        }
+        records++;
+        if (r.id < BLOG_MSG_COUNT) {
+            count[r.id]++;
+            repeats[r.id] += r.repeats;
+        }
+        if (stats) continue;
+
+        blog_format(text, sizeof(text), &r);
+        const blog_msg_info_t *m = (r.id < BLOG_MSG_COUNT) ? &blog_msgs[r.id] : NULL;
+        printf("%c (%lld) %s: %s\n", m ? letters[m->level] : '?', (long long)(r.ts_us / 1000),
+               m ? m->tag : "BLOG", text);
+    }
+    if (f != stdin) fclose(f);
+
+    if (stats) {
+        printf("%llu records, %llu malformed, catalog %08x\n",
+               (unsigned long long)records, (unsigned long long)bad, catalog);
+        for (int i = 0; i < BLOG_MSG_COUNT; i++) {
+            if (count[i] == 0) continue;
+            printf("%8llu (+%llu repeated)  %s: %s\n", (unsigned long long)count[i],
+                   (unsigned long long)repeats[i], blog_msgs[i].tag, blog_msgs[i].fmt);
+        }
+    }
+    return bad ? 1 : 0;
+}
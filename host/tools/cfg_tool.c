@@ -0,0 +1,199 @@
+// Lee y escribe el blob de configuración versionado (core/config_codec.c),
+// el mismo que el firmware guarda en NVS (namespace "vent_config", clave
+// "cfg") y que sirve GET /api/config?format=bin.
+//
+//   cfg_tool dump <blob>                 cabecera, registros y la config
+//                                        como JSON (el de GET /api/config,
+//                                        sirve de cuerpo para PUT)
+//   cfg_tool defaults <blob>             escribe la config de fábrica
+//   cfg_tool set <blob> clave=valor ...  cambia campos y reescribe el blob
+//
+// Claves: las de /api/config ("hold", "power", ...), "zones.N.<campo>" y
+// "schedules.N.<campo>" (N = cantidad actual agrega una regla). El resultado
+// se valida con config_check antes de escribir, como en el firmware.
+//
+// Para grabar un blob de fábrica sin pasar por la web, con el generador de
+// particiones NVS de ESP-IDF y un CSV como:
+//     key,type,encoding,value
+//     vent_config,namespace,,
+//     cfg,file,binary,cfg.bin
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config_codec.h"
+#include "config_check.h"
+#include "status_json.h"
+
+static size_t read_file(const char *path, uint8_t *buf, size_t cap) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        exit(2);
+    }
+    size_t n = fread(buf, 1, cap, f);
+    fclose(f);
+    return n;
+}
+
+static void write_blob(const char *path, const system_config_t *cfg) {
+    int index;
+    const char *bad = config_check(cfg, &index);
+    if (bad != NULL) {
+        fprintf(stderr, "valor inválido: %s", bad);
+        if (index >= 0) fprintf(stderr, " [%d]", index);
+        fprintf(stderr, "\n");
+        exit(1);
+    }
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t len = config_encode(cfg, blob, sizeof(blob));
+    FILE *f = fopen(path, "wb");
+    if (f == NULL || len == 0 || fwrite(blob, 1, len, f) != len) {
+        fprintf(stderr, "No se pudo escribir %s\n", path);
+        exit(2);
+    }
+    fclose(f);
+    printf("%s: %zu bytes (esquema %d, raw %zu bytes)\n", path, len, CONFIG_SCHEMA, sizeof(system_config_t));
+}
+
+static int flush_stdout(void *ctx, const char *data, size_t len) {
+    (void)ctx;
+    return fwrite(data, 1, len, stdout) == len ? 0 : -1;
+}
+
+// Registros de primer nivel: tag, largo y nombre si se conoce
+static void dump_records(const uint8_t *blob, size_t len) {
+    size_t body = blob[6] | (size_t)blob[7] << 8;
+    const uint8_t *p = blob + CONFIG_HEADER_SIZE, *end = p + body;
+    if (CONFIG_HEADER_SIZE + body > len) return;
+    unsigned zones = 0, rules = 0;
+    while (end - p >= 2 && end - p - 2 >= p[1]) {
+        const char *name = "?";
+        if (p[0] == CONFIG_TAG_ZONE) {
+            name = "zona";
+            zones++;
+        } else if (p[0] == CONFIG_TAG_SCHEDULE) {
+            name = "regla";
+            rules++;
+        } else {
+            for (size_t i = 0; i < config_global_field_count; i++) {
+                if (config_global_fields[i].tag == p[0]) name = config_global_fields[i].name;
+            }
+        }
+        if (p[0] != CONFIG_TAG_ZONE && p[0] != CONFIG_TAG_SCHEDULE) {
+            fprintf(stderr, "  tag 0x%02x %-10s %u bytes\n", p[0], name, p[1]);
+        }
+        p += 2 + p[1];
+    }
+    fprintf(stderr, "  %u zonas, %u reglas\n", zones, rules);
+}
+
+static int cmd_dump(const char *path) {
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t len = read_file(path, blob, sizeof(blob));
+    system_config_t cfg;
+    config_decode_info_t info;
+    config_decode_err_t err = config_decode(blob, len, &cfg, &info);
+    fprintf(stderr, "%s: %zu bytes, esquema %u, %s", path, len, info.schema, config_decode_err_name(err));
+    if (info.unknown || info.dropped) fprintf(stderr, ", %u registros desconocidos, %u descartados", info.unknown, info.dropped);
+    fprintf(stderr, "\n");
+    if (err != CONFIG_DECODE_OK) return 1;
+    dump_records(blob, len);
+
+    char buf[1024];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), flush_stdout, NULL);
+    config_json_write(&w, &cfg);
+    json_writer_finish(&w);
+    printf("\n");
+
+    int index;
+    const char *bad = config_check(&cfg, &index);
+    if (bad != NULL) {
+        fprintf(stderr, "fuera de rango: %s [%d] (el firmware lo descartaría)\n", bad, index);
+        return 1;
+    }
+    return 0;
+}
+
+static const config_field_t *find(const config_field_t *fields, size_t n, const char *name) {
+    for (size_t i = 0; i < n; i++) {
+        if (strcmp(fields[i].name, name) == 0) return &fields[i];
+    }
+    return NULL;
+}
+
+// "clave=valor" sobre cfg; false si la clave no existe o el valor no entra
+static bool set_one(system_config_t *cfg, const char *arg) {
+    char key[64];
+    const char *eq = strchr(arg, '=');
+    if (eq == NULL || (size_t)(eq - arg) >= sizeof(key)) return false;
+    memcpy(key, arg, (size_t)(eq - arg));
+    key[eq - arg] = '\0';
+    char *end;
+    double v = strtod(eq + 1, &end);
+    if (end == eq + 1 || *end != '\0') {
+        if (strcmp(eq + 1, "true") == 0) v = 1;
+        else if (strcmp(eq + 1, "false") == 0) v = 0;
+        else return false;
+    }
+
+    unsigned idx;
+    char field[32];
+    if (sscanf(key, "zones.%u.%31s", &idx, field) == 2) {
+        const config_field_t *f = find(config_zone_fields, config_zone_field_count, field);
+        return f != NULL && idx < MAX_ZONES && config_field_set(f, &cfg->zones[idx], v);
+    }
+    if (sscanf(key, "schedules.%u.%31s", &idx, field) == 2) {
+        const config_field_t *f = find(config_schedule_fields, config_schedule_field_count, field);
+        if (f == NULL || idx > cfg->schedule_count || idx >= MAX_SCHEDULES) return false;
+        if (idx == cfg->schedule_count) {
+            // Regla nueva: como las de la interfaz
+            cfg->schedules[idx] = (schedule_reg_t){ .days = DAYS_ALL, .end_hour = 23, .end_min = 59,
+                                                    .temp_min_0_percent = 23.0f, .temp_max_100_percent = 26.0f };
+            cfg->schedule_count++;
+        }
+        return config_field_set(f, &cfg->schedules[idx], v);
+    }
+    const config_field_t *f = find(config_global_fields, config_global_field_count, key);
+    return f != NULL && config_field_set(f, cfg, v);
+}
+
+static int cmd_set(const char *path, int argc, char **argv) {
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t len = read_file(path, blob, sizeof(blob));
+    system_config_t cfg;
+    config_decode_err_t err = config_decode(blob, len, &cfg, NULL);
+    if (err != CONFIG_DECODE_OK) {
+        fprintf(stderr, "%s: %s\n", path, config_decode_err_name(err));
+        return 1;
+    }
+    for (int i = 0; i < argc; i++) {
+        if (!set_one(&cfg, argv[i])) {
+            fprintf(stderr, "clave o valor inválido: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    cfg.version++;   // Como un cambio publicado desde la web
+    write_blob(path, &cfg);
+    return 0;
+}
+
+static void usage(void) {
+    fprintf(stderr, "uso: cfg_tool dump <blob>\n"
+                    "     cfg_tool defaults <blob>\n"
+                    "     cfg_tool set <blob> clave=valor ...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) usage();
+    if (strcmp(argv[1], "dump") == 0) return cmd_dump(argv[2]);
+    if (strcmp(argv[1], "defaults") == 0) {
+        write_blob(argv[2], &default_system_config);
+        return 0;
+    }
+    if (strcmp(argv[1], "set") == 0 && argc > 3) return cmd_set(argv[2], argc - 3, argv + 3);
+    usage();
+    return 2;
+}
@@ -0,0 +1,84 @@
+// Autotune offline del modo PID (core/pid_autotune.c) contra la planta del
+// mock de HAL (core/thermal_plant.c), con los parámetros por defecto o los
+// que se pasen. Imprime Ku/Tu, las ganancias PI sugeridas y el cuerpo listo
+// para POST /api/settings. --pid agrega la fila del PID completo, solo como
+// referencia: con el ruido del sensor de esta planta la derivada hace cazar
+// al ventilador (bench_controllers: ~16600 cambios de PWM en 8 h contra ~680
+// del PI).
+//
+// Uso: pid_autotune [--setpoint C] [--ambient C] [--gain C] [--tau S] [--dead S]
+//                   [--hyst C] [--low PWM] [--high PWM] [--pid] [--trace]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pid_autotune.h"
+#include "thermal_plant.h"
+
+int main(int argc, char **argv) {
+    thermal_plant_params_t pp = thermal_plant_default_params;
+    pid_params_t pid = default_system_config.zones[0].pid;
+    float hyst = 0.1f;
+    int low = 0, high = 100;
+    bool trace = false;
+    bool with_pid = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--setpoint") == 0 && i + 1 < argc) pid.setpoint_c = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--ambient") == 0 && i + 1 < argc) pp.ambient_c = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--gain") == 0 && i + 1 < argc) pp.fan_gain_c = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--tau") == 0 && i + 1 < argc) pp.tau_s = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--dead") == 0 && i + 1 < argc) pp.dead_time_s = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--hyst") == 0 && i + 1 < argc) hyst = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--low") == 0 && i + 1 < argc) low = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--high") == 0 && i + 1 < argc) high = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pid") == 0) with_pid = true;
+        else if (strcmp(argv[i], "--trace") == 0) trace = true;
+        else {
+            fprintf(stderr, "uso: %s [--setpoint C] [--ambient C] [--gain C] [--tau S] [--dead S] "
+                            "[--hyst C] [--low PWM] [--high PWM] [--pid] [--trace]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (low < 0 || high > 100 || low >= high || pp.tau_s <= 0.0f || pp.step_s <= 0.0f) {
+        fprintf(stderr, "Parámetros inválidos\n");
+        return 2;
+    }
+
+    thermal_plant_t plant;
+    thermal_plant_init(&plant, &pp, 1);
+    pid_autotune_t at;
+    pid_autotune_init(&at, pid.setpoint_c, hyst, (uint32_t)low, (uint32_t)high);
+
+    float t = 0.0f;
+    uint32_t pwm = 0;
+    while (at.status == PID_AUTOTUNE_RUNNING) {
+        float temp = thermal_plant_measure(&plant);
+        pwm = pid_autotune_step(&at, temp, t);
+        if (trace) printf("%.0f,%.3f,%u\n", t, temp, pwm);
+        thermal_plant_step(&plant, pwm);
+        t += pp.step_s;
+    }
+
+    if (at.status != PID_AUTOTUNE_DONE) {
+        fprintf(stderr, "Sin oscilación en %d s: la consigna %.2f °C no es alcanzable con PWM %d-%d "
+                        "(equilibrio %.2f-%.2f °C)\n", PID_AUTOTUNE_MAX_S, pid.setpoint_c, low, high,
+                pp.ambient_c - pp.fan_gain_c * high / 100.0f, pp.ambient_c - pp.fan_gain_c * low / 100.0f);
+        return 1;
+    }
+
+    printf("plant: ambient=%.1f gain=%.1f tau=%.0f dead=%.0f noise=%.2f\n",
+           pp.ambient_c, pp.fan_gain_c, pp.tau_s, pp.dead_time_s, pp.noise_c);
+    printf("relay: setpoint=%.2f hyst=%.2f pwm %d/%d -> Ku=%.2f %%/°C Tu=%.0f s (%.0f s of tuning)\n",
+           pid.setpoint_c, hyst, low, high, at.ku, at.tu, t);
+    for (int d = 0; d <= (with_pid ? 1 : 0); d++) {
+        pid_autotune_result(&at, d, &pid);
+        printf("%-3s kp=%.2f ki=%.4f kd=%.1f  {\"pid_sp\":%.2f,\"pid_kp\":%.2f,\"pid_ki\":%.4f,\"pid_kd\":%.1f}\n",
+               d ? "PID" : "PI", pid.kp, pid.ki, pid.kd, pid.setpoint_c, pid.kp, pid.ki, pid.kd);
+    }
+    if (with_pid) {
+        printf("aviso: la derivada amplifica el ruido del sensor (%.2f °C) y el ventilador caza; "
+               "comparar con bench_controllers antes de usar la fila PID\n", pp.noise_c);
+    }
+    return 0;
+}
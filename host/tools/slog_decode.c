@@ -0,0 +1,107 @@
+// Decodificador de Linux del log persistente de sensores.
+//
+// Acepta un volcado crudo de la partición "senslog"
+//     esptool.py read_flash 0x190000 0x100000 senslog.bin
+// o la descarga de GET /api/log (mismo formato: bloques de 4 KB). Ordena los
+// bloques por número de secuencia y emite CSV en el formato de traza de
+// bench_control (epoch,temp_c,presence,pwm), así el log se puede reproducir
+// directamente con el benchmark. Sin temperatura válida se imprime el
+// sentinela del firmware (-99).
+//
+// Uso: slog_decode <archivo> [--from EPOCH] [--to EPOCH] [--stats]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sensor_log_codec.h"
+#include "ntc_convert.h"
+
+typedef struct {
+    uint32_t seq;
+    size_t offset;
+} block_ref_t;
+
+typedef struct {
+    int64_t from;
+    int64_t to;
+    size_t printed;
+    bool quiet;
+} emit_ctx_t;
+
+static int cmp_seq(const void *a, const void *b) {
+    uint32_t x = ((const block_ref_t *)a)->seq, y = ((const block_ref_t *)b)->seq;
+    return (x > y) - (x < y);
+}
+
+static void emit(void *ctx, const slog_record_t *rec) {
+    emit_ctx_t *e = (emit_ctx_t *)ctx;
+    if (rec->ts < e->from || rec->ts > e->to) return;
+    e->printed++;
+    if (e->quiet) return;
+    double temp = (rec->temp_c100 == SLOG_NO_TEMP) ? NTC_INVALID_CELSIUS : rec->temp_c100 / 100.0;
+    printf("%lld,%.2f,%d,%u\n", (long long)rec->ts, temp, rec->presence, rec->pwm);
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    emit_ctx_t ctx = { .from = INT64_MIN, .to = INT64_MAX };
+    bool stats = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) ctx.from = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) ctx.to = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--stats") == 0) stats = true;
+        else path = argv[i];
+    }
+    if (path == NULL) {
+        fprintf(stderr, "uso: %s <senslog.bin> [--from EPOCH] [--to EPOCH] [--stats]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(size > 0 ? (size_t)size : 1);
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        fprintf(stderr, "No se pudo leer %s\n", path);
+        return 2;
+    }
+    fclose(f);
+
+    size_t nblocks = (size_t)size / SLOG_BLOCK_SIZE;
+    block_ref_t *refs = malloc((nblocks ? nblocks : 1) * sizeof(*refs));
+    size_t valid = 0;
+    for (size_t i = 0; i < nblocks; i++) {
+        slog_block_header_t hdr;
+        if (slog_header_read(&data[i * SLOG_BLOCK_SIZE], &hdr)) {
+            refs[valid].seq = hdr.seq;
+            refs[valid].offset = i * SLOG_BLOCK_SIZE;
+            valid++;
+        }
+    }
+    qsort(refs, valid, sizeof(*refs), cmp_seq);
+
+    ctx.quiet = stats;
+    if (!stats) printf("# epoch,temp_c,presence,pwm\n");
+    size_t records = 0, bytes = 0;
+    for (size_t i = 0; i < valid; i++) {
+        size_t used = 0;
+        records += slog_decode_block(&data[refs[i].offset], SLOG_BLOCK_SIZE, emit, &ctx, &used, NULL);
+        bytes += used;
+    }
+
+    if (stats) {
+        printf("blocks=%zu/%zu records=%zu in_range=%zu bytes=%zu (%.2f B/record)\n",
+               valid, nblocks, records, ctx.printed, bytes, records ? (double)bytes / records : 0.0);
+        if (valid > 0) {
+            printf("seq=%u..%u\n", refs[0].seq, refs[valid - 1].seq);
+        }
+    }
+    free(refs);
+    free(data);
+    return 0;
+}
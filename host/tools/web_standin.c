@@ -0,0 +1,272 @@
+// Servidor web de reemplazo: main/web/web_server.c y tasks/metrics.c tal cual,
+// compilados en Linux sobre host/shim (httpd de ESP-IDF, FreeRTOS, esp_timer
+// y esp_log sobre POSIX). Sirve de blanco local para bench_http sin un ESP32.
+//
+// Arma el app_context_t como main.c (config por defecto, historial, mutex de
+// config/horario/historial) y por cada zona un hilo que imita a ControlTask:
+// toma el mutex del horario para decidir con control_decide, publica el
+// estado, avisa al push por WebSocket y, en la zona 0, agrega al historial.
+// Lo que no existe en host (NVS, log en flash, energía, log binario, WiFi) queda
+// con stubs que solo cuentan.
+//
+// Uso: web_standin [--port N] [--max-sockets N] [--backlog N] [--lru 0|1]
+//                  [--recv-timeout S] [--zones N] [--rate HZ] [--duration S]
+// Al terminar (--duration o Ctrl-C) imprime los contadores del servidor y la
+// espera/retención de cada mutex.
+#define _GNU_SOURCE
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_http_server.h"
+#include "zone.h"
+#include "power_manager.h"
+#include "net_manager.h"
+#include "control_logic.h"
+#include "blog.h"
+
+esp_err_t start_web_server(app_context_t *ctx);
+
+// --- Stubs de lo que no hay en host ---
+
+static atomic_uint save_requests;
+
+void config_manager_request_save(void) { atomic_fetch_add(&save_requests, 1); }
+
+void config_manager_get_stats(config_store_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->requests = atomic_load(&save_requests);
+}
+
+void sensor_log_get_stats(sensor_log_stats_t *out) { memset(out, 0, sizeof(*out)); }
+
+esp_err_t sensor_log_export(int64_t from, int64_t to, sensor_log_sink_fn sink, void *ctx) {
+    (void)from; (void)to; (void)sink; (void)ctx;
+    return ESP_ERR_NOT_FOUND;   // Como un firmware sin partición de log
+}
+
+void power_manager_get_stats(power_stats_t *out) { memset(out, 0, sizeof(*out)); }
+void power_lock_acquire(power_lock_id_t id) { (void)id; }
+void power_lock_release(power_lock_id_t id) { (void)id; }
+
+const char *power_lock_name(power_lock_id_t id) {
+    static const char *const names[POWER_LOCK_COUNT] = { "fan", "adc", "http" };
+    return (id < POWER_LOCK_COUNT) ? names[id] : "?";
+}
+
+void blog_get_stats(uint32_t *written, uint32_t *dropped, uint32_t *suppressed) {
+    *written = *dropped = *suppressed = 0;
+}
+
+// Sin WiFi: el servidor ya escucha cuando main() lo arranca
+static uint32_t web_ms;
+
+void net_manager_get_stats(net_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->state = NET_CONNECTED;
+    out->web_ms = web_ms;
+}
+
+const char *net_state_name(net_state_t s) { return s == NET_CONNECTED ? "connected" : "?"; }
+
+void sensor_task_get_stats(zone_t *zone, sensor_loop_stats_t *out) {
+    taskENTER_CRITICAL(&zone->stats_mux);
+    *out = zone->sensor_stats;
+    taskEXIT_CRITICAL(&zone->stats_mux);
+}
+
+void control_task_get_stats(zone_t *zone, control_loop_stats_t *out) {
+    taskENTER_CRITICAL(&zone->stats_mux);
+    *out = zone->control_stats;
+    taskEXIT_CRITICAL(&zone->stats_mux);
+}
+
+// --- Contexto (como main.c) ---
+
+static app_context_t app_ctx;
+static system_config_t config_slots[2];
+static snapshot_t config_snap;
+static history_t history;
+static schedule_index_t schedule;
+static zone_t zones[MAX_ZONES];
+static pthread_t zone_threads[MAX_ZONES];
+static volatile sig_atomic_t running = 1;
+static unsigned rate_hz = 1;
+
+// Lazo de una zona: lo que hace task_control.c con cada muestra
+static void *zone_loop(void *arg) {
+    zone_t *zone = arg;
+    app_context_t *ctx = zone->app;
+    control_state_t st;
+    control_state_reset(&st);
+    system_config_t cfg;
+    system_state_t state = {0};
+    int64_t period_us = 1000000 / rate_hz;
+
+    for (uint32_t n = 0; running; n++) {
+        int64_t t0 = esp_timer_get_time();
+        time_t now = time(NULL);
+        struct tm tm;
+        localtime_r(&now, &tm);
+
+        sensor_data_t data = {
+            .temperature = 24.0f + 2.0f * sinf((float)n / 60.0f + zone->id),
+            .presence_detected = (n / 30) % 2,
+            .timestamp = t0,
+            .temp_quality = TEMP_QUALITY_GOOD,
+            .reason = SAMPLE_PERIODIC,
+            .due_us = t0,
+        };
+        uint32_t version = snapshot_read(ctx->config_snap, &cfg);
+
+        app_lock_take(ctx, METRIC_LOCK_SCHEDULE, ctx->schedule_mutex);
+        if ((int32_t)(version - ctx->schedule_version) > 0) {
+            schedule_index_compile(ctx->schedule, &cfg);
+            ctx->schedule_version = version;
+        }
+        control_decision_t d = control_decide(&cfg.zones[zone->id], ctx->schedule, &st, &data, &tm, true);
+        app_lock_give(ctx, METRIC_LOCK_SCHEDULE, ctx->schedule_mutex);
+
+        int64_t done = esp_timer_get_time();
+        taskENTER_CRITICAL(&zone->stats_mux);
+        zone->sensor_stats.checks++;
+        zone->sensor_stats.samples[SAMPLE_PERIODIC]++;
+        zone->sensor_stats.period_ms = (uint32_t)(period_us / 1000);
+        latency_hist_record(&zone->control_stats.latency[SAMPLE_PERIODIC], (uint32_t)(done - t0));
+        if (zone->control_stats.first_duty_ms == 0) zone->control_stats.first_duty_ms = (uint32_t)(done / 1000) + 1;
+        taskEXIT_CRITICAL(&zone->stats_mux);
+
+        state.current_temp = data.temperature;
+        state.temp_quality = data.temp_quality;
+        state.presence = data.presence_detected;
+        state.current_pwm = d.pwm;
+        strftime(state.current_time_str, sizeof(state.current_time_str), "%H:%M:%S", &tm);
+        snapshot_publish(&zone->state_snap, &state);
+        if (ctx->state_listener != NULL) ctx->state_listener();
+
+        if (zone->id == 0) {
+            app_lock_take(ctx, METRIC_LOCK_HISTORY, ctx->history_mutex);
+            history_push(ctx->history, (int64_t)now, data.temperature, data.temp_quality, data.presence_detected, d.pwm);
+            app_lock_give(ctx, METRIC_LOCK_HISTORY, ctx->history_mutex);
+        }
+
+        int64_t left = t0 + period_us - esp_timer_get_time();
+        if (left > 0) usleep((useconds_t)left);
+    }
+    return NULL;
+}
+
+// --- Opciones del servidor (sobre la config de start_web_server) ---
+
+static int opt_port = 8080;
+static int opt_max_sockets = -1;    // -1 = lo que pide start_web_server
+static int opt_backlog = -1;
+static int opt_lru = -1;
+static int opt_recv_timeout = -1;
+
+static void apply_overrides(httpd_config_t *c) {
+    c->server_port = (uint16_t)opt_port;
+    c->ctrl_port = 0;
+    if (opt_max_sockets > 0) c->max_open_sockets = (uint16_t)opt_max_sockets;
+    if (opt_backlog > 0) c->backlog_conn = (uint16_t)opt_backlog;
+    if (opt_lru >= 0) c->lru_purge_enable = opt_lru;
+    if (opt_recv_timeout > 0) c->recv_wait_timeout = (uint16_t)opt_recv_timeout;
+    fprintf(stderr, "httpd: puerto %u, max_open_sockets %u, backlog %u, lru_purge %s, recv_timeout %u s\n",
+            c->server_port, c->max_open_sockets, c->backlog_conn, c->lru_purge_enable ? "on" : "off",
+            c->recv_wait_timeout);
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void print_lock(const char *name, const latency_hist_t *wait, const latency_hist_t *hold) {
+    printf("  %-9s tomas %8u  espera p50 %6u p99 %6u max %7u us  | retención p50 %6u p99 %6u max %7u us\n",
+           name, hold->count,
+           latency_hist_percentile(wait, 50), latency_hist_percentile(wait, 99), wait->max_us,
+           latency_hist_percentile(hold, 50), latency_hist_percentile(hold, 99), hold->max_us);
+}
+
+static void usage(void) {
+    fprintf(stderr, "uso: web_standin [--port N] [--max-sockets N] [--backlog N] [--lru 0|1]\n"
+                    "                 [--recv-timeout S] [--zones N] [--rate HZ] [--duration S]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    unsigned zone_count = 1;
+    int duration_s = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) usage();
+        int v = atoi(argv[++i]);
+        if (strcmp(a, "--port") == 0) opt_port = v;
+        else if (strcmp(a, "--max-sockets") == 0) opt_max_sockets = v;
+        else if (strcmp(a, "--backlog") == 0) opt_backlog = v;
+        else if (strcmp(a, "--lru") == 0) opt_lru = v != 0;
+        else if (strcmp(a, "--recv-timeout") == 0) opt_recv_timeout = v;
+        else if (strcmp(a, "--zones") == 0) zone_count = (v >= 1 && v <= MAX_ZONES) ? (unsigned)v : 1;
+        else if (strcmp(a, "--rate") == 0) rate_hz = (v >= 1 && v <= 1000) ? (unsigned)v : 1;
+        else if (strcmp(a, "--duration") == 0) duration_s = v;
+        else usage();
+    }
+
+    system_config_t boot = default_system_config;
+    boot.zone_count = (uint8_t)zone_count;
+    snapshot_init(&config_snap, &config_slots[0], &config_slots[1], sizeof(system_config_t), &boot);
+    app_ctx.config_mutex = xSemaphoreCreateMutex();
+    app_ctx.config_snap = &config_snap;
+    history_init(&history);
+    app_ctx.history = &history;
+    app_ctx.history_mutex = xSemaphoreCreateMutex();
+    app_ctx.schedule = &schedule;
+    app_ctx.schedule_mutex = xSemaphoreCreateMutex();
+    portMUX_INITIALIZE(&app_ctx.lock_stats_mux);
+    app_ctx.zones = zones;
+    app_ctx.zone_count = (uint8_t)zone_count;
+    for (unsigned z = 0; z < zone_count; z++) {
+        system_state_t initial = {0};
+        zones[z].id = (uint8_t)z;
+        zones[z].core = (z + 1) % 2;
+        zones[z].app = &app_ctx;
+        zones[z].sensor_queue = xQueueCreate(4, sizeof(sensor_data_t));
+        portMUX_INITIALIZE(&zones[z].stats_mux);
+        snapshot_init(&zones[z].state_snap, &zones[z].state_slots[0], &zones[z].state_slots[1],
+                      sizeof(system_state_t), &initial);
+    }
+
+    httpd_shim_config_hook = apply_overrides;
+    if (start_web_server(&app_ctx) != ESP_OK) return 1;
+    httpd_handle_t server = httpd_shim_last_server();
+    web_ms = (uint32_t)(esp_timer_get_time() / 1000) + 1;
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    for (unsigned z = 0; z < zone_count; z++) pthread_create(&zone_threads[z], NULL, zone_loop, &zones[z]);
+
+    for (int t = 0; running && (duration_s <= 0 || t < duration_s * 10); t++) usleep(100000);
+    running = 0;
+    for (unsigned z = 0; z < zone_count; z++) pthread_join(zone_threads[z], NULL);
+
+    httpd_shim_stats_t st;
+    httpd_shim_get_stats(server, &st);
+    printf("httpd: %u sesiones (máx %u a la vez), %u rechazadas, %u cerradas por LRU\n",
+           st.accepted, st.open_max, st.rejected, st.lru_purged);
+    printf("       %u requests, %u errores, %u handlers fallidos, %u frames WS, %u trabajos\n",
+           st.requests, st.errors, st.handler_fail, st.ws_frames_out, st.work_items);
+    printf("mutex:\n");
+    for (int i = 0; i < METRIC_LOCK_COUNT; i++) {
+        taskENTER_CRITICAL(&app_ctx.lock_stats_mux);
+        latency_hist_t wait = app_ctx.lock_wait[i], hold = app_ctx.lock_hold[i];
+        taskEXIT_CRITICAL(&app_ctx.lock_stats_mux);
+        print_lock(metric_lock_name(i), &wait, &hold);
+    }
+    httpd_stop(server);
+    return 0;
+}
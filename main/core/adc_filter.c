@@ -0,0 +1,81 @@
+#include "adc_filter.h"
+#include "ntc_convert.h"
+
+#define IIR_FRAC_BITS  8
+
+static void window_reset(adc_filter_t *f) {
+    f->accepted = 0;
+    f->rejected = 0;
+    f->blocks = 0;
+    f->win_min = UINT16_MAX;
+    f->win_max = 0;
+}
+
+void adc_filter_init(adc_filter_t *f, uint8_t alpha_shift) {
+    f->block_len = 0;
+    f->alpha_shift = alpha_shift;
+    f->primed = false;
+    f->iir = 0;
+    window_reset(f);
+}
+
+// Mediana de un bloque chico: inserción (8 elementos, sin memoria extra)
+static uint16_t block_median(uint16_t *v, int n) {
+    for (int i = 1; i < n; i++) {
+        uint16_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+    // Con n par se promedian los dos centrales
+    return (n & 1) ? v[n / 2] : (uint16_t)((v[n / 2 - 1] + v[n / 2] + 1) / 2);
+}
+
+void adc_filter_push(adc_filter_t *f, uint16_t raw) {
+    if (!ntc_raw_is_valid(raw)) {
+        f->rejected++;
+        return;
+    }
+    f->accepted++;
+    f->block[f->block_len++] = raw;
+    if (f->block_len < ADC_FILTER_BLOCK) return;
+
+    // Bloque completo: mediana -> una muestra decimada -> IIR
+    uint16_t med = block_median(f->block, ADC_FILTER_BLOCK);
+    f->block_len = 0;
+    f->blocks++;
+    if (med < f->win_min) f->win_min = med;
+    if (med > f->win_max) f->win_max = med;
+
+    int32_t x = (int32_t)med << IIR_FRAC_BITS;
+    if (!f->primed) {
+        f->iir = x;
+        f->primed = true;
+    } else {
+        f->iir += (x - f->iir) >> f->alpha_shift;
+    }
+}
+
+bool adc_filter_output(const adc_filter_t *f, uint32_t *raw_q) {
+    if (!f->primed) return false;
+    *raw_q = (uint32_t)(f->iir >> (IIR_FRAC_BITS - ADC_FILTER_FRAC_BITS));
+    return true;
+}
+
+temp_quality_t adc_filter_quality(adc_filter_t *f, uint16_t max_spread) {
+    temp_quality_t q = TEMP_QUALITY_GOOD;
+
+    if (f->blocks == 0 || !f->primed) {
+        q = TEMP_QUALITY_INVALID;
+    } else if (f->rejected * 4 > f->accepted ||
+               (uint16_t)(f->win_max - f->win_min) > max_spread) {
+        // Más de 20% de saturaciones o ventana inestable
+        q = TEMP_QUALITY_DEGRADED;
+    }
+
+    window_reset(f);
+    return q;
+}
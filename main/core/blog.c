@@ -0,0 +1,141 @@
+#include "blog.h"
+#include <stdio.h>
+
+#define BLOG_INFO_(id, level, tag, interval, fmt) [id] = { level, tag, interval, fmt },
+const blog_msg_info_t blog_msgs[BLOG_MSG_COUNT] = { BLOG_MESSAGES(BLOG_INFO_) };
+#undef BLOG_INFO_
+
+_Static_assert((BLOG_RING_LEN & (BLOG_RING_LEN - 1)) == 0, "BLOG_RING_LEN debe ser potencia de 2");
+
+void blog_init(blog_t *b) {
+    memset(b, 0, sizeof(*b));
+    for (int i = 0; i < BLOG_MSG_COUNT; i++) b->last_us[i] = INT64_MIN;
+}
+
+bool blog_put(blog_t *b, int64_t ts_us, blog_msg_t id, const uint32_t *args, unsigned n) {
+    if ((unsigned)id >= BLOG_MSG_COUNT) return false;
+
+    // Límite por mensaje: dentro del intervalo solo se cuenta
+    uint32_t interval = blog_msgs[id].interval_ms;
+    if (interval != 0 && b->last_us[id] != INT64_MIN && ts_us - b->last_us[id] < (int64_t)interval * 1000) {
+        if (b->pending_repeats[id] < UINT16_MAX) b->pending_repeats[id]++;
+        b->suppressed++;
+        return false;
+    }
+    if (b->head - b->tail >= BLOG_RING_LEN) {
+        b->dropped++;       // Lo pendiente es más viejo: se conserva
+        return false;
+    }
+
+    blog_record_t *r = &b->ring[b->head & (BLOG_RING_LEN - 1)];
+    r->ts_us = ts_us;
+    r->id = (uint16_t)id;
+    r->repeats = b->pending_repeats[id];
+    if (n > BLOG_MAX_ARGS) n = BLOG_MAX_ARGS;
+    for (unsigned i = 0; i < n; i++) r->args[i] = args[i];
+    for (unsigned i = n; i < BLOG_MAX_ARGS; i++) r->args[i] = 0;
+    b->head++;
+    b->written++;
+    b->last_us[id] = ts_us;
+    b->pending_repeats[id] = 0;
+    return true;
+}
+
+bool blog_get(blog_t *b, blog_record_t *out) {
+    if (b->head == b->tail) return false;
+    *out = b->ring[b->tail & (BLOG_RING_LEN - 1)];
+    b->tail++;
+    return true;
+}
+
+// --- FORMATO ---
+
+static void append(char *out, size_t cap, size_t *len, const char *s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (*len + 1 < cap) out[*len] = s[i];
+        (*len)++;
+    }
+    if (cap > 0) out[(*len < cap) ? *len : cap - 1] = '\0';
+}
+
+size_t blog_format(char *out, size_t cap, const blog_record_t *r) {
+    size_t len = 0;
+    if (cap > 0) out[0] = '\0';
+    if (r->id >= BLOG_MSG_COUNT) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), "<mensaje %u desconocido>", r->id);
+        append(out, cap, &len, tmp, (size_t)n);
+        return len;
+    }
+
+    const char *p = blog_msgs[r->id].fmt;
+    unsigned arg = 0;
+    while (*p) {
+        const char *pct = strchr(p, '%');
+        if (pct == NULL) {
+            append(out, cap, &len, p, strlen(p));
+            break;
+        }
+        append(out, cap, &len, p, (size_t)(pct - p));
+        if (pct[1] == '%') {
+            append(out, cap, &len, "%", 1);
+            p = pct + 2;
+            continue;
+        }
+
+        // Especificación completa: flags, ancho, precisión y conversión
+        const char *q = pct + 1;
+        while (*q && strchr("-+ #0", *q)) q++;
+        while (*q >= '0' && *q <= '9') q++;
+        if (*q == '.') { q++; while (*q >= '0' && *q <= '9') q++; }
+        char conv = *q;
+        if (conv == '\0') break;
+        char spec[16];
+        size_t sl = (size_t)(q - pct + 1);
+        if (sl >= sizeof(spec)) sl = sizeof(spec) - 1;
+        memcpy(spec, pct, sl);
+        spec[sl] = '\0';
+
+        uint32_t v = (arg < BLOG_MAX_ARGS) ? r->args[arg] : 0;
+        arg++;
+        char tmp[48];
+        int n;
+        switch (conv) {
+        case 'd': case 'i': case 'c':
+            n = snprintf(tmp, sizeof(tmp), spec, (int)(int32_t)v);
+            break;
+        case 'u': case 'x': case 'X':
+            n = snprintf(tmp, sizeof(tmp), spec, (unsigned)v);
+            break;
+        case 'f': case 'e': case 'g': {
+            float f;
+            memcpy(&f, &v, sizeof(f));
+            n = snprintf(tmp, sizeof(tmp), spec, (double)f);
+            break;
+        }
+        default:
+            n = snprintf(tmp, sizeof(tmp), "<%%%c?>", conv);
+            break;
+        }
+        if (n > 0) append(out, cap, &len, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+        p = q + 1;
+    }
+
+    if (r->repeats > 0) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), " (+%u repetidos)", r->repeats);
+        append(out, cap, &len, tmp, (size_t)n);
+    }
+    return len;
+}
+
+uint32_t blog_catalog_hash(void) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < BLOG_MSG_COUNT; i++) {
+        for (const char *p = blog_msgs[i].fmt; ; p++) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+            if (*p == '\0') break;
+        }
+    }
+    return h;
+}
@@ -0,0 +1,120 @@
+#include "config_check.h"
+#include "config_codec.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Los usan todos los escritores de la configuración (web_server.c). Escritos como
+// !(lo <= x && x <= hi) para que NaN también quede fuera.
+#define OUT(x, lo, hi)  (!((lo) <= (x) && (x) <= (hi)))
+
+static const char *zone_check(const zone_config_t *zc) {
+    if (zc->operation_mode >= MODE_COUNT) return "mode";
+    if (zc->manual_duty > 100) return "manual_duty";
+    if (OUT(zc->pid.setpoint_c, 10.0f, 40.0f)) return "pid_sp";
+    if (OUT(zc->pid.kp, 0.0f, 1000.0f)) return "pid_kp";
+    if (OUT(zc->pid.ki, 0.0f, 100.0f)) return "pid_ki";
+    if (OUT(zc->pid.kd, 0.0f, 100000.0f)) return "pid_kd";
+    if (zc->pid.deadband_pct > 50) return "pid_db";
+    if (OUT(zc->hysteresis.setpoint_c, 10.0f, 40.0f)) return "hyst_sp";
+    if (OUT(zc->hysteresis.band_c, 0.1f, 10.0f)) return "hyst_band";
+    if (zc->hysteresis.on_pwm > 100) return "hyst_pwm";
+    return NULL;
+}
+
+static const char *schedule_check(const schedule_reg_t *reg) {
+    if (reg->start_hour > 23) return "sh";
+    if (reg->start_min > 59) return "sm";
+    if (reg->end_hour > 23) return "eh";
+    if (reg->end_min > 59) return "em";
+    if (reg->days & ~DAYS_ALL) return "days";
+    // Rango del NTC; el orden no se exige (calculate_pwm_linear lo tolera)
+    if (OUT(reg->temp_min_0_percent, -40.0f, 125.0f)) return "tmin";
+    if (OUT(reg->temp_max_100_percent, -40.0f, 125.0f)) return "tmax";
+    return NULL;
+}
+
+const char *config_check(const system_config_t *cfg, int *index) {
+    *index = -1;
+    if (OUT(cfg->zone_count, 1, MAX_ZONES)) return "zone_count";
+    if (cfg->schedule_count > MAX_SCHEDULES) return "schedules";
+    if (cfg->presence_hold_s > 3600) return "hold";
+    if (OUT(cfg->sample_min_ms, 50, 60000)) return "rate_min";
+    if (OUT(cfg->sample_max_ms, cfg->sample_min_ms, 60000)) return "rate_max";
+    if (OUT(cfg->sample_deadline_ms, 1, 60000)) return "deadline";
+    if (cfg->fan_slew_up > 1000) return "slew_up";
+    if (cfg->fan_slew_down > 1000) return "slew_down";
+    if (cfg->power_mode >= POWER_MODE_COUNT) return "power";
+
+    // Todas las zonas, no solo las activas: un cambio de zone_count las usa
+    for (int z = 0; z < MAX_ZONES; z++) {
+        const char *bad = zone_check(&cfg->zones[z]);
+        if (bad != NULL) {
+            *index = z;
+            return bad;
+        }
+    }
+    for (int i = 0; i < cfg->schedule_count; i++) {
+        const char *bad = schedule_check(&cfg->schedules[i]);
+        if (bad != NULL) {
+            *index = i;
+            return bad;
+        }
+    }
+    return NULL;
+}
+
+// --- REPARACIÓN ---
+// Los nombres de config_check son las claves de las tablas de config_codec:
+// de ahí salen el offset y el tamaño del campo a reponer.
+
+static const config_field_t *field_named(const config_field_t *fields, size_t n, const char *name) {
+    for (size_t i = 0; i < n; i++) {
+        if (strcmp(fields[i].name, name) == 0) return &fields[i];
+    }
+    return NULL;
+}
+
+static void field_reset(const config_field_t *f, void *base, const void *factory) {
+    memcpy((uint8_t *)base + f->offset, (const uint8_t *)factory + f->offset, f->size);
+}
+
+int config_repair(system_config_t *cfg) {
+    const system_config_t *d = &default_system_config;
+    int fixed = 0;
+    // Un arreglo por vuelta; el tope alcanza para todos los campos de todas
+    // las zonas y reglas
+    for (int round = 0; round < 16 * MAX_ZONES + MAX_SCHEDULES + 16; round++) {
+        int index;
+        const char *bad = config_check(cfg, &index);
+        if (bad == NULL) return fixed;
+        fixed++;
+
+        const config_field_t *f;
+        if (index < 0) {
+            if (strcmp(bad, "schedules") == 0) {
+                cfg->schedule_count = MAX_SCHEDULES;
+            } else if ((f = field_named(config_global_fields, config_global_field_count, bad)) != NULL) {
+                field_reset(f, cfg, d);
+                // rate_max se valida contra rate_min: el de fábrica puede no alcanzar
+                if (cfg->sample_max_ms < cfg->sample_min_ms) cfg->sample_max_ms = cfg->sample_min_ms;
+            } else {
+                break;
+            }
+        } else if ((f = field_named(config_zone_fields, config_zone_field_count, bad)) != NULL) {
+            field_reset(f, &cfg->zones[index], &d->zones[index]);
+        } else if (field_named(config_schedule_fields, config_schedule_field_count, bad) != NULL) {
+            memmove(&cfg->schedules[index], &cfg->schedules[index + 1],
+                    (cfg->schedule_count - index - 1) * sizeof(schedule_reg_t));
+            cfg->schedule_count--;
+            memset(&cfg->schedules[cfg->schedule_count], 0, sizeof(schedule_reg_t));
+        } else {
+            break;
+        }
+    }
+    // Un nombre que no está en las tablas: no se sabe qué reponer
+    uint32_t version = cfg->version;
+    *cfg = *d;
+    cfg->version = version;
+    return fixed;
+}
@@ -0,0 +1,352 @@
+#include "config_codec.h"
+#include "sensor_log_codec.h"   // slog_crc32 (el mismo CRC32 que el log)
+#include <string.h>
+
+#define FIELD(tag, kind, type, member, name) \
+    { tag, kind, sizeof(((type *)0)->member), offsetof(type, member), name }
+
+// --- Tablas de campos ---
+// Los tags son el formato: no se reordenan ni se reutilizan (ver config_codec.h)
+
+const config_field_t config_global_fields[] = {
+    FIELD(0x01, CONFIG_FIELD_UINT, system_config_t, version, "version"),
+    FIELD(0x02, CONFIG_FIELD_UINT, system_config_t, zone_count, "zone_count"),
+    FIELD(0x03, CONFIG_FIELD_UINT, system_config_t, presence_hold_s, "hold"),
+    FIELD(0x04, CONFIG_FIELD_UINT, system_config_t, sample_min_ms, "rate_min"),
+    FIELD(0x05, CONFIG_FIELD_UINT, system_config_t, sample_max_ms, "rate_max"),
+    FIELD(0x06, CONFIG_FIELD_UINT, system_config_t, sample_deadline_ms, "deadline"),
+    FIELD(0x07, CONFIG_FIELD_UINT, system_config_t, fan_slew_up, "slew_up"),
+    FIELD(0x08, CONFIG_FIELD_UINT, system_config_t, fan_slew_down, "slew_down"),
+    FIELD(0x09, CONFIG_FIELD_UINT, system_config_t, power_mode, "power"),
+};
+
+const config_field_t config_zone_fields[] = {
+    FIELD(0x01, CONFIG_FIELD_UINT, zone_config_t, operation_mode, "mode"),
+    FIELD(0x02, CONFIG_FIELD_UINT, zone_config_t, manual_duty, "manual_duty"),
+    FIELD(0x03, CONFIG_FIELD_FLOAT, zone_config_t, pid.setpoint_c, "pid_sp"),
+    FIELD(0x04, CONFIG_FIELD_FLOAT, zone_config_t, pid.kp, "pid_kp"),
+    FIELD(0x05, CONFIG_FIELD_FLOAT, zone_config_t, pid.ki, "pid_ki"),
+    FIELD(0x06, CONFIG_FIELD_FLOAT, zone_config_t, pid.kd, "pid_kd"),
+    FIELD(0x07, CONFIG_FIELD_UINT, zone_config_t, pid.deadband_pct, "pid_db"),
+    FIELD(0x08, CONFIG_FIELD_FLOAT, zone_config_t, hysteresis.setpoint_c, "hyst_sp"),
+    FIELD(0x09, CONFIG_FIELD_FLOAT, zone_config_t, hysteresis.band_c, "hyst_band"),
+    FIELD(0x0A, CONFIG_FIELD_UINT, zone_config_t, hysteresis.on_pwm, "hyst_pwm"),
+};
+
+const config_field_t config_schedule_fields[] = {
+    FIELD(0x01, CONFIG_FIELD_BOOL, schedule_reg_t, active, "act"),
+    FIELD(0x02, CONFIG_FIELD_UINT, schedule_reg_t, days, "days"),
+    FIELD(0x03, CONFIG_FIELD_UINT, schedule_reg_t, start_hour, "sh"),
+    FIELD(0x04, CONFIG_FIELD_UINT, schedule_reg_t, start_min, "sm"),
+    FIELD(0x05, CONFIG_FIELD_UINT, schedule_reg_t, end_hour, "eh"),
+    FIELD(0x06, CONFIG_FIELD_UINT, schedule_reg_t, end_min, "em"),
+    FIELD(0x07, CONFIG_FIELD_FLOAT, schedule_reg_t, temp_min_0_percent, "tmin"),
+    FIELD(0x08, CONFIG_FIELD_FLOAT, schedule_reg_t, temp_max_100_percent, "tmax"),
+};
+
+#define COUNT(a)  (sizeof(a) / sizeof((a)[0]))
+const size_t config_global_field_count = COUNT(config_global_fields);
+const size_t config_zone_field_count = COUNT(config_zone_fields);
+const size_t config_schedule_field_count = COUNT(config_schedule_fields);
+
+// --- Acceso a campos (tamaño en memoria 1, 2 o 4 bytes) ---
+
+static uint32_t field_uint(const config_field_t *f, const void *base) {
+    const uint8_t *p = (const uint8_t *)base + f->offset;
+    switch (f->size) {
+    case 1: { uint8_t v; memcpy(&v, p, 1); return v; }
+    case 2: { uint16_t v; memcpy(&v, p, 2); return v; }
+    default: { uint32_t v; memcpy(&v, p, 4); return v; }
+    }
+}
+
+static bool field_store_uint(const config_field_t *f, void *base, uint32_t v) {
+    uint8_t *p = (uint8_t *)base + f->offset;
+    switch (f->size) {
+    case 1: {
+        if (v > UINT8_MAX) return false;
+        uint8_t b = (uint8_t)v;
+        memcpy(p, &b, 1);
+        return true;
+    }
+    case 2: {
+        if (v > UINT16_MAX) return false;
+        uint16_t h = (uint16_t)v;
+        memcpy(p, &h, 2);
+        return true;
+    }
+    case 4:
+        memcpy(p, &v, 4);
+        return true;
+    }
+    return false;
+}
+
+double config_field_get(const config_field_t *f, const void *base) {
+    const uint8_t *p = (const uint8_t *)base + f->offset;
+    if (f->kind == CONFIG_FIELD_FLOAT) {
+        float x;
+        memcpy(&x, p, sizeof(x));
+        return x;
+    }
+    if (f->kind == CONFIG_FIELD_BOOL) {
+        bool b;
+        memcpy(&b, p, sizeof(b));
+        return b;
+    }
+    return field_uint(f, base);
+}
+
+bool config_field_set(const config_field_t *f, void *base, double v) {
+    uint8_t *p = (uint8_t *)base + f->offset;
+    if (f->kind == CONFIG_FIELD_FLOAT) {
+        float x = (float)v;
+        memcpy(p, &x, sizeof(x));
+        return true;
+    }
+    if (f->kind == CONFIG_FIELD_BOOL) {
+        if (v != 0 && v != 1) return false;
+        bool b = v != 0;
+        memcpy(p, &b, sizeof(b));
+        return true;
+    }
+    if (!(v >= 0 && v <= UINT32_MAX) || v != (double)(uint32_t)v) return false;
+    return field_store_uint(f, base, (uint32_t)v);
+}
+
+// --- Codificación ---
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool full;
+} out_t;
+
+static void put_byte(out_t *o, uint8_t b) {
+    if (o->len >= o->cap) {
+        o->full = true;
+        return;
+    }
+    o->buf[o->len++] = b;
+}
+
+static void put_le(out_t *o, uint32_t v, size_t n) {
+    for (size_t i = 0; i < n; i++) put_byte(o, (uint8_t)(v >> (8 * i)));
+}
+
+static uint32_t load_le(const uint8_t *p, size_t n) {
+    uint32_t v = 0;
+    for (size_t i = 0; i < n; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static size_t uint_width(uint32_t v) {
+    return (v <= 0xFF) ? 1 : (v <= 0xFFFF) ? 2 : (v <= 0xFFFFFF) ? 3 : 4;
+}
+
+static void put_fields(out_t *o, const config_field_t *fields, size_t n, const void *base) {
+    for (size_t i = 0; i < n; i++) {
+        const config_field_t *f = &fields[i];
+        put_byte(o, f->tag);
+        if (f->kind == CONFIG_FIELD_UINT) {
+            uint32_t v = field_uint(f, base);
+            size_t w = uint_width(v);
+            put_byte(o, (uint8_t)w);
+            put_le(o, v, w);
+        } else if (f->kind == CONFIG_FIELD_FLOAT) {
+            float x = (float)config_field_get(f, base);
+            uint32_t bits;
+            memcpy(&bits, &x, sizeof(bits));
+            put_byte(o, 4);
+            put_le(o, bits, 4);
+        } else {
+            put_byte(o, 1);
+            put_byte(o, config_field_get(f, base) != 0);
+        }
+    }
+}
+
+// Registro con campos anidados: el largo se completa al cerrar (una zona
+// ocupa a lo sumo 1 + 10 * 6 bytes, lejos del tope de 255)
+static size_t record_begin(out_t *o, uint8_t tag) {
+    put_byte(o, tag);
+    put_byte(o, 0);
+    return o->len;
+}
+
+static void record_end(out_t *o, size_t start) {
+    if (!o->full) o->buf[start - 1] = (uint8_t)(o->len - start);
+}
+
+size_t config_encode(const system_config_t *cfg, uint8_t *out, size_t cap) {
+    if (cap < CONFIG_HEADER_SIZE) return 0;
+    out_t o = { out, cap, CONFIG_HEADER_SIZE, false };
+    put_fields(&o, config_global_fields, config_global_field_count, cfg);
+
+    // Las zonas inactivas solo si se tocaron: las demás salen del default
+    for (unsigned z = 0; z < MAX_ZONES; z++) {
+        if (z >= cfg->zone_count &&
+            memcmp(&cfg->zones[z], &default_system_config.zones[z], sizeof(zone_config_t)) == 0) continue;
+        size_t at = record_begin(&o, CONFIG_TAG_ZONE);
+        put_byte(&o, (uint8_t)z);
+        put_fields(&o, config_zone_fields, config_zone_field_count, &cfg->zones[z]);
+        record_end(&o, at);
+    }
+    for (unsigned i = 0; i < cfg->schedule_count && i < MAX_SCHEDULES; i++) {
+        size_t at = record_begin(&o, CONFIG_TAG_SCHEDULE);
+        put_fields(&o, config_schedule_fields, config_schedule_field_count, &cfg->schedules[i]);
+        record_end(&o, at);
+    }
+    if (o.full) return 0;
+
+    size_t body = o.len - CONFIG_HEADER_SIZE;
+    out_t h = { out, CONFIG_HEADER_SIZE, 0, false };
+    put_le(&h, CONFIG_BLOB_MAGIC, 4);
+    put_le(&h, CONFIG_SCHEMA, 2);
+    put_le(&h, (uint32_t)body, 2);
+    put_le(&h, slog_crc32(out + CONFIG_HEADER_SIZE, body), 4);
+    return o.len;
+}
+
+// --- Decodificación ---
+
+static const config_field_t *find_field(const config_field_t *fields, size_t n, uint8_t tag) {
+    for (size_t i = 0; i < n; i++) {
+        if (fields[i].tag == tag) return &fields[i];
+    }
+    return NULL;
+}
+
+static bool get_field(const config_field_t *f, void *base, const uint8_t *v, uint8_t n) {
+    if (f->kind == CONFIG_FIELD_UINT) {
+        return n >= 1 && n <= 4 && field_store_uint(f, base, load_le(v, n));
+    }
+    if (f->kind == CONFIG_FIELD_FLOAT) {
+        if (n != 4 || f->size != sizeof(float)) return false;
+        uint32_t bits = load_le(v, 4);
+        memcpy((uint8_t *)base + f->offset, &bits, sizeof(bits));
+        return true;
+    }
+    return n == 1 && v[0] <= 1 && config_field_set(f, base, v[0]);
+}
+
+// Recorre los registros de [p, end); devuelve false si uno está truncado
+// o su valor no entra en el campo
+static bool get_fields(const uint8_t *p, const uint8_t *end, const config_field_t *fields, size_t n,
+                       void *base, config_decode_info_t *info) {
+    while (p < end) {
+        if (end - p < 2 || end - p - 2 < p[1]) return false;
+        const config_field_t *f = find_field(fields, n, p[0]);
+        if (f == NULL) info->unknown++;
+        else if (!get_field(f, base, p + 2, p[1])) return false;
+        p += 2 + p[1];
+    }
+    return true;
+}
+
+config_decode_err_t config_decode(const uint8_t *blob, size_t len, system_config_t *cfg,
+                                  config_decode_info_t *info) {
+    config_decode_info_t local;
+    if (info == NULL) info = &local;
+    memset(info, 0, sizeof(*info));
+    *cfg = default_system_config;
+
+    if (len < CONFIG_HEADER_SIZE) return CONFIG_DECODE_SHORT;
+    if (load_le(blob, 4) != CONFIG_BLOB_MAGIC) return CONFIG_DECODE_MAGIC;
+    info->schema = (uint16_t)load_le(blob + 4, 2);
+    if (info->schema == 0 || info->schema > CONFIG_SCHEMA) return CONFIG_DECODE_SCHEMA;
+    size_t body = load_le(blob + 6, 2);
+    if (len < CONFIG_HEADER_SIZE + body) return CONFIG_DECODE_SHORT;
+    const uint8_t *p = blob + CONFIG_HEADER_SIZE, *end = p + body;
+    if (slog_crc32(p, body) != load_le(blob + 8, 4)) return CONFIG_DECODE_CRC;
+
+    // La tabla de reglas es la del blob, no la del default
+    memset(cfg->schedules, 0, sizeof(cfg->schedules));
+    cfg->schedule_count = 0;
+
+    bool ok = true;
+    while (ok && p < end) {
+        if (end - p < 2 || end - p - 2 < p[1]) {
+            ok = false;
+            break;
+        }
+        uint8_t tag = p[0], n = p[1];
+        const uint8_t *v = p + 2;
+        p += 2 + n;
+        if (tag == CONFIG_TAG_ZONE) {
+            if (n < 1) ok = false;
+            else if (v[0] >= MAX_ZONES) info->dropped++;
+            else ok = get_fields(v + 1, v + n, config_zone_fields, config_zone_field_count, &cfg->zones[v[0]], info);
+        } else if (tag == CONFIG_TAG_SCHEDULE) {
+            if (cfg->schedule_count >= MAX_SCHEDULES) {
+                info->dropped++;
+                continue;
+            }
+            // Campos ausentes como en una regla nueva de /api/config
+            schedule_reg_t *reg = &cfg->schedules[cfg->schedule_count++];
+            reg->active = true;
+            reg->days = DAYS_ALL;
+            ok = get_fields(v, v + n, config_schedule_fields, config_schedule_field_count, reg, info);
+        } else {
+            const config_field_t *f = find_field(config_global_fields, config_global_field_count, tag);
+            if (f == NULL) info->unknown++;
+            else ok = get_field(f, cfg, v, n);
+        }
+    }
+    if (!ok) {
+        *cfg = default_system_config;
+        return CONFIG_DECODE_FORMAT;
+    }
+
+    // Migraciones: un paso por esquema anterior, en orden, sobre la config
+    // ya decodificada. El esquema 1 es el primero en este formato (los blobs
+    // crudos de antes los migra config_manager.c), así que aún no hay pasos.
+    return CONFIG_DECODE_OK;
+}
+
+// --- Volcado crudo del firmware original ---
+// struct { enum modo; uint32_t manual_duty; schedule_reg_t schedules[3]; }
+// con el ABI del ESP32: enum de 4 bytes y cada regla de 16 (4 x uint8 de
+// horario, 2 float, bool y 3 de padding). Se lee por offset, no con un cast.
+#define LEGACY_RULE_OFFSET  8
+#define LEGACY_RULE_SIZE    16
+#define LEGACY_RULES        3
+#define LEGACY_MODE_MAX     MODE_SCHEDULE   // El original solo tenía MANUAL, AUTO y PROG
+
+static float load_float(const uint8_t *p) {
+    uint32_t bits = load_le(p, 4);
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+bool config_decode_legacy(const uint8_t *raw, size_t len, system_config_t *cfg) {
+    *cfg = default_system_config;
+    if (len != CONFIG_LEGACY_SIZE) return false;
+
+    uint32_t mode = load_le(raw, 4);
+    if (mode <= LEGACY_MODE_MAX) cfg->zones[0].operation_mode = (operation_mode_t)mode;
+    cfg->zones[0].manual_duty = load_le(raw + 4, 4);
+
+    memset(cfg->schedules, 0, sizeof(cfg->schedules));
+    cfg->schedule_count = LEGACY_RULES;
+    for (int i = 0; i < LEGACY_RULES; i++) {
+        const uint8_t *r = raw + LEGACY_RULE_OFFSET + i * LEGACY_RULE_SIZE;
+        schedule_reg_t *reg = &cfg->schedules[i];
+        reg->start_hour = r[0];
+        reg->start_min = r[1];
+        reg->end_hour = r[2];
+        reg->end_min = r[3];
+        reg->temp_min_0_percent = load_float(r + 4);
+        reg->temp_max_100_percent = load_float(r + 8);
+        reg->active = r[12] != 0;
+        reg->days = DAYS_ALL;       // Sin días en el original: todos
+    }
+    return true;
+}
+
+const char *config_decode_err_name(config_decode_err_t err) {
+    static const char *const names[] = { "ok", "short", "magic", "schema", "crc", "format" };
+    return ((unsigned)err < COUNT(names)) ? names[err] : "?";
+}
@@ -0,0 +1,35 @@
+#include "data_types.h"
+
+// Configuración por defecto (Si es la primera vez que arranca)
+const system_config_t default_system_config = {
+    .zone_count = 1,
+    .zones = {
+        [0 ... MAX_ZONES - 1] = {
+            .operation_mode = MODE_SCHEDULE,
+            .manual_duty = 50,
+            // PI de tools/pid_autotune sobre la planta por defecto del mock; sin D y con
+            // banda muerta de 5 % para no seguir el ruido del sensor (bench_controllers)
+            .pid = { .setpoint_c = 24.0f, .kp = 118.7f, .ki = 0.221f, .kd = 0.0f, .deadband_pct = 5 },
+            .hysteresis = { .setpoint_c = 24.0f, .band_c = 1.0f, .on_pwm = 80 },
+        },
+    },
+    .schedule_count = 1,
+    .schedules = {
+        // REGISTRO 0: Activo todo el día (00:00 a 23:59) para pruebas
+        { 
+            .active = true, 
+            .start_hour=0, .start_min=0, 
+            .end_hour=23, .end_min=59, 
+            .days = DAYS_ALL,
+            .temp_min_0_percent=23.0,   // Empezar a girar a los 23°C
+            .temp_max_100_percent=26.0  // Máximo a los 26°C
+        },
+    },
+    .presence_hold_s = 30,
+    .sample_min_ms = 250,
+    .sample_max_ms = 10000,
+    .sample_deadline_ms = 50,   // Varios ticks + salida de light sleep + lectura y control
+    .fan_slew_up = 50,          // 0 -> 100 % en 2 s (limita la corriente de arranque)
+    .fan_slew_down = 100,
+    .power_mode = POWER_PERFORMANCE     // Bajo consumo a pedido: clave "power"
+};
@@ -0,0 +1,161 @@
+#include "control_logic.h"
+#include <math.h>
+#include <string.h>
+
+#define PID_MAX_DT_S    60.0f   // Huecos más largos no integran (sensor caído, reinicio)
+
+// --- FUNCIONES AUXILIARES ---
+
+// Convierte hora/min a minutos absolutos (ej: 01:30 -> 90 min)
+static int get_minutes_from_midnight(int hour, int min) {
+    return (hour * 60) + min;
+}
+
+bool is_time_in_range(const struct tm *now, const schedule_reg_t *reg) {
+    int now_mins = get_minutes_from_midnight(now->tm_hour, now->tm_min);
+    int start_mins = get_minutes_from_midnight(reg->start_hour, reg->start_min);
+    int end_mins = get_minutes_from_midnight(reg->end_hour, reg->end_min);
+
+    if (start_mins < end_mins) {
+        // Caso normal (ej: 14:00 a 18:00)
+        return (now_mins >= start_mins && now_mins < end_mins);
+    } else {
+        // Caso cruce de medianoche (ej: 22:00 a 06:00)
+        // Es válido si es mayor que el inicio (noche) O menor que el fin (madrugada)
+        return (now_mins >= start_mins || now_mins < end_mins);
+    }
+}
+
+uint32_t calculate_pwm_linear(float current_temp, float t_min, float t_max) {
+    if (current_temp <= t_min) return 0;
+    if (current_temp >= t_max) return 100;
+    
+    // Protección contra división por cero
+    if ((t_max - t_min) < 0.1) return 100;
+
+    float ratio = (current_temp - t_min) / (t_max - t_min);
+    return (uint32_t)(ratio * 100.0f);
+}
+
+// --- CONTROLADORES CON ESTADO ---
+
+void control_state_reset(control_state_t *st) {
+    memset(st, 0, sizeof(*st));
+}
+
+uint32_t pid_update(const pid_params_t *p, control_state_t *st, float temp, float dt_s) {
+    float error = temp - p->setpoint_c;
+    float pterm = p->kp * error;
+
+    if (st->primed && dt_s > 0.0f && dt_s <= PID_MAX_DT_S) {
+        // D sobre la medición (sin salto al cambiar la consigna) con paso bajo:
+        // el ruido del sensor derivado no debe llegar al ventilador
+        float raw = p->kd * (temp - st->prev_temp) / dt_s;
+        float tf = (p->kp > 0.0f) ? p->kd / (p->kp * PID_D_FILTER_N) : 0.0f;
+        st->dterm += (raw - st->dterm) * dt_s / (tf + dt_s);
+        st->integral += p->ki * error * dt_s;
+    } else {
+        st->dterm = 0.0f;
+    }
+    float dterm = st->dterm;
+    st->prev_temp = temp;
+    st->primed = true;
+
+    // Anti-windup: la integral solo ocupa el margen que dejan P y D
+    float hi = 100.0f - pterm - dterm;
+    float lo = 0.0f - pterm - dterm;
+    if (hi < 0.0f) hi = 0.0f;
+    if (lo > 100.0f) lo = 100.0f;
+    if (st->integral > hi) st->integral = hi;
+    if (st->integral < lo) st->integral = lo;
+
+    float u = pterm + st->integral + dterm;
+    if (u < 0.0f) u = 0.0f;
+    if (u > 100.0f) u = 100.0f;
+    uint32_t out = (uint32_t)lroundf(u);
+
+    // Banda muerta de salida: los extremos se aplican siempre
+    uint32_t delta = (out > st->output) ? out - st->output : st->output - out;
+    if (delta >= p->deadband_pct || out == 0 || out == 100) {
+        st->output = out;
+    }
+    return st->output;
+}
+
+uint32_t hysteresis_update(const hysteresis_params_t *p, control_state_t *st, float temp) {
+    float half = p->band_c * 0.5f;
+    if (temp >= p->setpoint_c + half) st->hyst_on = true;
+    else if (temp <= p->setpoint_c - half) st->hyst_on = false;
+    st->output = st->hyst_on ? p->on_pwm : 0;
+    return st->output;
+}
+
+// --- LÓGICA DE CONTROL ---
+
+control_decision_t control_decide(const zone_config_t *zone,
+                                  const schedule_index_t *sched,
+                                  control_state_t *st,
+                                  const sensor_data_t *data,
+                                  const struct tm *now,
+                                  bool time_synced) {
+    control_decision_t d = { .pwm = 0, .status = CONTROL_OK, .rule = -1 };
+
+    switch (zone->operation_mode) {
+        case MODE_MANUAL:
+            d.pwm = zone->manual_duty;
+            break;
+
+        case MODE_AUTO:
+            if (data->presence_detected) {
+                if (data->temp_quality == TEMP_QUALITY_INVALID) {
+                    d.status = CONTROL_BAD_SENSOR;
+                    break;
+                }
+                d.pwm = calculate_pwm_linear(data->temperature, 15.0, 25.0);
+            }
+            break;
+
+        case MODE_SCHEDULE:
+            if (!time_synced) {
+                d.status = CONTROL_NO_TIME;
+                break;
+            }
+            if (data->presence_detected) {
+                // Una sola lectura indexada por minuto de la semana
+                const schedule_rule_t *rule = schedule_index_lookup(sched, now);
+                if (rule == NULL) break;
+                if (data->temp_quality == TEMP_QUALITY_INVALID) {
+                    d.status = CONTROL_BAD_SENSOR;
+                    break;
+                }
+                d.pwm = calculate_pwm_linear(data->temperature, rule->t_min, rule->t_max);
+                d.rule = rule->source;
+            }
+            break;
+
+        case MODE_PID:
+        case MODE_HYSTERESIS:
+            // Como AUTO: solo con presencia. Sin presencia se apaga y se olvida la memoria
+            if (!data->presence_detected) {
+                control_state_reset(st);
+                break;
+            }
+            if (data->temp_quality == TEMP_QUALITY_INVALID) {
+                d.status = CONTROL_BAD_SENSOR;
+                break;
+            }
+            if (zone->operation_mode == MODE_PID) {
+                float dt_s = st->primed ? (float)(data->timestamp - st->prev_us) / 1e6f : 0.0f;
+                d.pwm = pid_update(&zone->pid, st, data->temperature, dt_s);
+            } else {
+                d.pwm = hysteresis_update(&zone->hysteresis, st, data->temperature);
+            }
+            st->prev_us = data->timestamp;
+            break;
+
+        default:
+            break;
+    }
+
+    return d;
+}
@@ -0,0 +1,209 @@
+#include "history.h"
+#include <string.h>
+#include <math.h>
+
+typedef struct {
+    uint32_t period_s;
+    size_t len;
+    size_t record_size;
+} tier_desc_t;
+
+static const tier_desc_t TIERS[HISTORY_TIER_COUNT] = {
+    [HISTORY_TIER_SECOND] = { 1,    HISTORY_SECONDS_LEN, sizeof(history_sample_t) },
+    [HISTORY_TIER_MINUTE] = { 60,   HISTORY_MINUTES_LEN, sizeof(history_agg_t) },
+    [HISTORY_TIER_HOUR]   = { 3600, HISTORY_HOURS_LEN,   sizeof(history_agg_t) },
+};
+
+static const history_sample_t EMPTY_SAMPLE = { .temp_c100 = HISTORY_NO_TEMP };
+static const history_agg_t EMPTY_AGG = {
+    .temp_avg = HISTORY_NO_TEMP, .temp_min = HISTORY_NO_TEMP, .temp_max = HISTORY_NO_TEMP,
+    .presence_pct = HISTORY_PRESENCE_EMPTY
+};
+
+// Redondeo hacia -inf: un from_ts negativo cae en buckets negativos (vacíos)
+static int64_t bucket_of(int64_t ts, uint32_t period) {
+    int64_t q = ts / (int64_t)period;
+    return (ts % (int64_t)period < 0) ? q - 1 : q;
+}
+
+static uint8_t *slot_ptr(history_t *h, int tier, int64_t bucket) {
+    size_t i = (size_t)(bucket % (int64_t)TIERS[tier].len);
+    switch (tier) {
+        case HISTORY_TIER_SECOND: return (uint8_t *)&h->seconds[i];
+        case HISTORY_TIER_MINUTE: return (uint8_t *)&h->minutes[i];
+        default:                  return (uint8_t *)&h->hours[i];
+    }
+}
+
+static const void *empty_record(int tier) {
+    return (tier == HISTORY_TIER_SECOND) ? (const void *)&EMPTY_SAMPLE : (const void *)&EMPTY_AGG;
+}
+
+static void clear_tier(history_t *h, int tier) {
+    for (size_t i = 0; i < TIERS[tier].len; i++) {
+        memcpy(slot_ptr(h, tier, (int64_t)i), empty_record(tier), TIERS[tier].record_size);
+    }
+}
+
+// Escribe 'rec' en el bucket; avanzar el head vacía los buckets salteados
+static void ring_put(history_t *h, int tier, int64_t bucket, const void *rec) {
+    const tier_desc_t *d = &TIERS[tier];
+    int64_t head = h->head[tier];
+
+    if (head < 0 || bucket - head >= (int64_t)d->len) {
+        clear_tier(h, tier);
+        h->head[tier] = bucket;
+    } else if (bucket > head) {
+        for (int64_t b = head + 1; b < bucket; b++) {
+            memcpy(slot_ptr(h, tier, b), empty_record(tier), d->record_size);
+        }
+        h->head[tier] = bucket;
+    } else if (bucket <= head - (int64_t)d->len) {
+        return; // Más viejo que todo el ring
+    }
+    memcpy(slot_ptr(h, tier, bucket), rec, d->record_size);
+}
+
+static void acc_reset(history_acc_t *acc, int64_t bucket) {
+    memset(acc, 0, sizeof(*acc));
+    acc->bucket = bucket;
+    acc->temp_min = INT16_MAX;
+    acc->temp_max = INT16_MIN;
+}
+
+static void acc_add(history_acc_t *acc, int16_t temp_c100, bool presence, uint32_t pwm) {
+    if (temp_c100 != HISTORY_NO_TEMP) {
+        acc->temp_sum += temp_c100;
+        if (temp_c100 < acc->temp_min) acc->temp_min = temp_c100;
+        if (temp_c100 > acc->temp_max) acc->temp_max = temp_c100;
+        acc->temp_n++;
+    }
+    if (presence) acc->presence_n++;
+    acc->pwm_sum += pwm;
+    acc->n++;
+}
+
+static void acc_to_agg(const history_acc_t *acc, history_agg_t *out) {
+    if (acc->n == 0) {
+        *out = EMPTY_AGG;
+        return;
+    }
+    if (acc->temp_n > 0) {
+        // Promedio redondeado al centésimo más cercano
+        int32_t half = (acc->temp_sum >= 0) ? acc->temp_n / 2 : -(acc->temp_n / 2);
+        out->temp_avg = (int16_t)((acc->temp_sum + half) / acc->temp_n);
+        out->temp_min = acc->temp_min;
+        out->temp_max = acc->temp_max;
+    } else {
+        out->temp_avg = out->temp_min = out->temp_max = HISTORY_NO_TEMP;
+    }
+    out->pwm_avg = (uint8_t)((acc->pwm_sum + acc->n / 2) / acc->n);
+    out->presence_pct = (uint8_t)((acc->presence_n * 100u + acc->n / 2) / acc->n);
+}
+
+static int16_t encode_temp(float temp_c, temp_quality_t quality) {
+    if (quality == TEMP_QUALITY_INVALID || isnan(temp_c)) return HISTORY_NO_TEMP;
+    float v = roundf(temp_c * 100.0f);
+    if (v <= (float)(INT16_MIN + 1)) return INT16_MIN + 1;
+    if (v >= (float)INT16_MAX) return INT16_MAX;
+    return (int16_t)v;
+}
+
+void history_init(history_t *h) {
+    for (int t = 0; t < HISTORY_TIER_COUNT; t++) {
+        clear_tier(h, t);
+        h->head[t] = -1;
+        acc_reset(&h->acc[t], -1);
+    }
+    h->last_ts = -1;
+}
+
+// Un segundo en cada nivel: la muestra cruda y su peso en los agregados
+static void record(history_t *h, int64_t ts, const history_sample_t *s) {
+    ring_put(h, HISTORY_TIER_SECOND, bucket_of(ts, TIERS[HISTORY_TIER_SECOND].period_s), s);
+
+    // Niveles agregados: al cambiar de bucket se cierra el anterior
+    for (int t = HISTORY_TIER_MINUTE; t < HISTORY_TIER_COUNT; t++) {
+        history_acc_t *acc = &h->acc[t];
+        int64_t b = bucket_of(ts, TIERS[t].period_s);
+        if (acc->bucket != b) {
+            if (acc->n > 0) {
+                history_agg_t agg;
+                acc_to_agg(acc, &agg);
+                ring_put(h, t, acc->bucket, &agg);
+            }
+            acc_reset(acc, b);
+        }
+        acc_add(acc, s->temp_c100, (s->flags & HISTORY_F_PRESENCE) != 0, s->pwm);
+    }
+}
+
+void history_push(history_t *h, int64_t ts, float temp_c, temp_quality_t quality,
+                  bool presence, uint32_t pwm) {
+    if (ts < 0) return;
+    if (pwm > 100) pwm = 100;
+    int16_t temp = encode_temp(temp_c, quality);
+
+    history_sample_t s = {
+        .temp_c100 = temp,
+        .pwm = (uint8_t)pwm,
+        .flags = (uint8_t)(HISTORY_F_VALID | (presence ? HISTORY_F_PRESENCE : 0) |
+                           ((quality << 1) & HISTORY_F_QUALITY_MASK)),
+    };
+
+    // La muestra anterior rige hasta esta: cada segundo en que estuvo vigente
+    // pesa lo mismo en los agregados, así un tramo estable muestreado cada
+    // 10 s no vale 10 veces menos que una rampa muestreada a 250 ms
+    if (h->last_ts >= 0 && ts > h->last_ts) {
+        int64_t end = (ts - h->last_ts > HISTORY_MAX_HOLD_S) ? h->last_ts + HISTORY_MAX_HOLD_S : ts;
+        for (int64_t t = h->last_ts + 1; t < end; t++) record(h, t, &h->last);
+    }
+    if (ts == h->last_ts) {
+        // Misma hora en segundos (muestreo a 250 ms): el segundo ya pesó una
+        // vez en los agregados; solo se actualiza el registro de 1 s
+        ring_put(h, HISTORY_TIER_SECOND, bucket_of(ts, TIERS[HISTORY_TIER_SECOND].period_s), &s);
+    } else {
+        record(h, ts, &s);
+    }
+    h->last = s;
+    h->last_ts = ts;
+}
+
+void history_read(const history_t *h, int tier, int64_t from_ts, size_t count, void *out) {
+    const tier_desc_t *d = &TIERS[tier];
+    const history_acc_t *acc = &h->acc[tier];
+    int64_t head = h->head[tier];
+    int64_t first = bucket_of(from_ts, d->period_s);
+    uint8_t *dst = (uint8_t *)out;
+
+    for (size_t i = 0; i < count; i++, dst += d->record_size) {
+        int64_t b = first + (int64_t)i;
+        if (tier != HISTORY_TIER_SECOND && b == acc->bucket && acc->n > 0) {
+            acc_to_agg(acc, (history_agg_t *)dst);  // Bucket en curso (parcial)
+        } else if (head >= 0 && b >= 0 && b <= head && b > head - (int64_t)d->len) {
+            memcpy(dst, slot_ptr((history_t *)h, tier, b), d->record_size);
+        } else {
+            memcpy(dst, empty_record(tier), d->record_size);
+        }
+    }
+}
+
+int64_t history_latest(const history_t *h, int tier) {
+    int64_t b = h->head[tier];
+    if (tier != HISTORY_TIER_SECOND && h->acc[tier].n > 0 && h->acc[tier].bucket > b) {
+        b = h->acc[tier].bucket;
+    }
+    return (b < 0) ? -1 : b * (int64_t)TIERS[tier].period_s;
+}
+
+uint32_t history_period_s(int tier) {
+    return TIERS[tier].period_s;
+}
+
+size_t history_capacity(int tier) {
+    return TIERS[tier].len;
+}
+
+size_t history_record_size(int tier) {
+    return TIERS[tier].record_size;
+}
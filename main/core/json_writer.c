@@ -0,0 +1,287 @@
+#include "json_writer.h"
+#include <string.h>
+#include <math.h>
+
+static void flush_buffer(json_writer_t *w) {
+    if (w->len == 0) return;
+    if (w->flush == NULL || w->flush(w->flush_ctx, w->buf, w->len) != 0) {
+        w->error = true;
+        return;
+    }
+    w->flushes++;
+    w->len = 0;
+}
+
+static void put(json_writer_t *w, const char *s, size_t n) {
+    if (w->error) return;
+    while (n > 0) {
+        if (w->len == w->cap) {
+            flush_buffer(w);
+            if (w->error) return;
+        }
+        size_t chunk = w->cap - w->len;
+        if (chunk > n) chunk = n;
+        memcpy(w->buf + w->len, s, chunk);
+        w->len += chunk;
+        w->total += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+static void putc_(json_writer_t *w, char c) {
+    put(w, &c, 1);
+}
+
+// Separador antes de cada valor/clave según el nivel actual
+static void begin_value(json_writer_t *w) {
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    if (w->depth == 0) return;
+    uint32_t bit = 1u << w->depth;
+    if (w->first & bit) {
+        w->first &= ~bit;
+    } else {
+        putc_(w, ',');
+    }
+}
+
+static void open_level(json_writer_t *w, char c) {
+    begin_value(w);
+    if (w->depth + 1 >= JSON_WRITER_MAX_DEPTH) {
+        w->error = true;
+        return;
+    }
+    w->depth++;
+    w->first |= 1u << w->depth;
+    putc_(w, c);
+}
+
+static void close_level(json_writer_t *w, char c) {
+    if (w->depth == 0) {
+        w->error = true;
+        return;
+    }
+    w->depth--;
+    putc_(w, c);
+}
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap, json_flush_fn flush, void *flush_ctx) {
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = cap;
+    w->flush = flush;
+    w->flush_ctx = flush_ctx;
+    if (cap == 0) w->error = true;
+}
+
+void json_obj_begin(json_writer_t *w) { open_level(w, '{'); }
+void json_obj_end(json_writer_t *w)   { close_level(w, '}'); }
+void json_arr_begin(json_writer_t *w) { open_level(w, '['); }
+void json_arr_end(json_writer_t *w)   { close_level(w, ']'); }
+
+void json_str(json_writer_t *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    begin_value(w);
+    putc_(w, '"');
+    const char *run = s;   // Tramo sin caracteres a escapar: se copia de una vez
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+        put(w, run, (size_t)(s - run));
+        run = s + 1;
+        if (c < 0x20) {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+            put(w, esc, sizeof(esc));
+        } else {
+            char esc[2] = { '\\', (char)c };
+            put(w, esc, sizeof(esc));
+        }
+    }
+    put(w, run, (size_t)(s - run));
+    putc_(w, '"');
+}
+
+void json_key(json_writer_t *w, const char *key) {
+    json_str(w, key);
+    putc_(w, ':');
+    w->after_key = true;
+}
+
+// Entero sin signo a texto (derecha a izquierda)
+static size_t fmt_u64(char *out, uint64_t v) {
+    char tmp[20];
+    size_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v > 0);
+    for (size_t i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+void json_int(json_writer_t *w, int64_t v) {
+    char out[21];
+    size_t n = 0;
+    begin_value(w);
+    uint64_t mag = (uint64_t)v;
+    if (v < 0) {
+        out[n++] = '-';
+        mag = 0 - mag;
+    }
+    n += fmt_u64(out + n, mag);
+    put(w, out, n);
+}
+
+void json_bool(json_writer_t *w, bool v) {
+    begin_value(w);
+    if (v) put(w, "true", 4);
+    else put(w, "false", 5);
+}
+
+static const uint32_t pow10_u32[7] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+void json_fixed(json_writer_t *w, float v, unsigned decimals) {
+    if (!isfinite(v) || fabsf(v) > 1e12f) {
+        begin_value(w);
+        put(w, "null", 4);
+        return;
+    }
+    if (decimals > 6) decimals = 6;
+    uint32_t scale = pow10_u32[decimals];
+
+    // Todo en float (el ESP32 no tiene FPU de double). La parte entera y la
+    // fraccionaria salen exactas del float; solo la fracción se escala (< 1e6,
+    // entra en la mantisa) y el acarreo del redondeo pasa a la parte entera
+    float a = fabsf(v);
+    uint64_t ip = (uint64_t)a;
+    uint32_t fp = (uint32_t)((a - (float)ip) * (float)scale + 0.5f);
+    if (fp >= scale) {
+        fp -= scale;
+        ip++;
+    }
+    bool nonzero = ip != 0 || fp != 0;
+
+    char out[32];
+    size_t n = 0;
+    if (v < 0 && nonzero) out[n++] = '-';
+    n += fmt_u64(out + n, ip);
+    if (decimals > 0) {
+        out[n++] = '.';
+        for (unsigned i = decimals; i > 0; i--) out[n++] = (char)('0' + (fp / pow10_u32[i - 1]) % 10);
+    }
+    begin_value(w);
+    put(w, out, n);
+}
+
+// round(m * 10^d / 2^k) en enteros. El producto se renormaliza (x >> 1,
+// k - 1) antes de desbordar: solo se pierden bits más allá de 2^59.
+static uint64_t scale_pow10(uint64_t m, int k, int d) {
+    uint64_t x = m;
+    for (int i = 0; i < d; i++) {
+        while (x >= (1ull << 59) && k > 0) {
+            x >>= 1;
+            k--;
+        }
+        x *= 10;
+    }
+    while (k > 63) {
+        x >>= 1;
+        k--;
+    }
+    return (k > 0) ? (x + (1ull << (k - 1))) >> k : x;
+}
+
+void json_float(json_writer_t *w, float v) {
+    if (!isfinite(v) || fabsf(v) > 1e12f) {
+        begin_value(w);
+        put(w, "null", 4);
+        return;
+    }
+    // |v| = m * 2^e exacto, m entero de 24 bits
+    int e;
+    float f = frexpf(fabsf(v), &e);
+    uint64_t m = (uint64_t)ldexpf(f, 24);
+    e -= 24;
+    if (m == 0 || e >= 0) {
+        // Entero exacto (todo float >= 2^24 lo es)
+        json_int(w, (v < 0) ? -(int64_t)(m << e) : (int64_t)(m << e));
+        return;
+    }
+
+    // q = |v| * 10^d con 9 cifras: 10^8 <= q < 10^9. d arranca de la
+    // estimación log10(2^(e+24)) y se corrige (a lo sumo un paso)
+    int d = 8 - ((e + 24) * 77) / 256;
+    uint64_t q = scale_pow10(m, -e, d < 0 ? 0 : d);
+    while (q >= 1000000000u && d > 0) q = scale_pow10(m, -e, --d);
+    while (q < 100000000u) q = scale_pow10(m, -e, ++d);
+    if (q >= 1000000000u) {
+        // El redondeo subió a 10^9: una cifra menos
+        q = 100000000u;
+        d--;
+    }
+
+    char digits[9];
+    for (int i = 8; i >= 0; i--) {
+        digits[i] = (char)('0' + q % 10);
+        q /= 10;
+    }
+    int ndig = 9;
+    while (ndig > 1 && ndig > 9 - d && digits[ndig - 1] == '0') ndig--;   // Sin ceros finales tras el punto
+
+    char out[64];
+    size_t n = 0;
+    if (v < 0) out[n++] = '-';
+    int int_digits = 9 - d;     // Cifras antes del punto (<= 0: "0.000...")
+    if (int_digits <= 0) {
+        out[n++] = '0';
+        out[n++] = '.';
+        for (int i = int_digits; i < 0 && n < sizeof(out) - 10; i++) out[n++] = '0';
+        for (int i = 0; i < ndig; i++) out[n++] = digits[i];
+    } else {
+        for (int i = 0; i < int_digits; i++) out[n++] = digits[i];
+        if (ndig > int_digits) {
+            out[n++] = '.';
+            for (int i = int_digits; i < ndig; i++) out[n++] = digits[i];
+        }
+    }
+    begin_value(w);
+    put(w, out, n);
+}
+
+void json_kv_int(json_writer_t *w, const char *key, int64_t v) {
+    json_key(w, key);
+    json_int(w, v);
+}
+
+void json_kv_bool(json_writer_t *w, const char *key, bool v) {
+    json_key(w, key);
+    json_bool(w, v);
+}
+
+void json_kv_str(json_writer_t *w, const char *key, const char *s) {
+    json_key(w, key);
+    json_str(w, s);
+}
+
+void json_kv_fixed(json_writer_t *w, const char *key, float v, unsigned decimals) {
+    json_key(w, key);
+    json_fixed(w, v, decimals);
+}
+
+void json_kv_float(json_writer_t *w, const char *key, float v) {
+    json_key(w, key);
+    json_float(w, v);
+}
+
+void json_raw(json_writer_t *w, const char *s) {
+    put(w, s, strlen(s));
+}
+
+int json_writer_finish(json_writer_t *w) {
+    if (w->depth != 0) w->error = true;
+    if (!w->error && w->flush != NULL) flush_buffer(w);
+    return w->error ? -1 : 0;
+}
@@ -0,0 +1,37 @@
+#include "latency_hist.h"
+
+void latency_hist_record(latency_hist_t *h, uint32_t us) {
+    unsigned b = 0;
+    while (b < LATENCY_HIST_BUCKETS - 1 && us >= (1u << b)) b++;
+    h->buckets[b]++;
+    h->count++;
+    h->sum_us += us;
+    if (us > h->max_us) h->max_us = us;
+}
+
+uint32_t latency_hist_percentile(const latency_hist_t *h, unsigned pct) {
+    if (h->count == 0) return 0;
+    uint64_t target = ((uint64_t)h->count * pct + 99) / 100;
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= target) {
+            // El último bucket no tiene cota: se informa el máximo observado
+            uint32_t upper = (b == LATENCY_HIST_BUCKETS - 1) ? h->max_us : (1u << b);
+            return upper < h->max_us ? upper : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+uint32_t latency_hist_avg(const latency_hist_t *h) {
+    return h->count ? (uint32_t)(h->sum_us / h->count) : 0;
+}
+
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src) {
+    for (unsigned b = 0; b < LATENCY_HIST_BUCKETS; b++) dst->buckets[b] += src->buckets[b];
+    dst->count += src->count;
+    dst->sum_us += src->sum_us;
+    if (src->max_us > dst->max_us) dst->max_us = src->max_us;
+}
@@ -0,0 +1,58 @@
+#include "ntc_convert.h"
+#include "ntc_params.h"
+#include "ntc_lut.h"   // Generado en build
+#include <math.h>
+
+#define LUT_SCALE  (1.0f / (float)(1 << NTC_LUT_FRAC_BITS))
+
+bool ntc_raw_is_valid(int adc_raw) {
+    return adc_raw > 0 && adc_raw < NTC_ADC_MAX;
+}
+
+float ntc_celsius_formula(int adc_raw) {
+    if (!ntc_raw_is_valid(adc_raw)) return NTC_INVALID_CELSIUS;
+
+    // 1. Convertir ADC a Voltaje
+    float voltage = (adc_raw * NTC_VREF) / (float)NTC_ADC_MAX;
+
+    // 2. Calcular Resistencia del NTC
+    float r_ntc = (voltage * R_SERIES) / (NTC_VREF - voltage);
+
+    // 3. Ecuación Beta
+    float steinhart;
+    steinhart = r_ntc / R_NOMINAL;      
+    steinhart = log(steinhart);         
+    steinhart /= B_COEFFICIENT;         
+    steinhart += 1.0f / (T_NOMINAL + 273.15f); 
+    steinhart = 1.0f / steinhart;       
+    steinhart -= 273.15f;               
+
+    // 4. Calibración por offset
+    return steinhart - NTC_CAL_OFFSET;
+}
+
+float ntc_celsius_lut(int adc_raw) {
+    if (!ntc_raw_is_valid(adc_raw)) return NTC_INVALID_CELSIUS;
+    return NTC_LUT[adc_raw] * LUT_SCALE;
+}
+
+float ntc_celsius_lut_q(uint32_t raw_q, unsigned frac_bits) {
+    uint32_t idx = raw_q >> frac_bits;
+    uint32_t frac = raw_q & ((1u << frac_bits) - 1u);
+
+    if (idx >= NTC_LUT_SIZE) return NTC_INVALID_CELSIUS;
+
+    int32_t lo = NTC_LUT[idx];
+    int32_t hi = (idx + 1 < NTC_LUT_SIZE) ? NTC_LUT[idx + 1] : NTC_LUT_INVALID;
+
+    // En los extremos no se interpola contra un código inválido
+    if (lo == NTC_LUT_INVALID) {
+        if (frac == 0 || hi == NTC_LUT_INVALID) return NTC_INVALID_CELSIUS;
+        return hi * LUT_SCALE;
+    }
+    if (frac == 0 || hi == NTC_LUT_INVALID) return lo * LUT_SCALE;
+
+    // Interpolación lineal en enteros: lo + (hi - lo) * frac / 2^frac_bits
+    int32_t q = lo + (int32_t)(((int64_t)(hi - lo) * frac) >> frac_bits);
+    return q * LUT_SCALE;
+}
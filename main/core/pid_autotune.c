@@ -0,0 +1,65 @@
+#include "pid_autotune.h"
+
+#define PI_F    3.14159265f
+
+void pid_autotune_init(pid_autotune_t *at, float setpoint_c, float hyst_c, uint32_t low, uint32_t high) {
+    *at = (pid_autotune_t){
+        .setpoint_c = setpoint_c,
+        .hyst_c = hyst_c,
+        .high = high,
+        .low = low,
+        .status = PID_AUTOTUNE_RUNNING,
+        .t_start = -1.0f,
+        .last_rise_t = -1.0f,
+        .peak_max = -1e9f,
+        .peak_min = 1e9f,
+    };
+}
+
+uint32_t pid_autotune_step(pid_autotune_t *at, float temp, float t_s) {
+    if (at->status != PID_AUTOTUNE_RUNNING) return at->low;
+    if (at->t_start < 0.0f) at->t_start = t_s;
+    if (t_s - at->t_start > PID_AUTOTUNE_MAX_S) {
+        at->status = PID_AUTOTUNE_FAILED;
+        return at->low;
+    }
+
+    if (temp > at->peak_max) at->peak_max = temp;
+    if (temp < at->peak_min) at->peak_min = temp;
+
+    if (!at->relay_high && temp > at->setpoint_c + at->hyst_c) {
+        // Conmuta a 'high': cierra un ciclo (subida a subida)
+        at->relay_high = true;
+        if (at->last_rise_t >= 0.0f) {
+            at->cycles++;
+            if (at->cycles > 1) {           // El primero arrastra el transitorio de arranque
+                at->sum_period += t_s - at->last_rise_t;
+                at->sum_amp += (at->peak_max - at->peak_min) * 0.5f;
+            }
+            if (at->cycles > PID_AUTOTUNE_CYCLES) {
+                int n = at->cycles - 1;
+                float a = at->sum_amp / (float)n;
+                float d = (float)(at->high - at->low) * 0.5f;
+                at->tu = at->sum_period / (float)n;
+                at->ku = (a > 0.0f) ? 4.0f * d / (PI_F * a) : 0.0f;
+                at->status = (at->ku > 0.0f && at->tu > 0.0f) ? PID_AUTOTUNE_DONE : PID_AUTOTUNE_FAILED;
+            }
+        }
+        at->last_rise_t = t_s;
+        at->peak_max = temp;
+        at->peak_min = temp;
+    } else if (at->relay_high && temp < at->setpoint_c - at->hyst_c) {
+        at->relay_high = false;
+    }
+    return at->relay_high ? at->high : at->low;
+}
+
+void pid_autotune_result(const pid_autotune_t *at, bool derivative, pid_params_t *out) {
+    // Tyreus-Luyben. PID: Kp = Ku/2.2, Ti = 2.2 Tu, Td = Tu/6.3; PI: Kp = Ku/3.2
+    float kp = at->ku / (derivative ? 2.2f : 3.2f);
+    float ti = 2.2f * at->tu;
+    float td = derivative ? at->tu / 6.3f : 0.0f;
+    out->kp = kp;
+    out->ki = kp / ti;
+    out->kd = kp * td;
+}
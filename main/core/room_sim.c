@@ -0,0 +1,148 @@
+#include "room_sim.h"
+#include <math.h>
+#include <string.h>
+
+#define DAY_S       86400u
+#define WEEK_S      (7u * DAY_S)
+#define PI_F        3.14159265f
+
+// Verano en el cuarto del bebé: exterior entre 22 y 28 °C, la habitación
+// llega a ~29.5 °C a media tarde sin ventilador. La planta es la misma del
+// mock original (tau 10 min, retardo 20 s, -4 °C a pleno). Ventilador chico
+// de 5 W que arranca al 15 %.
+const room_sim_params_t room_sim_default_params = {
+    .plant = {
+        .ambient_c = 27.0f,
+        .fan_gain_c = 4.0f,
+        .tau_s = 600.0f,
+        .dead_time_s = 20.0f,
+        .noise_c = 0.02f,
+        .step_s = 1.0f,
+    },
+    .outdoor_mean_c = 25.0f,
+    .outdoor_swing_c = 3.0f,
+    .internal_load_c = 1.0f,
+    .solar_load_c = 1.5f,
+    .occupant_load_c = 0.5f,
+    .fan_start_pct = 15,
+    .fan_curve_exp = 0.7f,
+    .fan_max_w = 5.0f,
+    .fan_min_w = 0.4f,
+    .comfort_lo_c = 22.0f,
+    .comfort_hi_c = 25.0f,
+    .occupancy = ROOM_OCC_NURSERY,
+    .motion_interval_s = 90.0f,
+    .burst_s = 60.0f,
+};
+
+static const char *const occupancy_names[ROOM_OCC_COUNT] = { "nursery", "always", "empty" };
+
+const char *room_sim_occupancy_name(room_occupancy_t occ) {
+    return (occ < ROOM_OCC_COUNT) ? occupancy_names[occ] : "?";
+}
+
+bool room_sim_profile_occupied(room_occupancy_t occ, uint32_t tod_s) {
+    switch (occ) {
+        case ROOM_OCC_NURSERY:
+            return tod_s >= 19 * 3600 + 1800 || tod_s < 7 * 3600 ||     // Noche
+                   (tod_s >= 13 * 3600 && tod_s < 15 * 3600);           // Siesta
+        case ROOM_OCC_ALWAYS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+float room_sim_fan_power_w(const room_sim_params_t *p, float duty) {
+    if (duty <= 0.0f) return 0.0f;
+    float u = duty / 100.0f;
+    return p->fan_min_w + (p->fan_max_w - p->fan_min_w) * u * u * u;
+}
+
+void room_sim_init(room_sim_t *s, const room_sim_params_t *p, uint32_t seed, uint32_t start_s) {
+    memset(s, 0, sizeof(*s));
+    s->p = *p;
+    s->start_s = start_s % WEEK_S;
+    s->seed = seed ? seed : 1;
+    s->last_motion_us = -1;
+    thermal_plant_init(&s->plant, &p->plant, seed);
+}
+
+static uint32_t week_s(const room_sim_t *s) {
+    return (uint32_t)((s->start_s + (uint64_t)(s->t_us / 1000000)) % WEEK_S);
+}
+
+uint32_t room_sim_time_of_day(const room_sim_t *s) { return week_s(s) % DAY_S; }
+uint32_t room_sim_weekday(const room_sim_t *s) { return week_s(s) / DAY_S; }
+
+// xorshift32, como el ruido de la planta
+static float rand_unit(room_sim_t *s) {
+    uint32_t x = s->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->seed = x;
+    return (float)(x >> 8) / 16777216.0f;
+}
+
+// Equilibrio sin ventilador en este segundo del día
+static float heat_load_c(const room_sim_t *s, uint32_t tod, bool occupied) {
+    const room_sim_params_t *p = &s->p;
+    float outdoor = p->outdoor_mean_c - p->outdoor_swing_c * cosf(2.0f * PI_F * (float)((tod + DAY_S - 5 * 3600) % DAY_S) / DAY_S);
+    float solar = 0.0f;
+    if (tod >= 9 * 3600 && tod < 19 * 3600) {
+        solar = p->solar_load_c * sinf(PI_F * (float)(tod - 9 * 3600) / (10 * 3600));
+    }
+    return outdoor + p->internal_load_c + solar + (occupied ? p->occupant_load_c : 0.0f);
+}
+
+static void step(room_sim_t *s) {
+    const room_sim_params_t *p = &s->p;
+    float dt = p->plant.step_s;
+    uint32_t tod = room_sim_time_of_day(s);
+
+    // Ventilador: pendiente hacia el pedido, como el fade del LEDC
+    float cmd = (float)s->duty_cmd;
+    float up = (float)s->slew_up * dt, down = (float)s->slew_down * dt;
+    if (cmd > s->duty) s->duty = (up > 0.0f && cmd - s->duty > up) ? s->duty + up : cmd;
+    else if (cmd < s->duty) s->duty = (down > 0.0f && s->duty - cmd > down) ? s->duty - down : cmd;
+
+    bool spin = s->duty >= (float)p->fan_start_pct;
+    if (spin && !s->spinning) s->score.fan_starts++;
+    s->spinning = spin;
+    float flow = spin ? powf(s->duty / 100.0f, p->fan_curve_exp) : 0.0f;
+
+    // Ocupación: movimientos sueltos de alguien quieto, continuos al entrar y salir
+    s->occupied = room_sim_profile_occupied(p->occupancy, tod);
+    if (s->occupied) {
+        uint32_t burst = (uint32_t)p->burst_s;
+        bool entering = !room_sim_profile_occupied(p->occupancy, (tod + DAY_S - burst) % DAY_S);
+        bool leaving = !room_sim_profile_occupied(p->occupancy, (tod + burst) % DAY_S);
+        if (entering || leaving || rand_unit(s) < dt / p->motion_interval_s) {
+            s->last_motion_us = s->t_us;
+            s->score.motions++;
+        }
+    }
+
+    s->plant.p.ambient_c = heat_load_c(s, tod, s->occupied);
+    thermal_plant_step(&s->plant, (uint32_t)(100.0f * flow + 0.5f));
+    s->t_us += (int64_t)(dt * 1e6f);
+
+    // Puntajes
+    room_sim_score_t *sc = &s->score;
+    sc->sim_s += dt;
+    sc->energy_wh += room_sim_fan_power_w(p, s->duty) * dt / 3600.0;
+    sc->duty_sum += s->duty * dt;
+    if (s->occupied) {
+        float t = s->plant.temp_c;
+        float out = (t > p->comfort_hi_c) ? t - p->comfort_hi_c : (t < p->comfort_lo_c) ? p->comfort_lo_c - t : 0.0f;
+        sc->occupied_s += dt;
+        if (out == 0.0f) sc->comfort_s += dt;
+        sc->discomfort_ch += out * dt / 3600.0;
+    }
+}
+
+void room_sim_advance(room_sim_t *s, int64_t until_us) {
+    int64_t step_us = (int64_t)(s->p.plant.step_s * 1e6f);
+    while (s->t_us + step_us <= until_us) step(s);
+}
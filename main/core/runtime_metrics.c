@@ -0,0 +1,298 @@
+#include "runtime_metrics.h"
+
+static const char *const lock_names[METRIC_LOCK_COUNT] = { "config", "schedule", "history" };
+static const char *const reason_names[SAMPLE_REASON_COUNT] = { "periodic", "presence", "threshold" };
+
+const char *metric_lock_name(metric_lock_t id) {
+    return (id < METRIC_LOCK_COUNT) ? lock_names[id] : "?";
+}
+
+// --- JSON ---
+
+static void hist_json(json_writer_t *w, const char *key, const latency_hist_t *h) {
+    json_key(w, key);
+    json_obj_begin(w);
+    json_kv_int(w, "n", h->count);
+    json_kv_int(w, "avg", latency_hist_avg(h));
+    json_kv_int(w, "p50", latency_hist_percentile(h, 50));
+    json_kv_int(w, "p99", latency_hist_percentile(h, 99));
+    json_kv_int(w, "max", h->max_us);
+    json_obj_end(w);
+}
+
+void runtime_metrics_json_write(json_writer_t *w, const runtime_metrics_t *m) {
+    json_obj_begin(w);
+    json_kv_int(w, "uptime_s", m->uptime_s);
+    json_kv_int(w, "heap_free", m->heap_free);
+    json_kv_int(w, "heap_min", m->heap_min);
+    json_kv_bool(w, "cpu_supported", m->cpu_supported);
+    json_kv_int(w, "cpu_window_ms", m->cpu_window_ms);
+    json_key(w, "core_busy_pct");
+    json_arr_begin(w);
+    for (int c = 0; c < m->core_count && c < METRICS_MAX_CORES; c++) {
+        json_fixed(w, m->core_busy_permille[c] / 10.0f, 1);
+    }
+    json_arr_end(w);
+
+    // Una tarea por elemento: nombre, núcleo, prioridad, % de un núcleo, stack libre
+    json_key(w, "tasks");
+    json_arr_begin(w);
+    for (int i = 0; i < m->task_count && i < METRICS_MAX_TASKS; i++) {
+        const task_metrics_t *t = &m->tasks[i];
+        json_obj_begin(w);
+        json_kv_str(w, "name", t->name);
+        json_kv_int(w, "core", t->core);
+        json_kv_int(w, "prio", t->priority);
+        json_kv_fixed(w, "cpu_pct", t->cpu_permille / 10.0f, 1);
+        json_kv_int(w, "stack_free", t->stack_free);
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+
+    json_key(w, "zones");
+    json_arr_begin(w);
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        const zone_metrics_t *zm = &m->zones[z];
+        json_obj_begin(w);
+        json_kv_int(w, "core", zm->core);
+        json_kv_int(w, "queue", zm->queue_len);
+        json_kv_int(w, "queue_cap", zm->queue_cap);
+        json_kv_int(w, "queue_max", zm->queue_max);
+        json_kv_int(w, "queue_full", zm->queue_full);
+        json_kv_int(w, "overruns", zm->overruns);
+        json_kv_int(w, "deadline_miss", zm->deadline_miss);
+        json_kv_int(w, "first_duty_ms", zm->first_duty_ms);
+        hist_json(w, "jitter_us", &zm->jitter);
+        json_key(w, "latency_us");
+        json_obj_begin(w);
+        for (int r = 0; r < SAMPLE_REASON_COUNT; r++) hist_json(w, reason_names[r], &zm->latency[r]);
+        json_obj_end(w);
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+
+    json_key(w, "lock_wait_us");
+    json_obj_begin(w);
+    for (int l = 0; l < METRIC_LOCK_COUNT; l++) hist_json(w, lock_names[l], &m->lock_wait[l]);
+    json_obj_end(w);
+    json_key(w, "lock_hold_us");
+    json_obj_begin(w);
+    for (int l = 0; l < METRIC_LOCK_COUNT; l++) hist_json(w, lock_names[l], &m->lock_hold[l]);
+    json_obj_end(w);
+    json_key(w, "log");
+    json_obj_begin(w);
+    json_kv_int(w, "written", m->log_written);
+    json_kv_int(w, "dropped", m->log_dropped);
+    json_kv_int(w, "suppressed", m->log_suppressed);
+    json_obj_end(w);
+    // Arranque: la red no demora el control (first_duty_ms va por zona)
+    json_key(w, "net");
+    json_obj_begin(w);
+    json_kv_str(w, "state", m->net_state != NULL ? m->net_state : "?");
+    json_kv_int(w, "attempts", m->net_attempts);
+    json_kv_int(w, "disconnects", m->net_disconnects);
+    json_kv_int(w, "init_errors", m->net_init_errors);
+    json_kv_int(w, "web_ms", m->net_web_ms);
+    json_kv_int(w, "wifi_ms", m->net_wifi_ms);
+    json_kv_int(w, "sntp_ms", m->net_sntp_ms);
+    json_obj_end(w);
+    json_obj_end(w);
+}
+
+// --- PROMETHEUS ---
+// Todo va a depth 0 del writer: json_int/json_fixed no agregan separadores
+
+static void prom_type(json_writer_t *w, const char *name, const char *type, const char *help) {
+    json_raw(w, "# HELP ");
+    json_raw(w, name);
+    json_raw(w, " ");
+    json_raw(w, help);
+    json_raw(w, "\n# TYPE ");
+    json_raw(w, name);
+    json_raw(w, " ");
+    json_raw(w, type);
+    json_raw(w, "\n");
+}
+
+// name{labels} (labels: 'k="v",...' ya armado, o NULL)
+static void prom_name(json_writer_t *w, const char *name, const char *suffix, const char *labels) {
+    json_raw(w, name);
+    if (suffix != NULL) json_raw(w, suffix);
+    if (labels != NULL && labels[0] != '\0') {
+        json_raw(w, "{");
+        json_raw(w, labels);
+        json_raw(w, "}");
+    }
+    json_raw(w, " ");
+}
+
+static void prom_int(json_writer_t *w, const char *name, const char *labels, int64_t v) {
+    prom_name(w, name, NULL, labels);
+    json_int(w, v);
+    json_raw(w, "\n");
+}
+
+// Hito de arranque en segundos (ms, 0 = todavía no: no se publica la serie)
+static void prom_ms(json_writer_t *w, const char *name, const char *labels, uint32_t ms) {
+    if (ms == 0) return;
+    prom_name(w, name, NULL, labels);
+    json_fixed(w, ms / 1000.0f, 3);
+    json_raw(w, "\n");
+}
+
+static void prom_ratio(json_writer_t *w, const char *name, const char *labels, uint32_t permille) {
+    prom_name(w, name, NULL, labels);
+    json_fixed(w, permille / 1000.0f, 3);
+    json_raw(w, "\n");
+}
+
+// Etiquetas en un buffer local (los nombres de tarea no llevan comillas ni '\')
+static const char *labels1(char *out, size_t cap, const char *k, const char *v) {
+    size_t n = 0;
+    for (const char *p = k; *p && n + 1 < cap; p++) out[n++] = *p;
+    const char *mid = "=\"";
+    for (const char *p = mid; *p && n + 1 < cap; p++) out[n++] = *p;
+    for (const char *p = v; *p && n + 1 < cap; p++) out[n++] = (*p == '"' || *p == '\\') ? '_' : *p;
+    if (n + 1 < cap) out[n++] = '"';
+    out[n] = '\0';
+    return out;
+}
+
+static const char *labels_append(char *out, size_t cap, const char *k, const char *v) {
+    size_t n = 0;
+    while (out[n]) n++;
+    if (n > 0 && n + 1 < cap) out[n++] = ',';
+    labels1(out + n, cap - n, k, v);
+    return out;
+}
+
+static const char *u_str(char *out, unsigned v) {
+    char tmp[10];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v > 0);
+    for (int i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    out[n] = '\0';
+    return out;
+}
+
+static void prom_hist(json_writer_t *w, const char *name, const char *labels, const latency_hist_t *h) {
+    char lb[96], le[12];
+    uint64_t cum = 0;
+    for (unsigned b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+        cum += h->buckets[b];
+        // Etiquetas del histograma + le (el último bucket es el de desborde)
+        size_t n = 0;
+        if (labels != NULL) { for (const char *p = labels; *p && n + 1 < sizeof(lb); p++) lb[n++] = *p; }
+        lb[n] = '\0';
+        labels_append(lb, sizeof(lb), "le", (b == LATENCY_HIST_BUCKETS - 1) ? "+Inf" : u_str(le, (1u << b) - 1));
+        prom_name(w, name, "_bucket", lb);
+        json_int(w, (int64_t)cum);
+        json_raw(w, "\n");
+    }
+    prom_name(w, name, "_sum", labels);
+    json_int(w, (int64_t)h->sum_us);
+    json_raw(w, "\n");
+    prom_name(w, name, "_count", labels);
+    json_int(w, h->count);
+    json_raw(w, "\n");
+}
+
+void runtime_metrics_prom_write(json_writer_t *w, const runtime_metrics_t *m) {
+    char lb[64], num[12];
+
+    prom_type(w, "cuna_uptime_seconds", "counter", "Segundos desde el arranque");
+    prom_int(w, "cuna_uptime_seconds", NULL, m->uptime_s);
+    prom_type(w, "cuna_heap_free_bytes", "gauge", "Heap libre");
+    prom_int(w, "cuna_heap_free_bytes", NULL, m->heap_free);
+    prom_type(w, "cuna_heap_min_free_bytes", "gauge", "Minimo de heap libre desde el arranque");
+    prom_int(w, "cuna_heap_min_free_bytes", NULL, m->heap_min);
+
+    if (m->cpu_supported) {
+        prom_type(w, "cuna_core_busy_ratio", "gauge", "Fraccion del nucleo fuera de la tarea idle desde la consulta anterior");
+        for (int c = 0; c < m->core_count && c < METRICS_MAX_CORES; c++) {
+            prom_ratio(w, "cuna_core_busy_ratio", labels1(lb, sizeof(lb), "core", u_str(num, c)), m->core_busy_permille[c]);
+        }
+        prom_type(w, "cuna_task_cpu_ratio", "gauge", "Fraccion de un nucleo usada por la tarea desde la consulta anterior");
+        for (int i = 0; i < m->task_count && i < METRICS_MAX_TASKS; i++) {
+            prom_ratio(w, "cuna_task_cpu_ratio", labels1(lb, sizeof(lb), "task", m->tasks[i].name), m->tasks[i].cpu_permille);
+        }
+    }
+    prom_type(w, "cuna_task_stack_free_bytes", "gauge", "Minimo de stack libre de la tarea desde el arranque");
+    for (int i = 0; i < m->task_count && i < METRICS_MAX_TASKS; i++) {
+        prom_int(w, "cuna_task_stack_free_bytes", labels1(lb, sizeof(lb), "task", m->tasks[i].name), m->tasks[i].stack_free);
+    }
+
+    prom_type(w, "cuna_queue_depth", "gauge", "Muestras en la cola SensorTask -> ControlTask");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_queue_depth", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].queue_len);
+    }
+    prom_type(w, "cuna_queue_capacity", "gauge", "Capacidad de la cola de la zona");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_queue_capacity", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].queue_cap);
+    }
+    prom_type(w, "cuna_queue_max_depth", "gauge", "Maxima ocupacion observada de la cola");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_queue_max_depth", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].queue_max);
+    }
+    prom_type(w, "cuna_queue_full_total", "counter", "Muestras descartadas por cola llena");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_queue_full_total", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].queue_full);
+    }
+
+    prom_type(w, "cuna_samples_total", "counter", "Muestras enviadas a control_task por motivo");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        for (int r = 0; r < SAMPLE_REASON_COUNT; r++) {
+            labels1(lb, sizeof(lb), "zone", u_str(num, z));
+            labels_append(lb, sizeof(lb), "reason", reason_names[r]);
+            prom_int(w, "cuna_samples_total", lb, m->zones[z].samples[r]);
+        }
+    }
+    prom_type(w, "cuna_loop_latency_us", "histogram", "Despertar de SensorTask -> set_duty (us)");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        for (int r = 0; r < SAMPLE_REASON_COUNT; r++) {
+            labels1(lb, sizeof(lb), "zone", u_str(num, z));
+            labels_append(lb, sizeof(lb), "reason", reason_names[r]);
+            prom_hist(w, "cuna_loop_latency_us", lb, &m->zones[z].latency[r]);
+        }
+    }
+
+    prom_type(w, "cuna_period_jitter_us", "histogram", "Muestras periodicas: despertar - vencimiento de la grilla (us)");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_hist(w, "cuna_period_jitter_us", labels1(lb, sizeof(lb), "zone", u_str(num, z)), &m->zones[z].jitter);
+    }
+    prom_type(w, "cuna_period_overruns_total", "counter", "Vencimientos periodicos saltados por atraso de mas de un periodo");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_period_overruns_total", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].overruns);
+    }
+    prom_type(w, "cuna_deadline_miss_total", "counter", "Muestras actuadas despues de vencimiento + plazo");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_int(w, "cuna_deadline_miss_total", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].deadline_miss);
+    }
+
+    prom_type(w, "cuna_boot_first_duty_seconds", "gauge", "Primera actuacion del ventilador desde el arranque");
+    for (int z = 0; z < m->zone_count && z < MAX_ZONES; z++) {
+        prom_ms(w, "cuna_boot_first_duty_seconds", labels1(lb, sizeof(lb), "zone", u_str(num, z)), m->zones[z].first_duty_ms);
+    }
+    prom_type(w, "cuna_boot_net_seconds", "gauge", "Hitos de la red en segundo plano desde el arranque");
+    prom_ms(w, "cuna_boot_net_seconds", "milestone=\"web\"", m->net_web_ms);
+    prom_ms(w, "cuna_boot_net_seconds", "milestone=\"wifi\"", m->net_wifi_ms);
+    prom_ms(w, "cuna_boot_net_seconds", "milestone=\"sntp\"", m->net_sntp_ms);
+    prom_type(w, "cuna_net_events_total", "counter", "Red: intentos de conexion, caidas y fallos de arranque");
+    prom_int(w, "cuna_net_events_total", "event=\"attempt\"", m->net_attempts);
+    prom_int(w, "cuna_net_events_total", "event=\"disconnect\"", m->net_disconnects);
+    prom_int(w, "cuna_net_events_total", "event=\"init_error\"", m->net_init_errors);
+
+    prom_type(w, "cuna_log_records_total", "counter", "Log binario: registros por resultado");
+    prom_int(w, "cuna_log_records_total", "result=\"written\"", m->log_written);
+    prom_int(w, "cuna_log_records_total", "result=\"dropped\"", m->log_dropped);
+    prom_int(w, "cuna_log_records_total", "result=\"suppressed\"", m->log_suppressed);
+
+    prom_type(w, "cuna_lock_wait_us", "histogram", "Espera para tomar el mutex (us)");
+    for (int l = 0; l < METRIC_LOCK_COUNT; l++) {
+        prom_hist(w, "cuna_lock_wait_us", labels1(lb, sizeof(lb), "lock", lock_names[l]), &m->lock_wait[l]);
+    }
+    prom_type(w, "cuna_lock_hold_us", "histogram", "Tiempo con el mutex tomado (us)");
+    for (int l = 0; l < METRIC_LOCK_COUNT; l++) {
+        prom_hist(w, "cuna_lock_hold_us", labels1(lb, sizeof(lb), "lock", lock_names[l]), &m->lock_hold[l]);
+    }
+}
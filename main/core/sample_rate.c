@@ -0,0 +1,180 @@
+#include "sample_rate.h"
+#include <math.h>
+
+// Umbrales AUTO (ver control_decide)
+#define AUTO_T_MIN  15.0f
+#define AUTO_T_MAX  25.0f
+
+static bool temp_usable(temp_quality_t q, float t) {
+    return q != TEMP_QUALITY_INVALID && !isnan(t);
+}
+
+static void add_ramp(sample_rate_t *r, float lo, float hi) {
+    for (int i = 0; i < r->ramp_count; i++) {
+        if (r->ramp_lo[i] == lo && r->ramp_hi[i] == hi) return;
+    }
+    if (r->ramp_count < SAMPLE_RATE_MAX_RAMPS) {
+        r->ramp_lo[r->ramp_count] = lo;
+        r->ramp_hi[r->ramp_count] = hi;
+        r->ramp_count++;
+    }
+}
+
+void sample_rate_configure(sample_rate_t *r, const system_config_t *cfg, const zone_config_t *zone) {
+    r->min_ms = cfg->sample_min_ms ? cfg->sample_min_ms : 1;
+    r->max_ms = cfg->sample_max_ms < r->min_ms ? r->min_ms : cfg->sample_max_ms;
+    if (r->period_ms < r->min_ms) r->period_ms = r->min_ms;
+    if (r->period_ms > r->max_ms) r->period_ms = r->max_ms;
+    // Cotas nuevas: un máximo más corto aplica ya, sin esperar al vencimiento viejo
+    if (r->has_last && r->due_us > r->last_due_us + (int64_t)r->period_ms * 1000) {
+        r->due_us = r->last_due_us + (int64_t)r->period_ms * 1000;
+    }
+
+    // Solo importan los umbrales del modo vigente: en MANUAL la temperatura
+    // no cambia la salida. El PID además integra con el período adaptativo.
+    r->ramp_count = 0;
+    if (zone->operation_mode == MODE_AUTO) {
+        add_ramp(r, AUTO_T_MIN, AUTO_T_MAX);
+    } else if (zone->operation_mode == MODE_SCHEDULE) {
+        for (int i = 0; i < cfg->schedule_count && i < MAX_SCHEDULES; i++) {
+            if (!cfg->schedules[i].active) continue;
+            add_ramp(r, cfg->schedules[i].temp_min_0_percent, cfg->schedules[i].temp_max_100_percent);
+        }
+    } else if (zone->operation_mode == MODE_PID && zone->pid.kp > 0.0f) {
+        // Zona en la que el término P recorre 0-100 %: mismo paso de PWM que una rampa
+        float half = 50.0f / zone->pid.kp;
+        add_ramp(r, zone->pid.setpoint_c - half, zone->pid.setpoint_c + half);
+    } else if (zone->operation_mode == MODE_HYSTERESIS) {
+        // Solo importan los bordes: rampas degeneradas (sin paso fino dentro de la banda)
+        float half = zone->hysteresis.band_c * 0.5f;
+        add_ramp(r, zone->hysteresis.setpoint_c - half, zone->hysteresis.setpoint_c - half);
+        add_ramp(r, zone->hysteresis.setpoint_c + half, zone->hysteresis.setpoint_c + half);
+    }
+}
+
+void sample_rate_init(sample_rate_t *r, const system_config_t *cfg, const zone_config_t *zone) {
+    *r = (sample_rate_t){0};
+    r->period_ms = cfg->sample_max_ms;
+    sample_rate_configure(r, cfg, zone);
+}
+
+// Banda alrededor de 'from': el borde más cercano entre el salto máximo, el
+// paso de PWM de las rampas que contienen 'from' y los umbrales (con histéresis)
+static void band_around(const sample_rate_t *r, float from, float *lo, float *hi) {
+    float half = SAMPLE_RATE_JUMP_C;
+    for (int i = 0; i < r->ramp_count; i++) {
+        float tl = r->ramp_lo[i], th = r->ramp_hi[i];
+        if (from >= tl && from < th) {
+            float step = (th - tl) * (SAMPLE_RATE_PWM_STEP / 100.0f);
+            if (step < half) half = step;
+        }
+    }
+    *lo = from - half;
+    *hi = from + half;
+
+    for (int i = 0; i < r->ramp_count; i++) {
+        float edges[2] = { r->ramp_lo[i], r->ramp_hi[i] };
+        for (int e = 0; e < 2; e++) {
+            float t = edges[e];
+            if (from < t) {
+                if (t + SAMPLE_RATE_HYST_C < *hi) *hi = t + SAMPLE_RATE_HYST_C;
+            } else if (t - SAMPLE_RATE_HYST_C > *lo) {
+                *lo = t - SAMPLE_RATE_HYST_C;
+            }
+        }
+    }
+}
+
+// Actualiza la pendiente y el período con la muestra que se envía
+static void update_period(sample_rate_t *r, float temp, bool usable, int64_t now_us) {
+    if (!usable) {
+        r->has_ref = false;
+        return;
+    }
+    if (!r->has_ref) {
+        r->has_ref = true;
+        r->ref_temp = temp;
+        r->ref_us = now_us;
+        return;
+    }
+    int64_t dt_us = now_us - r->ref_us;
+    if (dt_us < (int64_t)SAMPLE_RATE_MIN_DT_MS * 1000) return;   // Con bases cortas domina el ruido
+
+    float inst = fabsf(temp - r->ref_temp) * 1e6f / (float)dt_us;
+    // Sube rápido y baja lento: un cambio brusco acorta el período enseguida
+    float alpha = (inst > r->rate_c_per_s) ? 0.5f : 0.125f;
+    r->rate_c_per_s += alpha * (inst - r->rate_c_per_s);
+    r->ref_temp = temp;
+    r->ref_us = now_us;
+
+    float period = (r->rate_c_per_s > 0.0f) ? SAMPLE_RATE_STEP_C * 1000.0f / r->rate_c_per_s : (float)r->max_ms;
+    if (period < (float)r->min_ms) period = (float)r->min_ms;
+    if (period > (float)r->max_ms) period = (float)r->max_ms;
+    r->period_ms = (uint32_t)period;
+}
+
+static bool outside_band(const sample_rate_t *r, float from, float to) {
+    float lo, hi;
+    band_around(r, from, &lo, &hi);
+    return to < lo || to >= hi;
+}
+
+bool sample_rate_check(sample_rate_t *r, const sensor_data_t *s, int64_t now_us, sample_reason_t *reason) {
+    bool usable = temp_usable(s->temp_quality, s->temperature);
+    sample_reason_t why;
+
+    if (!r->has_last) {
+        why = SAMPLE_PERIODIC;
+    } else if (s->presence_detected != r->last_presence) {
+        why = SAMPLE_PRESENCE;
+    } else if (s->temp_quality != r->last_quality) {
+        why = SAMPLE_THRESHOLD;
+    } else if (usable && temp_usable(r->last_quality, r->last_temp) &&
+               outside_band(r, r->last_temp, s->temperature)) {
+        why = SAMPLE_THRESHOLD;
+    } else if (now_us >= r->due_us) {
+        why = SAMPLE_PERIODIC;
+    } else {
+        return false;
+    }
+
+    bool on_grid = r->has_last && why == SAMPLE_PERIODIC;
+    update_period(r, s->temperature, usable, now_us);
+    r->has_last = true;
+    r->last_presence = s->presence_detected;
+    r->last_quality = s->temp_quality;
+    if (usable) r->last_temp = s->temperature;
+    r->last_us = now_us;
+
+    // Tasa fija: el próximo vencimiento sale del atendido, no de now_us
+    int64_t period_us = (int64_t)r->period_ms * 1000;
+    r->last_due_us = on_grid ? r->due_us : now_us;
+    r->due_us = r->last_due_us + period_us;
+    if (r->due_us <= now_us) {
+        int64_t missed = (now_us - r->due_us) / period_us + 1;
+        r->due_us += missed * period_us;
+        r->overruns += (uint32_t)missed;
+    }
+    *reason = why;
+    return true;
+}
+
+void sample_rate_watch_band(const sample_rate_t *r, float *lo, float *hi) {
+    if (!r->has_last || !temp_usable(r->last_quality, r->last_temp)) {
+        // Sin referencia válida solo interesa el cambio de calidad
+        *lo = -INFINITY;
+        *hi = INFINITY;
+        return;
+    }
+    band_around(r, r->last_temp, lo, hi);
+}
+
+int64_t sample_rate_deadline_us(const sample_rate_t *r, int64_t now_us) {
+    return r->has_last ? r->due_us : now_us;
+}
+
+int64_t sample_rate_next_check_us(const sample_rate_t *r, int64_t now_us) {
+    int64_t next = now_us + (int64_t)r->min_ms * 1000;
+    int64_t due = sample_rate_deadline_us(r, now_us);
+    return (due < next) ? due : next;
+}
@@ -0,0 +1,68 @@
+#include "schedule_index.h"
+#include "control_logic.h"
+#include <string.h>
+
+static bool reg_is_valid(const schedule_reg_t *reg) {
+    return reg->start_hour < 24 && reg->start_min < 60 &&
+           reg->end_hour < 24 && reg->end_min < 60;
+}
+
+int schedule_minute_of_week(const struct tm *now) {
+    return (now->tm_wday * SCHEDULE_MINUTES_PER_DAY) + (now->tm_hour * 60) + now->tm_min;
+}
+
+void schedule_index_compile(schedule_index_t *idx, const system_config_t *cfg) {
+    memset(idx->slot, SCHEDULE_SLOT_NONE, sizeof(idx->slot));
+    idx->rule_count = 0;
+
+    int count = cfg->schedule_count;
+    if (count > MAX_SCHEDULES) count = MAX_SCHEDULES;
+
+    // Orden ascendente + "solo slots libres" = gana el menor índice
+    for (int i = 0; i < count; i++) {
+        const schedule_reg_t *reg = &cfg->schedules[i];
+        if (!reg->active || reg->days == 0 || !reg_is_valid(reg)) continue;
+
+        uint8_t r = idx->rule_count++;
+        idx->rules[r].t_min = reg->temp_min_0_percent;
+        idx->rules[r].t_max = reg->temp_max_100_percent;
+        idx->rules[r].source = (uint8_t)i;
+
+        int start = reg->start_hour * 60 + reg->start_min;
+        int end = reg->end_hour * 60 + reg->end_min;
+        int len = (end - start + SCHEDULE_MINUTES_PER_DAY) % SCHEDULE_MINUTES_PER_DAY;
+        if (len == 0) len = SCHEDULE_MINUTES_PER_DAY;   // inicio == fin: todo el día
+
+        for (int day = 0; day < 7; day++) {
+            if (!(reg->days & (1u << day))) continue;
+            int base = day * SCHEDULE_MINUTES_PER_DAY + start;
+            for (int m = 0; m < len; m++) {
+                int s = (base + m) % SCHEDULE_MINUTES_PER_WEEK;  // Sábado -> Domingo
+                if (idx->slot[s] == SCHEDULE_SLOT_NONE) idx->slot[s] = r;
+            }
+        }
+    }
+}
+
+const schedule_rule_t *schedule_index_lookup(const schedule_index_t *idx, const struct tm *now) {
+    int mow = schedule_minute_of_week(now);
+    if (mow < 0 || mow >= SCHEDULE_MINUTES_PER_WEEK) return NULL;
+    uint8_t r = idx->slot[mow];
+    return (r == SCHEDULE_SLOT_NONE) ? NULL : &idx->rules[r];
+}
+
+bool schedule_rule_matches(const schedule_reg_t *reg, const struct tm *now) {
+    if (!reg->active || !reg_is_valid(reg) || !is_time_in_range(now, reg)) return false;
+
+    int now_mins = now->tm_hour * 60 + now->tm_min;
+    int start_mins = reg->start_hour * 60 + reg->start_min;
+    int end_mins = reg->end_hour * 60 + reg->end_min;
+
+    // En la parte "de madrugada" de una regla que cruza medianoche, la regla
+    // empezó el día anterior
+    int start_day = now->tm_wday;
+    if (start_mins >= end_mins && now_mins < start_mins) {
+        start_day = (start_day + 6) % 7;
+    }
+    return (reg->days & (1u << start_day)) != 0;
+}
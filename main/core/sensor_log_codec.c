@@ -0,0 +1,199 @@
+#include "sensor_log_codec.h"
+#include <string.h>
+#include <math.h>
+
+uint32_t slog_crc32(const void *data, size_t len) {
+    // CRC-32 (IEEE, reflejado) bit a bit: solo cubre cabeceras de 20 bytes
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static size_t put_varint(uint8_t *out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Devuelve los bytes consumidos, o 0 si el varint está truncado o es inválido
+static size_t get_varint(const uint8_t *in, size_t avail, uint64_t *v) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < avail && i < 10; i++) {
+        result |= (uint64_t)(in[i] & 0x7F) << (7 * i);
+        if (!(in[i] & 0x80)) {
+            *v = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+void slog_record_from_sample(slog_record_t *rec, int64_t ts, const sensor_data_t *data, uint32_t pwm) {
+    rec->ts = ts;
+    rec->presence = data->presence_detected;
+    rec->quality = data->temp_quality;
+    rec->pwm = (uint8_t)(pwm > 100 ? 100 : pwm);
+
+    float v = roundf(data->temperature * 100.0f);
+    if (data->temp_quality == TEMP_QUALITY_INVALID || isnan(v)) {
+        rec->temp_c100 = SLOG_NO_TEMP;
+    } else if (v <= (float)(INT16_MIN + 1)) {
+        rec->temp_c100 = INT16_MIN + 1;
+    } else if (v >= (float)INT16_MAX) {
+        rec->temp_c100 = INT16_MAX;
+    } else {
+        rec->temp_c100 = (int16_t)v;
+    }
+}
+
+size_t slog_block_begin(uint8_t *block, uint32_t seq, const slog_record_t *first, slog_cursor_t *cur) {
+    slog_block_header_t hdr = {
+        .magic = SLOG_MAGIC,
+        .seq = seq,
+        .base_ts = first->ts,
+        .base_temp = first->temp_c100,
+        .base_pwm = first->pwm,
+        .version = SLOG_VERSION,
+    };
+    hdr.crc = slog_crc32(&hdr, offsetof(slog_block_header_t, crc));
+    memcpy(block, &hdr, sizeof(hdr));
+
+    cur->ts = hdr.base_ts;
+    cur->temp_c100 = hdr.base_temp;
+    cur->pwm = hdr.base_pwm;
+    return sizeof(hdr);
+}
+
+size_t slog_encode(slog_cursor_t *cur, const slog_record_t *rec, uint8_t *out, size_t cap) {
+    uint8_t tmp[SLOG_MAX_RECORD_BYTES];
+    size_t n = 1;
+    uint8_t flags = (rec->presence ? SLOG_F_PRESENCE : 0) |
+                    (uint8_t)((rec->quality << SLOG_F_QUALITY_SHIFT) & SLOG_F_QUALITY_MASK);
+
+    if (rec->pwm != cur->pwm) {
+        flags |= SLOG_F_PWM;
+        tmp[n++] = rec->pwm;
+    }
+
+    int64_t dt = rec->ts - cur->ts;
+    if (dt == 1) {
+        flags |= SLOG_F_DT_ONE;
+    } else {
+        n += put_varint(&tmp[n], zigzag(dt));
+    }
+
+    // La temperatura de referencia es la última válida (cur->temp_c100 puede
+    // ser SLOG_NO_TEMP si el bloque empezó sin lectura)
+    int16_t base_temp = (cur->temp_c100 == SLOG_NO_TEMP) ? 0 : cur->temp_c100;
+    if (rec->temp_c100 == SLOG_NO_TEMP) {
+        flags |= SLOG_F_NO_TEMP;
+    } else if (rec->temp_c100 == base_temp && cur->temp_c100 != SLOG_NO_TEMP) {
+        flags |= SLOG_F_DTEMP_ZERO;
+    } else {
+        n += put_varint(&tmp[n], zigzag((int64_t)rec->temp_c100 - base_temp));
+    }
+
+    if (n > cap) return 0;
+    tmp[0] = flags;
+    memcpy(out, tmp, n);
+
+    cur->ts = rec->ts;
+    cur->pwm = rec->pwm;
+    if (rec->temp_c100 != SLOG_NO_TEMP) cur->temp_c100 = rec->temp_c100;
+    return n;
+}
+
+bool slog_header_read(const uint8_t *block, slog_block_header_t *out) {
+    slog_block_header_t hdr;
+    memcpy(&hdr, block, sizeof(hdr));
+    if (hdr.magic != SLOG_MAGIC || hdr.version != SLOG_VERSION) return false;
+    if (hdr.crc != slog_crc32(&hdr, offsetof(slog_block_header_t, crc))) return false;
+    if (out != NULL) *out = hdr;
+    return true;
+}
+
+size_t slog_decode_block(const uint8_t *block, size_t len, slog_record_fn fn, void *ctx,
+                         size_t *used, slog_cursor_t *last) {
+    slog_block_header_t hdr;
+    size_t off = sizeof(hdr);
+    size_t count = 0;
+
+    if (len < sizeof(hdr) || !slog_header_read(block, &hdr)) {
+        if (used != NULL) *used = 0;
+        return 0;
+    }
+    slog_cursor_t cur = { .ts = hdr.base_ts, .temp_c100 = hdr.base_temp, .pwm = hdr.base_pwm };
+
+    while (off < len && block[off] != 0xFF) {
+        uint8_t flags = block[off];
+        size_t p = off + 1;
+        if (flags & SLOG_F_RESERVED) break;
+
+        slog_record_t rec = {
+            .presence = (flags & SLOG_F_PRESENCE) != 0,
+            .quality = (temp_quality_t)((flags & SLOG_F_QUALITY_MASK) >> SLOG_F_QUALITY_SHIFT),
+        };
+
+        uint8_t pwm = cur.pwm;
+        if (flags & SLOG_F_PWM) {
+            if (p >= len) break;
+            pwm = block[p++];
+            if (pwm > 100) break;   // 0xFF: registro cortado a mitad de escritura
+        }
+
+        int64_t dt = 1;
+        if (!(flags & SLOG_F_DT_ONE)) {
+            uint64_t v;
+            size_t k = get_varint(&block[p], len - p, &v);
+            if (k == 0) break;
+            dt = unzigzag(v);
+            p += k;
+        }
+
+        int16_t temp = cur.temp_c100;
+        if (flags & SLOG_F_NO_TEMP) {
+            temp = SLOG_NO_TEMP;
+        } else if (!(flags & SLOG_F_DTEMP_ZERO)) {
+            uint64_t v;
+            size_t k = get_varint(&block[p], len - p, &v);
+            if (k == 0) break;
+            int64_t t = (cur.temp_c100 == SLOG_NO_TEMP ? 0 : cur.temp_c100) + unzigzag(v);
+            if (t <= INT16_MIN || t > INT16_MAX) break;
+            temp = (int16_t)t;
+            p += k;
+        }
+
+        cur.ts += dt;
+        cur.pwm = pwm;
+        if (temp != SLOG_NO_TEMP) cur.temp_c100 = temp;
+
+        rec.ts = cur.ts;
+        rec.pwm = pwm;
+        rec.temp_c100 = temp;
+        if (fn != NULL) fn(ctx, &rec);
+        count++;
+        off = p;
+    }
+
+    if (used != NULL) *used = off;
+    if (last != NULL) *last = cur;
+    return count;
+}
@@ -0,0 +1,37 @@
+#include "snapshot.h"
+#include <string.h>
+
+void snapshot_init(snapshot_t *s, void *slot_a, void *slot_b, size_t size, const void *initial) {
+    s->slots[0] = slot_a;
+    s->slots[1] = slot_b;
+    s->size = size;
+    memcpy(slot_a, initial, size);
+    memcpy(slot_b, initial, size);
+    atomic_store_explicit(&s->version, 0, memory_order_release);
+}
+
+uint32_t snapshot_read(snapshot_t *s, void *out) {
+    uint32_t v1, v2;
+    do {
+        v1 = atomic_load_explicit(&s->version, memory_order_acquire);
+        memcpy(out, s->slots[v1 & 1u], s->size);
+        // La copia debe quedar ordenada antes de releer la versión
+        atomic_thread_fence(memory_order_acquire);
+        v2 = atomic_load_explicit(&s->version, memory_order_relaxed);
+    } while (v1 != v2);
+    return v1;
+}
+
+uint32_t snapshot_publish(snapshot_t *s, const void *src) {
+    uint32_t v = atomic_load_explicit(&s->version, memory_order_relaxed);
+    // La publicación anterior debe ser visible antes de pisar el slot inactivo
+    // (un lector lento puede estar copiándolo todavía: detectará el cambio).
+    atomic_thread_fence(memory_order_release);
+    memcpy(s->slots[(v + 1) & 1u], src, s->size);
+    atomic_store_explicit(&s->version, v + 1, memory_order_release);
+    return v + 1;
+}
+
+uint32_t snapshot_version(snapshot_t *s) {
+    return atomic_load_explicit(&s->version, memory_order_acquire);
+}
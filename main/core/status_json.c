@@ -0,0 +1,98 @@
+#include "status_json.h"
+
+// Un float de la configuración: en /api/status con los decimales que muestra
+// la UI (va en cada push); en /api/config exacto, para que GET -> PUT no
+// cambie ganancias ni consignas ni suba la versión sin una edición
+static void cfg_float(json_writer_t *w, const char *key, float v, unsigned decimals, bool exact) {
+    if (exact) json_kv_float(w, key, v);
+    else json_kv_fixed(w, key, v, decimals);
+}
+
+// Configuración de una zona (claves de /api/settings y /api/config)
+static void zone_config_fields(json_writer_t *w, const zone_config_t *zc, bool exact) {
+    json_kv_int(w, "mode", zc->operation_mode);
+    json_kv_int(w, "manual_duty", zc->manual_duty);
+    cfg_float(w, "pid_sp", zc->pid.setpoint_c, 2, exact);
+    cfg_float(w, "pid_kp", zc->pid.kp, 2, exact);
+    cfg_float(w, "pid_ki", zc->pid.ki, 4, exact);
+    cfg_float(w, "pid_kd", zc->pid.kd, 1, exact);
+    json_kv_int(w, "pid_db", zc->pid.deadband_pct);
+    cfg_float(w, "hyst_sp", zc->hysteresis.setpoint_c, 2, exact);
+    cfg_float(w, "hyst_band", zc->hysteresis.band_c, 2, exact);
+    json_kv_int(w, "hyst_pwm", zc->hysteresis.on_pwm);
+}
+
+static void zone_json_write(json_writer_t *w, const zone_config_t *zc, const system_state_t *state) {
+    json_obj_begin(w);
+    zone_config_fields(w, zc, false);
+    json_kv_fixed(w, "temp", state->current_temp, 2);
+    json_kv_int(w, "tq", state->temp_quality);
+    json_kv_bool(w, "pir", state->presence);
+    json_kv_int(w, "pwm", state->current_pwm);
+    json_kv_bool(w, "fading", state->fan_fading);
+    json_obj_end(w);
+}
+
+// Campos globales (los mismos en /api/status y /api/config)
+static void global_fields(json_writer_t *w, const system_config_t *cfg) {
+    json_kv_int(w, "version", cfg->version);
+    json_kv_int(w, "hold", cfg->presence_hold_s);
+    json_kv_int(w, "rate_min", cfg->sample_min_ms);
+    json_kv_int(w, "rate_max", cfg->sample_max_ms);
+    json_kv_int(w, "deadline", cfg->sample_deadline_ms);
+    json_kv_int(w, "slew_up", cfg->fan_slew_up);
+    json_kv_int(w, "slew_down", cfg->fan_slew_down);
+    json_kv_int(w, "power", cfg->power_mode);
+    json_kv_int(w, "zone_count", cfg->zone_count);
+}
+
+static void schedules_write(json_writer_t *w, const system_config_t *cfg, bool exact) {
+    json_key(w, "schedules");
+    json_arr_begin(w);
+    for (int i = 0; i < cfg->schedule_count && i < MAX_SCHEDULES; i++) {
+        const schedule_reg_t *reg = &cfg->schedules[i];
+        json_obj_begin(w);
+        json_kv_bool(w, "act", reg->active);
+        json_kv_int(w, "days", reg->days);
+        json_kv_int(w, "sh", reg->start_hour);
+        json_kv_int(w, "sm", reg->start_min);
+        json_kv_int(w, "eh", reg->end_hour);
+        json_kv_int(w, "em", reg->end_min);
+        cfg_float(w, "tmin", reg->temp_min_0_percent, 2, exact);
+        cfg_float(w, "tmax", reg->temp_max_100_percent, 2, exact);
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+}
+
+void status_json_write(json_writer_t *w, const system_config_t *cfg, const system_state_t *states, unsigned zone_count) {
+    json_obj_begin(w);
+    global_fields(w, cfg);
+    json_kv_str(w, "time", zone_count > 0 ? states[0].current_time_str : "");
+
+    json_key(w, "zones");
+    json_arr_begin(w);
+    for (unsigned z = 0; z < zone_count && z < MAX_ZONES; z++) {
+        zone_json_write(w, &cfg->zones[z], &states[z]);
+    }
+    json_arr_end(w);
+
+    schedules_write(w, cfg, false);
+    json_kv_int(w, "sched_max", MAX_SCHEDULES);
+    json_obj_end(w);
+}
+
+void config_json_write(json_writer_t *w, const system_config_t *cfg) {
+    json_obj_begin(w);
+    global_fields(w, cfg);
+    json_key(w, "zones");
+    json_arr_begin(w);
+    for (unsigned z = 0; z < cfg->zone_count && z < MAX_ZONES; z++) {
+        json_obj_begin(w);
+        zone_config_fields(w, &cfg->zones[z], true);
+        json_obj_end(w);
+    }
+    json_arr_end(w);
+    schedules_write(w, cfg, true);
+    json_obj_end(w);
+}
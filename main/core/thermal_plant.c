@@ -0,0 +1,45 @@
+#include "thermal_plant.h"
+#include <string.h>
+
+// Cuarto de bebé con un ventilador chico: sin ventilador se estabiliza en
+// 27 °C y a pleno baja 4 °C; la habitación responde en ~10 min y el aire
+// tarda ~20 s en llegar del ventilador al sensor.
+const thermal_plant_params_t thermal_plant_default_params = {
+    .ambient_c = 27.0f,
+    .fan_gain_c = 4.0f,
+    .tau_s = 600.0f,
+    .dead_time_s = 20.0f,
+    .noise_c = 0.02f,
+    .step_s = 1.0f,
+};
+
+void thermal_plant_init(thermal_plant_t *pl, const thermal_plant_params_t *params, uint32_t seed) {
+    memset(pl, 0, sizeof(*pl));
+    pl->p = *params;
+    pl->temp_c = params->ambient_c;
+    pl->seed = seed ? seed : 1;
+
+    float steps = params->dead_time_s / params->step_s;
+    pl->delay_len = (steps < 1.0f) ? 1 : (steps >= THERMAL_PLANT_DELAY_LEN) ? THERMAL_PLANT_DELAY_LEN : (uint16_t)steps;
+}
+
+void thermal_plant_step(thermal_plant_t *pl, uint32_t pwm) {
+    // El PWM que actúa ahora es el de hace dead_time_s
+    uint8_t acting = pl->delay[pl->delay_pos];
+    pl->delay[pl->delay_pos] = (uint8_t)(pwm > 100 ? 100 : pwm);
+    pl->delay_pos = (uint16_t)((pl->delay_pos + 1) % pl->delay_len);
+
+    float t_eq = pl->p.ambient_c - pl->p.fan_gain_c * (float)acting / 100.0f;
+    pl->temp_c += (t_eq - pl->temp_c) * pl->p.step_s / pl->p.tau_s;
+}
+
+float thermal_plant_measure(thermal_plant_t *pl) {
+    // xorshift32: mismo ruido en el ESP32 y en host para la misma semilla
+    uint32_t x = pl->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pl->seed = x;
+    float u = (float)(x >> 8) / 16777216.0f;    // [0, 1)
+    return pl->temp_c + (2.0f * u - 1.0f) * pl->p.noise_c;
+}
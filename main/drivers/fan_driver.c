@@ -1,59 +1,163 @@
 #include "hal_interfaces.h"
+#include "power_manager.h"
 #include <driver/ledc.h>
 #include <esp_log.h>
+#include <esp_attr.h>
+#include <stdatomic.h>
 
 static const char *TAG = "FAN_DRIVER";
 
-// Configuración PWM
-#define FAN_GPIO        2       // LED integrado del ESP32 (Cambia a 18 cuando tengas el RGB con resistencia)
+// Configuración PWM: un canal LEDC por zona, todos del mismo timer
 #define LEDC_TIMER      LEDC_TIMER_0
 #define LEDC_MODE       LEDC_LOW_SPEED_MODE
-#define LEDC_OUTPUT_IO  FAN_GPIO
-#define LEDC_CHANNEL    LEDC_CHANNEL_0
 #define LEDC_DUTY_RES   LEDC_TIMER_13_BIT // Resolución de 13 bits (0-8191)
 #define LEDC_FREQUENCY  5000    // Frecuencia 5 kHz (buena para LEDs y motores)
+#define LEDC_DUTY_MAX   8191
+#define FAN_CHANNELS    8       // Canales de baja velocidad del LEDC
 
-esp_err_t fan_driver_init(void) {
-    // 1. Configurar Timer
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode       = LEDC_MODE,
-        .timer_num        = LEDC_TIMER,
-        .duty_resolution  = LEDC_DUTY_RES,
-        .freq_hz          = LEDC_FREQUENCY, 
-        .clk_cfg          = LEDC_AUTO_CLK
-    };
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+// Zona 0 en el LED integrado (GPIO 2; cambia a 18 cuando tengas el RGB con resistencia)
+static const int fan_gpio[FAN_CHANNELS] = { 2, 16, 17, 18, 19, 21, 22, 23 };
+
+// --- RAMPAS ---
+// Los cambios de duty se hacen con el fade por hardware del LEDC: el
+// periférico recorre la rampa solo y avisa al terminar por interrupción,
+// set_duty() vuelve enseguida (LEDC_FADE_NO_WAIT) y la CPU no espera. La
+// pendiente máxima (%/s) se configura por separado para subir (corriente de
+// arranque del motor) y bajar; 0 = cambio instantáneo.
+#define FAN_DEFAULT_SLEW_UP     50      // 0 -> 100 % en 2 s
+#define FAN_DEFAULT_SLEW_DOWN   100
+
+// --- ENERGÍA ---
+// El LEDC corre del reloj APB: con la salida activa (o una rampa en curso)
+// se toma POWER_LOCK_FAN para que DFS no cambie la frecuencia del PWM ni el
+// chip entre en light sleep. Apagado (duty 0) el pin queda en bajo y el
+// ventilador no impide dormir. El lock es contado: uno por canal activo.
+
+// Estado por canal. Cada canal lo maneja solo la ControlTask de su zona (y la
+// ISR de fin de fade), así que no hay estado compartido entre zonas.
+typedef struct {
+    ledc_channel_t channel;
+    uint32_t slew_up;
+    uint32_t slew_down;
+    uint32_t target_duty;       // Último duty pedido (UINT32_MAX = ninguno)
+    atomic_bool fading;         // Lo baja la ISR de fin de fade
+    atomic_bool output_locked;
+    atomic_bool fading_to_zero;
+} fan_channel_t;
+
+static fan_channel_t fans[FAN_CHANNELS];
+static bool timer_ready = false;
+
+static void IRAM_ATTR output_lock(fan_channel_t *f, bool on) {
+    if (atomic_exchange_explicit(&f->output_locked, on, memory_order_relaxed) == on) return;
+    if (on) power_lock_acquire(POWER_LOCK_FAN);
+    else power_lock_release(POWER_LOCK_FAN);
+}
+
+static bool IRAM_ATTR on_fade_end(const ledc_cb_param_t *param, void *user_arg) {
+    fan_channel_t *f = (fan_channel_t *)user_arg;
+    if (param->event == LEDC_FADE_END_EVT) {
+        atomic_store_explicit(&f->fading, false, memory_order_relaxed);
+        if (atomic_load_explicit(&f->fading_to_zero, memory_order_relaxed)) output_lock(f, false);
+    }
+    return false; // No despierta ninguna tarea
+}
+
+esp_err_t fan_driver_init(uint8_t ch) {
+    if (ch >= FAN_CHANNELS) return ESP_ERR_INVALID_ARG;
+
+    // 1. Timer y servicio de fade: compartidos, una sola vez
+    if (!timer_ready) {
+        ledc_timer_config_t ledc_timer = {
+            .speed_mode       = LEDC_MODE,
+            .timer_num        = LEDC_TIMER,
+            .duty_resolution  = LEDC_DUTY_RES,
+            .freq_hz          = LEDC_FREQUENCY,
+            .clk_cfg          = LEDC_AUTO_CLK
+        };
+        ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+        ESP_ERROR_CHECK(ledc_fade_func_install(0));
+        timer_ready = true;
+    }
 
     // 2. Configurar Canal
+    fan_channel_t *f = &fans[ch];
+    f->channel = (ledc_channel_t)(LEDC_CHANNEL_0 + ch);
+    f->slew_up = FAN_DEFAULT_SLEW_UP;
+    f->slew_down = FAN_DEFAULT_SLEW_DOWN;
     ledc_channel_config_t ledc_channel = {
         .speed_mode     = LEDC_MODE,
-        .channel        = LEDC_CHANNEL,
+        .channel        = f->channel,
         .timer_sel      = LEDC_TIMER,
         .intr_type      = LEDC_INTR_DISABLE,
-        .gpio_num       = LEDC_OUTPUT_IO,
+        .gpio_num       = fan_gpio[ch],
         .duty           = 0, // Iniciar apagado
         .hpoint         = 0
     };
     ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+    f->target_duty = 0;
+
+    // 3. Aviso de fin de rampa
+    ledc_cbs_t cbs = { .fade_cb = on_fade_end };
+    ESP_ERROR_CHECK(ledc_cb_register(LEDC_MODE, f->channel, &cbs, f));
 
-    ESP_LOGI(TAG, "Fan Driver (PWM) inicializado en GPIO %d", FAN_GPIO);
+    ESP_LOGI(TAG, "Fan %u (PWM) inicializado en GPIO %d, slew %lu/%lu %%/s",
+             ch, fan_gpio[ch], f->slew_up, f->slew_down);
     return ESP_OK;
 }
 
-esp_err_t fan_driver_set_duty(uint32_t percent) {
+esp_err_t fan_driver_set_duty(uint8_t ch, uint32_t percent) {
+    fan_channel_t *f = &fans[ch];
     if (percent > 100) percent = 100;
 
     // Convertir porcentaje (0-100) a resolución de bits (0-8191)
-    uint32_t duty = (percent * 8191) / 100;
+    uint32_t duty = (percent * LEDC_DUTY_MAX) / 100;
+
+    // Mismo objetivo que el vigente (o la rampa en curso ya va hacia él): nada que hacer
+    if (duty == f->target_duty) return ESP_OK;
+
+    // Una rampa nueva parte del duty actual: cortar la anterior sin esperar a que termine
+    if (atomic_load_explicit(&f->fading, memory_order_relaxed)) {
+        ledc_fade_stop(LEDC_MODE, f->channel);
+        atomic_store_explicit(&f->fading, false, memory_order_relaxed);
+    }
+
+    uint32_t current = ledc_get_duty(LEDC_MODE, f->channel);
+    if (duty > 0 || current > 0) output_lock(f, true);     // La bajada a 0 también necesita el reloj
+    uint32_t delta = (duty > current) ? duty - current : current - duty;
+    uint32_t slew = (duty > current) ? f->slew_up : f->slew_down;
+    f->target_duty = duty;
 
-    // Actualizar PWM
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, LEDC_CHANNEL));
-    
+    // Duración de la rampa: delta en % / pendiente en %/s
+    uint32_t fade_ms = (slew > 0) ? (uint32_t)((uint64_t)delta * 100 * 1000 / ((uint64_t)LEDC_DUTY_MAX * slew)) : 0;
+    if (fade_ms == 0) {
+        ESP_ERROR_CHECK(ledc_set_duty(LEDC_MODE, f->channel, duty));
+        ESP_ERROR_CHECK(ledc_update_duty(LEDC_MODE, f->channel));
+        if (duty == 0) output_lock(f, false);
+        return ESP_OK;
+    }
+
+    atomic_store_explicit(&f->fading_to_zero, duty == 0, memory_order_relaxed);
+    atomic_store_explicit(&f->fading, true, memory_order_relaxed);
+    ESP_ERROR_CHECK(ledc_set_fade_with_time(LEDC_MODE, f->channel, duty, (int)fade_ms));
+    ESP_ERROR_CHECK(ledc_fade_start(LEDC_MODE, f->channel, LEDC_FADE_NO_WAIT));
     return ESP_OK;
 }
 
+bool fan_driver_is_fading(uint8_t ch) {
+    return atomic_load_explicit(&fans[ch].fading, memory_order_relaxed);
+}
+
+void fan_driver_set_slew(uint8_t ch, uint32_t up_pct_s, uint32_t down_pct_s) {
+    // Aplica desde la próxima rampa
+    fans[ch].slew_up = up_pct_s;
+    fans[ch].slew_down = down_pct_s;
+}
+
 const fan_interface_t fan_driver_impl = {
+    .channels = FAN_CHANNELS,
     .init = fan_driver_init,
-    .set_duty = fan_driver_set_duty
-};
\ No newline at end of file
+    .set_duty = fan_driver_set_duty,
+    .is_fading = fan_driver_is_fading,
+    .set_slew = fan_driver_set_slew
+};
@@ -0,0 +1,275 @@
+#include "hal_interfaces.h"
+#include "power_manager.h"
+#include "ntc_convert.h"
+#include "adc_filter.h"
+#include <esp_adc/adc_continuous.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "NTC_CONT";
+
+// --- CONFIGURACIÓN DEL SENSOR (mismos canales que ntc_driver.c) ---
+// Alternativa a ntc_sensor_impl: el ADC convierte por DMA a kHz y una tarea
+// de baja prioridad filtra el flujo. read_celsius() solo devuelve el último
+// valor publicado (no bloquea). No usar junto con ntc_sensor_impl (mismo ADC1).
+// Con varias zonas el patrón del DMA recorre todos los canales inicializados
+// en ronda: cada canal recibe SAMPLE_FREQ_HZ / N muestras por segundo y su
+// propio filtro.
+#define ADC_UNIT            ADC_UNIT_1
+#define ADC_ATTEN           ADC_ATTEN_DB_12
+#define NTC_CHANNELS        6
+#define SAMPLE_FREQ_HZ      20000           // Mínimo del modo DMA en ESP32 (total, repartido entre canales)
+#define FRAME_BYTES         256             // 128 muestras por trama DMA
+#define POOL_BYTES          2048            // Ring buffer interno del driver
+
+static const adc_channel_t ntc_adc_channel[NTC_CHANNELS] = {
+    ADC_CHANNEL_6, ADC_CHANNEL_7, ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_0, ADC_CHANNEL_3
+};
+
+// --- FILTRADO ---
+// Con N canales la ventana de publicación se mantiene en ~100 ms
+// (PUBLISH_BLOCKS / N bloques) y la constante del IIR crece a ~N * 100 ms.
+#define IIR_ALPHA_SHIFT     8               // tau ~ 256 muestras decimadas (~100 ms con un canal)
+#define PUBLISH_BLOCKS      250             // Publicar cada 250 bloques (~100 ms con un canal)
+#define MAX_SPREAD_CODES    48              // Rango tolerado entre medianas de una ventana
+#define STALE_US            (2 * 1000000LL) // Sin publicación -> INVALID
+
+// --- BAJO CONSUMO ---
+// El ADC por DMA no deja dormir al chip. Con set_low_power(true) convierte
+// en ráfagas: una ventana de publicación (~100 ms, hasta que publicaron
+// todos los canales) y se detiene hasta completar BURST_PERIOD_MS, con el
+// lock soltado. El IIR sigue entre ráfagas, así que la respuesta del filtro
+// pasa de ~100 ms a ~1 s (la habitación tarda minutos) y la vigilancia de
+// banda se evalúa una vez por ráfaga en vez de cada 100 ms.
+#define BURST_PERIOD_MS     1000            // < STALE_US
+
+#define FILTER_TASK_STACK   3072
+#define FILTER_TASK_PRIO    3               // Menor que SensorTask/ControlTask
+
+typedef struct {
+    adc_filter_t filter;        // Solo la tarea de filtrado
+
+    // Último valor publicado (escrito por la tarea de filtrado, leído por la SensorTask de la zona)
+    float published_celsius;
+    temp_quality_t published_quality;
+    int64_t published_at_us;
+
+    // Banda vigilada por la SensorTask (protegida por publish_lock): se desarma al avisar
+    TaskHandle_t watch_task;
+    float watch_lo, watch_hi;
+    temp_quality_t watch_quality;
+} ntc_channel_t;
+
+static adc_continuous_handle_t adc_handle = NULL;
+static TaskHandle_t filter_task_handle = NULL;
+static SemaphoreHandle_t adc_mutex = NULL;  // Arranque/parada/reconfiguración del DMA
+static bool adc_paused;                     // Detenido entre ráfagas (bajo consumo); con adc_mutex
+static atomic_bool low_power = false;
+static ntc_channel_t chans[NTC_CHANNELS];
+static uint32_t enabled_mask = 0;           // Canales en el patrón (bit = índice de zona)
+static uint32_t publish_blocks = PUBLISH_BLOCKS;
+static int8_t zone_of_adc[SOC_ADC_MAX_CHANNEL_NUM] = { [0 ... SOC_ADC_MAX_CHANNEL_NUM - 1] = -1 };
+
+static portMUX_TYPE publish_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static bool IRAM_ATTR on_conv_done(adc_continuous_handle_t handle,
+                                   const adc_continuous_evt_data_t *edata,
+                                   void *user_data) {
+    BaseType_t must_yield = pdFALSE;
+    vTaskNotifyGiveFromISR(filter_task_handle, &must_yield);
+    return must_yield == pdTRUE;
+}
+
+static void publish(ntc_channel_t *c) {
+    uint32_t raw_q = 0;
+    temp_quality_t quality = adc_filter_quality(&c->filter, MAX_SPREAD_CODES);
+    float celsius = NTC_INVALID_CELSIUS;
+
+    if (adc_filter_output(&c->filter, &raw_q)) {
+        celsius = ntc_celsius_lut_q(raw_q, ADC_FILTER_FRAC_BITS);
+    }
+    if (celsius == NTC_INVALID_CELSIUS) quality = TEMP_QUALITY_INVALID;
+
+    TaskHandle_t notify = NULL;
+    portENTER_CRITICAL(&publish_lock);
+    c->published_celsius = celsius;
+    c->published_quality = quality;
+    c->published_at_us = esp_timer_get_time();
+    if (c->watch_task != NULL &&
+        (quality != c->watch_quality || celsius < c->watch_lo || celsius >= c->watch_hi)) {
+        notify = c->watch_task;
+        c->watch_task = NULL;
+    }
+    portEXIT_CRITICAL(&publish_lock);
+
+    if (notify != NULL) xTaskNotifyGive(notify);
+}
+
+static void ntc_filter_task(void *pvParameters) {
+    uint8_t frame[FRAME_BYTES];
+    int64_t burst_start_us = esp_timer_get_time();
+    uint32_t burst_mask = 0;    // Canales que ya publicaron en la ráfaga
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Vaciar todas las tramas disponibles sin bloquear
+        uint32_t len = 0;
+        while (adc_continuous_read(adc_handle, frame, sizeof(frame), &len, 0) == ESP_OK) {
+            for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                adc_digi_output_data_t *p = (adc_digi_output_data_t *)&frame[i];
+                unsigned adc_ch = p->type1.channel;
+                if (adc_ch < SOC_ADC_MAX_CHANNEL_NUM && zone_of_adc[adc_ch] >= 0) {
+                    adc_filter_push(&chans[zone_of_adc[adc_ch]].filter, p->type1.data);
+                }
+            }
+        }
+
+        // adc_filter_quality() (dentro de publish) reinicia el contador de bloques
+        uint32_t mask = enabled_mask;
+        for (int ch = 0; ch < NTC_CHANNELS; ch++) {
+            if ((mask & (1u << ch)) && chans[ch].filter.blocks >= publish_blocks) {
+                publish(&chans[ch]);
+                burst_mask |= 1u << ch;
+            }
+        }
+
+        if (burst_mask == mask) {
+            burst_mask = 0;
+
+            if (atomic_load_explicit(&low_power, memory_order_relaxed)) {
+                int64_t burst_ms = (esp_timer_get_time() - burst_start_us) / 1000;
+                // adc_mutex solo para detener y para arrancar: la pausa se
+                // duerme sin él, así ntc_continuous_init de otra zona no
+                // espera hasta un segundo (ve adc_paused y no arranca)
+                xSemaphoreTake(adc_mutex, portMAX_DELAY);
+                adc_continuous_stop(adc_handle);
+                adc_paused = true;
+                power_lock_release(POWER_LOCK_ADC);
+                xSemaphoreGive(adc_mutex);
+                if (burst_ms < BURST_PERIOD_MS) vTaskDelay(pdMS_TO_TICKS(BURST_PERIOD_MS - burst_ms));
+
+                // Descartar lo que quedó en el pool de la ráfaga anterior
+                xSemaphoreTake(adc_mutex, portMAX_DELAY);
+                power_lock_acquire(POWER_LOCK_ADC);
+                adc_continuous_flush_pool(adc_handle);
+                ulTaskNotifyTake(pdTRUE, 0);
+                burst_start_us = esp_timer_get_time();
+                adc_paused = false;
+                ESP_ERROR_CHECK(adc_continuous_start(adc_handle));
+                xSemaphoreGive(adc_mutex);
+            }
+        }
+    }
+}
+
+// Patrón del DMA con todos los canales habilitados (con el ADC detenido)
+static void configure_pattern(uint32_t mask) {
+    adc_digi_pattern_config_t pattern[NTC_CHANNELS];
+    uint32_t n = 0;
+    for (int ch = 0; ch < NTC_CHANNELS; ch++) {
+        if (!(mask & (1u << ch))) continue;
+        pattern[n++] = (adc_digi_pattern_config_t) {
+            .atten = ADC_ATTEN,
+            .channel = ntc_adc_channel[ch],
+            .unit = ADC_UNIT,
+            .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+        };
+    }
+    adc_continuous_config_t dig_cfg = {
+        .sample_freq_hz = SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+        .pattern_num = n,
+        .adc_pattern = pattern,
+    };
+    ESP_ERROR_CHECK(adc_continuous_config(adc_handle, &dig_cfg));
+    publish_blocks = PUBLISH_BLOCKS / n;
+}
+
+esp_err_t ntc_continuous_init(uint8_t ch) {
+    if (ch >= NTC_CHANNELS) return ESP_ERR_INVALID_ARG;
+
+    ntc_channel_t *c = &chans[ch];
+    adc_filter_init(&c->filter, IIR_ALPHA_SHIFT);
+    c->published_celsius = NTC_INVALID_CELSIUS;
+    c->published_quality = TEMP_QUALITY_INVALID;
+    zone_of_adc[ntc_adc_channel[ch]] = (int8_t)ch;
+
+    bool first = (adc_handle == NULL);
+    if (first) {
+        adc_mutex = xSemaphoreCreateMutex();
+        adc_continuous_handle_cfg_t handle_cfg = {
+            .max_store_buf_size = POOL_BYTES,
+            .conv_frame_size = FRAME_BYTES,
+        };
+        ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_cfg, &adc_handle));
+        xTaskCreate(ntc_filter_task, "NtcFilter", FILTER_TASK_STACK, NULL, FILTER_TASK_PRIO, &filter_task_handle);
+
+        adc_continuous_evt_cbs_t cbs = {
+            .on_conv_done = on_conv_done,
+        };
+        ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(adc_handle, &cbs, NULL));
+        power_lock_acquire(POWER_LOCK_ADC);
+    }
+
+    // Agregar el canal al patrón: el DMA solo se reconfigura detenido
+    // (en la pausa entre ráfagas ya está detenido y lo arranca la tarea)
+    xSemaphoreTake(adc_mutex, portMAX_DELAY);
+    if (!first && !adc_paused) adc_continuous_stop(adc_handle);
+    enabled_mask |= 1u << ch;
+    configure_pattern(enabled_mask);
+    if (!adc_paused) ESP_ERROR_CHECK(adc_continuous_start(adc_handle));
+    xSemaphoreGive(adc_mutex);
+
+    ESP_LOGI(TAG, "ADC continuo: NTC %u en canal %d, %d Hz repartidos en %d canales (mediana %d + IIR)",
+             ch, ntc_adc_channel[ch], SAMPLE_FREQ_HZ, __builtin_popcount(enabled_mask), ADC_FILTER_BLOCK);
+    return ESP_OK;
+}
+
+float ntc_continuous_read_celsius(uint8_t ch) {
+    portENTER_CRITICAL(&publish_lock);
+    float celsius = chans[ch].published_celsius;
+    portEXIT_CRITICAL(&publish_lock);
+    return celsius;
+}
+
+temp_quality_t ntc_continuous_get_quality(uint8_t ch) {
+    portENTER_CRITICAL(&publish_lock);
+    temp_quality_t quality = chans[ch].published_quality;
+    int64_t age = esp_timer_get_time() - chans[ch].published_at_us;
+    portEXIT_CRITICAL(&publish_lock);
+
+    // Si la tarea de filtrado dejó de publicar, el valor ya no es confiable
+    return (age > STALE_US) ? TEMP_QUALITY_INVALID : quality;
+}
+
+void ntc_continuous_arm_watch(uint8_t ch, TaskHandle_t task, float lo, float hi) {
+    ntc_channel_t *c = &chans[ch];
+    portENTER_CRITICAL(&publish_lock);
+    c->watch_lo = lo;
+    c->watch_hi = hi;
+    c->watch_quality = c->published_quality;
+    c->watch_task = task;
+    portEXIT_CRITICAL(&publish_lock);
+}
+
+void ntc_continuous_set_low_power(bool enable) {
+    // Lo aplica la tarea de filtrado al terminar la ventana en curso
+    atomic_store_explicit(&low_power, enable, memory_order_relaxed);
+}
+
+// Interfaz pública
+const temp_sensor_interface_t ntc_continuous_impl = {
+    .channels = NTC_CHANNELS,
+    .init = ntc_continuous_init,
+    .read_celsius = ntc_continuous_read_celsius,
+    .get_quality = ntc_continuous_get_quality,
+    .arm_watch = ntc_continuous_arm_watch,
+    .set_low_power = ntc_continuous_set_low_power
+};
@@ -1,76 +1,80 @@
 #include "hal_interfaces.h"
+#include "power_manager.h"
 #include <esp_adc/adc_oneshot.h>
 #include <esp_log.h>
-#include <math.h>
+#include "ntc_convert.h"
+#include "blog.h"
 
 static const char *TAG = "NTC_DRIVER";
 
 // --- CONFIGURACIÓN DEL SENSOR ---
+// Un NTC por zona, todos en ADC1 (ADC2 no se puede usar con Wi-Fi activo).
+// Los canales 1 y 2 (GPIO 37/38) no salen en los módulos WROOM: quedan 6.
 #define ADC_UNIT       ADC_UNIT_1
-#define ADC_CHANNEL    ADC_CHANNEL_6   // GPIO 34 corresponde al Canal 6 del ADC1
 #define ADC_ATTEN      ADC_ATTEN_DB_12 // Permite medir hasta ~3.3V (aprox)
+#define NTC_CHANNELS   6
 
-// --- CONSTANTES AJUSTADAS PARA TU HARDWARE ---
-#define R_NOMINAL      47.0f   // Tu NTC es de 47 Ohmios
-#define T_NOMINAL      25.0f   // A 25 grados centígrados
-#define B_COEFFICIENT  3000.0f // Valor estimado para NTCs de potencia (no es perfecto, pero sirve)
+// Zona 0 en GPIO 34 (canal 6), luego 35, 32, 33, 36, 39
+static const adc_channel_t ntc_adc_channel[NTC_CHANNELS] = {
+    ADC_CHANNEL_6, ADC_CHANNEL_7, ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_0, ADC_CHANNEL_3
+};
 
-// ¡IMPORTANTE! Pon aquí el valor de la resistencia que encontraste (ej: 100, 220, 330)
-#define R_SERIES       100.0f  
+static adc_oneshot_unit_handle_t adc_handle = NULL;    // Compartido por todos los canales
+static temp_quality_t last_quality[NTC_CHANNELS] = {
+    [0 ... NTC_CHANNELS - 1] = TEMP_QUALITY_INVALID
+};
 
-static adc_oneshot_unit_handle_t adc_handle = NULL;
-
-esp_err_t ntc_init(void) {
-    adc_oneshot_unit_init_cfg_t init_config = {
-        .unit_id = ADC_UNIT,
-    };
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config, &adc_handle));
+esp_err_t ntc_init(uint8_t ch) {
+    if (ch >= NTC_CHANNELS) return ESP_ERR_INVALID_ARG;
+    if (adc_handle == NULL) {
+        adc_oneshot_unit_init_cfg_t init_config = {
+            .unit_id = ADC_UNIT,
+        };
+        ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config, &adc_handle));
+    }
 
     adc_oneshot_chan_cfg_t config = {
         .bitwidth = ADC_BITWIDTH_DEFAULT,
         .atten = ADC_ATTEN,
     };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc_handle, ADC_CHANNEL, &config));
+    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc_handle, ntc_adc_channel[ch], &config));
     
-    ESP_LOGI(TAG, "ADC Inicializado en GPIO 34");
+    ESP_LOGI(TAG, "ADC Inicializado para NTC %u (canal %d)", ch, ntc_adc_channel[ch]);
     return ESP_OK;
 }
 
-float ntc_read_celsius(void) {
+float ntc_read_celsius(uint8_t ch) {
     int adc_raw = 0;
-    ESP_ERROR_CHECK(adc_oneshot_read(adc_handle, ADC_CHANNEL, &adc_raw));
+    // adc_oneshot_read serializa internamente el acceso a la unidad entre zonas
+    power_lock_acquire(POWER_LOCK_ADC); // Solo durante la conversión
+    esp_err_t err = adc_oneshot_read(adc_handle, ntc_adc_channel[ch], &adc_raw);
+    power_lock_release(POWER_LOCK_ADC);
+    ESP_ERROR_CHECK(err);
 
-    if (adc_raw == 0 || adc_raw == 4095) {
-        ESP_LOGW(TAG, "Lectura ADC invalida: %d", adc_raw);
-        return -99.0f;
+    if (!ntc_raw_is_valid(adc_raw)) {
+        BLOG(BLOG_NTC_INVALID, ch, (uint32_t)adc_raw);
+        last_quality[ch] = TEMP_QUALITY_INVALID;
+        return NTC_INVALID_CELSIUS;
     }
+    last_quality[ch] = TEMP_QUALITY_GOOD;
 
-    // 1. Convertir ADC a Voltaje
-    float voltage = (adc_raw * 3.3f) / 4095.0f;
-
-    // 2. Calcular Resistencia del NTC
-    float r_ntc = (voltage * R_SERIES) / (3.3f - voltage);
+    // Tabla precalculada en build (ecuación Beta + calibración), sin log() por muestra
+    float celsius = ntc_celsius_lut(adc_raw);
 
-    // 3. Ecuación Beta
-    float steinhart;
-    steinhart = r_ntc / R_NOMINAL;      
-    steinhart = log(steinhart);         
-    steinhart /= B_COEFFICIENT;         
-    steinhart += 1.0f / (T_NOMINAL + 273.15f); 
-    steinhart = 1.0f / steinhart;       
-    steinhart -= 273.15f;               
-
-    // --- CALIBRACIÓN (AQUÍ ESTÁ EL CAMBIO) ---
-    // Restamos la diferencia: 31.5 (medido) - 19.0 (real) = 9.5
-    steinhart = steinhart - 9.5f; 
-
-    ESP_LOGD(TAG, "Raw: %d | V: %.2f | R: %.1f | Temp Calc: %.2f", adc_raw, voltage, r_ntc, steinhart);
+    BLOG(BLOG_NTC_READ, ch, (uint32_t)adc_raw, blog_f(celsius));
     
-    return steinhart;
+    return celsius;
+}
+
+// Una sola muestra: solo se distingue válida / inválida
+temp_quality_t ntc_get_quality(uint8_t ch) {
+    return last_quality[ch];
 }
 
 // Interfaz pública
 const temp_sensor_interface_t ntc_sensor_impl = {
+    .channels = NTC_CHANNELS,
     .init = ntc_init,
-    .read_celsius = ntc_read_celsius
-};
\ No newline at end of file
+    .read_celsius = ntc_read_celsius,
+    .get_quality = ntc_get_quality
+};
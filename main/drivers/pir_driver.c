@@ -1,29 +1,201 @@
 #include "hal_interfaces.h"
 #include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <hal/gpio_ll.h>
+#include <soc/gpio_struct.h>
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <stdatomic.h>
 
 static const char *TAG = "PIR_DRIVER";
-#define PIR_GPIO    14  // Conecta el pin OUT del PIR al GPIO 14
 
-esp_err_t pir_driver_init(void) {
+// Conecta el pin OUT del PIR de cada zona (zona 0 en GPIO 14). Sin pines de
+// arranque (0, 2, 5, 12, 15): un PIR en alto al encender cambiaría el boot.
+#define PIR_CHANNELS    6
+static const gpio_num_t pir_gpio[PIR_CHANNELS] = { 14, 27, 26, 25, 13, 4 };
+
+// --- MODO POLLING (una lectura de nivel por ciclo) ---
+
+esp_err_t pir_driver_init(uint8_t ch) {
+    if (ch >= PIR_CHANNELS) return ESP_ERR_INVALID_ARG;
     gpio_config_t io_conf = {};
     io_conf.intr_type = GPIO_INTR_DISABLE;
     io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << PIR_GPIO);
+    io_conf.pin_bit_mask = (1ULL << pir_gpio[ch]);
     io_conf.pull_down_en = 0; // El HW-416 suele tener salida activa, no necesita pull
     io_conf.pull_up_en = 0;
-    
+
     esp_err_t err = gpio_config(&io_conf);
-    ESP_LOGI(TAG, "PIR Driver inicializado en GPIO %d", PIR_GPIO);
+    ESP_LOGI(TAG, "PIR %u Driver inicializado en GPIO %d", ch, pir_gpio[ch]);
     return err;
 }
 
-bool pir_driver_read(void) {
+bool pir_driver_read(uint8_t ch) {
     // Retorna true si hay movimiento (HIGH), false si no (LOW)
-    return gpio_get_level(PIR_GPIO) == 1;
+    return gpio_get_level(pir_gpio[ch]) == 1;
 }
 
 const pir_sensor_interface_t pir_driver_impl = {
+    .channels = PIR_CHANNELS,
     .init = pir_driver_init,
     .is_motion_detected = pir_driver_read
-};
\ No newline at end of file
+};
+
+// --- MODO ISR (captura de flancos con timestamp) ---
+// La ISR registra cada flanco con esp_timer_get_time() en un ring SPSC sin
+// locks (productor: ISR, consumidor: SensorTask de la zona). Así no se
+// pierden pulsos más cortos que el período de muestreo. is_motion_detected()
+// responde "hubo presencia en los últimos N ms" (hold time) en vez del nivel
+// actual. Cada canal tiene su ring y su estado; la ISR recibe el canal.
+//
+// En el ESP32 el GPIO solo despierta del light sleep por NIVEL, y el tipo de
+// interrupción del pin es el mismo que el de despertar. Por eso el pin se
+// arma por nivel contrario al actual y la ISR lo invierte en cada cambio:
+// equivale a ANYEDGE despierto y además despierta al chip dormido.
+
+#define PIR_RING_SIZE           32      // Potencia de 2
+#define PIR_DEFAULT_HOLD_MS     30000
+
+typedef struct {
+    int64_t timestamp_us;
+    uint8_t level;          // 1 = flanco de subida, 0 = bajada
+} pir_edge_t;
+
+typedef struct {
+    gpio_num_t gpio;
+    pir_edge_t edge_ring[PIR_RING_SIZE];
+    atomic_uint ring_head;      // Escribe la ISR
+    atomic_uint ring_tail;      // Escribe el consumidor
+    atomic_uint ring_dropped;
+
+    // Estado del consumidor (solo la SensorTask de la zona)
+    bool pir_level;
+    bool rise_since_read;
+    int64_t last_motion_us;     // Último instante con el PIR en alto
+    uint32_t hold_ms;
+    TaskHandle_t notify_task;   // SensorTask: se despierta en cada flanco
+} pir_channel_t;
+
+static pir_channel_t pirs[PIR_CHANNELS];
+
+static inline gpio_int_type_t next_level_intr(int level) {
+    return level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+}
+
+static void pir_isr_handler(void *arg) {
+    pir_channel_t *p = (pir_channel_t *)arg;
+
+    // Rearmar por el nivel contrario (gpio_ll: inline, seguro en ISR)
+    int level = gpio_get_level(p->gpio);
+    gpio_ll_set_intr_type(&GPIO, p->gpio, next_level_intr(level));
+
+    unsigned head = atomic_load_explicit(&p->ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&p->ring_tail, memory_order_acquire);
+
+    if (head - tail >= PIR_RING_SIZE) {
+        atomic_fetch_add_explicit(&p->ring_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    pir_edge_t *e = &p->edge_ring[head & (PIR_RING_SIZE - 1)];
+    e->timestamp_us = esp_timer_get_time();
+    e->level = (uint8_t)level;
+    atomic_store_explicit(&p->ring_head, head + 1, memory_order_release);
+
+    if (p->notify_task != NULL) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(p->notify_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+// Consume los flancos pendientes y actualiza el estado de presencia
+static void pir_drain_edges(pir_channel_t *p) {
+    unsigned tail = atomic_load_explicit(&p->ring_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&p->ring_head, memory_order_acquire);
+
+    while (tail != head) {
+        const pir_edge_t *e = &p->edge_ring[tail & (PIR_RING_SIZE - 1)];
+        if (e->level) {
+            p->rise_since_read = true;
+        }
+        // Tanto la subida como la bajada marcan el último instante con movimiento
+        p->last_motion_us = e->timestamp_us;
+        p->pir_level = e->level;
+        tail++;
+    }
+    atomic_store_explicit(&p->ring_tail, tail, memory_order_release);
+}
+
+esp_err_t pir_isr_init(uint8_t ch) {
+    if (ch >= PIR_CHANNELS) return ESP_ERR_INVALID_ARG;
+    pir_channel_t *p = &pirs[ch];
+    p->gpio = pir_gpio[ch];
+    p->hold_ms = PIR_DEFAULT_HOLD_MS;
+
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << p->gpio);
+    io_conf.pull_down_en = 0;
+    io_conf.pull_up_en = 0;
+    ESP_ERROR_CHECK(gpio_config(&io_conf));
+
+    // Estado inicial antes de habilitar la interrupción
+    p->pir_level = gpio_get_level(p->gpio) == 1;
+    if (p->pir_level) p->last_motion_us = esp_timer_get_time();
+
+    // Armado por nivel contrario, que también despierta del light sleep
+    ESP_ERROR_CHECK(gpio_wakeup_enable(p->gpio, next_level_intr(p->pir_level)));
+    ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
+
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err; // INVALID_STATE: ya instalado
+    ESP_ERROR_CHECK(gpio_isr_handler_add(p->gpio, pir_isr_handler, p));
+    ESP_ERROR_CHECK(gpio_intr_enable(p->gpio));
+
+    ESP_LOGI(TAG, "PIR %u (ISR) inicializado en GPIO %d, hold %lu ms", ch, p->gpio, p->hold_ms);
+    return ESP_OK;
+}
+
+bool pir_isr_read(uint8_t ch) {
+    pir_channel_t *p = &pirs[ch];
+    pir_drain_edges(p);
+
+    unsigned dropped = atomic_exchange_explicit(&p->ring_dropped, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        ESP_LOGW(TAG, "PIR %u: ring de flancos lleno, %u descartados", ch, dropped);
+    }
+
+    // Pulsos cortos entre dos lecturas cuentan aunque el hold sea 0
+    bool presence = p->pir_level || p->rise_since_read;
+    p->rise_since_read = false;
+
+    if (!presence && p->last_motion_us > 0) {
+        presence = (esp_timer_get_time() - p->last_motion_us) < (int64_t)p->hold_ms * 1000;
+    }
+    return presence;
+}
+
+void pir_isr_set_hold_time_ms(uint8_t ch, uint32_t ms) {
+    pirs[ch].hold_ms = ms;
+}
+
+void pir_isr_set_notify_task(uint8_t ch, TaskHandle_t task) {
+    pirs[ch].notify_task = task;
+}
+
+int64_t pir_isr_last_motion_us(uint8_t ch) {
+    pir_channel_t *p = &pirs[ch];
+    pir_drain_edges(p);
+    // Si sigue en alto, el movimiento es "ahora"
+    return p->pir_level ? esp_timer_get_time() : p->last_motion_us;
+}
+
+const pir_sensor_interface_t pir_isr_impl = {
+    .channels = PIR_CHANNELS,
+    .init = pir_isr_init,
+    .is_motion_detected = pir_isr_read,
+    .set_hold_time_ms = pir_isr_set_hold_time_ms,
+    .last_motion_us = pir_isr_last_motion_us,
+    .set_notify_task = pir_isr_set_notify_task
+};
@@ -0,0 +1,150 @@
+#include "power_manager.h"
+#include <esp_pm.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_rom_sys.h>
+#include <sdkconfig.h>
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "POWER";
+
+// Con Wi-Fi conectado el mínimo útil es el cristal: el driver de Wi-Fi toma
+// sus propios locks cuando necesita 80 MHz
+#define PM_MIN_FREQ_MHZ     40
+
+typedef struct {
+    esp_pm_lock_handle_t handle;    // NULL sin CONFIG_PM_ENABLE (solo se cuenta)
+    int64_t since_us;
+    power_lock_stats_t st;
+} power_lock_t;
+
+static const char *const lock_names[POWER_LOCK_COUNT] = { "fan", "adc", "http" };
+
+#if CONFIG_PM_ENABLE
+// FAN: el LEDC corre del reloj APB; con DFS la frecuencia del PWM cambiaría
+// y en light sleep la salida se detiene. ADC: mismo motivo para el muestreo.
+// HTTP: solo impide dormir (con el chip despierto la pila responde sin
+// esperar al próximo beacon del AP).
+static const esp_pm_lock_type_t lock_types[POWER_LOCK_COUNT] = {
+    ESP_PM_APB_FREQ_MAX, ESP_PM_APB_FREQ_MAX, ESP_PM_NO_LIGHT_SLEEP
+};
+#endif
+
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static power_lock_t locks[POWER_LOCK_COUNT];
+static power_mode_t mode = POWER_PERFORMANCE;
+static int64_t mode_since_us;
+static int64_t sleep_us;
+static uint32_t sleeps;
+
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+// Corre en el idle con interrupciones deshabilitadas: solo acumula
+static esp_err_t IRAM_ATTR on_light_sleep_exit(int64_t slept_us, void *arg) {
+    portENTER_CRITICAL_SAFE(&stats_mux);
+    sleep_us += slept_us;
+    sleeps++;
+    portEXIT_CRITICAL_SAFE(&stats_mux);
+    return ESP_OK;
+}
+#endif
+
+esp_err_t power_manager_init(void) {
+    mode_since_us = esp_timer_get_time();
+#if CONFIG_PM_ENABLE
+    for (int i = 0; i < POWER_LOCK_COUNT; i++) {
+        ESP_ERROR_CHECK(esp_pm_lock_create(lock_types[i], 0, lock_names[i], &locks[i].handle));
+    }
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = { .exit_cb = on_light_sleep_exit };
+    ESP_ERROR_CHECK(esp_pm_light_sleep_register_cbs(&cbs));
+#endif
+    ESP_LOGI(TAG, "esp_pm listo (%d-%d MHz)", PM_MIN_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#else
+    ESP_LOGW(TAG, "Firmware sin CONFIG_PM_ENABLE: CPU fija a %d MHz", CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+    return ESP_OK;
+}
+
+esp_err_t power_manager_set_mode(power_mode_t new_mode) {
+    if (new_mode >= POWER_MODE_COUNT) return ESP_ERR_INVALID_ARG;
+    esp_err_t err = ESP_OK;
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = (new_mode == POWER_PERFORMANCE) ? CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ : PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = (new_mode == POWER_LIGHT_SLEEP),
+    };
+    err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        // Ej: light sleep sin CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        ESP_LOGE(TAG, "esp_pm_configure(modo %d): %s", new_mode, esp_err_to_name(err));
+        return err;
+    }
+#else
+    if (new_mode != POWER_PERFORMANCE) err = ESP_ERR_NOT_SUPPORTED;
+#endif
+
+    // Estadísticas por modo: los locks tomados siguen contando desde ahora
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&stats_mux);
+    mode = new_mode;
+    mode_since_us = now;
+    sleep_us = 0;
+    sleeps = 0;
+    for (int i = 0; i < POWER_LOCK_COUNT; i++) {
+        locks[i].st.held_us = 0;
+        locks[i].st.acquisitions = locks[i].st.depth ? 1 : 0;
+        locks[i].since_us = now;
+    }
+    portEXIT_CRITICAL(&stats_mux);
+
+    ESP_LOGI(TAG, "Modo de energía %d", new_mode);
+    return err;
+}
+
+void IRAM_ATTR power_lock_acquire(power_lock_id_t id) {
+    power_lock_t *l = &locks[id];
+    portENTER_CRITICAL_SAFE(&stats_mux);
+    if (l->st.depth++ == 0) {
+        l->since_us = esp_timer_get_time();
+        l->st.acquisitions++;
+    }
+    portEXIT_CRITICAL_SAFE(&stats_mux);
+    if (l->handle != NULL) esp_pm_lock_acquire(l->handle);
+}
+
+void IRAM_ATTR power_lock_release(power_lock_id_t id) {
+    power_lock_t *l = &locks[id];
+    if (l->handle != NULL) esp_pm_lock_release(l->handle);
+    portENTER_CRITICAL_SAFE(&stats_mux);
+    if (l->st.depth > 0 && --l->st.depth == 0) {
+        l->st.held_us += esp_timer_get_time() - l->since_us;
+    }
+    portEXIT_CRITICAL_SAFE(&stats_mux);
+}
+
+void power_manager_get_stats(power_stats_t *out) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&stats_mux);
+    out->mode = mode;
+    out->elapsed_us = now - mode_since_us;
+    out->sleep_us = sleep_us;
+    out->sleeps = sleeps;
+    for (int i = 0; i < POWER_LOCK_COUNT; i++) {
+        out->locks[i] = locks[i].st;
+        if (locks[i].st.depth > 0) out->locks[i].held_us += now - locks[i].since_us; // Tramo en curso
+    }
+    portEXIT_CRITICAL(&stats_mux);
+#if CONFIG_PM_ENABLE
+    out->supported = true;
+#else
+    out->supported = false;
+#endif
+    out->cpu_mhz = esp_rom_get_cpu_ticks_per_us();
+}
+
+const char *power_lock_name(power_lock_id_t id) {
+    return (id < POWER_LOCK_COUNT) ? lock_names[id] : "?";
+}
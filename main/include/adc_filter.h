@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "data_types.h"
+
+// Filtro para muestreo ADC continuo: mediana por bloque (rechaza picos) +
+// decimación + IIR de primer orden. Módulo puro (compila también en host/).
+//
+//   raw (kHz) -> [mediana de ADC_FILTER_BLOCK] -> decimado -> [IIR] -> código Q4
+
+#define ADC_FILTER_BLOCK      8     // Muestras por bloque de mediana (= factor de decimación)
+#define ADC_FILTER_FRAC_BITS  4     // Bits fraccionarios de la salida (ver ntc_celsius_lut_q)
+
+typedef struct {
+    uint16_t block[ADC_FILTER_BLOCK];
+    uint8_t block_len;
+    uint8_t alpha_shift;        // IIR: y += (x - y) >> alpha_shift
+    bool primed;                // El IIR ya tiene un valor inicial
+    int32_t iir;                // Estado IIR (código << 8)
+
+    // Estadísticas de la ventana actual (se reinician en adc_filter_quality)
+    uint32_t accepted;
+    uint32_t rejected;          // Códigos 0 / fondo de escala
+    uint32_t blocks;
+    uint16_t win_min;           // Rango de las medianas de la ventana
+    uint16_t win_max;
+} adc_filter_t;
+
+void adc_filter_init(adc_filter_t *f, uint8_t alpha_shift);
+
+// Agrega una muestra cruda (0..4095). Los códigos de saturación se descartan.
+void adc_filter_push(adc_filter_t *f, uint16_t raw);
+
+// Salida filtrada en código ADC con ADC_FILTER_FRAC_BITS bits fraccionarios.
+// Devuelve false si todavía no hay ningún bloque completo.
+bool adc_filter_output(const adc_filter_t *f, uint32_t *raw_q);
+
+// Evalúa la ventana desde la última llamada y la reinicia.
+// max_spread: rango máximo (en códigos) entre medianas para considerarla estable.
+temp_quality_t adc_filter_quality(adc_filter_t *f, uint16_t max_spread);
@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// Log binario diferido. Reemplaza a los ESP_LOG* del camino de control: el
+// productor solo copia un ID de mensaje y los argumentos crudos (enteros o
+// bits de float) a un ring en RAM, sin formatear ni tocar la UART. El texto
+// lo arma después la tarea BlogDrain (prioridad 1, tasks/task_blog.c) o, en
+// modo binario, el decodificador de Linux (host/tools/blog_decode.c) a partir
+// de las líneas "BLOG," de la consola.
+//
+// Los formatos viven en el catálogo BLOG_MESSAGES, compartido por firmware y
+// host: el registro no lleva strings. Conversiones soportadas: %d %i %u %x
+// %X %c (32 bits) y %f %e %g (float), con flags/ancho/precisión; sin %s.
+//
+// Cada mensaje puede tener un intervalo mínimo: las repeticiones dentro del
+// intervalo no ocupan el ring, solo se cuentan, y el próximo registro
+// emitido lleva cuántas se omitieron (el límite es por mensaje, no por zona).
+//
+// Módulo puro (compila también en host/); el llamador serializa blog_put y
+// blog_get.
+
+#define BLOG_MAX_ARGS       7
+#define BLOG_RING_LEN       64      // Potencia de 2
+
+typedef enum {
+    BLOG_LEVEL_ERROR = 1,           // Mismos valores que esp_log_level_t
+    BLOG_LEVEL_WARN,
+    BLOG_LEVEL_INFO,
+    BLOG_LEVEL_DEBUG,
+} blog_level_t;
+
+// X(id, nivel, tag, intervalo mínimo en ms (0 = sin límite), formato)
+#define BLOG_MESSAGES(X) \
+    X(BLOG_CONTROL_CYCLE,   BLOG_LEVEL_INFO,  "TASK_CONTROL", 0,     "Zona %u | Mode: %d | Temp: %.1f | PIR: %d -> PWM: %u%% (motivo %d, %u us)") \
+    X(BLOG_CONTROL_BAD_TEMP, BLOG_LEVEL_WARN, "TASK_CONTROL", 10000, "Zona %u: temperatura invalida, se mantiene PWM %u%%") \
+    X(BLOG_CONTROL_NO_TIME, BLOG_LEVEL_WARN,  "TASK_CONTROL", 60000, "Zona %u: falta NTP para modo programado") \
+    X(BLOG_CONTROL_RULE,    BLOG_LEVEL_DEBUG, "TASK_CONTROL", 0,     "Zona %u: regla horaria #%d activa") \
+    X(BLOG_SENSOR_QUEUE_FULL, BLOG_LEVEL_WARN, "TASK_SENSOR", 5000,  "Zona %u: queue full!") \
+    X(BLOG_NTC_INVALID,     BLOG_LEVEL_WARN,  "NTC_DRIVER",   10000, "NTC %u: lectura ADC invalida: %d") \
+    X(BLOG_NTC_READ,        BLOG_LEVEL_DEBUG, "NTC_DRIVER",   0,     "NTC %u Raw: %d | Temp Calc: %.2f") \
+    X(BLOG_CONTROL_FIRST_DUTY, BLOG_LEVEL_INFO, "TASK_CONTROL", 0,  "Zona %u: primera actuacion a %u ms del arranque (PWM %u%%)")
+
+#define BLOG_ENUM_(id, level, tag, interval, fmt) id,
+typedef enum { BLOG_MESSAGES(BLOG_ENUM_) BLOG_MSG_COUNT } blog_msg_t;
+#undef BLOG_ENUM_
+
+typedef struct {
+    blog_level_t level;
+    const char *tag;
+    uint32_t interval_ms;
+    const char *fmt;
+} blog_msg_info_t;
+
+extern const blog_msg_info_t blog_msgs[BLOG_MSG_COUNT];
+
+// Registro del ring (40 bytes, mismo layout en el ESP32 y en x86-64)
+typedef struct {
+    int64_t ts_us;              // esp_timer
+    uint16_t id;                // blog_msg_t
+    uint16_t repeats;           // Repeticiones omitidas antes de este (satura)
+    uint32_t args[BLOG_MAX_ARGS];
+} blog_record_t;
+
+_Static_assert(sizeof(blog_record_t) == 40, "registro de log binario: 40 bytes");
+
+typedef struct {
+    blog_record_t ring[BLOG_RING_LEN];
+    uint32_t head;              // Próximo a escribir (libre corrida, se enmascara)
+    uint32_t tail;              // Próximo a leer
+    uint32_t dropped;           // Ring lleno: registros perdidos (no se pisa lo pendiente)
+    uint32_t suppressed;        // Repeticiones omitidas por el límite
+    uint32_t written;
+    int64_t last_us[BLOG_MSG_COUNT];
+    uint16_t pending_repeats[BLOG_MSG_COUNT];
+} blog_t;
+
+void blog_init(blog_t *b);
+
+// Encola un registro. Devuelve false si lo descartó (límite o ring lleno).
+bool blog_put(blog_t *b, int64_t ts_us, blog_msg_t id, const uint32_t *args, unsigned n);
+
+// Saca el registro más viejo. Devuelve false si no hay.
+bool blog_get(blog_t *b, blog_record_t *out);
+
+static inline uint32_t blog_pending(const blog_t *b) { return b->head - b->tail; }
+
+// Texto del mensaje (sin tag ni timestamp), truncado a 'cap'. Devuelve la longitud.
+size_t blog_format(char *out, size_t cap, const blog_record_t *r);
+
+// Hash del catálogo (FNV-1a de los formatos): el decodificador verifica que
+// el firmware y el host usan el mismo
+uint32_t blog_catalog_hash(void);
+
+// Argumentos: enteros tal cual, floats por sus bits
+static inline uint32_t blog_f(float v) {
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+// --- Firmware (tasks/task_blog.c) ---
+
+void blog_write(blog_msg_t id, const uint32_t *args, unsigned n);
+void blog_start(void);
+void blog_get_stats(uint32_t *written, uint32_t *dropped, uint32_t *suppressed);
+
+#define BLOG(id, ...) do { \
+        const uint32_t blog_args_[] = { 0, ##__VA_ARGS__ }; \
+        blog_write((id), blog_args_ + 1, sizeof(blog_args_) / sizeof(blog_args_[0]) - 1); \
+    } while (0)
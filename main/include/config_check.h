@@ -0,0 +1,14 @@
+#pragma once
+#include "data_types.h"
+
+// Validación completa de un system_config_t antes de publicarlo (PUT/PATCH
+// /api/config y POST /api/settings) y al cargarlo de NVS: rangos de cada
+// campo, de todas las zonas y de las reglas en uso. Devuelve NULL si es válido o el nombre JSON del primer campo fuera de
+// rango; en *index la zona o regla (-1 si es un campo global).
+const char *config_check(const system_config_t *cfg, int *index);
+
+// Deja 'cfg' dentro de rango tocando lo mínimo: un campo global o de zona
+// fuera de rango vuelve a su valor de fábrica y una regla horaria inválida se
+// borra (las demás conservan su orden). Para configs guardadas: una regla
+// rota no se lleva el resto. Devuelve cuántos arreglos hizo (0 = era válida).
+int config_repair(system_config_t *cfg);
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "data_types.h"
+
+// Formato binario de la configuración guardada (storage/config_manager.c).
+// Módulo puro: lo usan el firmware, bench_config y host/tools/cfg_tool.c.
+//
+// A diferencia del volcado crudo de system_config_t, el layout no depende del
+// compilador (padding, tamaño de los enum) ni del orden de los campos:
+//
+//   cabecera (12 bytes): magic u32 "VCFG", esquema u16, largo u16 (bytes de
+//                        registros), CRC32 u32 de los registros
+//   registros:           tag (1 byte), largo (1 byte), valor
+//
+// Enteros en little-endian con el mínimo de bytes (1..4), float IEEE-754 de
+// 4 bytes, bool de 1 byte. Cada zona es un registro CONFIG_TAG_ZONE con el
+// índice (1 byte) y sus campos como registros anidados; cada regla horaria
+// es un registro CONFIG_TAG_SCHEDULE con sus campos (en orden de tabla).
+//
+// Compatibilidad: un campo nuevo lleva un tag nuevo y, en blobs viejos que no
+// lo traen, queda con su valor de default_system_config; los tags que no se
+// conocen se saltean (firmware anterior leyendo un blob nuevo). Un tag nunca
+// se reutiliza. CONFIG_SCHEMA solo sube con cambios de semántica (unidades,
+// significado de un campo), con su paso de migración en config_decode.
+
+#define CONFIG_BLOB_MAGIC       0x47464356u     // "VCFG"
+#define CONFIG_SCHEMA           1
+#define CONFIG_HEADER_SIZE      12
+#define CONFIG_BLOB_MAX         1536            // 8 zonas y 24 reglas: ~1.3 KB
+
+#define CONFIG_TAG_ZONE         0x40
+#define CONFIG_TAG_SCHEDULE     0x41
+
+typedef enum {
+    CONFIG_FIELD_UINT = 0,
+    CONFIG_FIELD_FLOAT,
+    CONFIG_FIELD_BOOL,
+} config_field_kind_t;
+
+// Un campo: tag en el blob, clave JSON (la de /api/config) y dónde vive en
+// la struct (tamaño en memoria: los enum miden lo que diga el compilador)
+typedef struct {
+    uint8_t tag;
+    uint8_t kind;               // config_field_kind_t
+    uint8_t size;
+    uint16_t offset;
+    const char *name;
+} config_field_t;
+
+// Campos globales (de system_config_t), por zona (zone_config_t) y por regla
+// (schedule_reg_t). zone_count y schedule_count no son campos: salen de los
+// registros presentes y de "zone_count".
+extern const config_field_t config_global_fields[];
+extern const config_field_t config_zone_fields[];
+extern const config_field_t config_schedule_fields[];
+extern const size_t config_global_field_count;
+extern const size_t config_zone_field_count;
+extern const size_t config_schedule_field_count;
+
+typedef enum {
+    CONFIG_DECODE_OK = 0,
+    CONFIG_DECODE_SHORT,        // Menos bytes que la cabecera o que el largo declarado
+    CONFIG_DECODE_MAGIC,
+    CONFIG_DECODE_SCHEMA,       // Esquema más nuevo que el del firmware
+    CONFIG_DECODE_CRC,
+    CONFIG_DECODE_FORMAT,       // Registro truncado o valor que no entra en el campo
+} config_decode_err_t;
+
+typedef struct {
+    uint16_t schema;            // Esquema del blob (< CONFIG_SCHEMA: se migró)
+    uint16_t unknown;           // Registros con tag desconocido (salteados)
+    uint16_t dropped;           // Zonas o reglas fuera de capacidad (descartadas)
+} config_decode_info_t;
+
+// Codifica 'cfg' en 'out'. Van todas las globales, las zonas activas y las
+// que difieren del default, y las schedule_count reglas. Devuelve los bytes
+// escritos o 0 si no entra en 'cap'.
+size_t config_encode(const system_config_t *cfg, uint8_t *out, size_t cap);
+
+// Decodifica un blob sobre default_system_config. 'info' es opcional. Con
+// error 'cfg' queda con el default. Los rangos no se validan: ver config_check.
+config_decode_err_t config_decode(const uint8_t *blob, size_t len, system_config_t *cfg,
+                                  config_decode_info_t *info);
+
+const char *config_decode_err_name(config_decode_err_t err);
+
+// Volcado crudo de system_config_t del firmware original (clave "sys_cfg",
+// 56 bytes: modo, manual_duty y 3 reglas sin días). Va a la zona 0 y a 3
+// reglas con DAYS_ALL; el resto queda de fábrica. false si el largo no es el
+// de ese layout. Los rangos no se validan: ver config_repair.
+#define CONFIG_LEGACY_SIZE      56
+bool config_decode_legacy(const uint8_t *raw, size_t len, system_config_t *cfg);
+
+// Acceso a un campo por tabla (cfg_tool): 'base' es la struct del campo.
+// config_field_set devuelve false si el valor no entra (negativo, no entero
+// o fuera del tamaño del campo).
+double config_field_get(const config_field_t *f, const void *base);
+bool config_field_set(const config_field_t *f, void *base, double v);
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "data_types.h"
+#include "schedule_index.h"
+
+// Núcleo de control puro: sin FreeRTOS, sin drivers, sin logs.
+// Lo usa control_task en el ESP32 y los benchmarks de host/ en Linux.
+
+typedef enum {
+    CONTROL_OK = 0,
+    CONTROL_NO_TIME,    // Modo programado sin hora NTP válida
+    CONTROL_BAD_SENSOR, // Se necesitaba la temperatura y la lectura es INVALID
+} control_status_t;
+
+// Resultado de una decisión de control
+typedef struct {
+    uint32_t pwm;              // 0-100
+    control_status_t status;
+    int rule;                  // Registro horario aplicado (índice en schedules[], -1 si ninguno)
+} control_decision_t;
+
+// Estado de los modos con memoria (PID, histéresis). Lo guarda el llamador
+// entre decisiones; control_state_reset() al arrancar o cambiar de modo.
+#define PID_D_FILTER_N  8       // Constante del filtro de D = Td / N
+
+typedef struct {
+    float integral;            // Término integral del PID (%), ya acotado
+    float prev_temp;           // Última medición (derivada sobre la medición)
+    float dterm;               // Término D filtrado (%)
+    int64_t prev_us;           // data->timestamp de la última medición
+    bool primed;               // prev_* válidos
+    uint32_t output;           // Última salida aplicada por PID/histéresis
+    bool hyst_on;              // Histéresis: ventilador encendido
+} control_state_t;
+
+void control_state_reset(control_state_t *st);
+
+// Un paso del PID con anti-windup (la integral se acota para que P+I+D no
+// salga de 0-100) y derivada sobre la medición filtrada (Td/PID_D_FILTER_N).
+// dt_s <= 0 omite I y D.
+uint32_t pid_update(const pid_params_t *p, control_state_t *st, float temp, float dt_s);
+
+// Todo/nada con banda alrededor de la consigna
+uint32_t hysteresis_update(const hysteresis_params_t *p, control_state_t *st, float temp);
+
+// Verifica si la hora actual está dentro del rango del registro
+bool is_time_in_range(const struct tm *now, const schedule_reg_t *reg);
+
+// Cálculo de PWM Lineal (Reutilizable)
+uint32_t calculate_pwm_linear(float current_temp, float t_min, float t_max);
+
+// Evalúa el modo de operación de la zona 'zone' y devuelve el PWM objetivo.
+// 'sched' debe estar compilado desde la configuración (schedule_index_compile).
+// 'st' guarda la memoria de PID/histéresis de la zona; data->timestamp (µs) da el dt.
+control_decision_t control_decide(const zone_config_t *zone,
+                                  const schedule_index_t *sched,
+                                  control_state_t *st,
+                                  const sensor_data_t *data,
+                                  const struct tm *now,
+                                  bool time_synced);
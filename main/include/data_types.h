@@ -0,0 +1,120 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- Definiciones de Tipos ---
+// Tipos de datos puros (sin dependencias de FreeRTOS/ESP-IDF) para que el
+// núcleo de control también compile en Linux (ver host/).
+
+// Calidad de la lectura de temperatura (GOOD = 0 para que el valor por defecto sea válido)
+typedef enum {
+    TEMP_QUALITY_GOOD = 0,     // Ventana estable y suficientes muestras
+    TEMP_QUALITY_DEGRADED,     // Ruido alto o muchas muestras descartadas
+    TEMP_QUALITY_INVALID,      // Sin dato utilizable (no usar para control)
+} temp_quality_t;
+
+// Motivo por el que SensorTask envió una muestra (core/sample_rate.c)
+typedef enum {
+    SAMPLE_PERIODIC = 0,        // Venció el período adaptativo
+    SAMPLE_PRESENCE,            // Cambió la presencia (flanco del PIR o fin del hold)
+    SAMPLE_THRESHOLD,           // La temperatura cruzó un umbral de control o dio un salto
+    SAMPLE_REASON_COUNT
+} sample_reason_t;
+
+// Modo de energía (drivers/power_manager.c)
+typedef enum {
+    POWER_PERFORMANCE = 0,      // CPU fija al máximo (comportamiento original)
+    POWER_DFS,                  // Escalado de frecuencia: baja al mínimo sin locks tomados
+    POWER_LIGHT_SLEEP,          // DFS + light sleep automático entre muestras
+    POWER_MODE_COUNT
+} power_mode_t;
+
+// Datos del Sensor (Producido por Sensor Task)
+typedef struct {
+    float temperature;
+    bool presence_detected;
+    int64_t timestamp;          // esp_timer_get_time() al despertar SensorTask (us)
+    temp_quality_t temp_quality;
+    sample_reason_t reason;
+    int64_t due_us;             // Vencimiento que atiende (= timestamp salvo las periódicas)
+} sensor_data_t;
+
+// Comandos de Actuación (Consumido por Actuator Task)
+typedef struct {
+    uint32_t duty_cycle_percent; // 0-100
+    bool enabled;
+} fan_command_t;
+
+// Definición de Registro Horario
+#define MAX_SCHEDULES   24      // Capacidad de la tabla de reglas (máx. 254, ver schedule_index.h)
+#define DAYS_ALL        0x7F    // Máscara de días: bit N = tm_wday N (0 = Domingo)
+
+typedef struct {
+    uint8_t start_hour;
+    uint8_t start_min;
+    uint8_t end_hour;
+    uint8_t end_min;
+    uint8_t days;               // Días en que EMPIEZA la regla (si cruza medianoche termina al día siguiente)
+    float temp_min_0_percent;   // T_0%
+    float temp_max_100_percent; // T_100%
+    bool active;
+} schedule_reg_t;
+
+// Parámetros del modo PID (core/control_logic.c). Error = T - consigna:
+// más calor -> más ventilador. Ganancias en unidades de % de PWM.
+typedef struct {
+    float setpoint_c;
+    float kp;                   // %/°C
+    float ki;                   // %/(°C·s)
+    float kd;                   // %·s/°C (derivada sobre la medición)
+    uint32_t deadband_pct;      // Cambio mínimo de salida que se aplica (evita "cazar")
+} pid_params_t;
+
+// Parámetros del modo histéresis (todo/nada con banda)
+typedef struct {
+    float setpoint_c;
+    float band_c;               // Ancho total: enciende en consigna + banda/2, apaga en consigna - banda/2
+    uint32_t on_pwm;            // PWM mientras está encendido
+} hysteresis_params_t;
+
+typedef enum { MODE_MANUAL, MODE_AUTO, MODE_SCHEDULE, MODE_PID, MODE_HYSTERESIS, MODE_COUNT } operation_mode_t;
+
+// Zonas: cada una con su sensor, su PIR y su ventilador (tasks/zones.c)
+#define MAX_ZONES       8       // Canales LEDC de baja velocidad del ESP32
+
+// Bloque de configuración por zona
+typedef struct {
+    operation_mode_t operation_mode;
+    uint32_t manual_duty;
+    pid_params_t pid;
+    hysteresis_params_t hysteresis;
+} zone_config_t;
+
+// Configuración Global
+typedef struct {
+    uint32_t version;           // Revisión: +1 en cada cambio publicado (ETag de /api/config)
+    uint8_t zone_count;         // Zonas activas (1..MAX_ZONES, se aplica al reiniciar)
+    zone_config_t zones[MAX_ZONES];
+    uint8_t schedule_count;     // Reglas usadas en schedules[] (compartidas por las zonas en PROG)
+    schedule_reg_t schedules[MAX_SCHEDULES];
+    uint32_t presence_hold_s;   // Presencia = movimiento en los últimos N segundos
+    uint32_t sample_min_ms;     // Período mínimo de muestreo (también intervalo de vigilancia)
+    uint32_t sample_max_ms;     // Período máximo con la temperatura estable
+    uint32_t sample_deadline_ms; // Plazo vencimiento -> set_duty; pasado, cuenta como deadline perdido
+    uint32_t fan_slew_up;       // Pendiente máxima del ventilador al subir (%/s, 0 = instantáneo)
+    uint32_t fan_slew_down;     // Ídem al bajar
+    power_mode_t power_mode;
+} system_config_t;
+
+// --- NUEVO: Estado en tiempo real de una zona (Volátil, solo para visualización) ---
+typedef struct {
+    float current_temp;
+    temp_quality_t temp_quality;
+    bool presence;
+    uint32_t current_pwm;
+    bool fan_fading;           // Rampa de hardware en curso hacia current_pwm
+    char current_time_str[16]; // "HH:MM:SS"
+} system_state_t;
+
+// Configuración por defecto (core/config_defaults.c)
+extern const system_config_t default_system_config;
@@ -1,21 +1,43 @@
 #pragma once
+#include <stdint.h>
 #include <stdbool.h>
 #include <esp_err.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "data_types.h"
+
+// Cada implementación maneja 'channels' instancias del periférico (una por
+// zona, ver zone.h); todas las funciones reciben el canal 0..channels-1.
+// init(ch) se llama una vez por canal, en orden y desde una sola tarea.
 
 // Interfaz Sensor Temperatura
 typedef struct {
-    esp_err_t (*init)(void);
-    float (*read_celsius)(void);
+    uint8_t channels;
+    esp_err_t (*init)(uint8_t ch);
+    float (*read_celsius)(uint8_t ch);
+    temp_quality_t (*get_quality)(uint8_t ch); // Opcional (NULL = siempre GOOD)
+    // Opcional: notificar UNA vez a 'task' cuando la lectura publicada salga de
+    // [lo, hi) o cambie su calidad (NULL = el llamador debe consultar periódicamente)
+    void (*arm_watch)(uint8_t ch, TaskHandle_t task, float lo, float hi);
+    // Opcional: medir en ráfagas entre muestras para permitir light sleep (todos los canales)
+    void (*set_low_power)(bool enable);
 } temp_sensor_interface_t;
 
 // Interfaz Sensor PIR
 typedef struct {
-    esp_err_t (*init)(void);
-    bool (*is_motion_detected)(void);
+    uint8_t channels;
+    esp_err_t (*init)(uint8_t ch);
+    bool (*is_motion_detected)(uint8_t ch);
+    void (*set_hold_time_ms)(uint8_t ch, uint32_t ms);  // Opcional: retención de presencia
+    int64_t (*last_motion_us)(uint8_t ch);        // Opcional: timestamp esp_timer del último movimiento
+    void (*set_notify_task)(uint8_t ch, TaskHandle_t task); // Opcional: notificar a 'task' en cada flanco (desde la ISR)
 } pir_sensor_interface_t;
 
 // Interfaz Ventilador
 typedef struct {
-    esp_err_t (*init)(void);
-    esp_err_t (*set_duty)(uint32_t percent);
-} fan_interface_t;
\ No newline at end of file
+    uint8_t channels;
+    esp_err_t (*init)(uint8_t ch);
+    esp_err_t (*set_duty)(uint8_t ch, uint32_t percent);           // No bloquea: con slew arranca una rampa
+    bool (*is_fading)(uint8_t ch);                                 // Opcional: rampa en curso
+    void (*set_slew)(uint8_t ch, uint32_t up_pct_s, uint32_t down_pct_s); // Opcional: pendiente máxima (0 = instantáneo)
+} fan_interface_t;
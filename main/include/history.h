@@ -0,0 +1,128 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "data_types.h"
+
+// Historial de telemetría en RAM con tres resoluciones y memoria fija:
+//   - SECOND: estado vigente en cada segundo durante 1 hora
+//   - MINUTE: agregado por minuto (min/max/promedio) durante 1 día
+//   - HOUR:   agregado por hora durante 30 días
+//
+// Cada nivel es un ring indexado por "bucket" absoluto (timestamp / período),
+// así una lectura por rango no se desplaza aunque entren muestras nuevas en
+// medio: los buckets que ya salieron del ring se devuelven vacíos. Los
+// huecos (sin muestras) también quedan marcados como vacíos. Módulo puro
+// (compila también en host/); el llamador serializa escritor y lectores.
+//
+// El muestreo es adaptativo (250 ms..10 s): cada muestra vale hasta la
+// siguiente, como máximo HISTORY_MAX_HOLD_S. Los segundos intermedios se
+// completan con ella y los agregados pesan cada muestra por el tiempo que
+// estuvo vigente, no por cantidad. Más separadas que eso es un corte
+// (sensor o tarea caídos) y el resto del hueco queda vacío.
+
+enum {
+    HISTORY_TIER_SECOND = 0,
+    HISTORY_TIER_MINUTE,
+    HISTORY_TIER_HOUR,
+    HISTORY_TIER_COUNT
+};
+
+#define HISTORY_SECONDS_LEN     3600    // 1 h a 1 s
+#define HISTORY_MINUTES_LEN     1440    // 1 día a 1 min
+#define HISTORY_HOURS_LEN       720     // 30 días a 1 h
+
+#define HISTORY_MAX_HOLD_S      60      // = tope de sample_max_ms (config_check)
+
+#define HISTORY_NO_TEMP         INT16_MIN   // Sin temperatura válida en el bucket
+
+// Flags de history_sample_t
+#define HISTORY_F_PRESENCE      0x01
+#define HISTORY_F_QUALITY_MASK  0x06        // temp_quality_t << 1
+#define HISTORY_F_VALID         0x80        // 0 = bucket vacío
+
+#define HISTORY_PRESENCE_EMPTY  0xFF        // presence_pct de un agregado vacío
+
+// Muestra de 1 s (4 bytes)
+typedef struct {
+    int16_t temp_c100;      // °C * 100, o HISTORY_NO_TEMP
+    uint8_t pwm;            // %
+    uint8_t flags;
+} history_sample_t;
+
+// Agregado de 1 min / 1 h (8 bytes)
+typedef struct {
+    int16_t temp_avg;       // °C * 100 (solo lecturas válidas), o HISTORY_NO_TEMP
+    int16_t temp_min;
+    int16_t temp_max;
+    uint8_t pwm_avg;        // %
+    uint8_t presence_pct;   // % del bucket con presencia, o HISTORY_PRESENCE_EMPTY
+} history_agg_t;
+
+_Static_assert(sizeof(history_sample_t) == 4, "history_sample_t debe ocupar 4 bytes");
+_Static_assert(sizeof(history_agg_t) == 8, "history_agg_t debe ocupar 8 bytes");
+
+// Acumulador del bucket en curso de un nivel agregado
+typedef struct {
+    int64_t bucket;         // -1 = sin datos
+    int32_t temp_sum;
+    int16_t temp_min;
+    int16_t temp_max;
+    uint16_t temp_n;
+    uint16_t n;
+    uint16_t presence_n;
+    uint32_t pwm_sum;
+} history_acc_t;
+
+typedef struct {
+    history_sample_t seconds[HISTORY_SECONDS_LEN];
+    history_agg_t minutes[HISTORY_MINUTES_LEN];
+    history_agg_t hours[HISTORY_HOURS_LEN];
+    int64_t head[HISTORY_TIER_COUNT];       // Bucket más nuevo escrito, -1 = vacío
+    history_acc_t acc[HISTORY_TIER_COUNT];  // acc[SECOND] sin uso
+    history_sample_t last;                  // Muestra vigente: se acredita al llegar la siguiente
+    int64_t last_ts;                        // -1 = ninguna
+} history_t;
+
+// --- Formato binario de /api/history (little-endian, como ESP32 y x86) ---
+// Cabecera seguida de 'count' registros de 'record_size' bytes en orden
+// cronológico; el registro i corresponde a first_ts + i * period_s.
+#define HISTORY_WIRE_MAGIC      0x54534856u     // "VHST"
+#define HISTORY_WIRE_VERSION    1
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t tier;
+    uint8_t record_size;
+    uint8_t reserved;
+    uint32_t period_s;
+    uint32_t count;
+    int64_t first_ts;       // Epoch (s) del primer bucket
+} history_wire_header_t;
+
+_Static_assert(sizeof(history_wire_header_t) == 24, "cabecera de historial: 24 bytes");
+
+void history_init(history_t *h);
+
+// Agrega una muestra en 'ts' (epoch en s) y completa los segundos desde la
+// anterior con esa (ver HISTORY_MAX_HOLD_S). Varias en el mismo segundo: la
+// última queda en el registro de 1 s y en los agregados ese segundo pesa una
+// sola vez (con la primera).
+// Las muestras INVALID no entran en las estadísticas de temperatura. Tiempos que retroceden (corrección
+// NTP) sobrescriben el bucket correspondiente si sigue en el ring.
+void history_push(history_t *h, int64_t ts, float temp_c, temp_quality_t quality,
+                  bool presence, uint32_t pwm);
+
+// Copia 'count' registros consecutivos del nivel 'tier' empezando en el
+// bucket de 'from_ts' (alineado hacia abajo al período). Los buckets fuera
+// del ring o sin datos salen vacíos. El bucket en curso de los niveles
+// agregados se entrega con lo acumulado hasta ahora.
+void history_read(const history_t *h, int tier, int64_t from_ts, size_t count, void *out);
+
+// Inicio (epoch) del bucket más nuevo del nivel, o -1 si está vacío
+int64_t history_latest(const history_t *h, int tier);
+
+uint32_t history_period_s(int tier);
+size_t history_capacity(int tier);
+size_t history_record_size(int tier);
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Serializador JSON en streaming sobre un buffer fijo, sin memoria dinámica.
+// Cuando el buffer se llena se entrega al callback 'flush' (ej: un chunk
+// HTTP) y se reutiliza. Los números con decimales se formatean en punto fijo
+// con aritmética entera y float, sin double (sin printf/dtoa, que en newlib
+// reservan heap).
+// Módulo puro (compila también en host/).
+
+#define JSON_WRITER_MAX_DEPTH  16
+
+// Devuelve 0 si pudo entregar los datos
+typedef int (*json_flush_fn)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+    json_flush_fn flush;        // NULL: todo debe entrar en el buffer
+    void *flush_ctx;
+    uint32_t first;             // Bit N: el nivel N aún no tiene elementos
+    uint8_t depth;
+    bool after_key;             // El próximo valor sigue a "clave":
+    bool error;                 // Overflow sin flush, flush fallido o anidación excesiva
+    uint32_t flushes;
+    size_t total;               // Bytes generados en total
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap, json_flush_fn flush, void *flush_ctx);
+
+void json_obj_begin(json_writer_t *w);
+void json_obj_end(json_writer_t *w);
+void json_arr_begin(json_writer_t *w);
+void json_arr_end(json_writer_t *w);
+void json_key(json_writer_t *w, const char *key);
+
+void json_int(json_writer_t *w, int64_t v);
+void json_bool(json_writer_t *w, bool v);
+void json_str(json_writer_t *w, const char *s);
+void json_fixed(json_writer_t *w, float v, unsigned decimals);   // NaN/Inf -> null
+// 9 cifras significativas sin exponente ni ceros de más: el float vuelve
+// idéntico al parsearlo (para documentos que se reenvían, ej: GET -> PUT)
+void json_float(json_writer_t *w, float v);                      // NaN/Inf -> null
+
+// Atajos "clave": valor
+void json_kv_int(json_writer_t *w, const char *key, int64_t v);
+void json_kv_bool(json_writer_t *w, const char *key, bool v);
+void json_kv_str(json_writer_t *w, const char *key, const char *s);
+void json_kv_fixed(json_writer_t *w, const char *key, float v, unsigned decimals);
+void json_kv_float(json_writer_t *w, const char *key, float v);
+
+// Texto tal cual, sin comillas ni separadores. Con depth 0 (fuera de todo
+// objeto) json_int/json_fixed tampoco agregan separadores: sirve para formatos
+// de texto sobre el mismo buffer (ej: exposición de Prometheus).
+void json_raw(json_writer_t *w, const char *s);
+
+// Entrega lo pendiente al callback (si lo hay). Devuelve 0 si no hubo errores.
+int json_writer_finish(json_writer_t *w);
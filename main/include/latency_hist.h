@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+// Histograma de latencias en buckets de potencias de 2 (µs): el bucket i
+// cuenta valores en [2^(i-1), 2^i) y el 0 los menores a 1 µs; el último
+// acumula todo lo que supera ~1 s. Memoria fija, registro O(1).
+// Módulo puro (compila también en host/); el llamador serializa el acceso.
+
+#define LATENCY_HIST_BUCKETS    22
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_HIST_BUCKETS];
+} latency_hist_t;
+
+void latency_hist_record(latency_hist_t *h, uint32_t us);
+
+// Cota superior del bucket que contiene el percentil 'pct' (0-100), o 0 si está vacío
+uint32_t latency_hist_percentile(const latency_hist_t *h, unsigned pct);
+
+uint32_t latency_hist_avg(const latency_hist_t *h);
+
+// Suma 'src' a 'dst' (ej: todos los motivos en un solo histograma)
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src);
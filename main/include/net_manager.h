@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include "system_common.h"
+
+// Red en segundo plano (network/net_manager.c).
+//
+// app_main ya no espera al AP: las zonas arrancan primero y una tarea de baja
+// prioridad levanta WiFi, SNTP y el servidor web. Si el AP no está, la cuna
+// sigue controlando el ventilador (los modos programados esperan la hora,
+// ver CONTROL_NO_TIME) y la red se reintenta con backoff exponencial.
+//
+//   NET_STARTING    netif + driver WiFi + servidor web (un fallo reintenta)
+//   NET_CONNECTING  esp_wifi_connect y espera IP hasta NET_CONNECT_TIMEOUT_MS
+//   NET_CONNECTED   con IP; la primera vez inicia SNTP. Espera la caída
+//   NET_BACKOFF     1 s, 2 s, 4 s... hasta 60 s (±25 %) y vuelve a intentar
+
+typedef enum {
+    NET_STARTING = 0,
+    NET_CONNECTING,
+    NET_CONNECTED,
+    NET_BACKOFF,
+    NET_STATE_COUNT
+} net_state_t;
+
+// Hitos en ms desde el arranque (esp_timer); 0 = todavía no
+typedef struct {
+    net_state_t state;
+    uint32_t attempts;          // Llamadas a esp_wifi_connect
+    uint32_t disconnects;       // Caídas con IP
+    uint32_t init_errors;       // Fallos de netif/driver WiFi/servidor web
+    uint32_t backoff_ms;        // Última espera antes de reintentar
+    uint32_t web_ms;            // Servidor web escuchando
+    uint32_t wifi_ms;           // Primera IP
+    uint32_t sntp_ms;           // Primera hora válida
+} net_stats_t;
+
+// Crea la tarea NetMgr y vuelve enseguida. Llamar después de zones_start:
+// el servidor web usa ctx->zones.
+void net_manager_start(app_context_t *ctx);
+
+void net_manager_get_stats(net_stats_t *out);
+
+const char *net_state_name(net_state_t s);
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Conversión ADC -> °C del NTC. Módulo puro (compila también en host/).
+
+// Sentinela histórico para lecturas inválidas
+#define NTC_INVALID_CELSIUS  (-99.0f)
+
+// Códigos 0 y fondo de escala no son medibles (divisor en corto/abierto)
+bool ntc_raw_is_valid(int adc_raw);
+
+// Referencia: ecuación Beta con log() en doble precisión (fórmula original).
+// Se conserva solo para el benchmark de host y validación de la tabla.
+float ntc_celsius_formula(int adc_raw);
+
+// Conversión por tabla generada en build (tools/gen_ntc_lut.py)
+float ntc_celsius_lut(int adc_raw);
+
+// Igual que ntc_celsius_lut() pero con código ADC fraccionario en punto fijo
+// (raw_q = código << frac_bits), interpolando linealmente entre entradas.
+// Útil para valores promediados/sobremuestreados.
+float ntc_celsius_lut_q(uint32_t raw_q, unsigned frac_bits);
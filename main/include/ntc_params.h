@@ -0,0 +1,27 @@
+#pragma once
+
+// --- PARÁMETROS DEL NTC ---
+// Fuente única para el driver (ntc_driver.c), la fórmula de referencia
+// (core/ntc_convert.c) y el generador de la tabla (tools/gen_ntc_lut.py).
+// El generador lee los #define de este archivo: mantener el formato
+// "#define NOMBRE valor" con un literal numérico.
+
+// --- CONSTANTES AJUSTADAS PARA TU HARDWARE ---
+#define R_NOMINAL      47.0f   // Tu NTC es de 47 Ohmios
+#define T_NOMINAL      25.0f   // A 25 grados centígrados
+#define B_COEFFICIENT  3000.0f // Valor estimado para NTCs de potencia (no es perfecto, pero sirve)
+
+// ¡IMPORTANTE! Pon aquí el valor de la resistencia que encontraste (ej: 100, 220, 330)
+#define R_SERIES       100.0f  
+
+// --- CALIBRACIÓN ---
+// Restamos la diferencia: 31.5 (medido) - 19.0 (real) = 9.5
+#define NTC_CAL_OFFSET 9.5f
+
+// --- ADC ---
+#define NTC_VREF       3.3f    // Tensión del divisor
+#define NTC_ADC_MAX    4095    // ADC de 12 bits
+
+// --- TABLA ---
+// Temperatura en punto fijo: 1 LSB = 1/32 °C (int16 cubre ±1024 °C)
+#define NTC_LUT_FRAC_BITS  5
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "data_types.h"
+
+// Autotune por relé (Åström-Hägglund) para el modo PID. El relé enciende el
+// ventilador a 'high' cuando T supera consigna + hyst y lo baja a 'low'
+// cuando cae de consigna - hyst; la planta oscila y de la amplitud 'a' y el
+// período Tu de la oscilación sale la ganancia última
+//     Ku = 4 * d / (pi * a),   d = (high - low) / 2
+// y de ahí las ganancias con la regla de Tyreus-Luyben (menos sobrepaso que
+// Ziegler-Nichols, mejor para un ventilador que no debe cazar).
+//
+// Es una máquina de estados sin E/S: el llamador le pasa cada medición y
+// aplica el PWM que devuelve (ver host/tools/pid_autotune.c, que la corre
+// contra la misma planta que el mock de HAL). Módulo puro.
+
+#define PID_AUTOTUNE_CYCLES     4       // Ciclos medidos (se descarta el primero)
+#define PID_AUTOTUNE_MAX_S      (6 * 3600)
+
+typedef enum {
+    PID_AUTOTUNE_RUNNING = 0,
+    PID_AUTOTUNE_DONE,
+    PID_AUTOTUNE_FAILED,        // Sin oscilación dentro de PID_AUTOTUNE_MAX_S
+} pid_autotune_status_t;
+
+typedef struct {
+    float setpoint_c;
+    float hyst_c;
+    uint32_t high, low;
+
+    pid_autotune_status_t status;
+    bool relay_high;
+    float t_start;
+    float peak_max, peak_min;       // Extremos del semiciclo en curso
+    float last_rise_t;              // Último cambio del relé a 'high'
+    int cycles;                     // Ciclos completos (de subida a subida)
+    float sum_period, sum_amp;
+
+    float ku, tu;                   // Resultado
+} pid_autotune_t;
+
+void pid_autotune_init(pid_autotune_t *at, float setpoint_c, float hyst_c, uint32_t low, uint32_t high);
+
+// Procesa la medición 'temp' en el instante t_s y devuelve el PWM a aplicar
+uint32_t pid_autotune_step(pid_autotune_t *at, float temp, float t_s);
+
+// Ganancias sugeridas (solo con status == PID_AUTOTUNE_DONE), PID completo o
+// PI (derivative = false: más robusto con un sensor ruidoso). 'out' conserva
+// la consigna y la banda muerta que ya tuviera.
+void pid_autotune_result(const pid_autotune_t *at, bool derivative, pid_params_t *out);
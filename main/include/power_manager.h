@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+#include "data_types.h"
+
+// Gestión de energía sobre esp_pm (drivers/power_manager.c).
+//
+// El modo (power_mode_t en system_config_t) configura el escalado dinámico
+// de frecuencia y el light sleep automático: con tickless idle, cuando todas
+// las tareas están bloqueadas y nadie tiene un lock, el chip duerme hasta el
+// próximo timeout de FreeRTOS o esp_timer (o una interrupción que despierte,
+// ej: el PIR por GPIO).
+//
+// Cada driver toma su lock SOLO mientras el periférico lo necesita:
+//   - FAN:  LEDC con salida distinta de 0 (reloj APB estable, sin light sleep)
+//   - ADC:  conversiones en curso (ráfaga del ADC continuo o lectura oneshot)
+//   - HTTP: sockets abiertos del servidor web (uno por socket)
+// Los locks son contados y se pueden tomar/soltar desde una ISR.
+
+typedef enum {
+    POWER_LOCK_FAN = 0,
+    POWER_LOCK_ADC,
+    POWER_LOCK_HTTP,
+    POWER_LOCK_COUNT
+} power_lock_id_t;
+
+typedef struct {
+    int64_t held_us;            // Tiempo con el lock tomado (al menos una vez)
+    uint32_t acquisitions;      // Veces que pasó de libre a tomado
+    uint32_t depth;             // Tomas vigentes
+} power_lock_stats_t;
+
+// Desde el último cambio de modo
+typedef struct {
+    power_mode_t mode;
+    bool supported;             // false: firmware sin CONFIG_PM_ENABLE (siempre a máxima frecuencia)
+    uint32_t cpu_mhz;           // Frecuencia al momento de la consulta
+    int64_t elapsed_us;
+    int64_t sleep_us;           // Tiempo en light sleep
+    uint32_t sleeps;            // Entradas a light sleep
+    power_lock_stats_t locks[POWER_LOCK_COUNT];
+} power_stats_t;
+
+esp_err_t power_manager_init(void);
+
+// Aplica el modo (esp_pm_configure) y reinicia las estadísticas
+esp_err_t power_manager_set_mode(power_mode_t mode);
+
+void power_lock_acquire(power_lock_id_t id);
+void power_lock_release(power_lock_id_t id);
+
+void power_manager_get_stats(power_stats_t *out);
+const char *power_lock_name(power_lock_id_t id);
@@ -0,0 +1,100 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "thermal_plant.h"
+
+// Simulador de la habitación sobre un reloj virtual. Envuelve la planta
+// térmica (core/thermal_plant.c) y le agrega lo que cambia durante el día:
+//   - carga térmica: exterior senoidal (mínimo a las 5:00), ganancias
+//     internas fijas, sol por la tarde y el calor de los ocupantes,
+//   - ventilador: pendiente (slew) como la rampa del LEDC, motor que no gira
+//     por debajo de fan_start_pct (pero consume), enfriamiento que crece
+//     menos que lineal con el caudal y potencia cúbica (leyes de afinidad),
+//   - ocupación por perfil horario: movimientos del PIR al azar mientras hay
+//     alguien (bebé dormido) y continuos al entrar y salir (adultos),
+//   - puntajes: energía del ventilador y confort (tiempo ocupado dentro de
+//     [comfort_lo_c, comfort_hi_c] y grados-hora fuera de la banda).
+//
+// Lo usan el mock de HAL (mocks/mock_room.c, con el reloj acelerado) y
+// host/bench/bench_room.c, que corre días de operación en segundos.
+// Módulo puro (compila también en host/).
+
+typedef enum {
+    ROOM_OCC_NURSERY = 0,       // Noche 19:30-07:00 y siesta 13:00-15:00
+    ROOM_OCC_ALWAYS,            // Siempre ocupada
+    ROOM_OCC_EMPTY,             // Nunca
+    ROOM_OCC_COUNT
+} room_occupancy_t;
+
+typedef struct {
+    thermal_plant_params_t plant;   // ambient_c se recalcula en cada paso
+    float outdoor_mean_c;           // Exterior medio del día
+    float outdoor_swing_c;          // Amplitud (mín. a las 5:00, máx. a las 17:00)
+    float internal_load_c;          // Ganancias fijas (equipos, iluminación)
+    float solar_load_c;             // Pico del sol (medio seno 9:00-19:00, máx. 14:00)
+    float occupant_load_c;          // Con la habitación ocupada
+    uint32_t fan_start_pct;         // Debajo de esto el motor no gira
+    float fan_curve_exp;            // Enfriamiento ~ caudal^exp (caudal lineal desde el arranque)
+    float fan_max_w;                // Potencia al 100 %
+    float fan_min_w;                // Electrónica + motor en el arranque (o trabado)
+    float comfort_lo_c;
+    float comfort_hi_c;
+    room_occupancy_t occupancy;
+    float motion_interval_s;        // Media entre movimientos de un ocupante quieto
+    float burst_s;                  // Movimiento continuo al entrar y al salir
+} room_sim_params_t;
+
+// Puntajes acumulados desde room_sim_init
+typedef struct {
+    double sim_s;               // Tiempo simulado
+    double energy_wh;           // Energía del ventilador
+    double occupied_s;
+    double comfort_s;           // Ocupada y dentro de la banda de confort
+    double discomfort_ch;       // Ocupada: integral de la distancia a la banda (°C·h)
+    double duty_sum;            // Suma de duty por segundo (para el promedio)
+    uint32_t fan_starts;        // Arranques del motor (parado -> girando)
+    uint32_t motions;           // Movimientos generados
+} room_sim_score_t;
+
+typedef struct {
+    room_sim_params_t p;
+    thermal_plant_t plant;
+    int64_t t_us;               // Reloj virtual desde el inicio
+    uint32_t start_s;           // Segundo de la semana en t = 0 (0 = domingo 00:00)
+    uint32_t seed;              // PRNG de movimientos (el de la planta es aparte)
+    volatile uint32_t duty_cmd; // Lo escribe el ventilador; lo toma el próximo paso
+    volatile uint32_t slew_up;  // %/s (0 = instantáneo)
+    volatile uint32_t slew_down;
+    float duty;                 // Duty efectivo tras la pendiente
+    bool spinning;
+    bool occupied;
+    int64_t last_motion_us;     // Reloj virtual (-1 = nunca)
+    room_sim_score_t score;
+} room_sim_t;
+
+extern const room_sim_params_t room_sim_default_params;
+
+void room_sim_init(room_sim_t *s, const room_sim_params_t *p, uint32_t seed, uint32_t start_s);
+
+// Avanza pasos de plant.step_s hasta alcanzar 'until_us' (reloj virtual)
+void room_sim_advance(room_sim_t *s, int64_t until_us);
+
+// Pedido al ventilador (como fan_interface_t.set_duty / set_slew)
+static inline void room_sim_set_duty(room_sim_t *s, uint32_t pct) { s->duty_cmd = pct > 100 ? 100 : pct; }
+static inline void room_sim_set_slew(room_sim_t *s, uint32_t up, uint32_t down) { s->slew_up = up; s->slew_down = down; }
+static inline bool room_sim_fading(const room_sim_t *s) { return (uint32_t)(s->duty + 0.5f) != s->duty_cmd; }
+
+// Lectura del sensor (temperatura real + ruido)
+static inline float room_sim_measure(room_sim_t *s) { return thermal_plant_measure(&s->plant); }
+
+// Segundo del día / día de la semana (0 = domingo) del reloj virtual
+uint32_t room_sim_time_of_day(const room_sim_t *s);
+uint32_t room_sim_weekday(const room_sim_t *s);
+
+// Ocupación del perfil en un segundo del día
+bool room_sim_profile_occupied(room_occupancy_t occ, uint32_t tod_s);
+
+const char *room_sim_occupancy_name(room_occupancy_t occ);
+
+// Potencia del ventilador con 'duty' aplicado (W)
+float room_sim_fan_power_w(const room_sim_params_t *p, float duty);
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "data_types.h"
+#include "latency_hist.h"
+#include "json_writer.h"
+
+// Métricas de ejecución para GET /api/metrics: CPU y stack por tarea,
+// ocupación de las colas de cada zona, espera en los mutex compartidos y
+// latencia muestra -> actuación. La recolección (FreeRTOS) está en
+// tasks/metrics.c; aquí solo los tipos y los dos formatos de salida, sin
+// heap. Módulo puro (compila también en host/).
+
+#define METRICS_MAX_TASKS       32
+#define METRICS_TASK_NAME_LEN   16      // configMAX_TASK_NAME_LEN por defecto
+#define METRICS_MAX_CORES       2
+
+// Mutex compartidos cuya espera y retención se miden (app_lock_take/app_lock_give en system_common.h)
+typedef enum {
+    METRIC_LOCK_CONFIG = 0,     // config_mutex: escritores de la configuración
+    METRIC_LOCK_SCHEDULE,       // schedule_mutex: horario compartido por las zonas
+    METRIC_LOCK_HISTORY,        // history_mutex: control_task vs /api/history
+    METRIC_LOCK_COUNT
+} metric_lock_t;
+
+typedef struct {
+    char name[METRICS_TASK_NAME_LEN];
+    int8_t core;                // -1 = sin afinidad
+    uint8_t priority;
+    uint16_t cpu_permille;      // ‰ de UN núcleo en la ventana (un núcleo entero = 1000)
+    uint32_t stack_free;        // Mínimo de stack libre desde el arranque (bytes)
+} task_metrics_t;
+
+typedef struct {
+    int8_t core;
+    uint16_t queue_len;         // Muestras esperando a control_task ahora
+    uint16_t queue_cap;
+    uint16_t queue_max;         // Máximo observado tras un envío
+    uint32_t queue_full;        // Envíos descartados por cola llena
+    uint32_t samples[SAMPLE_REASON_COUNT];
+    latency_hist_t latency[SAMPLE_REASON_COUNT];  // Despertar de SensorTask -> set_duty (µs)
+    latency_hist_t jitter;      // Muestras periódicas: despertar - vencimiento (µs)
+    uint32_t overruns;          // Vencimientos saltados
+    uint32_t deadline_miss;     // set_duty después del plazo
+    uint32_t first_duty_ms;     // Primera actuación (ms desde el arranque, 0 = todavía no)
+} zone_metrics_t;
+
+typedef struct {
+    uint32_t uptime_s;
+    uint32_t heap_free;
+    uint32_t heap_min;
+    bool cpu_supported;         // false: firmware sin CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    uint32_t cpu_window_ms;     // Ventana de los porcentajes (desde la consulta anterior)
+    uint8_t core_count;
+    uint16_t core_busy_permille[METRICS_MAX_CORES]; // 1000 - idle de cada núcleo
+    uint8_t task_count;
+    task_metrics_t tasks[METRICS_MAX_TASKS];
+    uint8_t zone_count;
+    zone_metrics_t zones[MAX_ZONES];
+    latency_hist_t lock_wait[METRIC_LOCK_COUNT];    // µs (0 = sin contención)
+    latency_hist_t lock_hold[METRIC_LOCK_COUNT];    // µs tomado, de Take a Give
+    uint32_t log_written;       // Log binario (core/blog.c): registros encolados,
+    uint32_t log_dropped;       // perdidos con el ring lleno
+    uint32_t log_suppressed;    // y omitidos por el límite de repetición
+    // Red en segundo plano (network/net_manager.c); hitos en ms desde el
+    // arranque, 0 = todavía no
+    const char *net_state;      // net_state_name()
+    uint32_t net_attempts;      // Intentos de conexión al AP
+    uint32_t net_disconnects;
+    uint32_t net_init_errors;
+    uint32_t net_web_ms;        // Servidor web escuchando
+    uint32_t net_wifi_ms;       // Primera IP
+    uint32_t net_sntp_ms;       // Primera hora válida
+} runtime_metrics_t;
+
+const char *metric_lock_name(metric_lock_t id);
+
+// JSON compacto (percentiles ya calculados)
+void runtime_metrics_json_write(json_writer_t *w, const runtime_metrics_t *m);
+
+// Formato de texto de Prometheus (0.0.4): gauges, contadores e histogramas
+// con los buckets log2 de latency_hist (le = 2^i - 1 µs)
+void runtime_metrics_prom_write(json_writer_t *w, const runtime_metrics_t *m);
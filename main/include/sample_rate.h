@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "data_types.h"
+
+// Muestreo adaptativo de SensorTask. Módulo puro (compila también en host/).
+//
+// SensorTask duerme hasta que vence el período, llega un flanco del PIR o
+// el driver de temperatura avisa que la lectura salió de la banda vigilada
+// (sample_rate_watch_band). Con drivers sin aviso vigila cada sample_min_ms,
+// que es solo copiar el último valor filtrado. Lo caro (cola, control,
+// historial, log, push WebSocket) ocurre únicamente cuando
+// sample_rate_check() decide enviar una muestra:
+//   - cambió la presencia o la calidad de la lectura,
+//   - la temperatura cruzó un umbral que cambia la decisión de control
+//     (T_0% / T_100% de las reglas activas o de AUTO), se movió lo que vale
+//     SAMPLE_RATE_PWM_STEP % de PWM dentro de una rampa, o saltó SAMPLE_RATE_JUMP_C,
+//   - venció el período adaptativo: el tiempo en que, a la velocidad de cambio
+//     medida, la temperatura se mueve SAMPLE_RATE_STEP_C, acotado a
+//     [sample_min_ms, sample_max_ms].
+//
+// Las muestras periódicas van a tasa fija: cada vencimiento se calcula desde
+// el anterior y no desde el despertar real, así lo que tarda SensorTask en
+// despertar y leer no se acumula (como vTaskDelayUntil). Si se atrasó más
+// de un período entero, los vencimientos perdidos se saltan y se cuentan en
+// 'overruns'. Una muestra por evento reinicia la grilla desde ella.
+
+#define SAMPLE_RATE_STEP_C          0.1f    // Cambio esperado entre muestras periódicas
+#define SAMPLE_RATE_JUMP_C          0.5f    // Salto que se envía sin esperar al período
+#define SAMPLE_RATE_HYST_C          0.05f   // Histéresis de los cruces (evita rebotes por ruido)
+#define SAMPLE_RATE_PWM_STEP        2       // % de PWM que justifica una muestra dentro de una rampa
+#define SAMPLE_RATE_MIN_DT_MS       1000    // Base mínima para estimar la pendiente
+#define SAMPLE_RATE_MAX_RAMPS       (MAX_SCHEDULES + 1)
+
+typedef struct {
+    uint32_t min_ms;
+    uint32_t max_ms;
+    float ramp_lo[SAMPLE_RATE_MAX_RAMPS];   // T_0% de cada rampa del modo vigente
+    float ramp_hi[SAMPLE_RATE_MAX_RAMPS];   // T_100%
+    uint8_t ramp_count;
+
+    // Última muestra enviada
+    bool has_last;
+    float last_temp;
+    temp_quality_t last_quality;
+    bool last_presence;
+    int64_t last_us;
+    int64_t last_due_us;    // Vencimiento que atendió (= last_us salvo las periódicas)
+
+    int64_t due_us;         // Próximo vencimiento periódico (grilla fija)
+    uint32_t overruns;      // Vencimientos saltados por atraso de más de un período
+
+    // Referencia de la pendiente (se renueva cada >= SAMPLE_RATE_MIN_DT_MS)
+    bool has_ref;
+    float ref_temp;
+    int64_t ref_us;
+
+    float rate_c_per_s;     // |dT/dt| suavizado
+    uint32_t period_ms;     // Período vigente
+} sample_rate_t;
+
+void sample_rate_init(sample_rate_t *r, const system_config_t *cfg, const zone_config_t *zone);
+
+// Cotas y umbrales desde la configuración y el modo de la zona (llamar cuando cambia su versión)
+void sample_rate_configure(sample_rate_t *r, const system_config_t *cfg, const zone_config_t *zone);
+
+// Decide si 's' (leída en now_us) debe enviarse. Si devuelve true deja el
+// motivo en 'reason' y toma la muestra como la última enviada.
+bool sample_rate_check(sample_rate_t *r, const sensor_data_t *s, int64_t now_us, sample_reason_t *reason);
+
+// Banda [lo, hi) fuera de la cual una lectura se envía sin esperar al
+// período: salto, paso de PWM o cruce del umbral más cercano
+void sample_rate_watch_band(const sample_rate_t *r, float *lo, float *hi);
+
+// Próximo vencimiento del período adaptativo (esp_timer, µs)
+int64_t sample_rate_deadline_us(const sample_rate_t *r, int64_t now_us);
+
+// Próxima vigilancia sin aviso del driver: now + min_ms, o antes si vence el período
+int64_t sample_rate_next_check_us(const sample_rate_t *r, int64_t now_us);
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "data_types.h"
+
+// Horario semanal compilado: en cada cambio de configuración las reglas se
+// "pintan" sobre un índice de 10080 slots (un minuto de la semana cada uno)
+// que apunta a una tabla compacta con solo las reglas activas. Cada ciclo de
+// control es entonces una única lectura indexada, sin importar cuántas reglas
+// haya. Módulo puro (compila también en host/).
+//
+// Solapamiento: si varias reglas cubren el mismo minuto gana la de MENOR
+// índice en schedules[] (mismo criterio que el recorrido lineal original).
+//
+// Cruce de medianoche: una regla 22:00-06:00 con el Lunes en 'days' cubre
+// Lunes 22:00 -> Martes 06:00 (Sábado cruza a Domingo). inicio == fin
+// significa 24 h, igual que is_time_in_range().
+
+#define SCHEDULE_MINUTES_PER_DAY    (24 * 60)
+#define SCHEDULE_MINUTES_PER_WEEK   (7 * SCHEDULE_MINUTES_PER_DAY)
+#define SCHEDULE_SLOT_NONE          0xFF
+
+// Regla compacta: solo lo que necesita la ley de control
+typedef struct {
+    float t_min;            // T_0%
+    float t_max;            // T_100%
+    uint8_t source;         // Índice original en system_config_t.schedules[]
+} schedule_rule_t;
+
+typedef struct {
+    uint8_t slot[SCHEDULE_MINUTES_PER_WEEK];    // Índice en rules[] o SCHEDULE_SLOT_NONE
+    schedule_rule_t rules[MAX_SCHEDULES];
+    uint8_t rule_count;
+} schedule_index_t;
+
+// Reconstruye el índice desde la configuración (~10 KB de escrituras)
+void schedule_index_compile(schedule_index_t *idx, const system_config_t *cfg);
+
+// Regla vigente en 'now', o NULL si ninguna aplica
+const schedule_rule_t *schedule_index_lookup(const schedule_index_t *idx, const struct tm *now);
+
+// Minuto de la semana (0 = Domingo 00:00)
+int schedule_minute_of_week(const struct tm *now);
+
+// Referencia lineal (sin índice): ¿la regla cubre 'now'? Respeta 'days' y
+// el cruce de medianoche. La usan los benchmarks para validar el índice.
+bool schedule_rule_matches(const schedule_reg_t *reg, const struct tm *now);
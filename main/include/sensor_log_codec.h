@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "data_types.h"
+
+// Formato del log persistente de sensores (storage/sensor_log.c).
+// Módulo puro: lo usan el firmware, los benchmarks y el decodificador de
+// Linux (host/tools/slog_decode.c).
+//
+// El log es una secuencia de bloques de SLOG_BLOCK_SIZE bytes (un sector de
+// flash cada uno). Cada bloque empieza con una cabecera con su número de
+// secuencia y la muestra base, así cualquier bloque se decodifica solo (sirve
+// para buscar por tiempo sin leer los anteriores). Después siguen registros
+// de longitud variable codificados como delta contra el anterior:
+//
+//   flags (1 byte), [pwm (1 byte)], [zigzag varint dt], [zigzag varint dtemp]
+//
+//   flags bit0   presencia
+//         bit1-2 temp_quality_t
+//         bit3   sin temperatura válida (no hay dtemp, se conserva la anterior)
+//         bit4   dt == 1 s (se omite dt)
+//         bit5   hay byte de pwm (cambió)
+//         bit6   siempre 0: un registro nunca empieza con 0xFF
+//         bit7   dtemp == 0 (se omite dtemp)
+//
+// El fin de los datos de un bloque es el primer byte 0xFF (flash borrada) en
+// posición de inicio de registro. Todo en little-endian.
+
+#define SLOG_BLOCK_SIZE         4096
+#define SLOG_MAGIC              0x474C5356u     // "VSLG"
+#define SLOG_VERSION            1
+#define SLOG_MAX_RECORD_BYTES   22              // flags + pwm + 2 varints de 10 bytes
+#define SLOG_NO_TEMP            INT16_MIN
+
+#define SLOG_F_PRESENCE         0x01
+#define SLOG_F_QUALITY_SHIFT    1
+#define SLOG_F_QUALITY_MASK     0x06
+#define SLOG_F_NO_TEMP          0x08
+#define SLOG_F_DT_ONE           0x10
+#define SLOG_F_PWM              0x20
+#define SLOG_F_RESERVED         0x40
+#define SLOG_F_DTEMP_ZERO       0x80
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;           // Creciente: orden de escritura de los bloques
+    int64_t base_ts;        // Epoch (s) de la muestra base
+    int16_t base_temp;      // °C * 100 (SLOG_NO_TEMP si no había)
+    uint8_t base_pwm;
+    uint8_t version;
+    uint32_t crc;           // CRC32 de los campos anteriores
+} slog_block_header_t;
+
+_Static_assert(sizeof(slog_block_header_t) == 24, "cabecera de bloque: 24 bytes");
+
+typedef struct {
+    int64_t ts;             // Epoch (s)
+    int16_t temp_c100;      // °C * 100, o SLOG_NO_TEMP
+    uint8_t pwm;
+    bool presence;
+    temp_quality_t quality;
+} slog_record_t;
+
+// Estado del codificador/decodificador (última muestra del bloque)
+typedef struct {
+    int64_t ts;
+    int16_t temp_c100;
+    uint8_t pwm;
+} slog_cursor_t;
+
+typedef void (*slog_record_fn)(void *ctx, const slog_record_t *rec);
+
+uint32_t slog_crc32(const void *data, size_t len);
+
+// Registro desde una muestra de control_task (temperatura redondeada a 0.01 °C)
+void slog_record_from_sample(slog_record_t *rec, int64_t ts, const sensor_data_t *data, uint32_t pwm);
+
+// Escribe la cabecera de un bloque nuevo con 'first' como muestra base.
+// Devuelve los bytes usados (la cabecera); el primer registro se agrega
+// después con slog_encode() como cualquier otro (dt = 0).
+size_t slog_block_begin(uint8_t *block, uint32_t seq, const slog_record_t *first, slog_cursor_t *cur);
+
+// Codifica 'rec' en 'out'. Devuelve los bytes escritos, o 0 si no entra en
+// 'cap' (el cursor no cambia en ese caso).
+size_t slog_encode(slog_cursor_t *cur, const slog_record_t *rec, uint8_t *out, size_t cap);
+
+// Valida la cabecera (magic, versión y CRC)
+bool slog_header_read(const uint8_t *block, slog_block_header_t *out);
+
+// Decodifica un bloque de 'len' bytes (normalmente SLOG_BLOCK_SIZE) y llama a
+// 'fn' por cada registro (fn puede ser NULL). Devuelve la cantidad de
+// registros; en 'used' (opcional) deja el offset del fin de datos válidos y
+// en 'last' (opcional) el cursor tras el último registro. Un registro
+// truncado o corrupto termina la decodificación.
+size_t slog_decode_block(const uint8_t *block, size_t len, slog_record_fn fn, void *ctx,
+                         size_t *used, slog_cursor_t *last);
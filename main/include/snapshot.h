@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+// Snapshot versionado sin bloqueo (seqlock sobre doble buffer).
+//
+// El escritor copia el valor nuevo en el slot inactivo y lo publica
+// incrementando la versión (slot activo = version & 1). Los lectores copian
+// el slot activo y reintentan si la versión cambió durante la copia: nunca
+// bloquean al escritor ni entre sí. Módulo puro (compila también en host/).
+//
+// Un solo escritor a la vez: si hay varios, deben serializarse por fuera
+// (ej: config_mutex para la configuración).
+
+typedef struct {
+    atomic_uint version;
+    size_t size;
+    void *slots[2];
+} snapshot_t;
+
+// slot_a/slot_b: dos buffers de 'size' bytes (estáticos, propiedad del llamador)
+void snapshot_init(snapshot_t *s, void *slot_a, void *slot_b, size_t size, const void *initial);
+
+// Copia el valor vigente en 'out'. Devuelve la versión copiada.
+uint32_t snapshot_read(snapshot_t *s, void *out);
+
+// Publica un valor nuevo (copy-on-write). Devuelve la nueva versión.
+uint32_t snapshot_publish(snapshot_t *s, const void *src);
+
+// Versión vigente (cambia en cada publicación)
+uint32_t snapshot_version(snapshot_t *s);
@@ -0,0 +1,13 @@
+#pragma once
+#include "data_types.h"
+#include "json_writer.h"
+
+// Documento JSON de /api/status (config compartida + config y estado en vivo
+// de cada zona en "zones"), sin heap. states[]: uno por zona en marcha.
+// Lo usan el handler HTTP y los benchmarks de host/.
+void status_json_write(json_writer_t *w, const system_config_t *cfg, const system_state_t *states, unsigned zone_count);
+
+// Documento de /api/config: solo la configuración (sin estado en vivo), con
+// las mismas claves y "version" (el ETag). Zonas: las cfg->zone_count primeras.
+// Los float van exactos (json_float): el documento se puede reenviar con PUT.
+void config_json_write(json_writer_t *w, const system_config_t *cfg);
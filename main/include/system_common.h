@@ -4,56 +4,125 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
+#include "data_types.h"
+#include "snapshot.h"
+#include "history.h"
+#include "latency_hist.h"
+#include "schedule_index.h"
+#include "runtime_metrics.h"
+#include "esp_timer.h"
 
-// --- Definiciones de Tipos ---
-// (Incluir aquí sensor_data_t, fan_command_t, system_config_t)
-// data_types.h
+struct zone_s;
 
-// Datos del Sensor (Producido por Sensor Task)
+// Contexto compartido entre tareas.
+// Config y estado se publican como snapshots sin bloqueo (core/snapshot.c):
+// control_task nunca espera a un cliente HTTP. config_mutex solo serializa
+// a los ESCRITORES de la configuración (lectura-modificación-publicación).
+// El estado de cada zona vive en su zone_t (ver zone.h).
 typedef struct {
-    float temperature;
-    bool presence_detected;
-    int64_t timestamp;
-} sensor_data_t;
+    SemaphoreHandle_t config_mutex;
+    snapshot_t *config_snap;    // system_config_t (escriben: web)
+    struct zone_s *zones;       // zone_count zonas en marcha
+    uint8_t zone_count;
+    // Horario compilado (~10 KB) compartido por las zonas: lo recompila la
+    // primera ControlTask que ve una versión nueva de la config. Protegido
+    // por schedule_mutex (buscar la regla toma µs).
+    schedule_index_t *schedule;
+    uint32_t schedule_version;
+    SemaphoreHandle_t schedule_mutex;
+    void (*state_listener)(void); // Aviso de estado/config nuevos (NULL = nadie escucha; lo fija el servidor web desde NetMgr, con las zonas ya andando)
+    history_t *history;         // Telemetría de la zona 0 (escribe: su control_task)
+    SemaphoreHandle_t history_mutex; // Protege 'history' (secciones de pocos µs)
+    // Espera para tomar cada mutex compartido y tiempo tomado (µs, ver app_lock_take)
+    portMUX_TYPE lock_stats_mux;
+    latency_hist_t lock_wait[METRIC_LOCK_COUNT];
+    latency_hist_t lock_hold[METRIC_LOCK_COUNT];
+    int64_t lock_taken_us[METRIC_LOCK_COUNT];   // Lo escribe solo quien tiene el mutex
+} app_context_t;
 
-// Comandos de Actuación (Consumido por Actuator Task)
-typedef struct {
-    uint32_t duty_cycle_percent; // 0-100
-    bool enabled;
-} fan_command_t;
+// xSemaphoreTake(m, portMAX_DELAY) midiendo la espera para /api/metrics. Sin
+// contención registra 0; si el mutex está tomado, mide con esp_timer cuánto
+// tardó en liberarse. Devuelve pdTRUE (como el Take). Se libera con
+// app_lock_give, que registra cuánto estuvo tomado.
+static inline BaseType_t app_lock_take(app_context_t *ctx, metric_lock_t id, SemaphoreHandle_t m) {
+    uint32_t waited = 0;
+    int64_t t0 = esp_timer_get_time();
+    if (xSemaphoreTake(m, 0) != pdTRUE) {
+        xSemaphoreTake(m, portMAX_DELAY);
+        int64_t t1 = esp_timer_get_time();
+        waited = (uint32_t)(t1 - t0);
+        t0 = t1;
+    }
+    ctx->lock_taken_us[id] = t0;
+    taskENTER_CRITICAL(&ctx->lock_stats_mux);
+    latency_hist_record(&ctx->lock_wait[id], waited);
+    taskEXIT_CRITICAL(&ctx->lock_stats_mux);
+    return pdTRUE;
+}
+
+static inline void app_lock_give(app_context_t *ctx, metric_lock_t id, SemaphoreHandle_t m) {
+    uint32_t held = (uint32_t)(esp_timer_get_time() - ctx->lock_taken_us[id]);
+    xSemaphoreGive(m);
+    taskENTER_CRITICAL(&ctx->lock_stats_mux);
+    latency_hist_record(&ctx->lock_hold[id], held);
+    taskEXIT_CRITICAL(&ctx->lock_stats_mux);
+}
 
-// Definición de Registro Horario
+// De dónde salió la configuración del arranque (storage/config_manager.c)
+typedef enum {
+    CONFIG_LOAD_DEFAULTS = 0,   // No había nada guardado
+    CONFIG_LOAD_NVS,            // Blob versionado (core/config_codec.c) del esquema actual
+    CONFIG_LOAD_MIGRATED,       // Esquema anterior o volcado crudo de un firmware viejo
+    CONFIG_LOAD_REJECTED,       // Blob corrupto: se usó el default
+    CONFIG_LOAD_REPAIRED,       // Campos o reglas fuera de rango repuestos (config_repair)
+} config_load_source_t;
+
+// Estadísticas del escritor diferido de configuración (storage/config_manager.c)
 typedef struct {
-    uint8_t start_hour;
-    uint8_t start_min;
-    uint8_t end_hour;
-    uint8_t end_min;
-    float temp_min_0_percent;   // T_0%
-    float temp_max_100_percent; // T_100%
-    bool active;
-} schedule_reg_t;
-
-// Configuración Global
+    uint32_t requests;          // Pedidos de guardado (uno por cambio vía web)
+    uint32_t writes;            // Escrituras reales a NVS
+    uint32_t skipped_unchanged; // Ventanas cerradas con el blob idéntico al guardado
+    uint32_t errors;            // Fallos de nvs_set_blob/nvs_commit
+    uint32_t last_save_us;      // Duración de la última escritura
+    uint32_t max_save_us;       // Peor escritura observada
+    uint32_t blob_bytes;        // Tamaño del último blob leído o escrito
+    uint32_t load_us;           // Arranque: lectura de NVS + decodificación (+ migración)
+    uint32_t load_unknown;      // Registros salteados al cargar (tags de un firmware más nuevo)
+    config_load_source_t load_source;
+} config_store_stats_t;
+
+// Estadísticas del log persistente de sensores (storage/sensor_log.c)
 typedef struct {
-    enum { MODE_MANUAL, MODE_AUTO, MODE_SCHEDULE } operation_mode;
-    uint32_t manual_duty;
-    schedule_reg_t schedules[3];
-} system_config_t;
+    uint32_t records;           // Registros codificados
+    uint32_t bytes;             // Bytes de registros (sin cabeceras de bloque)
+    uint32_t blocks;            // Bloques abiertos desde el arranque
+    uint32_t dropped;           // Registros perdidos (escritor atrasado)
+    uint32_t erases;            // Sectores borrados
+    uint32_t flash_writes;      // Llamadas a esp_partition_write
+    uint32_t errors;
+    uint32_t max_flush_us;      // Peor borrado + escritura observado
+    uint32_t sectors;           // Tamaño del anillo
+} sensor_log_stats_t;
 
-// --- NUEVO: Estado en tiempo real (Volátil, solo para visualización) ---
+// Muestreo por eventos de SensorTask (tasks/task_sensor.c)
 typedef struct {
-    float current_temp;
-    bool presence;
-    uint32_t current_pwm;
-    char current_time_str[16]; // "HH:MM:SS"
-} system_state_t;
+    uint32_t checks;            // Despertares (vigilancia, período o flanco del PIR)
+    uint32_t samples[SAMPLE_REASON_COUNT]; // Muestras enviadas a control_task por motivo
+    uint32_t period_ms;         // Período adaptativo vigente
+    uint32_t rate_mc_per_s;     // |dT/dt| estimado (m°C/s)
+    latency_hist_t timer_late;  // Despertares por tiempo: retraso sobre el vencimiento (tick + salida de light sleep)
+    uint32_t queue_max;         // Máxima ocupación de la cola vista tras un envío
+    uint32_t queue_full;        // Muestras descartadas por cola llena
+    latency_hist_t jitter;      // Muestras periódicas: despertar - vencimiento de la grilla (µs)
+    uint32_t overruns;          // Vencimientos saltados por atraso de más de un período
+} sensor_loop_stats_t;
 
-// Modificar el contexto para incluir el estado
+// Latencia despertar de SensorTask -> set_duty, por motivo (tasks/task_control.c)
 typedef struct {
-    QueueHandle_t sensor_queue;
-    QueueHandle_t actuator_queue;
-    SemaphoreHandle_t config_mutex;
-    system_config_t *shared_config;
-    system_state_t  *shared_state; // <--- NUEVO PUNTERO
-} app_context_t;
+    latency_hist_t latency[SAMPLE_REASON_COUNT];
+    uint32_t deadline_miss;     // set_duty después de vencimiento + sample_deadline_ms
+    uint32_t first_duty_ms;     // Primer set_duty, en ms desde el arranque (0 = todavía no; no se reinicia con el modo)
+} control_loop_stats_t;
 
+// Destino de sensor_log_export(): devuelve 0 si pudo entregar los datos
+typedef int (*sensor_log_sink_fn)(void *ctx, const uint8_t *data, size_t len);
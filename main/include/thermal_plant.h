@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// Modelo térmico mínimo de la habitación: primer orden con retardo puro del
+// actuador. Con el ventilador a u (0-100 %) la temperatura tiende a
+//     T_eq = ambient_c - fan_gain_c * u / 100
+// con constante de tiempo tau_s, y el efecto de u llega dead_time_s tarde.
+// Lo usan el mock de HAL (mocks/), el autotune y los benchmarks de
+// controladores. Módulo puro (compila también en host/).
+
+#define THERMAL_PLANT_DELAY_LEN     256     // Pasos de retardo máximos
+
+typedef struct {
+    float ambient_c;        // Equilibrio sin ventilador (carga térmica incluida)
+    float fan_gain_c;       // Enfriamiento de régimen con el ventilador al 100 %
+    float tau_s;            // Constante de tiempo térmica
+    float dead_time_s;      // Retardo entre el PWM y su efecto
+    float noise_c;          // Ruido de medición (uniforme, +-noise_c)
+    float step_s;           // Paso de integración
+} thermal_plant_params_t;
+
+typedef struct {
+    thermal_plant_params_t p;
+    float temp_c;           // Temperatura real
+    uint32_t seed;          // PRNG del ruido (determinista)
+    uint8_t delay[THERMAL_PLANT_DELAY_LEN];
+    uint16_t delay_len;
+    uint16_t delay_pos;
+} thermal_plant_t;
+
+extern const thermal_plant_params_t thermal_plant_default_params;
+
+// Arranca en equilibrio con el ventilador apagado
+void thermal_plant_init(thermal_plant_t *pl, const thermal_plant_params_t *params, uint32_t seed);
+
+// Avanza un paso (step_s) con el ventilador en 'pwm'
+void thermal_plant_step(thermal_plant_t *pl, uint32_t pwm);
+
+// Lectura del sensor (temperatura real + ruido)
+float thermal_plant_measure(thermal_plant_t *pl);
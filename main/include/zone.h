@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "system_common.h"
+#include "hal_interfaces.h"
+
+// Una zona: un sensor de temperatura, un PIR y un ventilador (el mismo canal
+// en cada interfaz de HAL), su bloque de configuración (cfg.zones[id]) y su
+// par de tareas SensorTask/ControlTask. Las zonas no comparten estado entre
+// sí salvo el horario compilado (app_context_t.schedule, con su mutex).
+//
+// Las tareas de cada zona van fijadas a un núcleo con xTaskCreatePinnedToCore
+// alternando entre ambos: la zona 0 en el APP_CPU (el PRO_CPU ya tiene Wi-Fi
+// y lwIP), la 1 en el PRO_CPU, etc. El par de una zona comparte núcleo: la
+// cola entre ambas nunca cruza de CPU.
+// Task watchdog (CONFIG_ESP_TASK_WDT_TIMEOUT_S): las dos tareas de cada zona
+// se suscriben y lo alimentan al menos cada ZONE_WDT_FEED_MS aunque no haya
+// muestras. Si una queda trabada (mutex, driver, cola) el TWDT la reporta
+// por nombre con backtrace.
+#define ZONE_WDT_FEED_MS    2000
+
+typedef struct zone_s {
+    uint8_t id;                 // Índice en cfg.zones[] y canal de HAL
+    BaseType_t core;
+    const temp_sensor_interface_t *temp;
+    const pir_sensor_interface_t *pir;
+    const fan_interface_t *fan;
+    app_context_t *app;
+
+    QueueHandle_t sensor_queue; // SensorTask -> ControlTask
+
+    // Estado en vivo (escribe: ControlTask de la zona; leen: web)
+    snapshot_t state_snap;
+    system_state_t state_slots[2];
+
+    // Estadísticas para /api/loop y /api/power (getters en tasks/*.c)
+    portMUX_TYPE stats_mux;
+    sensor_loop_stats_t sensor_stats;
+    control_loop_stats_t control_stats;
+
+    TaskHandle_t sensor_task;
+    TaskHandle_t control_task;
+} zone_t;
+
+// Crea las 'count' zonas (acotado a MAX_ZONES y a los canales de la HAL
+// elegida), inicializa sus periféricos y lanza sus tareas. Devuelve cuántas
+// quedaron en marcha.
+uint8_t zones_start(app_context_t *ctx, uint8_t count);
+
+void sensor_task_get_stats(zone_t *zone, sensor_loop_stats_t *out);
+void control_task_get_stats(zone_t *zone, control_loop_stats_t *out);
+
+// Métricas de ejecución para /api/metrics: tareas, colas y latencias de las
+// zonas, espera en los mutex (tasks/metrics.c)
+void runtime_metrics_collect(app_context_t *ctx, runtime_metrics_t *m);
@@ -1,42 +1,64 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "system_common.h"
+#include "zone.h"
+#include "power_manager.h"
+#include "net_manager.h"
+#include "blog.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 // Prototipos
-void sensor_task(void *pvParameters);
-void control_task(void *pvParameters);
 esp_err_t config_manager_init(void);
 esp_err_t config_manager_load(system_config_t *target_config);
-void wifi_init_sta(void);
-void start_web_server(app_context_t *ctx); // <--- NUEVO
+void config_manager_start_writer(snapshot_t *config_snap, const system_config_t *saved_config);
+esp_err_t sensor_log_init(void);
 
 static app_context_t app_ctx;
-static system_config_t global_config;
-static system_state_t global_state; // <--- NUEVA variable estática
+
+// Doble buffer de los snapshots (ver snapshot.h)
+static system_config_t config_slots[2];
+static snapshot_t config_snap;
+
+// Historial de telemetría en RAM (tamaño fijo, ver history.h)
+static history_t history;
 
 void app_main(void) {
     // 1. Inicializar Storage
+    system_config_t boot_config = default_system_config;
     config_manager_init();
-    config_manager_load(&global_config);
+    config_manager_load(&boot_config);
+    sensor_log_init();
+    snapshot_init(&config_snap, &config_slots[0], &config_slots[1], sizeof(system_config_t), &boot_config);
 
-    // 2. Inicializar WiFi
-    wifi_init_sta();
+    // Locks de energía antes de que los drivers los usen (el modo lo aplica control_task)
+    power_manager_init();
+    blog_start();   // Log binario de las tareas de control y los drivers
 
-    // 3. Inicializar Contexto
-    app_ctx.sensor_queue = xQueueCreate(5, sizeof(sensor_data_t));
-    app_ctx.actuator_queue = xQueueCreate(5, sizeof(fan_command_t));
+    // 2. Inicializar Contexto
     app_ctx.config_mutex = xSemaphoreCreateMutex();
-    app_ctx.shared_config = &global_config;
-    app_ctx.shared_state = &global_state; // <--- Asignar puntero
+    app_ctx.config_snap = &config_snap;
+    history_init(&history);
+    app_ctx.history = &history;
+    app_ctx.history_mutex = xSemaphoreCreateMutex();
+    portMUX_INITIALIZE(&app_ctx.lock_stats_mux);
+    ESP_LOGI("MAIN", "Historial: %u bytes en RAM", (unsigned)sizeof(history));
+
+    // Zona horaria antes de que las zonas usen localtime (la hora llega
+    // después, por SNTP). Colombia/Peru UTC-5: la forma POSIX sin horario
+    // de verano es "EST5" ("CET-1CEST" sería Europa).
+    setenv("TZ", "EST5", 1);
+    tzset();
 
-    // 4. Iniciar Tareas Core
-    xTaskCreate(sensor_task, "SensorTask", 4096, &app_ctx, 5, NULL);
-    xTaskCreate(control_task, "ControlTask", 4096, &app_ctx, 5, NULL);
+    // 3. Iniciar Tareas Core: el ventilador responde desde acá, haya red o no
+    config_manager_start_writer(&config_snap, &boot_config);
+    zones_start(&app_ctx, boot_config.zone_count); // Sensor + Control por zona, repartidas en ambos núcleos
 
-    // 5. Iniciar Servidor Web
-    start_web_server(&app_ctx); // <--- LANZAMIENTO
+    // 4. Red en segundo plano: WiFi, SNTP y servidor web con reintentos (no bloquea)
+    net_manager_start(&app_ctx);
 
-    ESP_LOGI("MAIN", "System 3.0 Running: Web Server Active");
-}
\ No newline at end of file
+    ESP_LOGI("MAIN", "System 3.0 Running: control a %lu ms del arranque, red en segundo plano",
+             (unsigned long)(esp_timer_get_time() / 1000));
+}
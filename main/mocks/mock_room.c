@@ -0,0 +1,115 @@
+#include "hal_interfaces.h"
+#include "room_sim.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static const char *TAG = "MOCK_ROOM";
+
+// HAL mock: sensor de temperatura, PIR y ventilador de cada zona salen del
+// mismo simulador de habitación (core/room_sim.c), que también corre en
+// host/bench/bench_room. El reloj virtual avanza MOCK_ROOM_TIME_SCALE veces
+// más rápido que esp_timer (idf.py -DMOCK_ROOM_TIME_SCALE=60 build: un día
+// en 24 min), así se ven la carga del día y los perfiles de ocupación en la
+// placa. El control sigue en tiempo real: con escala > 1 la habitación
+// responde más rápido que lo que supone el PID, y PROGRAMADO usa la hora NTP,
+// no la virtual.
+//
+// Una habitación por zona, cada una medio grado más cálida y con su propia
+// semilla. El simulador lo avanza solo la SensorTask de la zona (lecturas);
+// la ControlTask (mismo núcleo) solo escribe el pedido del ventilador, que
+// se toma en el próximo paso.
+
+#ifndef MOCK_ROOM_TIME_SCALE
+#define MOCK_ROOM_TIME_SCALE    1
+#endif
+#define MOCK_ROOM_START_S       (19 * 3600)     // Domingo 19:00 virtual al arrancar
+
+static room_sim_t rooms[MAX_ZONES];
+static int64_t boot_us[MAX_ZONES];
+static uint32_t hold_ms[MAX_ZONES];
+
+static void advance(uint8_t ch) {
+    room_sim_advance(&rooms[ch], (esp_timer_get_time() - boot_us[ch]) * MOCK_ROOM_TIME_SCALE);
+}
+
+// --- Temperatura ---
+
+static esp_err_t mock_temp_init(uint8_t ch) {
+    room_sim_params_t p = room_sim_default_params;
+    p.outdoor_mean_c += 0.5f * ch;
+    room_sim_init(&rooms[ch], &p, 1 + ch, MOCK_ROOM_START_S);
+    boot_us[ch] = esp_timer_get_time();
+    hold_ms[ch] = 30000;
+    if (ch == 0) {
+        ESP_LOGI(TAG, "Habitación simulada: perfil %s, reloj x%d", room_sim_occupancy_name(p.occupancy), MOCK_ROOM_TIME_SCALE);
+    }
+    return ESP_OK;
+}
+
+static float mock_temp_read(uint8_t ch) {
+    advance(ch);
+    float val = room_sim_measure(&rooms[ch]);
+    ESP_LOGD(TAG, "Mock Temp %u Reading: %.2f", ch, val);
+    return val;
+}
+
+// --- PIR: presencia = movimiento en los últimos hold_ms (reales), como pir_isr_impl ---
+
+static esp_err_t mock_pir_init(uint8_t ch) { return ESP_OK; }
+
+static bool mock_pir_read(uint8_t ch) {
+    advance(ch);
+    const room_sim_t *r = &rooms[ch];
+    bool motion = r->last_motion_us >= 0 &&
+                  r->t_us - r->last_motion_us < (int64_t)hold_ms[ch] * 1000 * MOCK_ROOM_TIME_SCALE;
+    ESP_LOGD(TAG, "Mock PIR %u: %s", ch, motion ? "YES" : "NO");
+    return motion;
+}
+
+static void mock_pir_set_hold_time_ms(uint8_t ch, uint32_t ms) {
+    hold_ms[ch] = ms;   // Tiempo real, como el resto de SensorTask
+}
+
+static int64_t mock_pir_last_motion_us(uint8_t ch) {
+    const room_sim_t *r = &rooms[ch];
+    return (r->last_motion_us < 0) ? 0 : boot_us[ch] + r->last_motion_us / MOCK_ROOM_TIME_SCALE;
+}
+
+// --- Ventilador ---
+
+static esp_err_t mock_fan_init(uint8_t ch) { return ESP_OK; }
+
+static esp_err_t mock_fan_set_duty(uint8_t ch, uint32_t percent) {
+    // Aquí verás en la consola la salida del sistema
+    ESP_LOGD(TAG, ">> FAN %u OUTPUT SET TO: %lu %% <<", ch, percent);
+    room_sim_set_duty(&rooms[ch], percent);
+    return ESP_OK;
+}
+
+static bool mock_fan_is_fading(uint8_t ch) { return room_sim_fading(&rooms[ch]); }
+
+// Pendiente en %/s reales -> %/s virtuales (al menos 1: 0 sería instantáneo)
+static uint32_t slew_virtual(uint32_t pct_s) {
+    return (pct_s == 0) ? 0 : (pct_s / MOCK_ROOM_TIME_SCALE > 0) ? pct_s / MOCK_ROOM_TIME_SCALE : 1;
+}
+
+static void mock_fan_set_slew(uint8_t ch, uint32_t up_pct_s, uint32_t down_pct_s) {
+    room_sim_set_slew(&rooms[ch], slew_virtual(up_pct_s), slew_virtual(down_pct_s));
+}
+
+// Instancias de interfaces llenas con funciones mock
+const temp_sensor_interface_t temp_mock_impl = { .channels = MAX_ZONES, .init = mock_temp_init, .read_celsius = mock_temp_read };
+const pir_sensor_interface_t pir_mock_impl = {
+    .channels = MAX_ZONES,
+    .init = mock_pir_init,
+    .is_motion_detected = mock_pir_read,
+    .set_hold_time_ms = mock_pir_set_hold_time_ms,
+    .last_motion_us = mock_pir_last_motion_us,
+};
+const fan_interface_t fan_mock_impl = {
+    .channels = MAX_ZONES,
+    .init = mock_fan_init,
+    .set_duty = mock_fan_set_duty,
+    .is_fading = mock_fan_is_fading,
+    .set_slew = mock_fan_set_slew,
+};
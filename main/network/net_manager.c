@@ -0,0 +1,266 @@
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_sntp.h"
+#include "esp_timer.h"
+#include "net_manager.h"
+
+// --- CREDENCIALES WIFI ---
+#define WIFI_SSID      "Teddy"
+#define WIFI_PASS      "amoateddy"
+// -------------------------
+
+#define NET_TASK_STACK          4096
+#define NET_TASK_PRIO           3       // Debajo de las zonas (5): la red nunca le gana al control
+#define NET_CONNECT_TIMEOUT_MS  15000
+#define NET_BACKOFF_MIN_MS      1000
+#define NET_BACKOFF_MAX_MS      60000
+#define NET_POLL_MS             1000    // Con IP: revisa si SNTP ya trajo la hora
+
+#define NET_GOT_IP_BIT          BIT0
+#define NET_DISCONNECTED_BIT    BIT1
+
+esp_err_t start_web_server(app_context_t *ctx);
+
+static const char *TAG = "NET_MGR";
+static EventGroupHandle_t s_net_events;
+static app_context_t *s_ctx;
+static atomic_bool s_leaving;           // La tarea pidió esp_wifi_disconnect: su evento no es una caída
+
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static net_stats_t stats;
+
+static const char *const state_names[NET_STATE_COUNT] = { "starting", "connecting", "connected", "backoff" };
+
+const char *net_state_name(net_state_t s) {
+    return (s < NET_STATE_COUNT) ? state_names[s] : "?";
+}
+
+void net_manager_get_stats(net_stats_t *out) {
+    taskENTER_CRITICAL(&stats_mux);
+    *out = stats;
+    taskEXIT_CRITICAL(&stats_mux);
+}
+
+static uint32_t ms_since_boot(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000) + 1;    // 0 queda para "todavía no"
+}
+
+// Hito de arranque: solo la primera vez
+static void mark(uint32_t *field) {
+    uint32_t now = ms_since_boot();
+    taskENTER_CRITICAL(&stats_mux);
+    if (*field == 0) *field = now;
+    taskEXIT_CRITICAL(&stats_mux);
+}
+
+static void count(uint32_t *field) {
+    taskENTER_CRITICAL(&stats_mux);
+    (*field)++;
+    taskEXIT_CRITICAL(&stats_mux);
+}
+
+// Los eventos solo marcan bits: las decisiones (reconectar, esperar) son de
+// la tarea, así una caída no dispara reintentos sin pausa desde el event loop.
+// La desconexión que pidió la propia tarea (timeout de conexión) se descarta:
+// si no, llegaría durante el backoff y contaría como otro fallo.
+static void event_handler(void* arg, esp_event_base_t event_base,
+                                int32_t event_id, void* event_data) {
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        if (atomic_exchange(&s_leaving, false)) return;
+        xEventGroupSetBits(s_net_events, NET_DISCONNECTED_BIT);
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
+        ESP_LOGI(TAG, "Conectado! IP:" IPSTR, IP2STR(&event->ip_info.ip));
+        xEventGroupSetBits(s_net_events, NET_GOT_IP_BIT);
+    }
+}
+
+// Inicializar SNTP (Simple Network Time Protocol). La zona horaria ya la
+// fijó app_main antes de arrancar las zonas.
+static void initialize_sntp(void) {
+    ESP_LOGI(TAG, "Inicializando SNTP...");
+    esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, "pool.ntp.org");
+    esp_sntp_init();
+}
+
+// Mismo criterio que control_task para habilitar los modos programados
+static bool time_valid(void) {
+    time_t now = time(NULL);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    return tm.tm_year > (2020 - 1900);
+}
+
+// netif, driver WiFi y servidor web. Cada paso queda hecho una sola vez
+// (su handle o flag se fija al completarlo): si uno falla (ej: sin heap para
+// el driver), el reintento sigue desde ese paso sin repetir los anteriores.
+// esp_netif_init y el event loop toleran una segunda llamada; el netif STA no
+// (segundo netif con la misma clave: assert), por eso va con su handle.
+static esp_err_t net_bring_up(void) {
+    static esp_netif_t *sta_netif;
+    static esp_event_handler_instance_t wifi_handler, ip_handler;
+    static bool wifi_done, web_done;
+    esp_err_t err;
+
+    err = esp_netif_init();
+    if (err != ESP_OK) return err;
+    err = esp_event_loop_create_default();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return err;
+    if (sta_netif == NULL) {
+        sta_netif = esp_netif_create_default_wifi_sta();
+        if (sta_netif == NULL) return ESP_FAIL;
+    }
+    if (wifi_handler == NULL) {
+        err = esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &event_handler, NULL, &wifi_handler);
+        if (err != ESP_OK) {
+            wifi_handler = NULL;
+            return err;
+        }
+    }
+    if (ip_handler == NULL) {
+        err = esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &event_handler, NULL, &ip_handler);
+        if (err != ESP_OK) {
+            ip_handler = NULL;
+            return err;
+        }
+    }
+
+    if (!wifi_done) {
+        wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+        err = esp_wifi_init(&cfg);
+        if (err != ESP_OK) return err;
+        wifi_config_t wifi_config = {
+            .sta = {
+                .ssid = WIFI_SSID,
+                .password = WIFI_PASS,
+                .threshold.authmode = WIFI_AUTH_WPA2_PSK,
+            },
+        };
+        err = esp_wifi_set_mode(WIFI_MODE_STA);
+        if (err == ESP_OK) err = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+        if (err == ESP_OK) err = esp_wifi_start();
+        if (err != ESP_OK) {
+            esp_wifi_deinit();
+            return err;
+        }
+        wifi_done = true;
+        ESP_LOGI(TAG, "WiFi Iniciado");
+    }
+
+    // El httpd escucha en todas las interfaces: queda listo antes de la IP
+    // y atiende en cuanto llega (o en la próxima reconexión)
+    if (!web_done) {
+        err = start_web_server(s_ctx);
+        if (err != ESP_OK) return err;
+        web_done = true;
+        mark(&stats.web_ms);
+    }
+    return ESP_OK;
+}
+
+// backoff ±25 % para que varias cunas no reintenten juntas tras un corte del AP
+static uint32_t jitter(uint32_t ms) {
+    return ms - ms / 4 + esp_random() % (ms / 2 + 1);
+}
+
+// --- TAREA DE RED ---
+
+static void net_task(void *arg) {
+    net_state_t state = NET_STARTING;
+    net_state_t retry = NET_STARTING;   // A dónde vuelve después del backoff
+    uint32_t backoff_ms = NET_BACKOFF_MIN_MS;
+    bool sntp_started = false;
+
+    while (1) {
+        taskENTER_CRITICAL(&stats_mux);
+        stats.state = state;
+        taskEXIT_CRITICAL(&stats_mux);
+
+        switch (state) {
+        case NET_STARTING: {
+            esp_err_t err = net_bring_up();
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Arranque de red: %s", esp_err_to_name(err));
+                count(&stats.init_errors);
+                retry = NET_STARTING;
+                state = NET_BACKOFF;
+            } else {
+                state = NET_CONNECTING;
+            }
+            break;
+        }
+
+        case NET_CONNECTING: {
+            count(&stats.attempts);
+            atomic_store(&s_leaving, false);    // Si el disconnect anterior no generó evento
+            xEventGroupClearBits(s_net_events, NET_GOT_IP_BIT | NET_DISCONNECTED_BIT);
+            esp_wifi_connect();
+            EventBits_t bits = xEventGroupWaitBits(s_net_events, NET_GOT_IP_BIT | NET_DISCONNECTED_BIT,
+                                                   pdTRUE, pdFALSE, pdMS_TO_TICKS(NET_CONNECT_TIMEOUT_MS));
+            if (bits & NET_GOT_IP_BIT) {
+                mark(&stats.wifi_ms);
+                if (!sntp_started) {
+                    initialize_sntp();
+                    sntp_started = true;
+                }
+                backoff_ms = NET_BACKOFF_MIN_MS;
+                state = NET_CONNECTED;
+            } else {
+                // AP ausente, clave rechazada o sin DHCP a tiempo
+                if (!(bits & NET_DISCONNECTED_BIT)) {
+                    atomic_store(&s_leaving, true);
+                    esp_wifi_disconnect();
+                }
+                retry = NET_CONNECTING;
+                state = NET_BACKOFF;
+            }
+            break;
+        }
+
+        case NET_CONNECTED: {
+            // Ya con hora solo espera la caída: sin despertares que corten el light sleep
+            TickType_t wait = stats.sntp_ms ? portMAX_DELAY : pdMS_TO_TICKS(NET_POLL_MS);
+            EventBits_t bits = xEventGroupWaitBits(s_net_events, NET_DISCONNECTED_BIT, pdTRUE, pdFALSE, wait);
+            if (stats.sntp_ms == 0 && time_valid()) {
+                mark(&stats.sntp_ms);
+                ESP_LOGI(TAG, "Hora sincronizada a %lu ms del arranque", (unsigned long)stats.sntp_ms);
+            }
+            if (bits & NET_DISCONNECTED_BIT) {
+                ESP_LOGW(TAG, "Desconectado del AP");
+                count(&stats.disconnects);
+                retry = NET_CONNECTING;
+                state = NET_BACKOFF;
+            }
+            break;
+        }
+
+        case NET_BACKOFF:
+        default: {
+            uint32_t wait_ms = jitter(backoff_ms);
+            taskENTER_CRITICAL(&stats_mux);
+            stats.backoff_ms = wait_ms;
+            taskEXIT_CRITICAL(&stats_mux);
+            ESP_LOGI(TAG, "Reintento en %lu ms", (unsigned long)wait_ms);
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+            backoff_ms = (backoff_ms * 2 > NET_BACKOFF_MAX_MS) ? NET_BACKOFF_MAX_MS : backoff_ms * 2;
+            state = retry;
+            break;
+        }
+        }
+    }
+}
+
+void net_manager_start(app_context_t *ctx) {
+    s_ctx = ctx;
+    s_net_events = xEventGroupCreate();
+    xTaskCreate(net_task, "NetMgr", NET_TASK_STACK, NULL, NET_TASK_PRIO, NULL);
+}
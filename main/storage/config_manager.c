@@ -1,31 +1,24 @@
 #include "system_common.h"
+#include "config_codec.h"
+#include "config_check.h"
 #include <esp_err.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <nvs_flash.h>
 #include <nvs.h>
+#include <stddef.h>
 #include <string.h> // para memcpy
 
 static const char *TAG = "NVS_MGR";
 static const char *NVS_NAMESPACE = "vent_config";
-static const char *KEY_CONFIG = "sys_cfg";
-
-// Configuración por defecto (Si es la primera vez que arranca)
-// Configuración por defecto
-static const system_config_t default_config = {
-    .operation_mode = 2, // <--- CAMBIADO A 2 (MODE_SCHEDULE)
-    .manual_duty = 50,
-    .schedules = {
-        // REGISTRO 0: Activo todo el día (00:00 a 23:59) para pruebas
-        { 
-            .active = true, 
-            .start_hour=0, .start_min=0, 
-            .end_hour=23, .end_min=59, 
-            .temp_min_0_percent=23.0,   // Empezar a girar a los 23°C
-            .temp_max_100_percent=26.0  // Máximo a los 26°C
-        },
-        {0}, {0}
-    }
-};
+static const char *KEY_CONFIG = "cfg";          // Formato versionado (core/config_codec.c)
+static const char *KEY_LEGACY = "sys_cfg";      // Volcado crudo del firmware original (56 bytes)
+
+// Blob codificado: lo usa config_manager_load en el arranque y después solo CfgWriter
+static uint8_t blob[CONFIG_BLOB_MAX];
+
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static config_store_stats_t stats;
 
 esp_err_t config_manager_init(void) {
     esp_err_t ret = nvs_flash_init();
@@ -36,6 +29,23 @@ esp_err_t config_manager_init(void) {
     return ret;
 }
 
+// Volcado crudo del firmware original (ver config_decode_legacy). Lo que
+// traiga fuera de rango se arregla igual que un blob versionado.
+static bool legacy_load(nvs_handle_t h, system_config_t *cfg) {
+    uint8_t raw[CONFIG_LEGACY_SIZE];
+    size_t size = sizeof(raw);
+    if (nvs_get_blob(h, KEY_LEGACY, raw, &size) != ESP_OK) return false;
+    if (!config_decode_legacy(raw, size, cfg)) {
+        ESP_LOGW(TAG, "Config cruda vieja de %u bytes, se descarta", (unsigned)size);
+        *cfg = default_system_config;
+        return false;
+    }
+    return true;
+}
+
+// Orden: blob versionado; si no hay, el volcado crudo de un firmware viejo;
+// si no, el default. Todo lo que no sea el blob del esquema actual se
+// reescribe en el formato nuevo ahora mismo: la migración corre una sola vez.
 esp_err_t config_manager_load(system_config_t *target_config) {
     nvs_handle_t my_handle;
     esp_err_t err;
@@ -43,37 +53,166 @@ esp_err_t config_manager_load(system_config_t *target_config) {
     err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &my_handle);
     if (err != ESP_OK) return err;
 
-    size_t required_size = sizeof(system_config_t);
-    
-    // Intentar leer la estructura completa
-    err = nvs_get_blob(my_handle, KEY_CONFIG, target_config, &required_size);
-
-    if (err == ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGW(TAG, "No config found, loading defaults...");
-        memcpy(target_config, &default_config, sizeof(system_config_t));
-        // Guardar la default inmediatamente
-        nvs_set_blob(my_handle, KEY_CONFIG, target_config, sizeof(system_config_t));
-        nvs_commit(my_handle);
-    } else if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Configuration loaded from NVS");
+    int64_t t0 = esp_timer_get_time();
+    config_load_source_t source = CONFIG_LOAD_DEFAULTS;
+    config_decode_info_t info = {0};
+    size_t size = sizeof(blob);
+    err = nvs_get_blob(my_handle, KEY_CONFIG, blob, &size);
+    if (err == ESP_OK) {
+        config_decode_err_t derr = config_decode(blob, size, target_config, &info);
+        if (derr != CONFIG_DECODE_OK) {
+            ESP_LOGE(TAG, "Config en NVS descartada (%s), se usa la de fábrica",
+                     config_decode_err_name(derr));
+            *target_config = default_system_config;
+            source = CONFIG_LOAD_REJECTED;
+        } else {
+            source = (info.schema < CONFIG_SCHEMA) ? CONFIG_LOAD_MIGRATED : CONFIG_LOAD_NVS;
+        }
+    } else if (legacy_load(my_handle, target_config)) {
+        source = CONFIG_LOAD_MIGRATED;
+        size = 0;
+    } else {
+        *target_config = default_system_config;
+        size = 0;
+    }
+
+    // Fuera de rango (escrita por un firmware con otros límites): se repone
+    // solo el campo o la regla mala, no toda la config
+    int index;
+    const char *bad = config_check(target_config, &index);
+    if (bad != NULL) {
+        int fixed = config_repair(target_config);
+        ESP_LOGW(TAG, "Config fuera de rango (%s %d): %d arreglos", bad, index, fixed);
+        source = CONFIG_LOAD_REPAIRED;
     }
+    uint32_t load_us = (uint32_t)(esp_timer_get_time() - t0);
 
+    if (source != CONFIG_LOAD_NVS) {
+        size = config_encode(target_config, blob, sizeof(blob));
+        if (size > 0 && nvs_set_blob(my_handle, KEY_CONFIG, blob, size) == ESP_OK) {
+            nvs_erase_key(my_handle, KEY_LEGACY);   // NOT_FOUND si no estaba
+            nvs_commit(my_handle);
+        }
+    }
     nvs_close(my_handle);
-    return ESP_OK; // Si no se encontró, devolvemos OK porque ya cargamos default
+
+    static const char *const source_names[] = { "de fábrica", "de NVS", "migrada", "descartada", "reparada" };
+    ESP_LOGI(TAG, "Config %s (esquema %u): %u bytes, %lu us, %u registros desconocidos",
+             source_names[source], info.schema, (unsigned)size, load_us, info.unknown);
+
+    portENTER_CRITICAL(&stats_lock);
+    stats.load_source = source;
+    stats.load_us = load_us;
+    stats.load_unknown = info.unknown;
+    stats.blob_bytes = size;
+    portEXIT_CRITICAL(&stats_lock);
+    return ESP_OK; // Sin config guardada también es OK: ya cargamos default
 }
 
 esp_err_t config_manager_save(const system_config_t *source_config) {
     nvs_handle_t my_handle;
     esp_err_t err;
 
+    size_t size = config_encode(source_config, blob, sizeof(blob));
+    if (size == 0) return ESP_ERR_INVALID_SIZE;
+
     err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &my_handle);
     if (err != ESP_OK) return err;
 
-    err = nvs_set_blob(my_handle, KEY_CONFIG, source_config, sizeof(system_config_t));
+    err = nvs_set_blob(my_handle, KEY_CONFIG, blob, size);
     if (err == ESP_OK) {
         err = nvs_commit(my_handle);
-        ESP_LOGI(TAG, "Configuration saved to NVS");
+        ESP_LOGI(TAG, "Configuration saved to NVS (%u bytes)", (unsigned)size);
     }
     nvs_close(my_handle);
+    if (err == ESP_OK) {
+        portENTER_CRITICAL(&stats_lock);
+        stats.blob_bytes = size;
+        portEXIT_CRITICAL(&stats_lock);
+    }
     return err;
-}
\ No newline at end of file
+}
+
+// --- ESCRITOR DIFERIDO ---
+// Los handlers web solo publican el snapshot y llaman a
+// config_manager_request_save(): no tocan la flash ni la hacen bajo
+// config_mutex. Una tarea de baja prioridad espera a que los cambios se
+// calmen (ventana de debounce que se reinicia con cada pedido, con un tope
+// para que un cliente insistente no posponga el guardado para siempre),
+// lee el snapshot sin bloqueo y escribe solo si difiere de lo ya guardado.
+// Un corte de energía dentro de la ventana pierde como máximo ese último
+// cambio; el sistema sigue funcionando con la config anterior.
+
+#define SAVE_DEBOUNCE_MS    2000
+#define SAVE_MAX_DELAY_MS   10000
+#define WRITER_TASK_STACK   3072
+#define WRITER_TASK_PRIO    2       // Menor que las tareas de control
+
+static TaskHandle_t writer_task_handle = NULL;
+static snapshot_t *writer_snap = NULL;
+static system_config_t last_saved;  // Última config escrita (solo la tarea)
+
+static void config_writer_task(void *pvParameters) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Debounce: cada pedido nuevo dentro de la ventana la extiende
+        int64_t first_us = esp_timer_get_time();
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SAVE_DEBOUNCE_MS)) > 0) {
+            if (esp_timer_get_time() - first_us >= SAVE_MAX_DELAY_MS * 1000LL) break;
+        }
+
+        system_config_t cfg;
+        snapshot_read(writer_snap, &cfg);
+        if (memcmp(&cfg, &last_saved, sizeof(cfg)) == 0) {
+            portENTER_CRITICAL(&stats_lock);
+            stats.skipped_unchanged++;
+            portEXIT_CRITICAL(&stats_lock);
+            continue;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t err = config_manager_save(&cfg);
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t0);
+
+        portENTER_CRITICAL(&stats_lock);
+        if (err == ESP_OK) {
+            stats.writes++;
+            stats.last_save_us = elapsed;
+            if (elapsed > stats.max_save_us) stats.max_save_us = elapsed;
+        } else {
+            stats.errors++;
+        }
+        portEXIT_CRITICAL(&stats_lock);
+
+        if (err == ESP_OK) {
+            last_saved = cfg;
+            ESP_LOGD(TAG, "Config persistida en %lu us", elapsed);
+        } else {
+            ESP_LOGE(TAG, "Error guardando config: %s", esp_err_to_name(err));
+        }
+    }
+}
+
+// saved_config: lo que ya está en NVS (lo cargado en el arranque)
+void config_manager_start_writer(snapshot_t *config_snap, const system_config_t *saved_config) {
+    writer_snap = config_snap;
+    last_saved = *saved_config;
+    xTaskCreate(config_writer_task, "CfgWriter", WRITER_TASK_STACK, NULL, WRITER_TASK_PRIO, &writer_task_handle);
+}
+
+// No bloquea: se puede llamar con config_mutex tomado o sin él
+void config_manager_request_save(void) {
+    portENTER_CRITICAL(&stats_lock);
+    stats.requests++;
+    portEXIT_CRITICAL(&stats_lock);
+    if (writer_task_handle != NULL) {
+        xTaskNotifyGive(writer_task_handle);
+    }
+}
+
+void config_manager_get_stats(config_store_stats_t *out) {
+    portENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&stats_lock);
+}
@@ -0,0 +1,328 @@
+#include "system_common.h"
+#include "sensor_log_codec.h"
+#include <esp_err.h>
+#include <esp_log.h>
+#include <esp_partition.h>
+#include <esp_timer.h>
+#include <string.h>
+
+static const char *TAG = "SENSOR_LOG";
+
+// --- LOG PERSISTENTE DE SENSORES ---
+// Log circular append-only sobre la partición "senslog" (ver partitions.csv),
+// un bloque de sensor_log_codec.h por sector. control_task solo codifica en
+// RAM (sensor_log_append no toca la flash); la tarea SLogWriter graba en
+// páginas completas de 256 bytes, borra el sector siguiente al abrir un
+// bloque y cada FLUSH_MAX_MS baja también la página parcial. Los sectores se
+// recorren en anillo, así el desgaste es uniforme (un borrado por sector por
+// vuelta). Al arrancar se leen las cabeceras para armar el índice por tiempo
+// y se continúa el último bloque.
+
+#define SLOG_PARTITION_LABEL    "senslog"
+#define SLOG_PARTITION_SUBTYPE  0x40        // Subtipo de datos propio
+#define FLASH_PAGE              256
+#define FLUSH_MAX_MS            (5 * 60 * 1000) // Pérdida máxima ante un corte
+#define MAX_SECTORS             512         // Índice en RAM (hasta 2 MB de log)
+#define WRITER_TASK_STACK       3072
+#define WRITER_TASK_PRIO        2
+
+typedef struct {
+    uint8_t data[SLOG_BLOCK_SIZE];  // Imagen en RAM del sector
+    uint32_t sector;
+    uint16_t used;                  // Bytes codificados (inmutables por debajo)
+    uint16_t flushed;               // Bytes ya grabados en flash
+    bool in_use;
+    bool sealed;                    // Lleno: no recibe más registros
+    bool erased;                    // Sector ya borrado para este bloque
+} slog_buf_t;
+
+// Entrada del índice por sector (seq 0 = sector vacío o inválido)
+typedef struct {
+    uint32_t seq;
+    int64_t first_ts;
+} slog_index_t;
+
+static const esp_partition_t *part = NULL;
+static uint32_t sector_count = 0;
+static slog_index_t index_tab[MAX_SECTORS];
+static SemaphoreHandle_t log_mutex = NULL;
+static TaskHandle_t writer_task_handle = NULL;
+
+// Doble buffer: el bloque actual y el anterior mientras termina de grabarse
+static slog_buf_t bufs[2];
+static int cur_buf = 0;
+static slog_cursor_t cursor;
+static uint32_t next_seq = 1;
+static uint32_t last_sector = 0;    // Sector del bloque más nuevo
+static bool has_block = false;
+
+static sensor_log_stats_t stats;
+
+static uint32_t next_sector(uint32_t s) {
+    return (s + 1) % sector_count;
+}
+
+// Con log_mutex tomado: abre un bloque nuevo en el sector siguiente
+static bool open_block(const slog_record_t *first) {
+    int nb = bufs[cur_buf].in_use ? (cur_buf ^ 1) : cur_buf;
+    if (bufs[nb].in_use) {
+        return false; // El escritor todavía no terminó el bloque anterior
+    }
+    if (bufs[cur_buf].in_use) bufs[cur_buf].sealed = true;
+    uint32_t sector = has_block ? next_sector(last_sector) : 0;
+
+    cur_buf = nb;
+    slog_buf_t *b = &bufs[cur_buf];
+    memset(b->data, 0xFF, sizeof(b->data));
+    b->sector = sector;
+    b->used = (uint16_t)slog_block_begin(b->data, next_seq, first, &cursor);
+    b->flushed = 0;
+    b->in_use = true;
+    b->sealed = false;
+    b->erased = false;
+
+    // El sector reutilizado pierde su bloque viejo en el índice
+    index_tab[sector].seq = next_seq++;
+    index_tab[sector].first_ts = first->ts;
+    last_sector = sector;
+    has_block = true;
+    stats.blocks++;
+    return true;
+}
+
+void sensor_log_append(int64_t ts, const sensor_data_t *data, uint32_t pwm) {
+    if (part == NULL) return;
+
+    slog_record_t rec;
+    slog_record_from_sample(&rec, ts, data, pwm);
+    bool notify = false;
+
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    slog_buf_t *b = &bufs[cur_buf];
+    size_t n = 0;
+    if (b->in_use && !b->sealed) {
+        n = slog_encode(&cursor, &rec, &b->data[b->used], SLOG_BLOCK_SIZE - b->used);
+    }
+    if (n == 0) {
+        if (open_block(&rec)) {
+            b = &bufs[cur_buf];
+            n = slog_encode(&cursor, &rec, &b->data[b->used], SLOG_BLOCK_SIZE - b->used);
+            notify = true; // Hay que borrar el sector nuevo
+        } else {
+            stats.dropped++;
+        }
+    }
+    if (n > 0) {
+        b->used += n;
+        stats.records++;
+        stats.bytes += n;
+        // Grabar recién con una página completa pendiente
+        if ((b->used / FLASH_PAGE) > (b->flushed / FLASH_PAGE)) notify = true;
+    }
+    xSemaphoreGive(log_mutex);
+
+    if (notify && writer_task_handle != NULL) {
+        xTaskNotifyGive(writer_task_handle);
+    }
+}
+
+// Graba lo pendiente de un buffer. 'full' = también la página parcial.
+static void flush_buf(slog_buf_t *b, bool full) {
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    bool in_use = b->in_use, erased = b->erased, sealed = b->sealed;
+    uint32_t sector = b->sector;
+    uint16_t used = b->used, flushed = b->flushed;
+    xSemaphoreGive(log_mutex);
+    if (!in_use) return;
+
+    int64_t t0 = esp_timer_get_time();
+    size_t base = (size_t)sector * SLOG_BLOCK_SIZE;
+    esp_err_t err = ESP_OK;
+    if (!erased) {
+        err = esp_partition_erase_range(part, base, SLOG_BLOCK_SIZE);
+    }
+
+    // Solo páginas completas, salvo flush forzado o bloque cerrado
+    uint16_t end = (full || sealed) ? used : (uint16_t)(used - used % FLASH_PAGE);
+    bool wrote = false;
+    if (err == ESP_OK && end > flushed) {
+        // Los bytes por debajo de 'used' ya no cambian: se graban sin el lock
+        err = esp_partition_write(part, base + flushed, &b->data[flushed], end - flushed);
+        wrote = true;
+    }
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - t0);
+
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    if (err != ESP_OK) {
+        stats.errors++;
+    } else {
+        if (!erased) stats.erases++;
+        if (wrote) stats.flash_writes++;
+        b->erased = true;
+        if (end > b->flushed) b->flushed = end;
+        if (b->sealed && b->flushed == b->used) b->in_use = false; // Libera el buffer
+    }
+    if (elapsed > stats.max_flush_us) stats.max_flush_us = elapsed;
+    xSemaphoreGive(log_mutex);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error grabando sector %lu: %s", sector, esp_err_to_name(err));
+    }
+}
+
+static void sensor_log_writer_task(void *pvParameters) {
+    int64_t last_full_us = esp_timer_get_time();
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_MAX_MS));
+        bool full = (esp_timer_get_time() - last_full_us) >= FLUSH_MAX_MS * 1000LL;
+        if (full) last_full_us = esp_timer_get_time();
+
+        // Primero el bloque cerrado (más viejo), después el actual
+        int older = cur_buf ^ 1;
+        flush_buf(&bufs[older], full);
+        flush_buf(&bufs[older ^ 1], full);
+    }
+}
+
+// Reconstruye índice y bloque actual desde la flash
+static void recover(void) {
+    uint32_t best = UINT32_MAX, best_seq = 0;
+    for (uint32_t s = 0; s < sector_count; s++) {
+        uint8_t raw[sizeof(slog_block_header_t)];
+        slog_block_header_t hdr;
+        index_tab[s].seq = 0;
+        if (esp_partition_read(part, (size_t)s * SLOG_BLOCK_SIZE, raw, sizeof(raw)) == ESP_OK &&
+            slog_header_read(raw, &hdr)) {
+            index_tab[s].seq = hdr.seq;
+            index_tab[s].first_ts = hdr.base_ts;
+            if (hdr.seq >= best_seq) {
+                best_seq = hdr.seq;
+                best = s;
+            }
+        }
+    }
+    if (best == UINT32_MAX) return; // Log vacío
+
+    next_seq = best_seq + 1;
+    slog_buf_t *b = &bufs[0];
+    cur_buf = 0;
+    esp_partition_read(part, (size_t)best * SLOG_BLOCK_SIZE, b->data, SLOG_BLOCK_SIZE);
+    size_t used = 0;
+    size_t records = slog_decode_block(b->data, SLOG_BLOCK_SIZE, NULL, NULL, &used, &cursor);
+
+    b->sector = best;
+    b->used = b->flushed = (uint16_t)used;
+    b->in_use = true;
+    b->sealed = false;
+    b->erased = true;
+    last_sector = best;
+    has_block = true;
+    // Si después del último registro válido hay bytes escritos (corte a mitad
+    // de una escritura), no se puede seguir agregando: el próximo registro
+    // abre un bloque nuevo en el sector siguiente.
+    for (size_t i = used; i < SLOG_BLOCK_SIZE; i++) {
+        if (b->data[i] != 0xFF) {
+            b->in_use = false;
+            b->sealed = true;
+            break;
+        }
+    }
+    ESP_LOGI(TAG, "Recuperado bloque seq %lu (sector %lu, %u registros, %u bytes)%s",
+             best_seq, best, (unsigned)records, (unsigned)used, b->sealed ? " [cerrado]" : "");
+}
+
+esp_err_t sensor_log_init(void) {
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, SLOG_PARTITION_SUBTYPE, SLOG_PARTITION_LABEL);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "Sin partición '%s': log persistente deshabilitado", SLOG_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    sector_count = part->size / SLOG_BLOCK_SIZE;
+    if (sector_count > MAX_SECTORS) sector_count = MAX_SECTORS;
+    if (sector_count < 2) {
+        part = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    log_mutex = xSemaphoreCreateMutex();
+    recover();
+    xTaskCreate(sensor_log_writer_task, "SLogWriter", WRITER_TASK_STACK, NULL, WRITER_TASK_PRIO, &writer_task_handle);
+    ESP_LOGI(TAG, "Log en '%s': %lu sectores de %d bytes", SLOG_PARTITION_LABEL, sector_count, SLOG_BLOCK_SIZE);
+    return ESP_OK;
+}
+
+void sensor_log_get_stats(sensor_log_stats_t *out) {
+    if (log_mutex == NULL) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    *out = stats;
+    out->sectors = sector_count;
+    xSemaphoreGive(log_mutex);
+}
+
+// --- EXPORTACIÓN ---
+// Recorre los bloques en orden de escritura que se solapan con [from, to] y
+// entrega cada uno completo (SLOG_BLOCK_SIZE bytes, cola en 0xFF): el mismo
+// formato que un volcado crudo de la partición, así un único decodificador
+// sirve para ambos. Los bloques aún en RAM se envían desde el buffer.
+
+// Con log_mutex tomado: copia un chunk del bloque si sigue en RAM
+static bool copy_from_ram(uint32_t sector, size_t off, uint8_t *chunk, size_t len) {
+    for (int i = 0; i < 2; i++) {
+        const slog_buf_t *b = &bufs[i];
+        if (!b->in_use || b->sector != sector) continue;
+        memset(chunk, 0xFF, len);
+        if (off < b->used) {
+            size_t n = (b->used - off < len) ? b->used - off : len;
+            memcpy(chunk, &b->data[off], n);
+        }
+        return true;
+    }
+    return false;
+}
+
+esp_err_t sensor_log_export(int64_t from, int64_t to, sensor_log_sink_fn sink, void *ctx) {
+    if (part == NULL) return ESP_ERR_NOT_FOUND;
+    uint8_t chunk[1024];
+
+    // Punto de partida: el bloque más viejo del índice
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    uint32_t oldest_seq = UINT32_MAX, start = 0;
+    for (uint32_t s = 0; s < sector_count; s++) {
+        if (index_tab[s].seq != 0 && index_tab[s].seq < oldest_seq) {
+            oldest_seq = index_tab[s].seq;
+            start = s;
+        }
+    }
+    xSemaphoreGive(log_mutex);
+    if (oldest_seq == UINT32_MAX) return ESP_OK;
+
+    uint32_t s = start;
+    for (uint32_t i = 0; i < sector_count; i++, s = next_sector(s)) {
+        xSemaphoreTake(log_mutex, portMAX_DELAY);
+        slog_index_t e = index_tab[s];
+        slog_index_t nx = index_tab[next_sector(s)];
+        xSemaphoreGive(log_mutex);
+
+        if (e.seq == 0) continue;
+        // El bloque cubre [first_ts, first_ts del siguiente en secuencia)
+        bool has_next = (nx.seq == e.seq + 1);
+        if (e.first_ts > to) break;
+        if (has_next && nx.first_ts <= from) continue;
+
+        for (size_t off = 0; off < SLOG_BLOCK_SIZE; off += sizeof(chunk)) {
+            // Un bloque que todavía está en RAM se copia desde el buffer (lo
+            // pendiente de grabar no está en flash); si no, desde la partición
+            xSemaphoreTake(log_mutex, portMAX_DELAY);
+            bool in_ram = copy_from_ram(s, off, chunk, sizeof(chunk));
+            xSemaphoreGive(log_mutex);
+            if (!in_ram && esp_partition_read(part, (size_t)s * SLOG_BLOCK_SIZE + off, chunk, sizeof(chunk)) != ESP_OK) {
+                return ESP_FAIL;
+            }
+            if (sink(ctx, chunk, sizeof(chunk)) != 0) return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
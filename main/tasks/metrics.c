@@ -0,0 +1,149 @@
+#include "zone.h"
+#include "blog.h"
+#include "net_manager.h"
+#include <esp_idf_version.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <string.h>
+#include "freertos/task.h"
+
+// Recolección de /api/metrics (formato en core/runtime_metrics.c). Solo la
+// llama el httpd (una tarea): el estado de la consulta anterior es estático.
+
+#ifndef configRUN_TIME_COUNTER_TYPE
+#define configRUN_TIME_COUNTER_TYPE uint32_t   // FreeRTOS < 10.5 (IDF 4.x)
+#endif
+
+// Idle de cada núcleo: IDF 5.3 renombró la función (la vieja quedó deprecada)
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define idle_task_of(core)  xTaskGetIdleTaskHandleForCore(core)
+#else
+#define idle_task_of(core)  xTaskGetIdleTaskHandleForCPU(core)
+#endif
+
+#if configUSE_TRACE_FACILITY
+static TaskStatus_t task_status[METRICS_MAX_TASKS];
+#endif
+
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+// Contadores de la consulta anterior: el % es sobre la ventana entre dos
+// consultas, no desde el arranque (que diluye cualquier pico)
+typedef struct {
+    TaskHandle_t handle;
+    configRUN_TIME_COUNTER_TYPE runtime;
+} prev_task_t;
+
+static prev_task_t prev_tasks[METRICS_MAX_TASKS];
+static unsigned prev_count;
+static configRUN_TIME_COUNTER_TYPE prev_total;
+
+static configRUN_TIME_COUNTER_TYPE prev_runtime(TaskHandle_t h) {
+    for (unsigned i = 0; i < prev_count; i++) {
+        if (prev_tasks[i].handle == h) return prev_tasks[i].runtime;
+    }
+    return 0;   // Tarea nueva: cuenta desde su creación
+}
+
+static uint16_t permille(configRUN_TIME_COUNTER_TYPE part, configRUN_TIME_COUNTER_TYPE whole) {
+    if (whole == 0) return 0;
+    uint64_t p = (uint64_t)part * 1000u / whole;
+    return (uint16_t)(p > 1000 ? 1000 : p);
+}
+#endif
+
+static void collect_tasks(runtime_metrics_t *m) {
+    m->task_count = 0;
+    m->cpu_supported = false;
+#if configUSE_TRACE_FACILITY
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t n = uxTaskGetSystemState(task_status, METRICS_MAX_TASKS, &total);
+    if (n == 0) return;     // Más tareas que METRICS_MAX_TASKS
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *ts = &task_status[i];
+        task_metrics_t *t = &m->tasks[m->task_count++];
+        strlcpy(t->name, ts->pcTaskName, sizeof(t->name));
+        t->priority = (uint8_t)ts->uxCurrentPriority;
+        t->stack_free = ts->usStackHighWaterMark;  // StackType_t es de 1 byte en ESP-IDF
+#if configTASKLIST_INCLUDE_COREID
+        t->core = (ts->xCoreID < portNUM_PROCESSORS) ? (int8_t)ts->xCoreID : -1;
+#else
+        t->core = -1;
+#endif
+        t->cpu_permille = 0;
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    // El contador total es tiempo de pared (esp_timer): el de cada tarea es
+    // tiempo de UN núcleo, así que 1000 ‰ = un núcleo entero
+    // (la primera consulta cubre desde el arranque)
+    configRUN_TIME_COUNTER_TYPE window = total - prev_total;
+    m->cpu_supported = true;
+    m->cpu_window_ms = (uint32_t)(window / 1000);
+    m->core_count = portNUM_PROCESSORS;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *ts = &task_status[i];
+        configRUN_TIME_COUNTER_TYPE delta = ts->ulRunTimeCounter - prev_runtime(ts->xHandle);
+        m->tasks[i].cpu_permille = permille(delta, window);
+        for (int c = 0; c < portNUM_PROCESSORS && c < METRICS_MAX_CORES; c++) {
+            if (ts->xHandle == idle_task_of(c)) {
+                m->core_busy_permille[c] = 1000 - permille(delta, window);
+            }
+        }
+    }
+    for (UBaseType_t i = 0; i < n; i++) {
+        prev_tasks[i].handle = task_status[i].xHandle;
+        prev_tasks[i].runtime = task_status[i].ulRunTimeCounter;
+    }
+    prev_count = n;
+    prev_total = total;
+#endif
+#endif
+}
+
+void runtime_metrics_collect(app_context_t *ctx, runtime_metrics_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    m->heap_free = esp_get_free_heap_size();
+    m->heap_min = esp_get_minimum_free_heap_size();
+    collect_tasks(m);
+    blog_get_stats(&m->log_written, &m->log_dropped, &m->log_suppressed);
+
+    m->zone_count = ctx->zone_count;
+    for (unsigned z = 0; z < ctx->zone_count && z < MAX_ZONES; z++) {
+        zone_t *zone = &ctx->zones[z];
+        zone_metrics_t *zm = &m->zones[z];
+        sensor_loop_stats_t sl;
+        control_loop_stats_t cl;
+        sensor_task_get_stats(zone, &sl);
+        control_task_get_stats(zone, &cl);
+
+        UBaseType_t waiting = uxQueueMessagesWaiting(zone->sensor_queue);
+        zm->core = (int8_t)zone->core;
+        zm->queue_len = (uint16_t)waiting;
+        zm->queue_cap = (uint16_t)(waiting + uxQueueSpacesAvailable(zone->sensor_queue));
+        zm->queue_max = (uint16_t)sl.queue_max;
+        zm->queue_full = sl.queue_full;
+        memcpy(zm->samples, sl.samples, sizeof(zm->samples));
+        memcpy(zm->latency, cl.latency, sizeof(zm->latency));
+        zm->jitter = sl.jitter;
+        zm->overruns = sl.overruns;
+        zm->deadline_miss = cl.deadline_miss;
+        zm->first_duty_ms = cl.first_duty_ms;
+    }
+
+    net_stats_t ns;
+    net_manager_get_stats(&ns);
+    m->net_state = net_state_name(ns.state);
+    m->net_attempts = ns.attempts;
+    m->net_disconnects = ns.disconnects;
+    m->net_init_errors = ns.init_errors;
+    m->net_web_ms = ns.web_ms;
+    m->net_wifi_ms = ns.wifi_ms;
+    m->net_sntp_ms = ns.sntp_ms;
+
+    taskENTER_CRITICAL(&ctx->lock_stats_mux);
+    memcpy(m->lock_wait, ctx->lock_wait, sizeof(m->lock_wait));
+    memcpy(m->lock_hold, ctx->lock_hold, sizeof(m->lock_hold));
+    taskEXIT_CRITICAL(&ctx->lock_stats_mux);
+}
@@ -0,0 +1,116 @@
+#include "blog.h"
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <stdio.h>
+#include <sdkconfig.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Productores (cualquier tarea, ambos núcleos): blog_write copia al ring
+// dentro de una sección crítica corta. BlogDrain formatea y escribe a la
+// consola con prioridad 1, agrupando cada BLOG_DRAIN_MS como mucho.
+//
+// Con BLOG_DRAIN_BINARY (idf.py -DBLOG_DRAIN_BINARY=1 build) no formatea:
+// emite cada registro como "BLOG,<hex>" y cada tanto "BLOG,V,<hash>" para
+// que host/tools/blog_decode lo reconstruya desde una captura de la consola.
+
+static const char *TAG = "BLOG";
+
+#ifndef BLOG_DRAIN_BINARY
+#define BLOG_DRAIN_BINARY   0
+#endif
+
+#define BLOG_DRAIN_MS           200
+#define BLOG_DRAIN_STACK        3072
+#define BLOG_DRAIN_PRIO         1       // Debajo de zonas (5) y escritores de storage
+#define BLOG_HEADER_EVERY       256     // Registros entre líneas de versión (modo binario)
+
+// Filtro por nivel en el productor: lo que no se imprimiría no ocupa el ring
+#define BLOG_MIN_LEVEL          CONFIG_LOG_DEFAULT_LEVEL
+
+static blog_t blog;
+static portMUX_TYPE blog_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t drain_task_handle = NULL;
+static bool blog_ready = false;
+
+void blog_write(blog_msg_t id, const uint32_t *args, unsigned n) {
+    if ((unsigned)id >= BLOG_MSG_COUNT || blog_msgs[id].level > BLOG_MIN_LEVEL || !blog_ready) return;
+    int64_t now = esp_timer_get_time();
+    taskENTER_CRITICAL(&blog_mux);
+    bool queued = blog_put(&blog, now, id, args, n);
+    uint32_t pending = blog_pending(&blog);
+    taskEXIT_CRITICAL(&blog_mux);
+
+    // Despertar al drenaje con el primer registro y con el ring a la mitad
+    if (queued && drain_task_handle != NULL && (pending == 1 || pending == BLOG_RING_LEN / 2)) {
+        xTaskNotifyGive(drain_task_handle);
+    }
+}
+
+void blog_get_stats(uint32_t *written, uint32_t *dropped, uint32_t *suppressed) {
+    taskENTER_CRITICAL(&blog_mux);
+    *written = blog.written;
+    *dropped = blog.dropped;
+    *suppressed = blog.suppressed;
+    taskEXIT_CRITICAL(&blog_mux);
+}
+
+static void emit(const blog_record_t *r) {
+#if BLOG_DRAIN_BINARY
+    static const char hex[] = "0123456789abcdef";
+    const uint8_t *p = (const uint8_t *)r;
+    char line[5 + 2 * sizeof(*r) + 2];
+    memcpy(line, "BLOG,", 5);
+    for (size_t i = 0; i < sizeof(*r); i++) {
+        line[5 + 2 * i] = hex[p[i] >> 4];
+        line[6 + 2 * i] = hex[p[i] & 0x0F];
+    }
+    line[sizeof(line) - 2] = '\n';
+    line[sizeof(line) - 1] = '\0';
+    fputs(line, stdout);
+#else
+    static const char letters[] = "NEWIDV";
+    const blog_msg_info_t *m = &blog_msgs[r->id];
+    char text[160];
+    blog_format(text, sizeof(text), r);
+    esp_log_write((esp_log_level_t)m->level, m->tag, "%c (%lu) %s: %s\n",
+                  letters[m->level], (unsigned long)(r->ts_us / 1000), m->tag, text);
+#endif
+}
+
+static void blog_drain_task(void *pvParameters) {
+    uint32_t seen_dropped = 0, since_header = BLOG_HEADER_EVERY;
+    blog_record_t r;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(BLOG_DRAIN_MS));   // Agrupar lo que llegue mientras tanto
+
+        while (1) {
+            taskENTER_CRITICAL(&blog_mux);
+            bool got = blog_get(&blog, &r);
+            uint32_t dropped = blog.dropped;
+            taskEXIT_CRITICAL(&blog_mux);
+            if (!got) break;
+
+            if (BLOG_DRAIN_BINARY && since_header >= BLOG_HEADER_EVERY) {
+                printf("BLOG,V,%08lx\n", (unsigned long)blog_catalog_hash());
+                since_header = 0;
+            }
+            since_header++;
+            emit(&r);
+            if (dropped != seen_dropped) {
+                ESP_LOGW(TAG, "%lu registros perdidos (ring lleno)", (unsigned long)(dropped - seen_dropped));
+                seen_dropped = dropped;
+            }
+        }
+    }
+}
+
+void blog_start(void) {
+    blog_init(&blog);
+    blog_ready = true;
+    xTaskCreate(blog_drain_task, "BlogDrain", BLOG_DRAIN_STACK, NULL, BLOG_DRAIN_PRIO, &drain_task_handle);
+    ESP_LOGI(TAG, "Log binario: ring de %d registros (%u bytes), catálogo %08lx%s", BLOG_RING_LEN,
+             (unsigned)sizeof(blog), (unsigned long)blog_catalog_hash(), BLOG_DRAIN_BINARY ? ", salida binaria" : "");
+}
@@ -1,141 +1,176 @@
-#include "system_common.h"
-#include "hal_interfaces.h"
+#include "zone.h"
+#include "control_logic.h"
+#include "schedule_index.h"
+#include "power_manager.h"
+#include "blog.h"
 #include <esp_log.h>
-#include <math.h>
+#include <esp_timer.h>
+#include <esp_task_wdt.h>
 #include <time.h>
 #include <sys/time.h>
+#include <string.h>
 
 static const char *TAG = "TASK_CONTROL";
-//extern const fan_interface_t fan_mock_impl;
-extern const fan_interface_t fan_driver_impl; // USAR ESTE (Real PWM)
 
+extern void sensor_log_append(int64_t ts, const sensor_data_t *data, uint32_t pwm);
 
-// --- FUNCIONES AUXILIARES ---
-
-// Convierte hora/min a minutos absolutos (ej: 01:30 -> 90 min)
-static int get_minutes_from_midnight(int hour, int min) {
-    return (hour * 60) + min;
-}
-
-// Verifica si la hora actual está dentro del rango del registro
-static bool is_time_in_range(struct tm *now, schedule_reg_t *reg) {
-    int now_mins = get_minutes_from_midnight(now->tm_hour, now->tm_min);
-    int start_mins = get_minutes_from_midnight(reg->start_hour, reg->start_min);
-    int end_mins = get_minutes_from_midnight(reg->end_hour, reg->end_min);
-
-    if (start_mins < end_mins) {
-        // Caso normal (ej: 14:00 a 18:00)
-        return (now_mins >= start_mins && now_mins < end_mins);
-    } else {
-        // Caso cruce de medianoche (ej: 22:00 a 06:00)
-        // Es válido si es mayor que el inicio (noche) O menor que el fin (madrugada)
-        return (now_mins >= start_mins || now_mins < end_mins);
-    }
-}
-
-// Cálculo de PWM Lineal (Reutilizable)
-static uint32_t calculate_pwm_linear(float current_temp, float t_min, float t_max) {
-    if (current_temp <= t_min) return 0;
-    if (current_temp >= t_max) return 100;
-    
-    // Protección contra división por cero
-    if ((t_max - t_min) < 0.1) return 100;
-
-    float ratio = (current_temp - t_min) / (t_max - t_min);
-    return (uint32_t)(ratio * 100.0f);
+// Latencia despertar -> actuación (la lee la web con control_task_get_stats)
+void control_task_get_stats(zone_t *zone, control_loop_stats_t *out) {
+    taskENTER_CRITICAL(&zone->stats_mux);
+    *out = zone->control_stats;
+    taskEXIT_CRITICAL(&zone->stats_mux);
 }
 
 // --- TAREA PRINCIPAL ---
+// Una instancia por zona (pvParameters = zone_t*). La zona 0 además aplica
+// el modo de energía y alimenta el historial y el log persistente.
 
 void control_task(void *pvParameters) {
-    app_context_t *ctx = (app_context_t *)pvParameters;
-    
-    // Inicializar el Driver Real (LED integrado GPIO 2)
-    fan_driver_impl.init();
+    zone_t *zone = (zone_t *)pvParameters;
+    app_context_t *ctx = zone->app;
+    const fan_interface_t *fan = zone->fan;
+    const uint8_t ch = zone->id;
+    control_loop_stats_t *stats = &zone->control_stats;
 
     sensor_data_t incoming_data;
+    system_config_t cfg;
+    system_state_t state = {0};
+    control_state_t control_state;      // Memoria de PID/histéresis
     uint32_t target_pwm = 0;
+    uint32_t applied_version = UINT32_MAX;
+    bool first_duty = true;
+    int compiled_mode = -1;
+    int applied_power = -1;
+    control_state_reset(&control_state);
 
     // Variables de tiempo
     time_t now;
     struct tm timeinfo;
     bool time_synced = false;
 
+    if (esp_task_wdt_add(NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Zona %u: sin task watchdog", ch);
+    }
+
     while (1) {
-        // Esperar datos del sensor (Bloqueante hasta que llegue algo)
-        if (xQueueReceive(ctx->sensor_queue, &incoming_data, portMAX_DELAY) == pdTRUE) {
+        // Esperar datos del sensor; sin muestras igual despierta cada
+        // ZONE_WDT_FEED_MS para alimentar al watchdog
+        esp_task_wdt_reset();
+        if (xQueueReceive(zone->sensor_queue, &incoming_data, pdMS_TO_TICKS(ZONE_WDT_FEED_MS)) == pdTRUE) {
             
             // 1. Actualizar tiempo
             time(&now);
             localtime_r(&now, &timeinfo);
             time_synced = (timeinfo.tm_year > (2020 - 1900));
 
-            // 2. Tomar Mutex para leer Config y escribir Estado
-            xSemaphoreTake(ctx->config_mutex, portMAX_DELAY);
-            system_config_t *cfg = ctx->shared_config;
-
-            // --- LÓGICA DE CONTROL ---
-            switch (cfg->operation_mode) {
-                case 0: // MANUAL
-                    target_pwm = cfg->manual_duty;
-                    break;
-
-                case 1: // AUTO
-                    if (incoming_data.presence_detected) {
-                        target_pwm = calculate_pwm_linear(incoming_data.temperature, 15.0, 25.0);
-                    } else {
-                        target_pwm = 0;
-                    }
-                    break;
-
-                case 2: // PROGRAMADO
-                    target_pwm = 0; 
-                    if (!time_synced) {
-                        ESP_LOGW(TAG, "Falta NTP para modo programado");
-                        break; 
-                    }
-                    if (incoming_data.presence_detected) {
-                        for (int i = 0; i < 3; i++) {
-                            schedule_reg_t *reg = &cfg->schedules[i];
-                            if (reg->active && is_time_in_range(&timeinfo, reg)) {
-                                target_pwm = calculate_pwm_linear(
-                                    incoming_data.temperature, 
-                                    reg->temp_min_0_percent, 
-                                    reg->temp_max_100_percent
-                                );
-                                // Log breve para depuración
-                                ESP_LOGD(TAG, "Regla horaria #%d activa", i);
-                                break; 
-                            }
-                        }
-                    }
-                    break;
+            // 2. Copia de la Config vigente (snapshot sin bloqueo, no espera a la web)
+            uint32_t cfg_version = snapshot_read(ctx->config_snap, &cfg);
+            const zone_config_t *zc = &cfg.zones[ch];
+
+            // Aplicar lo propio de la zona solo cuando cambia la configuración
+            if (cfg_version != applied_version) {
+                applied_version = cfg_version;
+                if (zc->operation_mode != compiled_mode) {
+                    control_state_reset(&control_state); // Cada modo arranca sin memoria
+                    compiled_mode = zc->operation_mode;
+                }
+                if (fan->set_slew != NULL) {
+                    fan->set_slew(ch, cfg.fan_slew_up, cfg.fan_slew_down);
+                }
+                if (cfg.power_mode != applied_power) {
+                    // Las latencias se vuelven a medir con el modo nuevo (ver
+                    // /api/power); first_duty_ms es del arranque y se conserva
+                    if (ch == 0) power_manager_set_mode(cfg.power_mode);
+                    applied_power = cfg.power_mode;
+                    taskENTER_CRITICAL(&zone->stats_mux);
+                    memset(stats->latency, 0, sizeof(stats->latency));
+                    stats->deadline_miss = 0;
+                    taskEXIT_CRITICAL(&zone->stats_mux);
+                }
             }
 
-            // 3. Actualizar el Estado Compartido (Para el Servidor Web)
-            if (ctx->shared_state != NULL) {
-                ctx->shared_state->current_temp = incoming_data.temperature;
-                ctx->shared_state->presence = incoming_data.presence_detected;
-                ctx->shared_state->current_pwm = target_pwm;
-                strftime(ctx->shared_state->current_time_str, 16, "%H:%M:%S", &timeinfo);
+            // --- LÓGICA DE CONTROL (core/control_logic.c) ---
+            // El horario es compartido: lo recompila la primera zona que ve
+            // una config más nueva que la compilada (versiones crecientes)
+            app_lock_take(ctx, METRIC_LOCK_SCHEDULE, ctx->schedule_mutex);
+            if ((int32_t)(cfg_version - ctx->schedule_version) > 0) {
+                schedule_index_compile(ctx->schedule, &cfg);
+                ctx->schedule_version = cfg_version;
+                ESP_LOGI(TAG, "Horario compilado (zona %u): %d reglas activas", ch, ctx->schedule->rule_count);
+            }
+            control_decision_t decision = control_decide(zc, ctx->schedule, &control_state, &incoming_data, &timeinfo, time_synced);
+            app_lock_give(ctx, METRIC_LOCK_SCHEDULE, ctx->schedule_mutex);
+
+            if (decision.status == CONTROL_BAD_SENSOR) {
+                // Lectura inválida: se mantiene el último PWM en vez de actuar con el sentinela
+                BLOG(BLOG_CONTROL_BAD_TEMP, ch, target_pwm);
+            } else {
+                target_pwm = decision.pwm;
+            }
+
+            // 3. Actuar sobre el Hardware (Ventilador) antes de publicar: la
+            // latencia que se mide es la que ve la persona que entra. Con
+            // slew configurado solo arranca la rampa (no bloquea) y el
+            // driver ignora el pedido si el objetivo no cambió.
+            fan->set_duty(ch, target_pwm);
+            int64_t done_us = esp_timer_get_time();
+            uint32_t done_ms = (uint32_t)(done_us / 1000) + 1;     // 0 queda para "todavía no"
+            int64_t latency_us = done_us - incoming_data.timestamp;
+            if (latency_us < 0) latency_us = 0;
+            // Plazo desde el vencimiento (incluye el jitter del despertar)
+            bool missed = done_us - incoming_data.due_us > (int64_t)cfg.sample_deadline_ms * 1000;
+            taskENTER_CRITICAL(&zone->stats_mux);
+            latency_hist_record(&stats->latency[incoming_data.reason], (uint32_t)latency_us);
+            if (missed) stats->deadline_miss++;
+            if (first_duty) stats->first_duty_ms = done_ms;
+            taskEXIT_CRITICAL(&zone->stats_mux);
+            if (first_duty) {
+                // Tiempo de arranque hasta que el ventilador responde: no espera a la red
+                BLOG(BLOG_CONTROL_FIRST_DUTY, ch, done_ms, target_pwm);
+                first_duty = false;
             }
 
-            // Guardamos el modo en una variable local para el log, así podemos soltar el mutex rápido
-            int current_mode = cfg->operation_mode;
+            if (decision.status == CONTROL_NO_TIME) {
+                BLOG(BLOG_CONTROL_NO_TIME, ch);
+            } else if (decision.rule >= 0) {
+                // Log breve para depuración
+                BLOG(BLOG_CONTROL_RULE, ch, (uint32_t)decision.rule);
+            }
 
-            // 4. Liberar Mutex (¡SOLO UNA VEZ!)
-            xSemaphoreGive(ctx->config_mutex); 
+            // 4. Publicar el Estado (Para el Servidor Web): los lectores copian sin bloquear
+            state.current_temp = incoming_data.temperature;
+            state.temp_quality = incoming_data.temp_quality;
+            state.presence = incoming_data.presence_detected;
+            state.current_pwm = target_pwm;
+            state.fan_fading = fan->is_fading ? fan->is_fading(ch) : false;
+            strftime(state.current_time_str, sizeof(state.current_time_str), "%H:%M:%S", &timeinfo);
+            snapshot_publish(&zone->state_snap, &state);
+            if (ctx->state_listener != NULL) {
+                ctx->state_listener(); // Push a clientes WebSocket (no bloquea)
+            }
 
-            // 5. Actuar sobre el Hardware (Ventilador)
-            fan_driver_impl.set_duty(target_pwm);
+            // Historial: solo con hora NTP válida (los buckets son por epoch)
+            if (time_synced && ch == 0) {
+                app_lock_take(ctx, METRIC_LOCK_HISTORY, ctx->history_mutex);
+                history_push(ctx->history, (int64_t)now, incoming_data.temperature,
+                             incoming_data.temp_quality, incoming_data.presence_detected, target_pwm);
+                app_lock_give(ctx, METRIC_LOCK_HISTORY, ctx->history_mutex);
+                sensor_log_append((int64_t)now, &incoming_data, target_pwm); // Solo RAM, no bloquea
+            }
 
-            // 6. Logging informativo
-            ESP_LOGI(TAG, "[%s] Mode: %d | Temp: %.1f | PIR: %d -> PWM: %lu%%", 
-                     ctx->shared_state->current_time_str,
-                     current_mode, // Usamos la variable local
-                     incoming_data.temperature, 
-                     incoming_data.presence_detected, 
-                     target_pwm);
+            // 5. Logging informativo: log binario, lo formatea BlogDrain fuera del lazo
+            BLOG(BLOG_CONTROL_CYCLE, ch, zc->operation_mode, blog_f(incoming_data.temperature),
+                 incoming_data.presence_detected, target_pwm, incoming_data.reason,
+                 latency_us > UINT32_MAX ? UINT32_MAX : (uint32_t)latency_us);
+
+            // Línea de traza para replay en host (host/bench/bench_control.c)
+            if (ch == 0) {
+                ESP_LOGD(TAG, "TRACE,%lld,%.2f,%d,%lu",
+                         (long long)now,
+                         incoming_data.temperature,
+                         incoming_data.presence_detected,
+                         target_pwm);
+            }
         }
     }
-}
\ No newline at end of file
+}
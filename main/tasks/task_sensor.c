@@ -1,38 +1,145 @@
-#include "system_common.h"
-#include "hal_interfaces.h"
+#include "zone.h"
+#include "sample_rate.h"
+#include "blog.h"
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_task_wdt.h>
+#include <string.h>
 
 static const char *TAG = "TASK_SENSOR"; // ¡Aquí está la corrección del error de imagen!
 
-// Importar interfaces disponibles
-extern const temp_sensor_interface_t temp_mock_impl; // Mock Temp (Usar este hoy)
-extern const temp_sensor_interface_t ntc_sensor_impl; // Real Temp (Falta resistencia)
+// Estado del muestreo adaptativo para /api/loop (lo escribe solo la SensorTask de la zona)
+void sensor_task_get_stats(zone_t *zone, sensor_loop_stats_t *out) {
+    taskENTER_CRITICAL(&zone->stats_mux);
+    *out = zone->sensor_stats;
+    taskEXIT_CRITICAL(&zone->stats_mux);
+}
 
-extern const pir_sensor_interface_t pir_mock_impl;   // Mock PIR
-extern const pir_sensor_interface_t pir_driver_impl; // Real PIR (Usar este hoy)
+// Ticks hasta 'us' redondeando hacia arriba: pdMS_TO_TICKS trunca y con un
+// tick de 10 ms despertaría antes del vencimiento
+static TickType_t us_to_ticks_ceil(int64_t us) {
+    const int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    TickType_t ticks = (TickType_t)((us + tick_us - 1) / tick_us);
+    return ticks > 0 ? ticks : 1;
+}
 
+// Una instancia por zona (pvParameters = zone_t*). Los periféricos ya los
+// inicializó zones_start().
 void sensor_task(void *pvParameters) {
-    app_context_t *ctx = (app_context_t *)pvParameters;
-    
-    // --- CAMBIO AQUÍ: Usamos el NTC Real ---
-    const temp_sensor_interface_t *temp_sensor = &ntc_sensor_impl; // <--- YA NO ES EL MOCK
-    
-    const pir_sensor_interface_t *pir_sensor = &pir_driver_impl;   // PIR Real
+    zone_t *zone = (zone_t *)pvParameters;
+    app_context_t *ctx = zone->app;
+    const temp_sensor_interface_t *temp_sensor = zone->temp;
+    const pir_sensor_interface_t *pir_sensor = zone->pir;
+    const uint8_t ch = zone->id;
+    sensor_loop_stats_t *stats = &zone->sensor_stats;
 
-    temp_sensor->init();
-    pir_sensor->init();
+    if (pir_sensor->set_notify_task != NULL) {
+        pir_sensor->set_notify_task(ch, xTaskGetCurrentTaskHandle()); // Despertar en cada flanco
+    }
 
     sensor_data_t data;
+    system_config_t cfg;
+    uint32_t hold_s = UINT32_MAX;
+    int power_mode = -1;
+    sample_rate_t rate;
+
+    uint32_t cfg_version = snapshot_read(ctx->config_snap, &cfg);
+    sample_rate_init(&rate, &cfg, &cfg.zones[ch]);
+
+    if (esp_task_wdt_add(NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Zona %u: sin task watchdog", ch);
+    }
 
     while (1) {
-        data.temperature = temp_sensor->read_celsius();
-        data.presence_detected = pir_sensor->is_motion_detected();
-        data.timestamp = 0; 
+        uint32_t version = snapshot_read(ctx->config_snap, &cfg);
+        if (version != cfg_version) {
+            cfg_version = version;
+            sample_rate_configure(&rate, &cfg, &cfg.zones[ch]); // Cotas y umbrales del modo vigente
+        }
+
+        // Con light sleep el ADC mide en ráfagas; las latencias se miden de nuevo por modo
+        if (cfg.power_mode != power_mode) {
+            power_mode = cfg.power_mode;
+            if (temp_sensor->set_low_power != NULL) {
+                temp_sensor->set_low_power(power_mode == POWER_LIGHT_SLEEP);
+            }
+            taskENTER_CRITICAL(&zone->stats_mux);
+            memset(&stats->timer_late, 0, sizeof(stats->timer_late));
+            memset(&stats->jitter, 0, sizeof(stats->jitter));
+            taskEXIT_CRITICAL(&zone->stats_mux);
+        }
+
+        // Aplicar la retención de presencia configurada (si el driver la soporta)
+        if (pir_sensor->set_hold_time_ms != NULL && cfg.presence_hold_s != hold_s) {
+            hold_s = cfg.presence_hold_s;
+            pir_sensor->set_hold_time_ms(ch, hold_s * 1000);
+        }
 
-        if (xQueueSend(ctx->sensor_queue, &data, pdMS_TO_TICKS(100)) != pdTRUE) {
-            ESP_LOGW(TAG, "Queue full!");
+        int64_t now = esp_timer_get_time();
+        data.timestamp = now;
+        data.temperature = temp_sensor->read_celsius(ch);
+        data.temp_quality = temp_sensor->get_quality ? temp_sensor->get_quality(ch) : TEMP_QUALITY_GOOD;
+        data.presence_detected = pir_sensor->is_motion_detected(ch);
+
+        bool send = sample_rate_check(&rate, &data, now, &data.reason);
+        data.due_us = rate.last_due_us;
+        bool dropped = false;
+        if (send && xQueueSend(zone->sensor_queue, &data, pdMS_TO_TICKS(100)) != pdTRUE) {
+            BLOG(BLOG_SENSOR_QUEUE_FULL, ch);
+            dropped = true;
         }
+        UBaseType_t queued = send ? uxQueueMessagesWaiting(zone->sensor_queue) : 0;
 
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        // Próximo despertar: vence el período o el hold (la presencia se
+        // apaga sin flanco). Lo adelantan un flanco del PIR o el aviso del
+        // driver de temperatura; sin aviso se vigila cada sample_min_ms.
+        int64_t next;
+        if (temp_sensor->arm_watch != NULL) {
+            float lo, hi;
+            sample_rate_watch_band(&rate, &lo, &hi);
+            temp_sensor->arm_watch(ch, xTaskGetCurrentTaskHandle(), lo, hi);
+            next = sample_rate_deadline_us(&rate, now);
+        } else {
+            next = sample_rate_next_check_us(&rate, now);
+        }
+        if (data.presence_detected && pir_sensor->last_motion_us != NULL) {
+            int64_t hold_end = pir_sensor->last_motion_us(ch) + (int64_t)cfg.presence_hold_s * 1000000 + 1000;
+            if (hold_end > now && hold_end < next) next = hold_end;
+        }
+
+        taskENTER_CRITICAL(&zone->stats_mux);
+        stats->checks++;
+        if (send) stats->samples[data.reason]++;
+        if (dropped) stats->queue_full++;
+        if (queued > stats->queue_max) stats->queue_max = queued;
+        if (send && data.reason == SAMPLE_PERIODIC) {
+            latency_hist_record(&stats->jitter, (uint32_t)(now - data.due_us));
+        }
+        stats->overruns = rate.overruns;
+        stats->period_ms = rate.period_ms;
+        stats->rate_mc_per_s = (uint32_t)(rate.rate_c_per_s * 1000.0f);
+        taskEXIT_CRITICAL(&zone->stats_mux);
+
+        // Dormir hasta 'next' (absoluto: lo que tardó esta vuelta no corre el
+        // vencimiento) en tramos de ZONE_WDT_FEED_MS para alimentar al watchdog
+        esp_task_wdt_reset();
+        int64_t wait_us = next - esp_timer_get_time();
+        if (wait_us <= 0) {
+            ulTaskNotifyTake(pdTRUE, 0);    // Ya vencido: descartar avisos pendientes
+            continue;
+        }
+        bool notified = false;
+        while (!notified && wait_us > 0) {
+            int64_t slice = (wait_us < ZONE_WDT_FEED_MS * 1000LL) ? wait_us : ZONE_WDT_FEED_MS * 1000LL;
+            notified = ulTaskNotifyTake(pdTRUE, us_to_ticks_ceil(slice)) != 0;
+            esp_task_wdt_reset();
+            wait_us = next - esp_timer_get_time();
+        }
+        if (!notified) {
+            // Despertó por tiempo: cuánto después del vencimiento pedido
+            taskENTER_CRITICAL(&zone->stats_mux);
+            latency_hist_record(&stats->timer_late, (uint32_t)-wait_us);
+            taskEXIT_CRITICAL(&zone->stats_mux);
+        }
     }
-}
\ No newline at end of file
+}
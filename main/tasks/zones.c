@@ -0,0 +1,97 @@
+#include "zone.h"
+#include <esp_log.h>
+#include <stdio.h>
+
+static const char *TAG = "ZONES";
+
+// Importar interfaces disponibles
+extern const temp_sensor_interface_t temp_mock_impl; // Mock Temp (planta térmica por zona)
+extern const temp_sensor_interface_t ntc_sensor_impl; // Real Temp (OneShot, 1 muestra por ciclo)
+extern const temp_sensor_interface_t ntc_continuous_impl; // Real Temp (DMA + filtrado)
+
+extern const pir_sensor_interface_t pir_mock_impl;   // Mock PIR
+extern const pir_sensor_interface_t pir_driver_impl; // Real PIR (Polling de nivel)
+extern const pir_sensor_interface_t pir_isr_impl;    // Real PIR (ISR + hold time)
+
+extern const fan_interface_t fan_mock_impl;
+extern const fan_interface_t fan_driver_impl; // Real PWM (LEDC)
+
+void sensor_task(void *pvParameters);
+void control_task(void *pvParameters);
+
+// HAL mock: sin hardware y con canales para MAX_ZONES zonas, para medir el
+// escalado en placa (idf.py -DZONES_USE_MOCK_HAL=1 build, ver README)
+#ifndef ZONES_USE_MOCK_HAL
+#define ZONES_USE_MOCK_HAL  0
+#endif
+
+#define SENSOR_TASK_STACK   4096
+#define CONTROL_TASK_STACK  4096
+#define ZONE_TASK_PRIO      5
+#define SENSOR_QUEUE_LEN    5
+
+static zone_t zones[MAX_ZONES];
+static schedule_index_t schedule_index;    // Compartido (~10 KB, ver app_context_t)
+
+static uint8_t min_u8(uint8_t a, uint8_t b) { return a < b ? a : b; }
+
+uint8_t zones_start(app_context_t *ctx, uint8_t count) {
+#if ZONES_USE_MOCK_HAL
+    const temp_sensor_interface_t *temp = &temp_mock_impl;
+    const pir_sensor_interface_t *pir = &pir_mock_impl;
+    const fan_interface_t *fan = &fan_mock_impl;
+#else
+    const temp_sensor_interface_t *temp = &ntc_continuous_impl;
+    const pir_sensor_interface_t *pir = &pir_isr_impl;      // PIR Real (flancos por ISR)
+    const fan_interface_t *fan = &fan_driver_impl;
+#endif
+
+    uint8_t hw = min_u8(min_u8(temp->channels, pir->channels), min_u8(fan->channels, MAX_ZONES));
+    if (count == 0) count = 1;
+    if (count > hw) {
+        ESP_LOGW(TAG, "%u zonas configuradas, la HAL solo tiene %u canales", count, hw);
+        count = hw;
+    }
+
+    // Horario compilado antes de lanzar las tareas (luego lo mantienen ellas)
+    system_config_t cfg;
+    ctx->schedule = &schedule_index;
+    ctx->schedule_mutex = xSemaphoreCreateMutex();
+    ctx->schedule_version = snapshot_read(ctx->config_snap, &cfg);
+    schedule_index_compile(&schedule_index, &cfg);
+
+    ctx->zones = zones;
+    ctx->zone_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        zone_t *z = &zones[i];
+        system_state_t boot_state = {0};
+        z->id = i;
+        z->core = (i + 1) % portNUM_PROCESSORS;    // Zona 0 en APP_CPU, luego alterna
+        z->temp = temp;
+        z->pir = pir;
+        z->fan = fan;
+        z->app = ctx;
+        z->sensor_queue = xQueueCreate(SENSOR_QUEUE_LEN, sizeof(sensor_data_t));
+        snapshot_init(&z->state_snap, &z->state_slots[0], &z->state_slots[1], sizeof(system_state_t), &boot_state);
+        portMUX_INITIALIZE(&z->stats_mux);
+
+        // Periféricos en orden y desde esta tarea (los drivers comparten timer/unidad ADC)
+        if (temp->init(i) != ESP_OK || pir->init(i) != ESP_OK || fan->init(i) != ESP_OK) {
+            ESP_LOGE(TAG, "Zona %u: fallo al inicializar la HAL, se detiene en %u zonas", i, i);
+            vQueueDelete(z->sensor_queue);
+            break;
+        }
+
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "SensorZ%u", i);
+        xTaskCreatePinnedToCore(sensor_task, name, SENSOR_TASK_STACK, z, ZONE_TASK_PRIO, &z->sensor_task, z->core);
+        snprintf(name, sizeof(name), "ControlZ%u", i);
+        xTaskCreatePinnedToCore(control_task, name, CONTROL_TASK_STACK, z, ZONE_TASK_PRIO, &z->control_task, z->core);
+        ctx->zone_count = i + 1;
+    }
+
+    ESP_LOGI(TAG, "%u zonas en marcha (%s HAL), %u bytes de estado por zona + %u de stack",
+             ctx->zone_count, ZONES_USE_MOCK_HAL ? "mock" : "real",
+             (unsigned)sizeof(zone_t), SENSOR_TASK_STACK + CONTROL_TASK_STACK);
+    return ctx->zone_count;
+}
@@ -1,55 +1,170 @@
-#include "system_common.h"
-#include "web_page.h" 
+#include "zone.h"
+#include "web_asset.h"  // Generado en build desde web/index.html
+#include "status_json.h"
+#include "config_check.h"
+#include "config_codec.h"
+#include "power_manager.h"
 #include <esp_http_server.h>
 #include <esp_log.h>
 #include <cJSON.h>
 #include <esp_system.h>
+#include <esp_timer.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <unistd.h>
 
 static const char *TAG = "WEB_SERVER";
 static app_context_t *global_ctx = NULL;
+static httpd_handle_t server = NULL;
 
-extern esp_err_t config_manager_save(const system_config_t *source_config);
+static void web_server_notify_state(void);
 
+extern void config_manager_request_save(void);
+extern void config_manager_get_stats(config_store_stats_t *out);
+extern void sensor_log_get_stats(sensor_log_stats_t *out);
+extern esp_err_t sensor_log_export(int64_t from, int64_t to, sensor_log_sink_fn sink, void *ctx);
+
+// --- INTERFAZ (asset gzip con ETag) ---
+// La página se comprime en build; el navegador la guarda en caché y en cada
+// visita revalida con If-None-Match: si el ETag coincide se responde 304 sin
+// cuerpo. "no-cache" obliga a revalidar, así una nueva firmware se ve al
+// recargar sin tener que esperar a que expire la caché.
 static esp_err_t root_get_handler(httpd_req_t *req) {
+    httpd_resp_set_hdr(req, "ETag", WEB_INDEX_ETAG);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char inm[40];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        strstr(inm, WEB_INDEX_ETAG) != NULL) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // Todos los navegadores actuales aceptan gzip; no se guarda copia sin comprimir
     httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, HTML_PAGE, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    return httpd_resp_send(req, (const char *)WEB_INDEX_GZ, WEB_INDEX_GZ_LEN);
+}
+
+// Buffer del serializador: el documento típico entra completo (una sola
+// respuesta con Content-Length); si no, se envía en chunks al llenarse.
+#define STATUS_BUF_SIZE  1024
+
+static int status_flush_chunk(void *ctx, const char *data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len) == ESP_OK ? 0 : -1;
+}
+
+// Estado en vivo de cada zona en marcha (copias sin bloqueo)
+static unsigned read_zone_states(system_state_t *states) {
+    for (unsigned z = 0; z < global_ctx->zone_count; z++) {
+        snapshot_read(&global_ctx->zones[z].state_snap, &states[z]);
+    }
+    return global_ctx->zone_count;
 }
 
 static esp_err_t api_status_get_handler(httpd_req_t *req) {
+    int64_t t0 = esp_timer_get_time();
     httpd_resp_set_type(req, "application/json");
-    cJSON *root = cJSON_CreateObject();
-
-    if (xSemaphoreTake(global_ctx->config_mutex, portMAX_DELAY)) {
-        cJSON_AddNumberToObject(root, "mode", global_ctx->shared_config->operation_mode);
-        cJSON_AddNumberToObject(root, "manual_duty", global_ctx->shared_config->manual_duty);
-        cJSON_AddNumberToObject(root, "temp", global_ctx->shared_state->current_temp);
-        cJSON_AddBoolToObject(root, "pir", global_ctx->shared_state->presence);
-        cJSON_AddNumberToObject(root, "pwm", global_ctx->shared_state->current_pwm);
-        cJSON_AddStringToObject(root, "time", global_ctx->shared_state->current_time_str);
-
-        cJSON *schedules = cJSON_CreateArray();
-        for(int i=0; i<3; i++) {
-            cJSON *item = cJSON_CreateObject();
-            schedule_reg_t *reg = &global_ctx->shared_config->schedules[i];
-            cJSON_AddBoolToObject(item, "act", reg->active);
-            cJSON_AddNumberToObject(item, "sh", reg->start_hour);
-            cJSON_AddNumberToObject(item, "sm", reg->start_min);
-            cJSON_AddNumberToObject(item, "eh", reg->end_hour);
-            cJSON_AddNumberToObject(item, "em", reg->end_min);
-            cJSON_AddNumberToObject(item, "tmin", reg->temp_min_0_percent);
-            cJSON_AddNumberToObject(item, "tmax", reg->temp_max_100_percent);
-            cJSON_AddItemToArray(schedules, item);
-        }
-        cJSON_AddItemToObject(root, "schedules", schedules);
-        xSemaphoreGive(global_ctx->config_mutex);
+
+    // Copias locales sin bloqueo: un cliente lento nunca retrasa a control_task
+    system_config_t cfg;
+    system_state_t states[MAX_ZONES];
+    snapshot_read(global_ctx->config_snap, &cfg);
+    unsigned zone_count = read_zone_states(states);
+
+    // Serialización en streaming sobre el stack del httpd: cero uso de heap
+    char buf[STATUS_BUF_SIZE];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), status_flush_chunk, req);
+    status_json_write(&w, &cfg, states, zone_count);
+
+    esp_err_t err;
+    if (w.flushes == 0 && !w.error) {
+        err = httpd_resp_send(req, buf, w.len);
+    } else {
+        json_writer_finish(&w);
+        err = httpd_resp_send_chunk(req, NULL, 0);
     }
 
-    const char *json_response = cJSON_PrintUnformatted(root);
-    httpd_resp_send(req, json_response, HTTPD_RESP_USE_STRLEN);
-    free((void *)json_response);
-    cJSON_Delete(root);
-    return ESP_OK;
+    ESP_LOGD(TAG, "/api/status: %u bytes, %lu chunks, %lld us",
+             (unsigned)w.total, w.flushes, esp_timer_get_time() - t0);
+    return err;
+}
+
+// Publica 'cfg' si difiere de 'cur' (con config_mutex tomado) con la versión
+// siguiente. Sin cambios reales no se publica: ni push ni pedido de guardado.
+static bool config_publish(system_config_t *cfg, const system_config_t *cur) {
+    cfg->version = cur->version;
+    if (memcmp(cfg, cur, sizeof(*cfg)) == 0) return false;
+    cfg->version = cur->version + 1;
+    snapshot_publish(global_ctx->config_snap, cfg);
+    return true;
+}
+
+// Lectores de claves: sin la clave no tocan el destino; con un tipo o valor
+// que no entra en el campo anotan la clave en *bad (solo la primera)
+static void rd_u32(const cJSON *o, const char *key, uint32_t max, uint32_t *dst, const char **bad) {
+    const cJSON *it = cJSON_GetObjectItem(o, key);
+    if (it == NULL) return;
+    double v = it->valuedouble;
+    if (!cJSON_IsNumber(it) || !(v >= 0 && v <= max) || v != (double)(uint32_t)v) {
+        if (*bad == NULL) *bad = key;
+        return;
+    }
+    *dst = (uint32_t)v;
+}
+
+static void rd_u8(const cJSON *o, const char *key, uint8_t *dst, const char **bad) {
+    uint32_t v = *dst;
+    rd_u32(o, key, UINT8_MAX, &v, bad);
+    *dst = (uint8_t)v;
+}
+
+static void rd_float(const cJSON *o, const char *key, float *dst, const char **bad) {
+    const cJSON *it = cJSON_GetObjectItem(o, key);
+    if (it == NULL) return;
+    if (!cJSON_IsNumber(it)) {
+        if (*bad == NULL) *bad = key;
+        return;
+    }
+    *dst = (float)it->valuedouble;
+}
+
+static void rd_bool(const cJSON *o, const char *key, bool *dst, const char **bad) {
+    const cJSON *it = cJSON_GetObjectItem(o, key);
+    if (it == NULL) return;
+    if (!cJSON_IsBool(it)) {
+        if (*bad == NULL) *bad = key;
+        return;
+    }
+    *dst = cJSON_IsTrue(it);
+}
+
+// Claves por zona: las mismas en /api/settings y en cada entrada de "zones"
+// de /api/config
+static void zone_from_json(zone_config_t *zc, const cJSON *o, const char **bad) {
+    uint32_t mode = zc->operation_mode;
+    rd_u32(o, "mode", MODE_COUNT - 1, &mode, bad);
+    zc->operation_mode = (operation_mode_t)mode;
+    rd_u32(o, "manual_duty", UINT32_MAX, &zc->manual_duty, bad);
+    rd_float(o, "pid_sp", &zc->pid.setpoint_c, bad);
+    rd_float(o, "pid_kp", &zc->pid.kp, bad);
+    rd_float(o, "pid_ki", &zc->pid.ki, bad);
+    rd_float(o, "pid_kd", &zc->pid.kd, bad);
+    rd_u32(o, "pid_db", UINT32_MAX, &zc->pid.deadband_pct, bad);
+    rd_float(o, "hyst_sp", &zc->hysteresis.setpoint_c, bad);
+    rd_float(o, "hyst_band", &zc->hysteresis.band_c, bad);
+    rd_u32(o, "hyst_pwm", UINT32_MAX, &zc->hysteresis.on_pwm, bad);
+}
+
+// 400 con el campo (y la zona o regla) que no pasó la validación
+static esp_err_t send_invalid(httpd_req_t *req, const char *bad, int index) {
+    char msg[48];
+    if (index >= 0) snprintf(msg, sizeof(msg), "Valor invalido: %s [%d]", bad, index);
+    else snprintf(msg, sizeof(msg), "Valor invalido: %s", bad);
+    return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
 }
 
 static esp_err_t api_settings_post_handler(httpd_req_t *req) {
@@ -63,58 +178,694 @@ static esp_err_t api_settings_post_handler(httpd_req_t *req) {
     cJSON *root = cJSON_Parse(buf);
     if (root == NULL) { httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Invalid JSON"); return ESP_FAIL; }
 
-    if (xSemaphoreTake(global_ctx->config_mutex, portMAX_DELAY)) {
-        cJSON *mode = cJSON_GetObjectItem(root, "mode");
-        cJSON *duty = cJSON_GetObjectItem(root, "manual_duty");
-        cJSON *idx  = cJSON_GetObjectItem(root, "sched_idx");
-
-        if (mode) global_ctx->shared_config->operation_mode = mode->valueint;
-        if (duty) global_ctx->shared_config->manual_duty = duty->valueint;
-
-        if (idx) {
-            int i = idx->valueint;
-            if (i >= 0 && i < 3) {
-                schedule_reg_t *reg = &global_ctx->shared_config->schedules[i];
-                cJSON *act = cJSON_GetObjectItem(root, "act");
-                cJSON *sh = cJSON_GetObjectItem(root, "sh");
-                cJSON *sm = cJSON_GetObjectItem(root, "sm");
-                cJSON *eh = cJSON_GetObjectItem(root, "eh");
-                cJSON *em = cJSON_GetObjectItem(root, "em");
-                cJSON *tmin = cJSON_GetObjectItem(root, "tmin");
-                cJSON *tmax = cJSON_GetObjectItem(root, "tmax");
-
-                if (act) reg->active = cJSON_IsTrue(act);
-                if (sh) reg->start_hour = sh->valueint;
-                if (sm) reg->start_min = sm->valueint;
-                if (eh) reg->end_hour = eh->valueint;
-                if (em) reg->end_min = em->valueint;
-                if (tmin) reg->temp_min_0_percent = (float)tmin->valuedouble;
-                if (tmax) reg->temp_max_100_percent = (float)tmax->valuedouble;
+    // config_mutex serializa solo a los escritores: copiar -> modificar -> publicar
+    if (app_lock_take(global_ctx, METRIC_LOCK_CONFIG, global_ctx->config_mutex)) {
+        system_config_t cur, cfg;
+        snapshot_read(global_ctx->config_snap, &cur);
+        cfg = cur;
+        const char *bad = NULL;
+        int bad_index = -1;
+
+        // Claves por zona (mode, manual_duty, pid_*, hyst_*): aplican a la zona
+        // "zone" (0 si no viene). "zones" cambia cuántas hay (al reiniciar).
+        // Cada clave con su lector tipado: un tipo o un índice inválido es un
+        // 400 con la clave, igual que en /api/config
+        uint32_t z = 0;
+        rd_u32(root, "zone", MAX_ZONES - 1, &z, &bad);
+        if (bad == NULL) {
+            zone_from_json(&cfg.zones[z], root, &bad);
+            if (bad != NULL) bad_index = (int)z;
+        }
+
+        uint32_t zones = cfg.zone_count;
+        rd_u32(root, "zones", MAX_ZONES, &zones, &bad);
+        if (zones == 0 && bad == NULL) bad = "zones";
+        cfg.zone_count = (uint8_t)zones;
+        rd_u32(root, "hold", UINT32_MAX, &cfg.presence_hold_s, &bad);
+        rd_u32(root, "rate_min", UINT32_MAX, &cfg.sample_min_ms, &bad);
+        rd_u32(root, "rate_max", UINT32_MAX, &cfg.sample_max_ms, &bad);
+        // Subir solo rate_min arrastra rate_max; un rate_max explícito menor es un error
+        if (cJSON_GetObjectItem(root, "rate_max") == NULL && cfg.sample_max_ms < cfg.sample_min_ms) {
+            cfg.sample_max_ms = cfg.sample_min_ms;
+        }
+        rd_u32(root, "deadline", UINT32_MAX, &cfg.sample_deadline_ms, &bad);
+        rd_u32(root, "slew_up", UINT32_MAX, &cfg.fan_slew_up, &bad);
+        rd_u32(root, "slew_down", UINT32_MAX, &cfg.fan_slew_down, &bad);
+        uint32_t power = cfg.power_mode;
+        rd_u32(root, "power", POWER_MODE_COUNT - 1, &power, &bad);
+        cfg.power_mode = (power_mode_t)power;
+
+        if (bad == NULL && cJSON_GetObjectItem(root, "sched_idx") != NULL) {
+            uint32_t i = 0;
+            bool del = false;
+            rd_u32(root, "sched_idx", MAX_SCHEDULES - 1, &i, &bad);
+            rd_bool(root, "del", &del, &bad);
+            // Borrar pide una regla existente; editar, una existente o la siguiente
+            if (bad == NULL && (i > cfg.schedule_count || (del && i == cfg.schedule_count))) bad = "sched_idx";
+
+            if (bad != NULL) {
+                // 400 abajo
+            } else if (del) {
+                // Borrar: compactar la tabla (el orden define la prioridad)
+                memmove(&cfg.schedules[i], &cfg.schedules[i + 1],
+                        (cfg.schedule_count - i - 1) * sizeof(schedule_reg_t));
+                cfg.schedule_count--;
+                memset(&cfg.schedules[cfg.schedule_count], 0, sizeof(schedule_reg_t));
+            } else {
+                // i == schedule_count agrega una regla nueva al final (todos los días)
+                if (i == cfg.schedule_count) {
+                    memset(&cfg.schedules[i], 0, sizeof(schedule_reg_t));
+                    cfg.schedules[i].days = DAYS_ALL;
+                    cfg.schedule_count++;
+                }
+                schedule_reg_t *reg = &cfg.schedules[i];
+                rd_bool(root, "act", &reg->active, &bad);
+                rd_u8(root, "days", &reg->days, &bad);
+                rd_u8(root, "sh", &reg->start_hour, &bad);
+                rd_u8(root, "sm", &reg->start_min, &bad);
+                rd_u8(root, "eh", &reg->end_hour, &bad);
+                rd_u8(root, "em", &reg->end_min, &bad);
+                rd_float(root, "tmin", &reg->temp_min_0_percent, &bad);
+                rd_float(root, "tmax", &reg->temp_max_100_percent, &bad);
+                if (bad != NULL) bad_index = (int)i;
             }
         }
-        config_manager_save(global_ctx->shared_config);
-        xSemaphoreGive(global_ctx->config_mutex);
+        // Mismos rangos que PUT/PATCH /api/config: un valor fuera de rango
+        // no se publica ni se guarda (y no rompe los PATCH de otros clientes)
+        if (bad == NULL) bad = config_check(&cfg, &bad_index);
+        bool changed = bad == NULL && config_publish(&cfg, &cur);
+        app_lock_give(global_ctx, METRIC_LOCK_CONFIG, global_ctx->config_mutex);
+        if (bad != NULL) {
+            cJSON_Delete(root);
+            return send_invalid(req, bad, bad_index);
+        }
+        if (changed) {
+            config_manager_request_save(); // Persistencia diferida (CfgWriter)
+            web_server_notify_state(); // Otros clientes ven el cambio sin esperar
+        }
     }
     cJSON_Delete(root);
     httpd_resp_send(req, "{\"status\":\"ok\"}", HTTPD_RESP_USE_STRLEN);
     return ESP_OK;
 }
 
+// --- CONFIGURACIÓN COMPLETA (versionada) ---
+// GET /api/config devuelve solo la configuración, con su versión como ETag.
+// PUT la reemplaza entera (lo que no venga toma el valor por defecto) y PATCH
+// aplica solo las claves presentes, así una UI manda varios cambios en un
+// request. Los dos exigen If-Match con el ETag vigente: 428 si falta, 412 si
+// otro cliente cambió la config antes (ambos con la config actual para
+// rehacer el cambio). Se valida todo antes de publicar (400 con el campo):
+// nunca queda publicada una config a medias.
+#define CONFIG_BODY_MAX  6144   // PUT con MAX_ZONES zonas y MAX_SCHEDULES reglas (~4 KB)
+#define CONFIG_RECV_RETRIES  3  // Timeouts de recv seguidos antes del 408
+_Static_assert(CONFIG_BODY_MAX >= CONFIG_BLOB_MAX, "config_body también guarda el blob de ?format=bin");
+
+static char config_body[CONFIG_BODY_MAX + 1];   // Solo lo usa la tarea del httpd
+
+// Aplica un documento con las claves de GET /api/config sobre 'cfg'. En
+// "zones" la entrada i va a la zona "id" si viene, si no a la i; "schedules"
+// reemplaza la tabla entera. "version" se ignora (manda If-Match). Devuelve
+// la primera clave con tipo inválido o NULL; los rangos los ve config_check.
+static const char *config_from_json(system_config_t *cfg, const cJSON *root) {
+    const char *bad = NULL;
+    if (!cJSON_IsObject(root)) return "body";
+    rd_u8(root, "zone_count", &cfg->zone_count, &bad);
+    rd_u32(root, "hold", UINT32_MAX, &cfg->presence_hold_s, &bad);
+    rd_u32(root, "rate_min", UINT32_MAX, &cfg->sample_min_ms, &bad);
+    rd_u32(root, "rate_max", UINT32_MAX, &cfg->sample_max_ms, &bad);
+    rd_u32(root, "deadline", UINT32_MAX, &cfg->sample_deadline_ms, &bad);
+    rd_u32(root, "slew_up", UINT32_MAX, &cfg->fan_slew_up, &bad);
+    rd_u32(root, "slew_down", UINT32_MAX, &cfg->fan_slew_down, &bad);
+    uint32_t power = cfg->power_mode;
+    rd_u32(root, "power", POWER_MODE_COUNT - 1, &power, &bad);
+    cfg->power_mode = (power_mode_t)power;
+
+    const cJSON *zones = cJSON_GetObjectItem(root, "zones");
+    if (zones != NULL) {
+        if (!cJSON_IsArray(zones)) return "zones";
+        uint32_t i = 0;
+        const cJSON *zo;
+        cJSON_ArrayForEach(zo, zones) {
+            uint32_t id = i++;
+            if (!cJSON_IsObject(zo)) return "zones";
+            rd_u32(zo, "id", MAX_ZONES - 1, &id, &bad);
+            if (id >= MAX_ZONES) return "zones";
+            zone_from_json(&cfg->zones[id], zo, &bad);
+        }
+    }
+
+    const cJSON *scheds = cJSON_GetObjectItem(root, "schedules");
+    if (scheds != NULL) {
+        if (!cJSON_IsArray(scheds) || cJSON_GetArraySize(scheds) > MAX_SCHEDULES) return "schedules";
+        memset(cfg->schedules, 0, sizeof(cfg->schedules));
+        cfg->schedule_count = 0;
+        const cJSON *so;
+        cJSON_ArrayForEach(so, scheds) {
+            if (!cJSON_IsObject(so)) return "schedules";
+            schedule_reg_t *reg = &cfg->schedules[cfg->schedule_count++];
+            reg->active = true;
+            reg->days = DAYS_ALL;
+            rd_bool(so, "act", &reg->active, &bad);
+            rd_u8(so, "days", &reg->days, &bad);
+            rd_u8(so, "sh", &reg->start_hour, &bad);
+            rd_u8(so, "sm", &reg->start_min, &bad);
+            rd_u8(so, "eh", &reg->end_hour, &bad);
+            rd_u8(so, "em", &reg->end_min, &bad);
+            rd_float(so, "tmin", &reg->temp_min_0_percent, &bad);
+            rd_float(so, "tmax", &reg->temp_max_100_percent, &bad);
+        }
+    }
+    return bad;
+}
+
+// Documento de la config con su ETag ("<versión>") y el status dado
+static esp_err_t config_respond(httpd_req_t *req, const system_config_t *cfg, const char *status) {
+    char etag[16];
+    snprintf(etag, sizeof(etag), "\"%lu\"", (unsigned long)cfg->version);
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char buf[1024];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), status_flush_chunk, req);
+    config_json_write(&w, cfg);
+    if (w.flushes == 0 && !w.error) return httpd_resp_send(req, buf, w.len);
+    json_writer_finish(&w);
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static esp_err_t api_config_get_handler(httpd_req_t *req) {
+    system_config_t cfg;
+    snapshot_read(global_ctx->config_snap, &cfg);
+
+    // Polling barato: sin cambios, 304 sin cuerpo
+    char inm[24], etag[16];
+    snprintf(etag, sizeof(etag), "\"%lu\"", (unsigned long)cfg.version);
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK && strstr(inm, etag) != NULL) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_set_hdr(req, "ETag", etag);
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    // ?format=bin: el blob versionado que se guarda en NVS (host/tools/cfg_tool)
+    char query[24], fmt[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "format", fmt, sizeof(fmt)) == ESP_OK && strcmp(fmt, "bin") == 0) {
+        size_t len = config_encode(&cfg, (uint8_t *)config_body, sizeof(config_body));
+        if (len == 0) return httpd_resp_send_500(req);
+        httpd_resp_set_type(req, "application/octet-stream");
+        httpd_resp_set_hdr(req, "ETag", etag);
+        return httpd_resp_send(req, config_body, len);
+    }
+    return config_respond(req, &cfg, "200 OK");
+}
+
+static esp_err_t config_write(httpd_req_t *req, bool replace) {
+    if (req->content_len > CONFIG_BODY_MAX) {
+        httpd_resp_set_status(req, "413 Payload Too Large");
+        return httpd_resp_send(req, "Config demasiado grande", HTTPD_RESP_USE_STRLEN);
+    }
+    // Un cliente que se traba a mitad del cuerpo no retiene el socket ni la
+    // tarea del httpd: unos pocos timeouts seguidos y se corta con 408
+    size_t got = 0;
+    int timeouts = 0;
+    while (got < req->content_len) {
+        int n = httpd_req_recv(req, config_body + got, req->content_len - got);
+        if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= CONFIG_RECV_RETRIES) continue;
+        if (n == HTTPD_SOCK_ERR_TIMEOUT) {
+            httpd_resp_send_408(req);
+            return ESP_FAIL;
+        }
+        if (n <= 0) return ESP_FAIL;
+        timeouts = 0;
+        got += n;
+    }
+    cJSON *root = cJSON_ParseWithLength(config_body, got);
+    if (root == NULL) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "JSON invalido");
+
+    // If-Match se compara con config_mutex tomado: entre la comparación y la
+    // publicación ningún otro escritor puede cambiar la versión
+    char if_match[48];
+    bool has_if_match = httpd_req_get_hdr_value_str(req, "If-Match", if_match, sizeof(if_match)) == ESP_OK;
+    const char *status = "200 OK";
+    const char *bad = NULL;
+    int bad_index = -1;
+    bool changed = false;
+    system_config_t cur, cfg;
+
+    app_lock_take(global_ctx, METRIC_LOCK_CONFIG, global_ctx->config_mutex);
+    snapshot_read(global_ctx->config_snap, &cur);
+    char etag[16];
+    snprintf(etag, sizeof(etag), "\"%lu\"", (unsigned long)cur.version);
+    if (!has_if_match) {
+        status = "428 Precondition Required";
+    } else if (strcmp(if_match, "*") != 0 && strstr(if_match, etag) == NULL) {
+        status = "412 Precondition Failed";
+    } else {
+        cfg = replace ? default_system_config : cur;
+        bad = config_from_json(&cfg, root);
+        if (bad == NULL) bad = config_check(&cfg, &bad_index);
+        if (bad == NULL) {
+            changed = config_publish(&cfg, &cur);
+            cur = cfg;
+        }
+    }
+    app_lock_give(global_ctx, METRIC_LOCK_CONFIG, global_ctx->config_mutex);
+    cJSON_Delete(root);
+
+    if (bad != NULL) return send_invalid(req, bad, bad_index);
+    if (changed) {
+        config_manager_request_save();  // Un solo guardado por lote de cambios
+        web_server_notify_state();
+    }
+    return config_respond(req, &cur, status);
+}
+
+static esp_err_t api_config_put_handler(httpd_req_t *req) { return config_write(req, true); }
+static esp_err_t api_config_patch_handler(httpd_req_t *req) { return config_write(req, false); }
+
+// --- HISTORIAL (binario, ver history.h) ---
+// GET /api/history?tier=0|1|2&from=<epoch>&to=<epoch>
+// Sin from/to devuelve el nivel completo. La cabecera y los registros se
+// envían en chunks; history_mutex se toma solo para copiar cada bloque, no
+// mientras se escribe al socket.
+#define HISTORY_CHUNK_BYTES  1024
+
+static int64_t query_int(const char *query, const char *key, int64_t def) {
+    char val[24];
+    if (query == NULL || httpd_query_key_value(query, key, val, sizeof(val)) != ESP_OK) return def;
+    return strtoll(val, NULL, 10);
+}
+
+static esp_err_t api_history_get_handler(httpd_req_t *req) {
+    char query[96];
+    const char *q = (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) ? query : NULL;
+
+    int tier = (int)query_int(q, "tier", HISTORY_TIER_MINUTE);
+    if (tier < 0 || tier >= HISTORY_TIER_COUNT) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "tier invalido");
+    }
+    uint32_t period = history_period_s(tier);
+    int64_t cap = (int64_t)history_capacity(tier);
+
+    app_lock_take(global_ctx, METRIC_LOCK_HISTORY, global_ctx->history_mutex);
+    int64_t latest = history_latest(global_ctx->history, tier);
+    app_lock_give(global_ctx, METRIC_LOCK_HISTORY, global_ctx->history_mutex);
+
+    int64_t to = query_int(q, "to", latest);
+    int64_t from = query_int(q, "from", to - (cap - 1) * (int64_t)period);
+    if (to < from) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "rango invalido");
+    }
+    if (from < 0) from = 0;
+    from -= from % period;
+    int64_t count = (latest < 0 || to < from) ? 0 : (to - from) / period + 1; // Sin datos: sin NTP aún
+    if (count > cap) {                      // Como máximo un ring completo (el más reciente)
+        from += (count - cap) * (int64_t)period;
+        count = cap;
+    }
+
+    history_wire_header_t hdr = {
+        .magic = HISTORY_WIRE_MAGIC,
+        .version = HISTORY_WIRE_VERSION,
+        .tier = (uint8_t)tier,
+        .record_size = (uint8_t)history_record_size(tier),
+        .period_s = period,
+        .count = (uint32_t)count,
+        .first_ts = from,
+    };
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    if (httpd_resp_send_chunk(req, (const char *)&hdr, sizeof(hdr)) != ESP_OK) return ESP_FAIL;
+
+    uint8_t buf[HISTORY_CHUNK_BYTES];
+    size_t per_chunk = sizeof(buf) / hdr.record_size;
+    for (int64_t done = 0; done < count; ) {
+        size_t n = (count - done < (int64_t)per_chunk) ? (size_t)(count - done) : per_chunk;
+        app_lock_take(global_ctx, METRIC_LOCK_HISTORY, global_ctx->history_mutex);
+        history_read(global_ctx->history, tier, from + done * (int64_t)period, n, buf);
+        app_lock_give(global_ctx, METRIC_LOCK_HISTORY, global_ctx->history_mutex);
+        if (httpd_resp_send_chunk(req, (const char *)buf, n * hdr.record_size) != ESP_OK) return ESP_FAIL;
+        done += n;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// --- LOG PERSISTENTE (binario, ver sensor_log_codec.h) ---
+// GET /api/log?from=<epoch>&to=<epoch>: bloques completos de 4 KB en orden
+// de escritura, mismo formato que un volcado de la partición. Se decodifica
+// en Linux con host/build/slog_decode.
+static int log_sink_chunk(void *ctx, const uint8_t *data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, (const char *)data, len) == ESP_OK ? 0 : -1;
+}
+
+static esp_err_t api_log_get_handler(httpd_req_t *req) {
+    char query[96];
+    const char *q = (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) ? query : NULL;
+    int64_t from = query_int(q, "from", 0);
+    int64_t to = query_int(q, "to", INT64_MAX);
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"senslog.bin\"");
+    esp_err_t err = sensor_log_export(from, to, log_sink_chunk, req);
+    if (err == ESP_ERR_NOT_FOUND) {
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Sin particion de log");
+    }
+    if (err != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Contadores del escritor diferido de NVS
+static esp_err_t api_storage_get_handler(httpd_req_t *req) {
+    config_store_stats_t st;
+    sensor_log_stats_t lg;
+    config_manager_get_stats(&st);
+    sensor_log_get_stats(&lg);
+
+    char buf[512];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+    json_obj_begin(&w);
+    json_kv_int(&w, "requests", st.requests);
+    json_kv_int(&w, "writes", st.writes);
+    json_kv_int(&w, "skipped_unchanged", st.skipped_unchanged);
+    // Pedidos absorbidos por la ventana de debounce (incluye los aún pendientes)
+    json_kv_int(&w, "coalesced", st.requests - st.writes - st.skipped_unchanged - st.errors);
+    json_kv_int(&w, "errors", st.errors);
+    json_kv_int(&w, "last_save_us", st.last_save_us);
+    json_kv_int(&w, "max_save_us", st.max_save_us);
+    // Blob versionado en NVS (core/config_codec.c) y su carga en el arranque
+    static const char *const sources[] = { "defaults", "nvs", "migrated", "rejected", "repaired" };
+    json_kv_int(&w, "blob_bytes", st.blob_bytes);
+    json_kv_int(&w, "raw_bytes", sizeof(system_config_t));
+    json_kv_int(&w, "load_us", st.load_us);
+    json_kv_str(&w, "load_from", sources[st.load_source]);
+    json_kv_int(&w, "load_unknown", st.load_unknown);
+
+    // Log persistente de sensores (sensor_log.c)
+    json_key(&w, "log");
+    json_obj_begin(&w);
+    json_kv_int(&w, "records", lg.records);
+    json_kv_int(&w, "bytes", lg.bytes);
+    json_kv_int(&w, "blocks", lg.blocks);
+    json_kv_int(&w, "dropped", lg.dropped);
+    json_kv_int(&w, "erases", lg.erases);
+    json_kv_int(&w, "flash_writes", lg.flash_writes);
+    json_kv_int(&w, "errors", lg.errors);
+    json_kv_int(&w, "max_flush_us", lg.max_flush_us);
+    json_kv_int(&w, "sectors", lg.sectors);
+    json_obj_end(&w);
+    json_obj_end(&w);
+    if (json_writer_finish(&w) != 0) return httpd_resp_send_500(req);
+
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, buf, w.len);
+}
+
+// Lazo por eventos: período adaptativo y latencia despertar -> set_duty,
+// por zona ({"zones":[...]}, en chunks: con 8 zonas no entra en un buffer)
+static esp_err_t api_loop_get_handler(httpd_req_t *req) {
+    static const char *const reason_names[SAMPLE_REASON_COUNT] = { "periodic", "presence", "threshold" };
+    httpd_resp_set_type(req, "application/json");
+
+    char buf[768];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), status_flush_chunk, req);
+    json_obj_begin(&w);
+    json_key(&w, "zones");
+    json_arr_begin(&w);
+    for (unsigned z = 0; z < global_ctx->zone_count; z++) {
+        zone_t *zone = &global_ctx->zones[z];
+        sensor_loop_stats_t sl;
+        control_loop_stats_t cl;
+        sensor_task_get_stats(zone, &sl);
+        control_task_get_stats(zone, &cl);
+
+        json_obj_begin(&w);
+        json_kv_int(&w, "core", zone->core);
+        json_kv_int(&w, "period_ms", sl.period_ms);
+        json_kv_int(&w, "rate_mc_s", sl.rate_mc_per_s);
+        json_kv_int(&w, "checks", sl.checks);
+        json_kv_int(&w, "jitter_p99_us", latency_hist_percentile(&sl.jitter, 99));
+        json_kv_int(&w, "jitter_max_us", sl.jitter.max_us);
+        json_kv_int(&w, "overruns", sl.overruns);
+        json_kv_int(&w, "deadline_miss", cl.deadline_miss);
+        for (int i = 0; i < SAMPLE_REASON_COUNT; i++) {
+            const latency_hist_t *h = &cl.latency[i];
+            json_key(&w, reason_names[i]);
+            json_obj_begin(&w);
+            json_kv_int(&w, "samples", sl.samples[i]);
+            json_kv_int(&w, "lat_avg_us", latency_hist_avg(h));
+            json_kv_int(&w, "lat_p50_us", latency_hist_percentile(h, 50));
+            json_kv_int(&w, "lat_p99_us", latency_hist_percentile(h, 99));
+            json_kv_int(&w, "lat_max_us", h->max_us);
+            json_obj_end(&w);
+        }
+        json_obj_end(&w);
+    }
+    json_arr_end(&w);
+    json_obj_end(&w);
+    json_writer_finish(&w);
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Energía: tiempo dormido y con cada lock desde el último cambio de modo, y
+// lo que el modo agrega a la latencia del lazo (despertar por tiempo tarde y
+// despertar -> set_duty). Cambiar de modo reinicia todo para comparar.
+static void write_hist(json_writer_t *w, const char *key, const latency_hist_t *h) {
+    json_key(w, key);
+    json_obj_begin(w);
+    json_kv_int(w, "n", h->count);
+    json_kv_int(w, "avg_us", latency_hist_avg(h));
+    json_kv_int(w, "p50_us", latency_hist_percentile(h, 50));
+    json_kv_int(w, "p99_us", latency_hist_percentile(h, 99));
+    json_kv_int(w, "max_us", h->max_us);
+    json_obj_end(w);
+}
+
+static esp_err_t api_power_get_handler(httpd_req_t *req) {
+    power_stats_t ps;
+    power_manager_get_stats(&ps);
+
+    // Latencias de todas las zonas juntas: el modo de energía afecta a todas igual
+    latency_hist_t timer_late = {0};
+    latency_hist_t control = {0};
+    for (unsigned z = 0; z < global_ctx->zone_count; z++) {
+        sensor_loop_stats_t sl;
+        control_loop_stats_t cl;
+        sensor_task_get_stats(&global_ctx->zones[z], &sl);
+        control_task_get_stats(&global_ctx->zones[z], &cl);
+        latency_hist_merge(&timer_late, &sl.timer_late);
+        for (int i = 0; i < SAMPLE_REASON_COUNT; i++) latency_hist_merge(&control, &cl.latency[i]);
+    }
+
+    int64_t elapsed = ps.elapsed_us > 0 ? ps.elapsed_us : 1;
+    char buf[1024];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), NULL, NULL);
+    json_obj_begin(&w);
+    json_kv_int(&w, "mode", ps.mode);
+    json_kv_bool(&w, "supported", ps.supported);
+    json_kv_int(&w, "cpu_mhz", ps.cpu_mhz);
+    json_kv_int(&w, "elapsed_ms", ps.elapsed_us / 1000);
+    json_kv_int(&w, "sleep_ms", ps.sleep_us / 1000);
+    json_kv_fixed(&w, "sleep_pct", (float)(100.0 * ps.sleep_us / elapsed), 1);
+    json_kv_int(&w, "sleeps", ps.sleeps);
+    json_key(&w, "locks");
+    json_obj_begin(&w);
+    for (int i = 0; i < POWER_LOCK_COUNT; i++) {
+        json_key(&w, power_lock_name(i));
+        json_obj_begin(&w);
+        json_kv_int(&w, "held_ms", ps.locks[i].held_us / 1000);
+        json_kv_fixed(&w, "pct", (float)(100.0 * ps.locks[i].held_us / elapsed), 1);
+        json_kv_int(&w, "count", ps.locks[i].acquisitions);
+        json_kv_int(&w, "depth", ps.locks[i].depth);
+        json_obj_end(&w);
+    }
+    json_obj_end(&w);
+    write_hist(&w, "timer_late", &timer_late);
+    write_hist(&w, "control", &control);
+    json_obj_end(&w);
+    if (json_writer_finish(&w) != 0) return httpd_resp_send_500(req);
+
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, buf, w.len);
+}
+
+// Métricas de ejecución: texto de Prometheus por defecto (para un scraper),
+// JSON compacto con ?format=json o "Accept: application/json". Va en chunks:
+// con 8 zonas el histograma de latencias ocupa decenas de KB de texto.
+static runtime_metrics_t metrics;   // ~4 KB: estático (solo lo usa la tarea del httpd)
+
+static bool metrics_want_json(httpd_req_t *req) {
+    char query[32], fmt[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "format", fmt, sizeof(fmt)) == ESP_OK) {
+        return strcmp(fmt, "json") == 0;
+    }
+    // Un Accept largo llega truncado: alcanza con el comienzo
+    char accept[128] = "";
+    esp_err_t err = httpd_req_get_hdr_value_str(req, "Accept", accept, sizeof(accept));
+    return (err == ESP_OK || err == ESP_ERR_HTTPD_RESULT_TRUNC) && strstr(accept, "application/json") != NULL;
+}
+
+static esp_err_t api_metrics_get_handler(httpd_req_t *req) {
+    bool json = metrics_want_json(req);
+    runtime_metrics_collect(global_ctx, &metrics);
+    httpd_resp_set_type(req, json ? "application/json" : "text/plain; version=0.0.4");
+
+    char buf[1024];
+    json_writer_t w;
+    json_writer_init(&w, buf, sizeof(buf), status_flush_chunk, req);
+    if (json) runtime_metrics_json_write(&w, &metrics);
+    else runtime_metrics_prom_write(&w, &metrics);
+    if (json_writer_finish(&w) != 0) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Un socket abierto (UI con WebSocket o keep-alive) impide el light sleep:
+// dormido, cada paquete esperaría al próximo beacon del AP
+static esp_err_t on_sess_open(httpd_handle_t hd, int sockfd) {
+    power_lock_acquire(POWER_LOCK_HTTP);
+    return ESP_OK;
+}
+
+static void on_sess_close(httpd_handle_t hd, int sockfd) {
+    power_lock_release(POWER_LOCK_HTTP);
+    close(sockfd); // Con close_fn el cierre queda a cargo nuestro
+}
+
+// --- PUSH POR WEBSOCKET ---
+// control_task avisa cada vez que publica estado; el aviso solo encola UN
+// trabajo en el httpd (los avisos que llegan mientras está pendiente se
+// fusionan). El trabajo serializa el documento una vez y lo envía a todos
+// los clientes WebSocket abiertos.
+
+#define WS_PUSH_BUF_SIZE  4096  // Documento completo con MAX_ZONES y MAX_SCHEDULES (~3.7 KB)
+
+static atomic_bool ws_push_pending = false;
+static char ws_push_buf[WS_PUSH_BUF_SIZE];  // Solo lo usa la tarea del httpd
+
+static void ws_broadcast_work(void *arg) {
+    atomic_store(&ws_push_pending, false);
+
+    size_t fds = CONFIG_LWIP_MAX_SOCKETS;
+    int client_fds[CONFIG_LWIP_MAX_SOCKETS];
+    if (httpd_get_client_list(server, &fds, client_fds) != ESP_OK) return;
+
+    bool serialized = false;
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .fragmented = false,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)ws_push_buf,
+    };
+
+    for (size_t i = 0; i < fds; i++) {
+        if (httpd_ws_get_fd_info(server, client_fds[i]) != HTTPD_WS_CLIENT_WEBSOCKET) continue;
+
+        // Serializar solo si hay al menos un cliente
+        if (!serialized) {
+            system_config_t cfg;
+            system_state_t states[MAX_ZONES];
+            snapshot_read(global_ctx->config_snap, &cfg);
+            unsigned zone_count = read_zone_states(states);
+
+            json_writer_t w;
+            json_writer_init(&w, ws_push_buf, sizeof(ws_push_buf), NULL, NULL);
+            status_json_write(&w, &cfg, states, zone_count);
+            if (json_writer_finish(&w) != 0) {
+                ESP_LOGW(TAG, "Push WS: documento mayor que %d bytes", WS_PUSH_BUF_SIZE);
+                return;
+            }
+            frame.len = w.len;
+            serialized = true;
+        }
+
+        if (httpd_ws_send_frame_async(server, client_fds[i], &frame) != ESP_OK) {
+            httpd_sess_trigger_close(server, client_fds[i]);
+        }
+    }
+}
+
+// Llamado desde control_task (y tras cambios de config): no bloquea
+static void web_server_notify_state(void) {
+    if (server == NULL) return;
+    if (atomic_exchange(&ws_push_pending, true)) return; // Ya hay un push en cola
+    if (httpd_queue_work(server, ws_broadcast_work, NULL) != ESP_OK) {
+        atomic_store(&ws_push_pending, false);
+    }
+}
+
+static esp_err_t ws_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        // Handshake completado: enviar el estado actual de inmediato
+        ESP_LOGI(TAG, "Cliente WebSocket conectado (fd %d)", httpd_req_to_sockfd(req));
+        web_server_notify_state();
+        return ESP_OK;
+    }
+
+    // El canal es solo de bajada: los mensajes del cliente se leen y descartan
+    httpd_ws_frame_t frame = {0};
+    uint8_t discard[64];
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) return err;
+    if (frame.len > sizeof(discard)) return ESP_FAIL;
+    frame.payload = discard;
+    return httpd_ws_recv_frame(req, &frame, frame.len);
+}
+
 static const httpd_uri_t uri_root = { .uri = "/", .method = HTTP_GET, .handler = root_get_handler, .user_ctx = NULL };
 static const httpd_uri_t uri_status = { .uri = "/api/status", .method = HTTP_GET, .handler = api_status_get_handler, .user_ctx = NULL };
 static const httpd_uri_t uri_settings = { .uri = "/api/settings", .method = HTTP_POST, .handler = api_settings_post_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_config_get = { .uri = "/api/config", .method = HTTP_GET, .handler = api_config_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_config_put = { .uri = "/api/config", .method = HTTP_PUT, .handler = api_config_put_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_config_patch = { .uri = "/api/config", .method = HTTP_PATCH, .handler = api_config_patch_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_history = { .uri = "/api/history", .method = HTTP_GET, .handler = api_history_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_log = { .uri = "/api/log", .method = HTTP_GET, .handler = api_log_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_storage = { .uri = "/api/storage", .method = HTTP_GET, .handler = api_storage_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_loop = { .uri = "/api/loop", .method = HTTP_GET, .handler = api_loop_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_power = { .uri = "/api/power", .method = HTTP_GET, .handler = api_power_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_metrics = { .uri = "/api/metrics", .method = HTTP_GET, .handler = api_metrics_get_handler, .user_ctx = NULL };
+static const httpd_uri_t uri_ws = { .uri = "/ws", .method = HTTP_GET, .handler = ws_handler, .user_ctx = NULL, .is_websocket = true };
 
-void start_web_server(app_context_t *ctx) {
+// Lo llama la tarea de red (network/net_manager.c) con el netif ya
+// iniciado; con error reintenta en el próximo ciclo de backoff
+esp_err_t start_web_server(app_context_t *ctx) {
     global_ctx = ctx;
-    httpd_handle_t server = NULL;
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.stack_size = 8192; // Necesario para JSON grande
-    config.max_uri_handlers = 8;
+    config.max_uri_handlers = 13;
+    // Con el cupo de sesiones (7) lleno, sin LRU cada conexión nueva se
+    // acepta y se cierra: bastan 7 keep-alive ociosos (pestañas, scripts) para
+    // que un escritor no entre nunca (host/bench/bench_http). Con LRU se cierra
+    // la sesión con menos actividad; la UI reconecta su WebSocket sola.
+    config.lru_purge_enable = true;
+    config.open_fn = on_sess_open;
+    config.close_fn = on_sess_close;
     
-    if (httpd_start(&server, &config) == ESP_OK) {
+    esp_err_t err = httpd_start(&server, &config);
+    if (err == ESP_OK) {
         httpd_register_uri_handler(server, &uri_root);
         httpd_register_uri_handler(server, &uri_status);
         httpd_register_uri_handler(server, &uri_settings);
-        ESP_LOGI(TAG, "Web Server OK");
+        httpd_register_uri_handler(server, &uri_config_get);
+        httpd_register_uri_handler(server, &uri_config_put);
+        httpd_register_uri_handler(server, &uri_config_patch);
+        httpd_register_uri_handler(server, &uri_history);
+        httpd_register_uri_handler(server, &uri_log);
+        httpd_register_uri_handler(server, &uri_storage);
+        httpd_register_uri_handler(server, &uri_loop);
+        httpd_register_uri_handler(server, &uri_power);
+        httpd_register_uri_handler(server, &uri_metrics);
+        httpd_register_uri_handler(server, &uri_ws);
+        ctx->state_listener = web_server_notify_state;
+        ESP_LOGI(TAG, "Web Server OK (push en /ws)");
+    } else {
+        ESP_LOGE(TAG, "httpd_start: %s", esp_err_to_name(err));
     }
+    return err;
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Genera la tabla ADC -> temperatura del NTC (ntc_lut.h).
+
+Lee los parámetros de main/include/ntc_params.h y evalúa la ecuación Beta
+para los 4096 códigos del ADC. La usan el build de ESP-IDF (main/CMakeLists.txt)
+y el build de host (host/CMakeLists.txt).
+
+Uso: gen_ntc_lut.py <ntc_params.h> <salida ntc_lut.h>
+"""
+import math
+import os
+import re
+import sys
+
+REQUIRED = ("R_NOMINAL", "T_NOMINAL", "B_COEFFICIENT", "R_SERIES",
+            "NTC_CAL_OFFSET", "NTC_VREF", "NTC_ADC_MAX", "NTC_LUT_FRAC_BITS")
+INVALID = -32768  # INT16_MIN: código fuera de rango (0 o fondo de escala)
+
+
+def parse_params(path):
+    params = {}
+    pattern = re.compile(r"^\s*#define\s+(\w+)\s+([-+0-9.eE]+)f?\b")
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            m = pattern.match(line)
+            if m:
+                params[m.group(1)] = float(m.group(2))
+    missing = [k for k in REQUIRED if k not in params]
+    if missing:
+        sys.exit("gen_ntc_lut: faltan parámetros en %s: %s" % (path, ", ".join(missing)))
+    return params
+
+
+def celsius(raw, p):
+    # Misma secuencia que la fórmula original de ntc_driver.c
+    voltage = raw * p["NTC_VREF"] / p["NTC_ADC_MAX"]
+    r_ntc = voltage * p["R_SERIES"] / (p["NTC_VREF"] - voltage)
+    steinhart = math.log(r_ntc / p["R_NOMINAL"]) / p["B_COEFFICIENT"]
+    steinhart += 1.0 / (p["T_NOMINAL"] + 273.15)
+    return 1.0 / steinhart - 273.15 - p["NTC_CAL_OFFSET"]
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    p = parse_params(sys.argv[1])
+    adc_max = int(p["NTC_ADC_MAX"])
+    scale = 1 << int(p["NTC_LUT_FRAC_BITS"])
+
+    table = []
+    for raw in range(adc_max + 1):
+        if raw == 0 or raw == adc_max:
+            table.append(INVALID)
+            continue
+        q = int(round(celsius(raw, p) * scale))
+        if not INVALID < q <= 32767:
+            sys.exit("gen_ntc_lut: código %d fuera de rango int16 (%d)" % (raw, q))
+        table.append(q)
+
+    os.makedirs(os.path.dirname(os.path.abspath(sys.argv[2])), exist_ok=True)
+    with open(sys.argv[2], "w", encoding="utf-8") as out:
+        out.write("// Archivo generado por tools/gen_ntc_lut.py. NO EDITAR.\n")
+        out.write("#pragma once\n#include <stdint.h>\n\n")
+        out.write("#define NTC_LUT_SIZE    %d\n" % len(table))
+        out.write("#define NTC_LUT_INVALID INT16_MIN\n\n")
+        out.write("// Temperatura por código ADC, en 1/%d °C\n" % scale)
+        out.write("static const int16_t NTC_LUT[NTC_LUT_SIZE] = {\n")
+        for i in range(0, len(table), 12):
+            row = ", ".join("INT16_MIN" if v == INVALID else str(v) for v in table[i:i + 12])
+            out.write("    %s,\n" % row)
+        out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
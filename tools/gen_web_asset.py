@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Empaqueta la interfaz web (main/web/index.html) como asset gzip (web_asset.h).
+
+Comprime el HTML en build (gzip determinista: mtime=0, nivel 9) y genera un
+header con el arreglo de bytes, su longitud y un ETag derivado del hash del
+contenido. web_server.c lo sirve con Content-Encoding: gzip y responde 304
+cuando el navegador envía el mismo ETag en If-None-Match.
+
+Uso: gen_web_asset.py <index.html> <salida web_asset.h>
+"""
+import gzip
+import hashlib
+import os
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    src, out = sys.argv[1], sys.argv[2]
+
+    with open(src, "rb") as f:
+        html = f.read()
+    gz = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(html).hexdigest()[:16]
+
+    lines = [
+        "// Archivo generado por tools/gen_web_asset.py desde %s. NO EDITAR." % os.path.basename(src),
+        "#pragma once",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        "#define WEB_INDEX_ETAG       \"\\\"%s\\\"\"" % etag,
+        "#define WEB_INDEX_RAW_LEN    %d" % len(html),
+        "",
+        "static const size_t WEB_INDEX_GZ_LEN = %d;" % len(gz),
+        "static const uint8_t WEB_INDEX_GZ[] = {",
+    ]
+    for i in range(0, len(gz), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in gz[i:i + 16]) + ",")
+    lines.append("};")
+
+    os.makedirs(os.path.dirname(os.path.abspath(out)), exist_ok=True)
+    with open(out, "w", encoding="utf-8") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()